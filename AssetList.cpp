@@ -12,6 +12,9 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <utility>
+
 #include "Item.h"
 
 #include "AssetList.h"
@@ -23,18 +26,11 @@ namespace Evernus
     {
     }
 
-    AssetList::AssetList(const AssetList &other)
-        : Entity{other}
-        , mCharacterId{other.mCharacterId}
-    {
-        for (const auto &item : other)
-            addItem(std::make_unique<Item>(*item));
-    }
-
     AssetList::AssetList(ItemList &&items)
         : Entity{}
         , mItems{std::move(items)}
     {
+        linkItems();
     }
 
     AssetList::~AssetList()
@@ -53,45 +49,101 @@ namespace Evernus
 
     AssetList::Iterator AssetList::begin() noexcept
     {
-        return mItems.begin();
+        return Iterator{(mFirstRoot != noItem) ? (&mItems[mFirstRoot]) : (nullptr)};
     }
 
     AssetList::ConstIterator AssetList::begin() const noexcept
     {
-        return mItems.begin();
+        return ConstIterator{(mFirstRoot != noItem) ? (&mItems[mFirstRoot]) : (nullptr)};
     }
 
     AssetList::Iterator AssetList::end() noexcept
     {
-        return mItems.end();
+        return Iterator{};
     }
 
     AssetList::ConstIterator AssetList::end() const noexcept
     {
-        return mItems.end();
+        return ConstIterator{};
     }
 
     size_t AssetList::size() const noexcept
     {
-        return mItems.size();
+        return mRootCount;
     }
 
-    void AssetList::addItem(ItemType &&item)
+    AssetList::ItemList &AssetList::getAllItems() noexcept
     {
-        item->setListId(getId());
-        mItems.emplace_back(std::move(item));
+        return mItems;
     }
 
-    AssetList &AssetList::operator =(const AssetList &other)
+    const AssetList::ItemList &AssetList::getAllItems() const noexcept
     {
-        using std::swap;
-
-        AssetList temp{other};
+        return mItems;
+    }
 
-        swap(static_cast<Entity &>(*this), static_cast<Entity &>(temp));
-        swap(mCharacterId, temp.mCharacterId);
-        swap(mItems, temp.mItems);
+    void AssetList::setItems(ItemList &&items)
+    {
+        mItems = std::move(items);
+        linkItems();
+    }
 
-        return *this;
+    void AssetList::linkItems()
+    {
+        // sorted id index instead of a hash map, to avoid per-item allocations
+        std::vector<std::pair<Item::IdType, std::size_t>> ids;
+        ids.reserve(mItems.size());
+
+        for (auto i = 0u; i < mItems.size(); ++i)
+            ids.emplace_back(mItems[i].getId(), i);
+
+        std::sort(std::begin(ids), std::end(ids));
+
+        mFirstRoot = noItem;
+        mRootCount = 0;
+
+        for (auto &item : mItems)
+        {
+            item.mFirstChildOffset = 0;
+            item.mNextSiblingOffset = 0;
+            item.mChildCount = 0;
+        }
+
+        const auto offset = [](std::size_t from, std::size_t to) {
+            return static_cast<std::ptrdiff_t>(to) - static_cast<std::ptrdiff_t>(from);
+        };
+
+        // walk backwards and prepend, so siblings keep their storage order
+        for (auto i = mItems.size(); i-- > 0;)
+        {
+            auto &item = mItems[i];
+            auto parent = noItem;
+
+            const auto parentId = item.getParentId();
+            if (parentId)
+            {
+                const auto it = std::lower_bound(std::begin(ids), std::end(ids), std::make_pair(*parentId, std::size_t{0}));
+                if (it != std::end(ids) && it->first == *parentId && it->second != i)
+                    parent = it->second;
+            }
+
+            if (parent != noItem)
+            {
+                auto &parentItem = mItems[parent];
+                if (parentItem.mFirstChildOffset != 0)
+                    item.mNextSiblingOffset = offset(i, parent) + parentItem.mFirstChildOffset;
+
+                parentItem.mFirstChildOffset = offset(parent, i);
+                ++parentItem.mChildCount;
+            }
+            else
+            {
+                if (mFirstRoot != noItem)
+                    item.mNextSiblingOffset = offset(i, mFirstRoot);
+
+                mFirstRoot = i;
+                ++mRootCount;
+            }
+        }
     }
 }
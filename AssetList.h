@@ -14,7 +14,7 @@
  */
 #pragma once
 
-#include <memory>
+#include <cstddef>
 #include <vector>
 
 #include "Character.h"
@@ -27,16 +27,15 @@ namespace Evernus
         : public Entity<uint>
     {
     public:
-        typedef std::unique_ptr<Item> ItemType;
-        typedef std::vector<ItemType> ItemList;
-        typedef ItemList::iterator Iterator;
-        typedef ItemList::const_iterator ConstIterator;
+        typedef std::vector<Item> ItemList;
+        typedef Item::ItemIterator Iterator;
+        typedef Item::ConstItemIterator ConstIterator;
 
         using Entity::Entity;
 
         AssetList();
-        AssetList(const AssetList &other);
-        AssetList(AssetList &&other) = default;
+        AssetList(const AssetList &) = default;
+        AssetList(AssetList &&) = default;
         explicit AssetList(ItemList &&items);
 
         virtual ~AssetList();
@@ -51,13 +50,24 @@ namespace Evernus
 
         size_t size() const noexcept;
 
-        void addItem(ItemType &&item);
+        // all items, in storage order, regardless of nesting
+        ItemList &getAllItems() noexcept;
+        const ItemList &getAllItems() const noexcept;
 
-        AssetList &operator =(const AssetList &other);
-        AssetList &operator =(AssetList &&other) = default;
+        // replaces contents - items are nested according to their parent ids
+        void setItems(ItemList &&items);
+
+        AssetList &operator =(const AssetList &) = default;
+        AssetList &operator =(AssetList &&) = default;
 
     private:
+        static const auto noItem = static_cast<std::size_t>(-1);
+
         Character::IdType mCharacterId = Character::invalidId;
         ItemList mItems;
+        std::size_t mFirstRoot = noItem;
+        std::size_t mRootCount = 0;
+
+        void linkItems();
     };
 }
@@ -0,0 +1,42 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+
+#include "Item.h"
+
+namespace Evernus
+{
+    // item level difference between a stored asset list and its refreshed version
+    struct AssetListChanges
+    {
+        std::vector<Item::IdType> mAdded;
+        std::vector<Item::IdType> mMoved;   // parent or location changed
+        std::vector<Item::IdType> mChanged; // same place, different contents
+        std::vector<Item::IdType> mRemoved;
+
+        // added or moved items need to be placed anew in any nested view
+        inline bool isStructural() const noexcept
+        {
+            return !mAdded.empty() || !mMoved.empty();
+        }
+
+        inline bool isEmpty() const noexcept
+        {
+            return !isStructural() && mChanged.empty() && mRemoved.empty();
+        }
+    };
+}
@@ -77,30 +77,16 @@ namespace Evernus
 
         DatabaseUtils::execQuery(query);
 
-        std::unordered_map<Item::IdType, Item *> itemMap;
-        std::vector<std::unique_ptr<Item>> items;
+        AssetList::ItemList items;
 
-        while (query.next())
-        {
-            auto item = mItemRepository.populate(query.record());
-            auto itemPtr = std::make_unique<Item>(std::move(*item));
-
-            itemMap[itemPtr->getId()] = itemPtr.get();
-            items.emplace_back(std::move(itemPtr));
-        }
+        const auto size = query.size();
+        if (size > 0)
+            items.reserve(size);
 
-        for (auto &item : items)
-        {
-            const auto parentId = item->getParentId();
-            if (parentId && itemMap.find(*parentId) != std::end(itemMap))
-                itemMap[*parentId]->addItem(std::move(item));
-        }
+        while (query.next())
+            items.emplace_back(mItemRepository.populateItem(query.record()));
 
-        for (auto &item : items)
-        {
-            if (item)
-                assets->addItem(std::move(item));
-        }
+        assets->setItems(std::move(items));
 
         return assets;
     }
@@ -113,6 +99,100 @@ namespace Evernus
         DatabaseUtils::execQuery(query);
     }
 
+    AssetListChanges AssetListRepository::syncForCharacter(AssetList &list) const
+    {
+        AssetListChanges changes;
+
+        EntityPtr previous;
+
+        try
+        {
+            previous = fetchForCharacter(list.getCharacterId());
+        }
+        catch (const NotFoundException &)
+        {
+            store(list);
+
+            for (const auto &item : list.getAllItems())
+                changes.mAdded.emplace_back(item.getId());
+
+            return changes;
+        }
+
+        Q_ASSERT(previous);
+
+        list.setId(previous->getId());
+        list.updateOriginalId();
+        list.setNew(false);
+
+        std::unordered_map<Item::IdType, const Item *> previousItems;
+        for (const auto &item : previous->getAllItems())
+            previousItems.emplace(item.getId(), &item);
+
+        for (auto &item : list.getAllItems())
+            item.setListId(list.getId());
+
+        ItemRepository::PropertyMap added;
+        std::vector<const Item *> updated;
+
+        for (const auto item : getParentFirstOrder(list))
+        {
+            const auto previousItem = previousItems.find(item->getId());
+            if (previousItem == std::end(previousItems))
+            {
+                ItemRepository::fillProperties(*item, added);
+                changes.mAdded.emplace_back(item->getId());
+                continue;
+            }
+
+            const auto &oldItem = *previousItem->second;
+            previousItems.erase(previousItem);
+
+            if (item->getParentId() != oldItem.getParentId() || item->getLocationId() != oldItem.getLocationId())
+            {
+                updated.emplace_back(item);
+                changes.mMoved.emplace_back(item->getId());
+            }
+            else if (item->getTypeId() != oldItem.getTypeId() ||
+                     item->getQuantity() != oldItem.getQuantity() ||
+                     item->getRawQuantity() != oldItem.getRawQuantity() ||
+                     item->getCustomValue() != oldItem.getCustomValue() ||
+                     item->getBPCFlag() != oldItem.getBPCFlag())
+            {
+                updated.emplace_back(item);
+                changes.mChanged.emplace_back(item->getId());
+            }
+        }
+
+        for (const auto &item : previousItems)
+            changes.mRemoved.emplace_back(item.first);
+
+        if (changes.isEmpty())
+            return changes;
+
+        auto db = getDatabase();
+
+        db.transaction();
+
+        try
+        {
+            // order matters: new parents must exist before anything moves into them, and moved items
+            // must leave removed containers before those get deleted along with their contents
+            mItemRepository.batchStore(added);
+            mItemRepository.batchUpdate(updated);
+            mItemRepository.batchRemove(changes.mRemoved);
+        }
+        catch (...)
+        {
+            db.rollback();
+            throw;
+        }
+
+        db.commit();
+
+        return changes;
+    }
+
     QStringList AssetListRepository::getColumns() const
     {
         return QStringList{}
@@ -149,14 +229,32 @@ namespace Evernus
 
     void AssetListRepository::postStore(AssetList &entity) const
     {
-        for (const auto &item : entity)
-            item->setListId(entity.getId());
+        for (auto &item : entity.getAllItems())
+            item.setListId(entity.getId());
 
         ItemRepository::PropertyMap map;
 
-        for (const auto &item : entity)
+        for (const auto item : getParentFirstOrder(entity))
             ItemRepository::fillProperties(*item, map);
 
         mItemRepository.batchStore(map);
     }
+
+    std::vector<const Item *> AssetListRepository::getParentFirstOrder(const AssetList &list)
+    {
+        // items reference their parents, so those need to be stored first
+        std::vector<const Item *> result;
+        result.reserve(list.getAllItems().size());
+
+        for (const auto item : list)
+            result.emplace_back(item);
+
+        for (auto i = 0u; i < result.size(); ++i)
+        {
+            for (const auto child : *result[i])
+                result.emplace_back(child);
+        }
+
+        return result;
+    }
 }
@@ -14,6 +14,9 @@
  */
 #pragma once
 
+#include <vector>
+
+#include "AssetListChanges.h"
 #include "Repository.h"
 #include "AssetList.h"
 
@@ -39,6 +42,9 @@ namespace Evernus
         EntityPtr fetchForCharacter(Character::IdType id) const;
         void deleteForCharacter(Character::IdType id) const;
 
+        // stores the list by writing only items which differ from the currently stored version
+        AssetListChanges syncForCharacter(AssetList &list) const;
+
     private:
         const ItemRepository &mItemRepository;
 
@@ -50,5 +56,7 @@ namespace Evernus
 
         virtual void preStore(AssetList &entity) const override;
         virtual void postStore(AssetList &entity) const override;
+
+        static std::vector<const Item *> getParentFirstOrder(const AssetList &list);
     };
 }
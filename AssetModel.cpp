@@ -12,15 +12,22 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <QSettings>
+#include <unordered_set>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QTimer>
 #include <QLocale>
 #include <QColor>
 #include <QFont>
 #include <QIcon>
 
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "AssetProvider.h"
-#include "PriceSettings.h"
 #include "ExternalOrder.h"
 #include "AssetList.h"
 #include "IconUtils.h"
@@ -36,6 +43,12 @@ namespace Evernus
         mChildItems.emplace_back(std::move(child));
     }
 
+    void AssetModel::TreeItem::removeChild(int row)
+    {
+        Q_ASSERT(row >= 0 && row < static_cast<int>(mChildItems.size()));
+        mChildItems.erase(std::next(std::begin(mChildItems), row));
+    }
+
     void AssetModel::TreeItem::clearChildren() noexcept
     {
         mChildItems.clear();
@@ -191,6 +204,11 @@ namespace Evernus
         connect(&mDataProvider, &EveDataProvider::namesChanged, this, &AssetModel::updateNames);
     }
 
+    AssetModel::~AssetModel()
+    {
+        cancelLoading();
+    }
+
     int AssetModel::columnCount(const QModelIndex &parent) const
     {
         if (parent.isValid())
@@ -234,7 +252,7 @@ namespace Evernus
             case totalVolumeColumn:
                 return QString{"%1m³"}.arg(locale.toString(item->data(totalVolumeColumn).toDouble(), 'f', 2));
             case unitPriceColumn:
-                if (item->parent() != &mRootItem)
+                if (item->parent() != &mRootItem && !isPricePending(*item))
                     return TextUtils::currencyToString(item->data(unitPriceColumn).toDouble(), locale);
                 break;
             case customValueColumn:
@@ -245,7 +263,12 @@ namespace Evernus
                 }
                 break;
             case totalPriceColumn:
-                return TextUtils::currencyToString(item->data(totalPriceColumn).toDouble(), locale);
+                {
+                    const auto value = item->data(totalPriceColumn);
+                    if (!value.isNull())
+                        return TextUtils::currencyToString(value.toDouble(), locale);
+                }
+                break;
             case ownerColumn:
                 {
                     const auto id = item->data(ownerColumn).value<Character::IdType>();
@@ -264,16 +287,15 @@ namespace Evernus
 
             return QFont{};
         case Qt::BackgroundRole:
-            if ((column == unitPriceColumn || column == totalPriceColumn) && item->parent() != &mRootItem)
+            if ((column == unitPriceColumn || column == totalPriceColumn) && item->parent() != &mRootItem && !isPricePending(*item))
             {
-                QSettings settings;
-                const auto maxPriceAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                const auto maxPriceAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                 if (item->priceTimestamp() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxPriceAge))
                     return QColor{255, 255, 192};
             }
             break;
         case Qt::ToolTipRole:
-            if ((column == unitPriceColumn || column == totalPriceColumn) && item->parent() != &mRootItem)
+            if ((column == unitPriceColumn || column == totalPriceColumn) && item->parent() != &mRootItem && !isPricePending(*item))
                 return tr("Price update time: %1").arg(TextUtils::dateTimeToString(item->priceTimestamp().toLocalTime(), locale));
         }
 
@@ -357,26 +379,120 @@ namespace Evernus
 
     void AssetModel::reset()
     {
+        cancelLoading();
+
         beginResetModel();
 
         mRootItem.clearChildren();
         mLocationItems.clear();
+        mItems.clear();
+        mPendingPriceItems.clear();
 
         mTotalAssets = 0;
         mTotalVolume = mTotalSellPrice = 0.;
 
+        endResetModel();
+
+        // NOTE: the lists themselves are still read here - moving that off the GUI thread needs the asset provider
+        // cache and the data provider name caches to be made thread safe first
         if (mCombineCharacters)
         {
             const auto assets = mAssetProvider.fetchAllAssets();
-            for (const auto &list : assets)
-                fillAssets(list);
+            mPendingAssets.assign(std::begin(assets), std::end(assets));
         }
         else if (Q_LIKELY(mCharacterId != Character::invalidId))
         {
-            fillAssets(mAssetProvider.fetchAssetsForCharacter(mCharacterId));
+            mPendingAssets.emplace_back(mAssetProvider.fetchAssetsForCharacter(mCharacterId));
         }
 
-        endResetModel();
+        if (!mPendingAssets.empty())
+            mNextAsset = std::as_const(*mPendingAssets.front()).begin();
+
+        loadAssets();
+    }
+
+    bool AssetModel::applyChanges(Character::IdType ownerId, const AssetListChanges &changes)
+    {
+        if (!mCombineCharacters && ownerId != mCharacterId)
+            return true;
+        // items which are not in the tree yet cannot be updated in place
+        if (changes.isStructural() || !mPendingAssets.empty())
+            return false;
+        if (changes.isEmpty())
+            return true;
+
+        std::vector<std::pair<TreeItem *, const Item *>> changedItems;
+        changedItems.reserve(changes.mChanged.size());
+
+        const auto assets = mAssetProvider.fetchAssetsForCharacter(ownerId);
+        if (!changes.mChanged.empty())
+        {
+            const std::unordered_set<Item::IdType> changedIds(std::begin(changes.mChanged), std::end(changes.mChanged));
+
+            for (const auto &item : assets->getAllItems())
+            {
+                if (changedIds.find(item.getId()) == std::end(changedIds))
+                    continue;
+
+                const auto treeItem = mItems.find(item.getId());
+                if (treeItem == std::end(mItems) || treeItem->second->typeId() != item.getTypeId())
+                    return false;
+
+                changedItems.emplace_back(treeItem->second, &item);
+            }
+
+            if (changedItems.size() != changes.mChanged.size())
+                return false;
+        }
+
+        const auto lastColumn = mRootItem.columnCount() - 1;
+
+        for (const auto &changed : changedItems)
+        {
+            auto &treeItem = *changed.first;
+            const auto quantity = changed.second->getQuantity();
+            const auto customValue = changed.second->getCustomValue();
+
+            auto data = treeItem.data();
+
+            const auto volume = data[unitVolumeColumn].toDouble() * quantity;
+            const auto unitPrice = data[unitPriceColumn];
+
+            // without a custom value, pending items get their price from the background pass
+            QVariant totalPrice;
+            if (customValue)
+                totalPrice = *customValue * quantity;
+            else if (!unitPrice.isNull())
+                totalPrice = unitPrice.toDouble() * quantity;
+
+            const auto quantityDelta = static_cast<qint64>(quantity) - data[quantityColumn].toUInt();
+            const auto volumeDelta = volume - data[totalVolumeColumn].toDouble();
+            const auto sellPriceDelta = totalPrice.toDouble() - data[totalPriceColumn].toDouble();
+
+            data[quantityColumn] = quantity;
+            data[totalVolumeColumn] = volume;
+            data[customValueColumn] = (customValue) ? (*customValue) : (QVariant{});
+            data[totalPriceColumn] = totalPrice;
+
+            treeItem.setData(data);
+            treeItem.setCustomValue(customValue);
+
+            const auto row = treeItem.row();
+            emit dataChanged(createIndex(row, 0, &treeItem), createIndex(row, lastColumn, &treeItem));
+
+            adjustLocationTotals(treeItem, quantityDelta, volumeDelta, sellPriceDelta);
+        }
+
+        for (const auto id : changes.mRemoved)
+        {
+            // nested items are already gone along with their containers
+            const auto item = mItems.find(id);
+            if (item != std::end(mItems))
+                removeItem(*item->second);
+        }
+
+        emit totalsChanged();
+        return true;
     }
 
     uint AssetModel::getTotalAssets() const noexcept
@@ -439,106 +555,447 @@ namespace Evernus
         updateOwner(mRootItem, QModelIndex{}, 0);
     }
 
-    void AssetModel::buildItemMap(const Item &item, TreeItem &treeItem, LocationId locationId, Character::IdType ownerId)
+    void AssetModel::applyPrices(const LocationPrices &prices)
+    {
+        const auto pending = mPendingPriceItems.find(prices.mLocationId);
+        if (pending == std::end(mPendingPriceItems))
+            return;
+
+        // items added by later load steps wait for their own calculation
+        auto &items = pending->second;
+        const auto priced = std::partition(std::begin(items), std::end(items), [&](auto item) {
+            return prices.mPrices.find(item->typeId()) == std::end(prices.mPrices);
+        });
+
+        std::unordered_set<TreeItem *> changedParents;
+        auto locationSellPrice = 0.;
+
+        for (auto it = priced; it != std::end(items); ++it)
+        {
+            const auto item = *it;
+            const auto &sellPrice = prices.mPrices.find(item->typeId())->second;
+
+            auto data = item->data();
+            data[unitPriceColumn] = sellPrice->getPrice();
+
+            if (!item->customValue())
+            {
+                const auto totalPrice = sellPrice->getPrice() * data[quantityColumn].toUInt();
+                data[totalPriceColumn] = totalPrice;
+                locationSellPrice += totalPrice;
+            }
+
+            item->setData(data);
+            item->setPriceTimestamp(sellPrice->getUpdateTime());
+
+            changedParents.emplace(item->parent());
+        }
+
+        items.erase(priced, std::end(items));
+        if (items.empty())
+            mPendingPriceItems.erase(pending);
+
+        const QVector<int> roles{Qt::DisplayRole, Qt::UserRole, Qt::BackgroundRole, Qt::ToolTipRole};
+
+        for (const auto parent : changedParents)
+        {
+            const auto parentIndex = createIndex(parent->row(), 0, parent);
+            emit dataChanged(index(0, unitPriceColumn, parentIndex),
+                             index(parent->childCount() - 1, totalPriceColumn, parentIndex),
+                             roles);
+        }
+
+        const auto location = mLocationItems.find(prices.mLocationId);
+        if (location != std::end(mLocationItems))
+        {
+            auto data = location->second->data();
+            data[totalPriceColumn] = data[totalPriceColumn].toDouble() + locationSellPrice;
+            location->second->setData(data);
+
+            const auto locationIndex = createIndex(location->second->row(), totalPriceColumn, location->second);
+            emit dataChanged(locationIndex, locationIndex, roles);
+        }
+
+        mTotalSellPrice += locationSellPrice;
+
+        emit totalsChanged();
+    }
+
+    void AssetModel::buildItemMap(const Item &item,
+                                  TreeItem &treeItem,
+                                  LocationId locationId,
+                                  Character::IdType ownerId,
+                                  std::vector<TreeItem *> &pendingPriceItems)
     {
         for (const auto &child : item)
         {
-            auto childItem = createTreeItemForItem(*child, locationId, ownerId);
-            buildItemMap(*child, *childItem, locationId, ownerId);
+            auto childItem = createTreeItemForItem(*child, locationId, ownerId, pendingPriceItems);
+            buildItemMap(*child, *childItem, locationId, ownerId, pendingPriceItems);
 
             treeItem.appendChild(std::move(childItem));
         }
     }
 
-    std::unique_ptr<AssetModel::TreeItem> AssetModel
-    ::createTreeItemForItem(const Item &item, LocationId locationId, Character::IdType ownerId)
+    std::unique_ptr<AssetModel::TreeItem> AssetModel::createTreeItemForItem(const Item &item,
+                                                                            LocationId locationId,
+                                                                            Character::IdType ownerId,
+                                                                            std::vector<TreeItem *> &pendingPriceItems)
     {
         const auto typeId = item.getTypeId();
         const auto volume = mDataProvider.getTypeVolume(typeId);
         const auto quantity = item.getQuantity();
-        const auto sellPrice = (item.isBPC()) ? (ExternalOrder::nullOrder()) : (mDataProvider.getTypeStationSellPrice(typeId, locationId));
         const auto metaIcon = IconUtils::getIconForMetaGroup(mDataProvider.getTypeMetaGroupName(typeId));
         const auto customValue = item.getCustomValue();
-        const auto price = (customValue) ? (*customValue) : (sellPrice->getPrice());
 
         mTotalAssets += quantity;
         mTotalVolume += volume * quantity;
-        mTotalSellPrice += price * quantity;
+
+        // market prices are filled in by the background pass, unless they're known upfront
+        QVariant unitPrice, totalPrice;
+        if (customValue)
+        {
+            totalPrice = *customValue * quantity;
+            mTotalSellPrice += *customValue * quantity;
+        }
 
         auto treeItem = std::make_unique<TreeItem>();
+
+        if (item.isBPC())
+        {
+            const auto sellPrice = ExternalOrder::nullOrder();
+            unitPrice = sellPrice->getPrice();
+
+            if (!customValue)
+                totalPrice = sellPrice->getPrice() * quantity;
+
+            treeItem->setPriceTimestamp(sellPrice->getUpdateTime());
+        }
+        else
+        {
+            pendingPriceItems.emplace_back(treeItem.get());
+        }
+
         treeItem->setData(QVariantList{}
             << mDataProvider.getTypeName(typeId)
             << quantity
             << volume
             << (volume * quantity)
-            << sellPrice->getPrice()
+            << unitPrice
             << ((customValue) ? (*customValue) : (QVariant{}))
-            << (price * quantity)
+            << totalPrice
             << ownerId
         );
-        treeItem->setPriceTimestamp(sellPrice->getUpdateTime());
         treeItem->setLocationId(locationId);
         treeItem->setTypeId(typeId);
         treeItem->setOwnerId(ownerId);
         treeItem->setCustomValue(customValue);
         treeItem->setId(item.getId());
 
+        mItems[item.getId()] = treeItem.get();
+
         if (!metaIcon.isNull())
             treeItem->setDecoration(metaIcon);
 
         return treeItem;
     }
 
-    void AssetModel::fillAssets(const std::shared_ptr<AssetList> &assets)
+    void AssetModel::loadAssets()
     {
-        for (const auto &item : *assets)
+        struct LocationBatch
         {
+            LocationId mLocationId = LocationId{};
+            std::vector<std::unique_ptr<TreeItem>> mItems;
+            uint mQuantity = 0;
+            double mVolume = 0.;
+            double mSellPrice = 0.;
+        };
+
+        // group new rows per location, so each location gets a single insertion
+        std::vector<LocationBatch> batches;
+        std::unordered_map<LocationId, std::size_t> batchIndices;
+        std::unordered_map<LocationId, std::vector<TreeItem *>> pendingPriceItems;
+
+        const auto itemLimit = mItems.size() + itemsPerLoadStep;
+        while (!mPendingAssets.empty() && mItems.size() < itemLimit)
+        {
+            const auto &assets = mPendingAssets.front();
+            if (mNextAsset == std::end(std::as_const(*assets)))
+            {
+                mPendingAssets.pop_front();
+                if (!mPendingAssets.empty())
+                    mNextAsset = std::as_const(*mPendingAssets.front()).begin();
+
+                continue;
+            }
+
+            const auto item = *mNextAsset;
+            ++mNextAsset;
+
             auto id = item->getLocationId();
             if (!id)
                 id = LocationId{};
 
-            TreeItem *locationItem = nullptr;
+            const auto batchIndex = batchIndices.emplace(*id, batches.size());
+            if (batchIndex.second)
+            {
+                batches.emplace_back();
+                batches.back().mLocationId = *id;
+            }
+
+            auto &batch = batches[batchIndex.first->second];
+
+            const auto locationId = (mCustomStationId == 0) ? (*id) : (mCustomStationId);
+
+            const auto curAssets = mTotalAssets;
+            const auto curVolume = mTotalVolume;
+            const auto curSellPrice = mTotalSellPrice;
+
+            auto &locationPriceItems = pendingPriceItems[*id];
+
+            auto treeItem = createTreeItemForItem(*item, locationId, assets->getCharacterId(), locationPriceItems);
+            buildItemMap(*item, *treeItem, locationId, assets->getCharacterId(), locationPriceItems);
+            batch.mItems.emplace_back(std::move(treeItem));
 
-            const auto it = mLocationItems.find(*id);
-            if (it == std::end(mLocationItems))
+            batch.mQuantity += mTotalAssets - curAssets;
+            batch.mVolume += mTotalVolume - curVolume;
+            batch.mSellPrice += mTotalSellPrice - curSellPrice;
+        }
+
+        for (auto &batch : batches)
+        {
+            const auto location = mLocationItems.find(batch.mLocationId);
+            if (location == std::end(mLocationItems))
             {
-                auto treeItem = std::make_unique<TreeItem>();
-                treeItem->setData(QVariantList{}
-                    << mDataProvider.getLocationName(*id)
-                    << 0
+                auto locationItem = std::make_unique<TreeItem>();
+                locationItem->setData(QVariantList{}
+                    << mDataProvider.getLocationName(batch.mLocationId)
+                    << batch.mQuantity
                     << QString{}
-                    << 0.
+                    << batch.mVolume
                     << QString{}
                     << QVariant{}
-                    << 0.
+                    << batch.mSellPrice
                     << Character::invalidId);
-                treeItem->setLocationId(*id);
-                locationItem = treeItem.get();
+                locationItem->setLocationId(batch.mLocationId);
+
+                for (auto &child : batch.mItems)
+                    locationItem->appendChild(std::move(child));
+
+                mLocationItems[batch.mLocationId] = locationItem.get();
+
+                const auto row = mRootItem.childCount();
 
-                mLocationItems[*id] = locationItem;
-                mRootItem.appendChild(std::move(treeItem));
+                beginInsertRows(QModelIndex{}, row, row);
+                mRootItem.appendChild(std::move(locationItem));
+                endInsertRows();
             }
             else
             {
-                locationItem = mLocationItems[*id];
+                const auto locationItem = location->second;
+                const auto row = locationItem->row();
+                const auto first = locationItem->childCount();
+
+                beginInsertRows(createIndex(row, 0, locationItem), first, first + static_cast<int>(batch.mItems.size()) - 1);
+
+                for (auto &child : batch.mItems)
+                    locationItem->appendChild(std::move(child));
+
+                endInsertRows();
+
+                auto data = locationItem->data();
+                data[quantityColumn] = data[quantityColumn].toUInt() + batch.mQuantity;
+                data[totalVolumeColumn] = data[totalVolumeColumn].toDouble() + batch.mVolume;
+                data[totalPriceColumn] = data[totalPriceColumn].toDouble() + batch.mSellPrice;
+                locationItem->setData(data);
+
+                emit dataChanged(createIndex(row, quantityColumn, locationItem), createIndex(row, totalPriceColumn, locationItem));
             }
+        }
 
-            const auto locationId = (mCustomStationId == 0) ? (*id) : (mCustomStationId);
+        for (const auto &pending : pendingPriceItems)
+        {
+            auto &items = mPendingPriceItems[pending.first];
+            items.insert(std::end(items), std::begin(pending.second), std::end(pending.second));
+        }
 
-            const auto curAssets = mTotalAssets;
-            const auto curVolume = mTotalVolume;
-            const auto curSellPrice = mTotalSellPrice;
+        startPriceCalculation(pendingPriceItems);
+
+        emit totalsChanged();
+
+        if (mPendingAssets.empty())
+        {
+            emit assetsLoaded();
+            return;
+        }
+
+        const auto generation = mGeneration;
+        QTimer::singleShot(0, this, [=] {
+            if (generation == mGeneration)
+                loadAssets();
+        });
+    }
+
+    void AssetModel::removeItem(TreeItem &item)
+    {
+        auto &locationItem = getLocationItem(item);
+
+        std::unordered_set<TreeItem *> removedItems;
+        qint64 quantity = 0;
+        double volume = 0., sellPrice = 0.;
+
+        forgetItem(item, removedItems, quantity, volume, sellPrice);
+
+        const auto pending = mPendingPriceItems.find(locationItem.locationId());
+        if (pending != std::end(mPendingPriceItems))
+        {
+            auto &items = pending->second;
+            items.erase(std::remove_if(std::begin(items), std::end(items), [&](auto pendingItem) {
+                return removedItems.find(pendingItem) != std::end(removedItems);
+            }), std::end(items));
+        }
+
+        adjustLocationTotals(locationItem, -quantity, -volume, -sellPrice);
+
+        const auto parent = item.parent();
+        Q_ASSERT(parent != nullptr);
 
-            auto treeItem = createTreeItemForItem(*item, locationId, assets->getCharacterId());
+        const auto row = item.row();
 
-            buildItemMap(*item, *treeItem, locationId, assets->getCharacterId());
-            locationItem->appendChild(std::move(treeItem));
+        beginRemoveRows(createIndex(parent->row(), 0, parent), row, row);
+        parent->removeChild(row);
+        endRemoveRows();
 
-            auto data = locationItem->data();
-            data[quantityColumn] = data[quantityColumn].toUInt() + mTotalAssets - curAssets;
-            data[totalVolumeColumn] = data[totalVolumeColumn].toDouble() + mTotalVolume - curVolume;
-            data[totalPriceColumn] = data[totalPriceColumn].toDouble() + mTotalSellPrice - curSellPrice;
-            locationItem->setData(data);
+        if (locationItem.childCount() == 0)
+        {
+            const auto locationId = locationItem.locationId();
+            const auto locationRow = locationItem.row();
+
+            beginRemoveRows(QModelIndex{}, locationRow, locationRow);
+            mRootItem.removeChild(locationRow);
+            endRemoveRows();
+
+            mLocationItems.erase(locationId);
+            mPendingPriceItems.erase(locationId);
         }
     }
+
+    void AssetModel::forgetItem(TreeItem &item,
+                                std::unordered_set<TreeItem *> &removedItems,
+                                qint64 &quantity,
+                                double &volume,
+                                double &sellPrice)
+    {
+        quantity += item.data(quantityColumn).toUInt();
+        volume += item.data(totalVolumeColumn).toDouble();
+        sellPrice += item.data(totalPriceColumn).toDouble();
+
+        mItems.erase(item.id());
+        removedItems.emplace(&item);
+
+        const auto childCount = item.childCount();
+        for (auto i = 0; i < childCount; ++i)
+            forgetItem(*item.child(i), removedItems, quantity, volume, sellPrice);
+    }
+
+    AssetModel::TreeItem &AssetModel::getLocationItem(TreeItem &item) noexcept
+    {
+        auto locationItem = &item;
+        while (locationItem->parent() != nullptr && locationItem->parent() != &mRootItem)
+            locationItem = locationItem->parent();
+
+        return *locationItem;
+    }
+
+    void AssetModel::adjustLocationTotals(TreeItem &item, qint64 quantityDelta, double volumeDelta, double sellPriceDelta)
+    {
+        auto &locationItem = getLocationItem(item);
+
+        auto data = locationItem.data();
+        data[quantityColumn] = static_cast<uint>(data[quantityColumn].toUInt() + quantityDelta);
+        data[totalVolumeColumn] = data[totalVolumeColumn].toDouble() + volumeDelta;
+        data[totalPriceColumn] = data[totalPriceColumn].toDouble() + sellPriceDelta;
+        locationItem.setData(data);
+
+        const auto row = locationItem.row();
+        emit dataChanged(createIndex(row, quantityColumn, &locationItem), createIndex(row, totalPriceColumn, &locationItem));
+
+        mTotalAssets = static_cast<uint>(mTotalAssets + quantityDelta);
+        mTotalVolume += volumeDelta;
+        mTotalSellPrice += sellPriceDelta;
+    }
+
+    void AssetModel::startPriceCalculation(const std::unordered_map<LocationId, std::vector<TreeItem *>> &pendingPriceItems)
+    {
+        std::vector<LocationPriceRequest> requests;
+        requests.reserve(pendingPriceItems.size());
+
+        for (const auto &pending : pendingPriceItems)
+        {
+            if (pending.second.empty())
+                continue;
+
+            std::unordered_set<ItemData::TypeIdType> typeIds;
+            for (const auto item : pending.second)
+                typeIds.emplace(item->typeId());
+
+            LocationPriceRequest request;
+            request.mLocationId = pending.first;
+            request.mPriceLocationId = (mCustomStationId == 0) ? (pending.first) : (mCustomStationId);
+            request.mTypeIds.assign(std::begin(typeIds), std::end(typeIds));
+
+            requests.emplace_back(std::move(request));
+        }
+
+        if (requests.empty())
+            return;
+
+        // NOTE: using std::function because QtConcurrent::mapped cannot infer the result type properly
+        const auto &dataProvider = mDataProvider;
+        const std::function<LocationPrices (const LocationPriceRequest &)> fetchPrices = [&dataProvider](const auto &request) {
+            LocationPrices result;
+            result.mLocationId = request.mLocationId;
+
+            for (const auto typeId : request.mTypeIds)
+                result.mPrices.emplace(typeId, dataProvider.getTypeStationSellPrice(typeId, request.mPriceLocationId));
+
+            return result;
+        };
+
+        const auto generation = mGeneration;
+
+        // workers only use the requests and the data provider, which outlives the model, so a watcher can outlive its generation
+        const auto watcher = new QFutureWatcher<LocationPrices>{this};
+        connect(watcher, &QFutureWatcher<LocationPrices>::resultReadyAt, this, [=](int resultIndex) {
+            if (generation == mGeneration && !watcher->isCanceled())
+                applyPrices(watcher->resultAt(resultIndex));
+        });
+        connect(watcher, &QFutureWatcher<LocationPrices>::finished, this, [=] {
+            watcher->deleteLater();
+
+            const auto future = watcher->future();
+            mPriceCalculations.erase(std::remove(std::begin(mPriceCalculations), std::end(mPriceCalculations), future),
+                                     std::end(mPriceCalculations));
+        });
+
+        const auto calculation = QtConcurrent::mapped(requests, fetchPrices);
+        mPriceCalculations.emplace_back(calculation);
+
+        watcher->setFuture(calculation);
+    }
+
+    void AssetModel::cancelLoading()
+    {
+        ++mGeneration;
+
+        for (auto &calculation : mPriceCalculations)
+            calculation.cancel();
+
+        mPriceCalculations.clear();
+        mPendingAssets.clear();
+    }
+
+    bool AssetModel::isPricePending(const TreeItem &item)
+    {
+        return item.data(unitPriceColumn).isNull();
+    }
 }
@@ -15,11 +15,17 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <optional>
+#include <deque>
+#include <vector>
+#include <memory>
 
 #include <QAbstractItemModel>
+#include <QFuture>
 #include <QDateTime>
 
+#include "AssetListChanges.h"
 #include "Character.h"
 #include "Item.h"
 
@@ -27,6 +33,7 @@ namespace Evernus
 {
     class EveDataProvider;
     class AssetProvider;
+    class ExternalOrder;
     class AssetList;
 
     class AssetModel
@@ -42,7 +49,7 @@ namespace Evernus
                    const EveDataProvider &dataProvider,
                    bool showOwner,
                    QObject *parent = nullptr);
-        virtual ~AssetModel() = default;
+        virtual ~AssetModel();
 
         virtual int columnCount(const QModelIndex &parent = QModelIndex{}) const override;
         virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -59,6 +66,9 @@ namespace Evernus
 
         void reset();
 
+        // updates affected rows in place; returns false if the changes require a full reset
+        bool applyChanges(Character::IdType ownerId, const AssetListChanges &changes);
+
         uint getTotalAssets() const noexcept;
         double getTotalVolume() const noexcept;
         double getTotalSellPrice() const noexcept;
@@ -69,6 +79,11 @@ namespace Evernus
         CustomValueType getAssetCustomValue(const QModelIndex &index) const;
         Item::IdType getAssetId(const QModelIndex &index) const;
 
+    signals:
+        void totalsChanged();
+        // the last batch of locations from reset() has been added
+        void assetsLoaded();
+
     private slots:
         void updateNames();
 
@@ -80,6 +95,7 @@ namespace Evernus
             ~TreeItem() = default;
 
             void appendChild(std::unique_ptr<TreeItem> child);
+            void removeChild(int row);
             void clearChildren() noexcept;
 
             TreeItem *child(int row) const noexcept;
@@ -144,6 +160,22 @@ namespace Evernus
             numColumns
         };
 
+        struct LocationPriceRequest
+        {
+            LocationId mLocationId = LocationId{};
+            quint64 mPriceLocationId = 0;
+            std::vector<ItemData::TypeIdType> mTypeIds;
+        };
+
+        struct LocationPrices
+        {
+            LocationId mLocationId = LocationId{};
+            std::unordered_map<ItemData::TypeIdType, std::shared_ptr<ExternalOrder>> mPrices;
+        };
+
+        // tree items added per event loop pass, so large asset lists don't freeze the GUI
+        static const auto itemsPerLoadStep = 500;
+
         const AssetProvider &mAssetProvider;
         const EveDataProvider &mDataProvider;
 
@@ -158,10 +190,45 @@ namespace Evernus
         double mTotalSellPrice = 0.;
 
         std::unordered_map<LocationId, TreeItem *> mLocationItems;
-
-        void buildItemMap(const Item &item, TreeItem &treeItem, LocationId locationId, Character::IdType ownerId);
-
-        std::unique_ptr<TreeItem> createTreeItemForItem(const Item &item, LocationId locationId, Character::IdType ownerId);
-        void fillAssets(const std::shared_ptr<AssetList> &assets);
+        std::unordered_map<Item::IdType, TreeItem *> mItems;
+
+        // items waiting for the background price pass, per location
+        std::unordered_map<LocationId, std::vector<TreeItem *>> mPendingPriceItems;
+
+        // lists not yet added to the tree; the front one is partially added up to mNextAsset
+        std::deque<std::shared_ptr<AssetList>> mPendingAssets;
+        Item::ConstItemIterator mNextAsset;
+
+        // results from older generations are stale and get ignored, so nothing needs to wait for them
+        std::vector<QFuture<LocationPrices>> mPriceCalculations;
+        quint64 mGeneration = 0;
+
+        void buildItemMap(const Item &item,
+                          TreeItem &treeItem,
+                          LocationId locationId,
+                          Character::IdType ownerId,
+                          std::vector<TreeItem *> &pendingPriceItems);
+
+        std::unique_ptr<TreeItem> createTreeItemForItem(const Item &item,
+                                                        LocationId locationId,
+                                                        Character::IdType ownerId,
+                                                        std::vector<TreeItem *> &pendingPriceItems);
+        void loadAssets();
+
+        void removeItem(TreeItem &item);
+        void forgetItem(TreeItem &item,
+                        std::unordered_set<TreeItem *> &removedItems,
+                        qint64 &quantity,
+                        double &volume,
+                        double &sellPrice);
+
+        TreeItem &getLocationItem(TreeItem &item) noexcept;
+        void adjustLocationTotals(TreeItem &item, qint64 quantityDelta, double volumeDelta, double sellPriceDelta);
+
+        void startPriceCalculation(const std::unordered_map<LocationId, std::vector<TreeItem *>> &pendingPriceItems);
+        void applyPrices(const LocationPrices &prices);
+        void cancelLoading();
+
+        static bool isPricePending(const TreeItem &item);
     };
 }
@@ -115,6 +115,7 @@ namespace Evernus
 
         mInventoryModel.setCombineCharacters(combineBtn->isChecked());
         mInventoryModelProxy.setSourceModel(&mInventoryModel);
+        connect(&mInventoryModel, &AssetModel::totalsChanged, this, &AssetsWidget::setNewInfo);
 
         mAggregatedModel.setCombineCharacters(combineBtn->isChecked());
         mAggregatedModelProxy.setSourceModel(&mAggregatedModel);
@@ -134,6 +135,8 @@ namespace Evernus
                 this, &AssetsWidget::handleSelection);
         connect(expandAll, &QPushButton::clicked, mAssetView, &StyledTreeView::expandAll);
         connect(collapseAll, &QPushButton::clicked, mAssetView, &StyledTreeView::collapseAll);
+        // locations added after reset() returned are collapsed otherwise
+        connect(&mInventoryModel, &AssetModel::assetsLoaded, mAssetView, &StyledTreeView::expandAll);
 
         mSetDestinationAct = new QAction{tr("Set destination in EVE"), this};
         mSetDestinationAct->setEnabled(false);
@@ -215,6 +218,23 @@ namespace Evernus
         setNewInfo();
     }
 
+    void AssetsWidget::applyChanges(Character::IdType id, const AssetListChanges &changes)
+    {
+        if (!mInventoryModel.applyChanges(id, changes))
+        {
+            updateData();
+            return;
+        }
+
+        refreshImportTimer();
+
+        if (!changes.isEmpty())
+        {
+            mAggregatedModel.reset();
+            setNewInfo();
+        }
+    }
+
     void AssetsWidget::prepareItemImportFromWeb()
     {
         emit importPricesFromWeb(getCharacterId(), getImportTarget());
@@ -60,6 +60,7 @@ namespace Evernus
 
     public slots:
         void updateData();
+        void applyChanges(Character::IdType id, const AssetListChanges &changes);
 
     private slots:
         void prepareItemImportFromWeb();
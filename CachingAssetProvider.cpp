@@ -12,7 +12,7 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <functional>
+#include <algorithm>
 
 #include "CharacterRepository.h"
 #include "ItemRepository.h"
@@ -96,28 +96,15 @@ namespace Evernus
 
     Item *CachingAssetProvider::findItem(Item::IdType id) const
     {
-        const std::function<Item *(Item &)> lookForItem = [&](Item &item) -> Item * {
-            if (item.getId() == id)
-                return &item;
-
-            for (const auto &child : item)
-            {
-                const auto item = lookForItem(*child);
-                if (item != nullptr)
-                    return item;
-            }
-
-            return nullptr;
-        };
-
         for (const auto &assets : mAssets)
         {
-            for (const auto &item : *assets.second)
-            {
-                const auto found = lookForItem(*item);
-                if (found != nullptr)
-                    return found;
-            }
+            auto &items = assets.second->getAllItems();
+            const auto item = std::find_if(std::begin(items), std::end(items), [=](const auto &item) {
+                return item.getId() == id;
+            });
+
+            if (item != std::end(items))
+                return &*item;
         }
 
         return nullptr;
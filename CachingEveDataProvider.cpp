@@ -12,8 +12,6 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <queue>
-
 #include <QtDebug>
 
 #include <QStandardPaths>
@@ -26,6 +24,7 @@
 
 #include "DatabaseConnectionProvider.h"
 #include "EveDataManagerProvider.h"
+#include "GenericNameRepository.h"
 #include "MarketOrderRepository.h"
 #include "UISettings.h"
 
@@ -67,6 +66,7 @@ namespace Evernus
                                                    const MarketOrderRepository &corpMarketOrderRepository,
                                                    const MarketGroupRepository &marketGroupRepository,
                                                    const CitadelRepository &citadelRepository,
+                                                   const GenericNameRepository &genericNameRepository,
                                                    const EveDataManagerProvider &dataManagerProvider,
                                                    const DatabaseConnectionProvider &connectionProvider,
                                                    QObject *parent)
@@ -78,14 +78,20 @@ namespace Evernus
         , mCorpMarketOrderRepository{corpMarketOrderRepository}
         , mMarketGroupRepository{marketGroupRepository}
         , mCitadelRepository{citadelRepository}
+        , mGenericNameRepository{genericNameRepository}
         , mDataManagerProvider{dataManagerProvider}
         , mConnectionProvider{connectionProvider}
     {
-        readCache(nameCacheFileName, mGenericNameCache);
+        importLegacyNameCache();
         findManufaturingActivity();
         handleNewPreferences();
 
+        // gather ids requested by a single view refresh into one batch
+        mGenericNameRequestTimer.setSingleShot(true);
+        mGenericNameRequestTimer.setInterval(100);
+
         connect(this, &CachingEveDataProvider::genericNameRequested, this, &CachingEveDataProvider::fetchGenericName);
+        connect(&mGenericNameRequestTimer, &QTimer::timeout, this, &CachingEveDataProvider::fetchQueuedGenericNames);
     }
 
     CachingEveDataProvider::~CachingEveDataProvider()
@@ -95,7 +101,6 @@ namespace Evernus
             const auto dataCacheDir = getCacheDir();
             if (dataCacheDir.mkpath(QStringLiteral(".")))
             {
-                cacheWrite(nameCacheFileName, mGenericNameCache);
                 cacheWrite(systemDistanceCacheFileName, mSystemDistances);
                 cacheWrite(raceCacheFileName, mRaceNameCache);
                 cacheWrite(bloodlineCacheFileName, mBloodlineNameCache);
@@ -191,8 +196,13 @@ namespace Evernus
         if (mGenericNameCache.contains(id))
             return mGenericNameCache[id];
 
-        if (mPendingNameRequests.find(id) == std::end(mPendingNameRequests))
+        if (mQueuedNameRequests.find(id) == std::end(mQueuedNameRequests) &&
+            mPendingNameRequests.find(id) == std::end(mPendingNameRequests))
         {
+            if (loadGenericName(id))
+                return mGenericNameCache[id];
+
+            mQueuedNameRequests.emplace(id);
             emit genericNameRequested(id);
         }
 
@@ -205,7 +215,17 @@ namespace Evernus
             return true;
 
         std::lock_guard<std::recursive_mutex> lock{mGenericNameCacheMutex};
-        return mGenericNameCache.contains(id);
+
+        if (mGenericNameCache.contains(id))
+            return true;
+
+        if (mQueuedNameRequests.find(id) != std::end(mQueuedNameRequests) ||
+            mPendingNameRequests.find(id) != std::end(mPendingNameRequests))
+        {
+            return false;
+        }
+
+        return loadGenericName(id);
     }
 
     double CachingEveDataProvider::getTypeVolume(EveType::IdType id) const
@@ -936,26 +956,90 @@ SELECT m.typeID, m.materialTypeID, m.quantity, t.portionSize, t.groupID FROM inv
 
     void CachingEveDataProvider::fetchGenericName(quint64 id)
     {
-        qDebug() << "Fetching generic name:" << id;
-
-        // potential recursive lock if sync invokation
-        std::lock_guard<std::recursive_mutex> lock{mGenericNameCacheMutex};
+        Q_UNUSED(id);
 
-        mPendingNameRequests.emplace(id);
+        // the id is already queued - just make sure the batch goes out
+        if (!mGenericNameRequestTimer.isActive())
+            mGenericNameRequestTimer.start();
+    }
 
-        mDataManagerProvider.getESIManager().fetchGenericName(id, [=](auto &&data, const auto &error) {
-            qDebug() << "Got generic name:" << id << data << " (" << error << ")";
+    void CachingEveDataProvider::fetchQueuedGenericNames()
+    {
+        std::vector<quint64> ids;
 
+        {
             std::lock_guard<std::recursive_mutex> lock{mGenericNameCacheMutex};
 
-            mPendingNameRequests.erase(id);
+            ids.assign(std::begin(mQueuedNameRequests), std::end(mQueuedNameRequests));
+            mPendingNameRequests.insert(std::begin(mQueuedNameRequests), std::end(mQueuedNameRequests));
+            mQueuedNameRequests.clear();
+        }
 
-            if (error.isEmpty())
-                mGenericNameCache[id] = std::move(data);
-            else
-                mGenericNameCache[id] = tr("(unknown)");
+        if (ids.empty())
+            return;
+
+        qDebug() << "Fetching generic names:" << ids.size();
+
+        fetchGenericNameBatch(std::move(ids));
+    }
 
-            if (mPendingNameRequests.empty())
+    void CachingEveDataProvider::fetchGenericNameBatch(std::vector<quint64> ids)
+    {
+        mDataManagerProvider.getESIManager().fetchGenericNames(ids, [=](auto &&data, const auto &error) {
+            if (!error.isEmpty())
+            {
+                qWarning() << "Error fetching generic names:" << error << "(" << ids.size() << "ids)";
+
+                // a single unresolvable id fails the whole batch, so bisect to isolate it and only ask one by one
+                // for the last few ids
+                const auto maxSingleFetches = 4u;
+
+                if (ids.size() <= maxSingleFetches)
+                {
+                    for (const auto id : ids)
+                        fetchSingleGenericName(id);
+                }
+                else
+                {
+                    const auto middle = std::next(std::begin(ids), ids.size() / 2);
+
+                    fetchGenericNameBatch(std::vector<quint64>(std::begin(ids), middle));
+                    fetchGenericNameBatch(std::vector<quint64>(middle, std::end(ids)));
+                }
+
+                return;
+            }
+
+            std::vector<GenericName> names;
+            names.reserve(data.size());
+
+            auto allResolved = false;
+
+            {
+                std::lock_guard<std::recursive_mutex> lock{mGenericNameCacheMutex};
+
+                for (const auto id : ids)
+                {
+                    mPendingNameRequests.erase(id);
+
+                    const auto name = data.find(id);
+                    if (name == std::end(data))
+                    {
+                        mGenericNameCache[id] = tr("(unknown)");
+                    }
+                    else
+                    {
+                        mGenericNameCache[id] = name->second;
+                        names.emplace_back(id, name->second);
+                    }
+                }
+
+                allResolved = mPendingNameRequests.empty();
+            }
+
+            mGenericNameRepository.batchStore(names, true);
+
+            if (allResolved)
                 emit namesChanged();
         });
     }
@@ -1063,7 +1147,7 @@ SELECT m.typeID, m.materialTypeID, m.quantity, t.portionSize, t.groupID FROM inv
             return it.value();
 
         const auto makeUnreachable = [=] {
-            const auto value = std::numeric_limits<uint>::max();
+            const auto value = RouteUtils::unreachableDistance;
             mSystemDistances[key] = value;
             mSystemDistances[qMakePair(endSystem, startSystem)] = value;
 
@@ -1078,40 +1162,12 @@ SELECT m.typeID, m.materialTypeID, m.quantity, t.portionSize, t.groupID FROM inv
         if (jIt == std::end(mSystemJumpMap))
             return makeUnreachable();
 
-        const auto &jumpMap = jIt->second;
-
-        std::unordered_set<uint> visited;
-        std::queue<std::pair<uint, uint>> candidates;
-
-        visited.emplace(startSystem);
-        candidates.emplace(std::make_pair(startSystem, 0u));
+        const auto distance = RouteUtils::getJumpDistance(jIt->second, startSystem, endSystem);
 
-        while (!candidates.empty())
-        {
-            const auto current = candidates.front();
-            candidates.pop();
-
-            const auto depth = current.second;
-            if (current.first == endSystem)
-            {
-                mSystemDistances[key] = depth;
-                mSystemDistances[qMakePair(endSystem, startSystem)] = depth;
+        mSystemDistances[key] = distance;
+        mSystemDistances[qMakePair(endSystem, startSystem)] = distance;
 
-                return depth;
-            }
-
-            const auto children = jumpMap.equal_range(current.first);
-            for (auto it = children.first; it != children.second; ++it)
-            {
-                if (visited.find(it->second) == std::end(visited))
-                {
-                    visited.emplace(it->second);
-                    candidates.emplace(std::make_pair(it->second, depth + 1));
-                }
-            }
-        }
-
-        return makeUnreachable();
+        return distance;
     }
 
     QString CachingEveDataProvider::getRaceName(uint raceId) const
@@ -1347,6 +1403,76 @@ SELECT m.materialTypeID, m.quantity, p.quantity, a.time, s.skillID FROM industry
             qWarning() << "Manufacturing activity id not found - assuming:" << mManufacturingActivityId;
     }
 
+    bool CachingEveDataProvider::loadGenericName(quint64 id) const
+    {
+        try
+        {
+            const auto name = mGenericNameRepository.find(id);
+            mGenericNameCache[id] = std::move(*name).getName();
+
+            return true;
+        }
+        catch (const GenericNameRepository::NotFoundException &)
+        {
+            return false;
+        }
+    }
+
+    void CachingEveDataProvider::fetchSingleGenericName(quint64 id)
+    {
+        qDebug() << "Fetching generic name:" << id;
+
+        mDataManagerProvider.getESIManager().fetchGenericName(id, [=](auto &&data, const auto &error) {
+            qDebug() << "Got generic name:" << id << data << " (" << error << ")";
+
+            auto allResolved = false;
+
+            {
+                std::lock_guard<std::recursive_mutex> lock{mGenericNameCacheMutex};
+
+                mPendingNameRequests.erase(id);
+
+                if (error.isEmpty())
+                    mGenericNameCache[id] = data;
+                else
+                    mGenericNameCache[id] = tr("(unknown)");
+
+                allResolved = mPendingNameRequests.empty();
+            }
+
+            if (error.isEmpty())
+                mGenericNameRepository.batchStore(std::vector<GenericName>{GenericName{id, std::move(data)}}, true);
+
+            if (allResolved)
+                emit namesChanged();
+        });
+    }
+
+    void CachingEveDataProvider::importLegacyNameCache()
+    {
+        // names used to be kept in a flat cache file, read and written as a whole
+        QFile legacyCache{getCacheDir().filePath(nameCacheFileName)};
+        if (!legacyCache.exists())
+            return;
+
+        NameMap legacyNames;
+        readCache(nameCacheFileName, legacyNames);
+
+        const auto unknownName = tr("(unknown)");
+
+        std::vector<GenericName> names;
+        names.reserve(legacyNames.size());
+
+        for (auto it = std::begin(legacyNames); it != std::end(legacyNames); ++it)
+        {
+            if (it.value() != unknownName)
+                names.emplace_back(it.key(), it.value());
+        }
+
+        mGenericNameRepository.batchStore(names, true);
+        legacyCache.remove();
+    }
+
     void CachingEveDataProvider::readCache(const QString &cacheFileName, NameMap &cache)
     {
         QFile cacheFile{getCacheDir().filePath(cacheFileName)};
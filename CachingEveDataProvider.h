@@ -15,9 +15,11 @@
 #pragma once
 
 #include <unordered_set>
+#include <vector>
 #include <mutex>
 
 #include <QStringList>
+#include <QTimer>
 #include <QHash>
 
 #include <boost/functional/hash.hpp>
@@ -27,6 +29,7 @@
 #include "MetaGroupRepository.h"
 #include "EveTypeRepository.h"
 #include "EveDataProvider.h"
+#include "RouteUtils.h"
 #include "ESIManager.h"
 #include "Citadel.h"
 
@@ -36,6 +39,7 @@ namespace Evernus
 {
     class DatabaseConnectionProvider;
     class EveDataManagerProvider;
+    class GenericNameRepository;
     class MarketOrderRepository;
 
     class CachingEveDataProvider
@@ -53,6 +57,7 @@ namespace Evernus
                                const MarketOrderRepository &corpMarketOrderRepository,
                                const MarketGroupRepository &marketGroupRepository,
                                const CitadelRepository &citadelRepository,
+                               const GenericNameRepository &genericNameRepository,
                                const EveDataManagerProvider &dataManagerProvider,
                                const DatabaseConnectionProvider &connectionProvider,
                                QObject *parent = nullptr);
@@ -133,6 +138,7 @@ namespace Evernus
 
     private slots:
         void fetchGenericName(quint64 id);
+        void fetchQueuedGenericNames();
 
     private:
         using TypeLocationPair = std::pair<EveType::IdType, quint64>;
@@ -153,6 +159,7 @@ namespace Evernus
         const MarketOrderRepository &mMarketOrderRepository, &mCorpMarketOrderRepository;
         const MarketGroupRepository &mMarketGroupRepository;
         const CitadelRepository &mCitadelRepository;
+        const GenericNameRepository &mGenericNameRepository;
 
         const EveDataManagerProvider &mDataManagerProvider;
 
@@ -180,9 +187,11 @@ namespace Evernus
         mutable std::unordered_map<EveType::IdType, MarketGroupRepository::EntityPtr> mTypeMarketGroupCache;
 
         mutable NameMap mGenericNameCache;
+        mutable std::unordered_set<quint64> mQueuedNameRequests;
         mutable std::unordered_set<quint64> mPendingNameRequests;
+        QTimer mGenericNameRequestTimer;
 
-        std::unordered_map<uint, std::unordered_multimap<uint, uint>> mSystemJumpMap;
+        std::unordered_map<uint, RouteUtils::JumpMap> mSystemJumpMap;
 
         mutable std::unordered_map<uint, uint> mSolarSystemRegionCache;
         mutable std::unordered_map<uint, uint> mSolarSystemConstellationCache;
@@ -231,6 +240,11 @@ namespace Evernus
 
         EveTypeRepository::EntityPtr getEveType(EveType::IdType id) const;
 
+        bool loadGenericName(quint64 id) const;
+        void fetchGenericNameBatch(std::vector<quint64> ids);
+        void fetchSingleGenericName(quint64 id);
+        void importLegacyNameCache();
+
         MarketGroupRepository::EntityPtr getMarketGroupParent(MarketGroup::IdType id) const;
         MarketGroupRepository::EntityPtr getMarketGroup(MarketGroup::IdType id) const;
 
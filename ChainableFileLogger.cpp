@@ -28,6 +28,7 @@ namespace Evernus
 {
     ChainableFileLogger *ChainableFileLogger::instance = nullptr;
 
+    const std::chrono::milliseconds ChainableFileLogger::flushInterval{50};
     const QString ChainableFileLogger::fileNameBase = "main.log";
 
     ChainableFileLogger::ChainableFileLogger(std::size_t maxLogSize, uint maxLogFiles)
@@ -38,14 +39,34 @@ namespace Evernus
         QDir{}.mkpath(getLogDir());
 
         if (!openLog())
+        {
             qWarning() << "Error opening main.log file at:" << getLogDir();
+        }
         else
+        {
+            mQueue = std::make_unique<LogEntry[]>(queueSize);
+            for (auto i = 0u; i < queueSize; ++i)
+                mQueue[i].mSequence.store(i, std::memory_order_relaxed);
+
+            mWriterThread = std::thread{&ChainableFileLogger::processQueue, this};
             mPrevHandler = qInstallMessageHandler(&ChainableFileLogger::handleMessage);
+        }
     }
 
     ChainableFileLogger::~ChainableFileLogger()
     {
         qInstallMessageHandler(mPrevHandler);
+
+        if (mWriterThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock{mWriterMutex};
+                mStopping = true;
+            }
+
+            mWriterCondition.notify_one();
+            mWriterThread.join();
+        }
     }
 
     void ChainableFileLogger::initialize(std::size_t maxLogSize, uint maxLogFiles)
@@ -61,13 +82,117 @@ namespace Evernus
         if (mPrevHandler != nullptr)
             mPrevHandler(type, context, msg);
 
-        const auto log = qFormatLogMessage(type, context, msg);
-        if (Q_LIKELY(!log.isEmpty()))
+        // format here, since the pattern refers to the calling thread
+        auto log = qFormatLogMessage(type, context, msg);
+        if (Q_UNLIKELY(log.isEmpty()))
+            return;
+
+        if (Q_UNLIKELY(!enqueue(std::move(log))))
+        {
+            // never lose warnings and errors, unless it's the writer itself which would wait forever
+            if (type == QtDebugMsg || type == QtInfoMsg || std::this_thread::get_id() == mWriterThread.get_id())
+            {
+                ++mDroppedMessages;
+                return;
+            }
+
+            // enqueue() leaves the message alone on failure
+            while (!enqueue(std::move(log)))
+                std::this_thread::yield();
+        }
+
+        // the application is going down after this one
+        if (Q_UNLIKELY(type == QtFatalMsg))
+            flush();
+    }
+
+    bool ChainableFileLogger::enqueue(QString &&msg)
+    {
+        auto pos = mEnqueuePos.load(std::memory_order_relaxed);
+        forever
+        {
+            auto &entry = mQueue[pos & (queueSize - 1)];
+
+            const auto sequence = entry.mSequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    entry.mMessage = std::move(msg);
+                    entry.mSequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void ChainableFileLogger::flush()
+    {
+        if (std::this_thread::get_id() == mWriterThread.get_id())
+            return;
+
+        std::unique_lock<std::mutex> lock{mWriterMutex};
+        mFlushRequested = true;
+        mWriterCondition.notify_one();
+        mFlushCondition.wait(lock, [=] {
+            return !mFlushRequested;
+        });
+    }
+
+    void ChainableFileLogger::processQueue()
+    {
+        std::unique_lock<std::mutex> lock{mWriterMutex};
+        forever
         {
-            std::lock_guard<std::mutex> lock{mStreamMutex};
+            const auto flushRequested = mFlushRequested;
+            const auto stopping = mStopping;
+
+            lock.unlock();
+            writeQueuedMessages();
+            lock.lock();
+
+            if (flushRequested)
+            {
+                mFlushRequested = false;
+                mFlushCondition.notify_all();
+            }
+
+            if (stopping)
+                break;
+
+            mWriterCondition.wait_for(lock, flushInterval, [=] {
+                return mStopping || mFlushRequested;
+            });
+        }
+    }
+
+    void ChainableFileLogger::writeQueuedMessages()
+    {
+        auto written = false;
+
+        forever
+        {
+            auto &entry = mQueue[mDequeuePos & (queueSize - 1)];
+            if (entry.mSequence.load(std::memory_order_acquire) != mDequeuePos + 1)
+                break;
+
+            const auto log = std::move(entry.mMessage);
+            entry.mSequence.store(mDequeuePos + queueSize, std::memory_order_release);
+            ++mDequeuePos;
 
             if (Q_UNLIKELY(mCurrentLogCheckCount == 0))
             {
+                mStream.flush();
                 if (Q_UNLIKELY(static_cast<std::size_t>(mLogFile.size()) > mMaxLogSize))
                     rotateLogs();
 
@@ -79,8 +204,19 @@ namespace Evernus
             }
 
             mStream << log << '\n';
-            mStream.flush();
+            written = true;
         }
+
+        const auto dropped = mDroppedMessages.exchange(0);
+        if (Q_UNLIKELY(dropped > 0))
+        {
+            mStream << QStringLiteral("[warning] Log queue full, dropped %1 messages").arg(dropped) << '\n';
+            written = true;
+        }
+
+        // one flush per batch instead of one per message
+        if (written)
+            mStream.flush();
     }
 
     void ChainableFileLogger::rotateLogs()
@@ -14,6 +14,11 @@
  */
 #pragma once
 
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <atomic>
+#include <thread>
 #include <mutex>
 
 #include <QTextStream>
@@ -33,9 +38,18 @@ namespace Evernus
         static void initialize(std::size_t maxLogSize, uint maxLogFiles);
 
     private:
+        // slot in the bounded multi-producer queue; sequence tells whether it's free or ready to be written
+        struct LogEntry
+        {
+            std::atomic_size_t mSequence;
+            QString mMessage;
+        };
+
         static ChainableFileLogger *instance;
 
         static const uint logCheckCount = 100;
+        static const std::size_t queueSize = 16384;  // must be a power of 2
+        static const std::chrono::milliseconds flushInterval;
         static const QString fileNameBase;
 
         std::size_t mMaxLogSize = 10 * 1024 * 1024;
@@ -48,12 +62,27 @@ namespace Evernus
         uint mCurrentLogCheckCount = 0;
         uint mRotationCount = 0;    // keep current log chain from being removed
 
-        std::mutex mStreamMutex;
+        std::unique_ptr<LogEntry[]> mQueue;
+        std::atomic_size_t mEnqueuePos{0};
+        std::size_t mDequeuePos = 0;
+        std::atomic_size_t mDroppedMessages{0};
+
+        std::thread mWriterThread;
+        std::mutex mWriterMutex;
+        std::condition_variable mWriterCondition;
+        std::condition_variable mFlushCondition;
+        bool mStopping = false;
+        bool mFlushRequested = false;
 
         ChainableFileLogger(std::size_t maxLogSize, uint maxLogFiles);
         ~ChainableFileLogger();
 
         void writeMessage(QtMsgType type, const QMessageLogContext &context, const QString &msg);
+        bool enqueue(QString &&msg);
+        void flush();
+
+        void processQueue();
+        void writeQueuedMessages();
         void rotateLogs();
 
         bool openLog();
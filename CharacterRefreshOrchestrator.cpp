@@ -0,0 +1,414 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <QSettings>
+#include <QtDebug>
+#include <QTimer>
+
+#include "EvernusApplication.h"
+#include "ImportSettings.h"
+#include "PriceSettings.h"
+
+#include "CharacterRefreshOrchestrator.h"
+
+namespace Evernus
+{
+    CharacterRefreshOrchestrator::CharacterRefreshOrchestrator(EvernusApplication &app, QObject *parent)
+        : QObject{parent}
+        , mApp{app}
+    {
+        connect(&mApp, QOverload<uint, uint, const QString &>::of(&EvernusApplication::taskStarted),
+                this, &CharacterRefreshOrchestrator::startTrackedTask);
+        connect(&mApp, &EvernusApplication::taskEnded,
+                this, &CharacterRefreshOrchestrator::endTrackedTask);
+    }
+
+    void CharacterRefreshOrchestrator::refresh(const Plan &plan)
+    {
+        for (const auto &character : plan)
+        {
+            const auto id = character.first;
+            const auto &steps = character.second;
+
+            if (steps.empty())
+                continue;
+
+            if (mCharacters.find(id) != std::end(mCharacters))
+            {
+                // the running steps might be the last ones holding the character task, so start anew when they're done
+                auto &deferred = mDeferredPlan[id];
+                deferred.insert(std::end(deferred), std::begin(steps), std::end(steps));
+                continue;
+            }
+
+            auto &state = mCharacters[id];
+            state.mTask = mApp.startTask(tr("Refreshing character %1...").arg(id));
+            // steps waiting for their dependencies have no task yet, so this keeps the parent task from ending too soon
+            state.mGuardTask = mApp.startTask(state.mTask, tr("Waiting for dependencies..."));
+            state.mPendingSteps.insert(std::begin(steps), std::end(steps));
+
+            mCharacterTasks[state.mTask] = id;
+
+            scheduleReadySteps(id, state);
+        }
+
+        launchReadySteps();
+    }
+
+    bool CharacterRefreshOrchestrator::isRefreshing() const noexcept
+    {
+        return !mCharacters.empty();
+    }
+
+    std::vector<CharacterRefreshOrchestrator::Step> CharacterRefreshOrchestrator::getConfiguredSteps()
+    {
+        QSettings settings;
+
+        const auto corp = settings.value(ImportSettings::updateCorpDataKey).toBool();
+
+        std::vector<Step> steps{Step::Character};
+
+        const auto addSteps = [&](auto characterStep, auto corpStep) {
+            if (corp)
+                steps.emplace_back(corpStep);
+
+            steps.emplace_back(characterStep);
+        };
+
+        addSteps(Step::WalletJournal, Step::CorpWalletJournal);
+
+        const auto marketOrderSource = static_cast<ImportSettings::MarketOrderImportSource>(
+            settings.value(ImportSettings::marketOrderImportSourceKey, static_cast<int>(ImportSettings::marketOrderImportSourceDefault)).toInt());
+        if (marketOrderSource == ImportSettings::MarketOrderImportSource::Logs)
+            addSteps(Step::MarketOrdersFromLogs, Step::CorpMarketOrdersFromLogs);
+        else
+            addSteps(Step::MarketOrdersFromAPI, Step::CorpMarketOrdersFromAPI);
+
+        if (!settings.value(PriceSettings::autoAddCustomItemCostKey, PriceSettings::autoAddCustomItemCostDefault).toBool())
+            addSteps(Step::WalletTransactions, Step::CorpWalletTransactions);
+
+        if (settings.value(ImportSettings::importAssetsKey, ImportSettings::importAssetsDefault).toBool())
+            addSteps(Step::Assets, Step::CorpAssets);
+        if (settings.value(ImportSettings::importContractsKey, ImportSettings::importContractsDefault).toBool())
+            addSteps(Step::Contracts, Step::CorpContracts);
+        if (settings.value(ImportSettings::importMiningLedgerKey, ImportSettings::importMiningLedgerDefault).toBool())
+            steps.emplace_back(Step::MiningLedger);
+
+        return steps;
+    }
+
+    void CharacterRefreshOrchestrator::startTrackedTask(uint taskId, uint parentTask)
+    {
+        const auto character = mCharacterTasks.find(parentTask);
+        if (character != std::end(mCharacterTasks))
+        {
+            const auto state = mCharacters.find(character->second);
+            Q_ASSERT(state != std::end(mCharacters));
+
+            if (taskId == state->second.mGuardTask)
+                return;
+
+            // steps start their tasks in the order they were launched
+            Q_ASSERT(!state->second.mLaunchedSteps.empty());
+
+            TrackedTask task;
+            task.mKey = StepKey{character->second, state->second.mLaunchedSteps.front()};
+
+            state->second.mLaunchedSteps.pop_front();
+            --mUnstartedSteps;
+
+            mTrackedTasks.emplace(taskId, task);
+        }
+        else
+        {
+            const auto parent = mTrackedTasks.find(parentTask);
+            if (parent == std::end(mTrackedTasks))
+                return;
+
+            ++parent->second.mChildren;
+
+            TrackedTask task;
+            task.mKey = parent->second.mKey;
+            task.mParentTask = parentTask;
+
+            mTrackedTasks.emplace(taskId, task);
+        }
+
+        if (mEarlyEndedTasks.erase(taskId) != 0)
+            endTrackedTask(taskId);
+    }
+
+    void CharacterRefreshOrchestrator::endTrackedTask(uint taskId)
+    {
+        const auto task = mTrackedTasks.find(taskId);
+        if (task == std::end(mTrackedTasks))
+        {
+            // start notifications are always queued, but some imports emit taskEnded directly instead of calling
+            // endTask() - e.g. market orders from logs, or errors reported before any request is made - so the end
+            // can arrive first
+            if (mUnstartedSteps != 0)
+                mEarlyEndedTasks.emplace(taskId);
+
+            return;
+        }
+
+        task->second.mEnded = true;
+        if (task->second.mChildren == 0)
+            completeTrackedTask(taskId);
+    }
+
+    void CharacterRefreshOrchestrator::scheduleReadySteps(Character::IdType id, CharacterState &state)
+    {
+        for (auto step = std::begin(state.mPendingSteps); step != std::end(state.mPendingSteps);)
+        {
+            const auto dependencies = getDependencies(*step);
+            const auto ready = std::none_of(std::begin(dependencies), std::end(dependencies), [&](auto dependency) {
+                return state.mPendingSteps.count(dependency) != 0 || state.mActiveSteps.count(dependency) != 0;
+            });
+
+            if (ready)
+            {
+                state.mActiveSteps.emplace(*step);
+                ++state.mQueuedSteps;
+
+                mReadySteps.emplace_back(StepKey{id, *step});
+
+                step = state.mPendingSteps.erase(step);
+            }
+            else
+            {
+                ++step;
+            }
+        }
+    }
+
+    void CharacterRefreshOrchestrator::launchReadySteps()
+    {
+        if (mLaunching)
+            return;
+
+        mLaunching = true;
+
+        while (mRunningSteps < maxRunningSteps && !mReadySteps.empty())
+        {
+            const auto key = mReadySteps.front();
+            mReadySteps.pop_front();
+
+            const auto state = mCharacters.find(key.mCharacterId);
+            Q_ASSERT(state != std::end(mCharacters));
+
+            --state->second.mQueuedSteps;
+            state->second.mLaunchedSteps.emplace_back(key.mStep);
+
+            ++mRunningSteps;
+            ++mUnstartedSteps;
+
+            const auto launch = mNextLaunch++;
+            state->second.mStepLaunches[key.mStep] = launch;
+
+            QTimer::singleShot(stepTimeout, this, [=] {
+                timeOutStep(key, launch);
+            });
+
+            launchStep(key, state->second.mTask);
+            releaseGuardTask(state->second);
+        }
+
+        mLaunching = false;
+    }
+
+    void CharacterRefreshOrchestrator::launchStep(const StepKey &key, uint parentTask)
+    {
+        const auto id = key.mCharacterId;
+
+        switch (key.mStep) {
+        case Step::Character:
+            mApp.refreshCharacter(id, parentTask);
+            break;
+        case Step::Assets:
+            mApp.refreshCharacterAssets(id, parentTask);
+            break;
+        case Step::Contracts:
+            mApp.refreshCharacterContracts(id, parentTask);
+            break;
+        case Step::WalletJournal:
+            mApp.refreshCharacterWalletJournal(id, parentTask);
+            break;
+        case Step::WalletTransactions:
+            mApp.refreshCharacterWalletTransactions(id, parentTask);
+            break;
+        case Step::MarketOrdersFromAPI:
+            mApp.refreshCharacterMarketOrdersFromAPI(id, parentTask);
+            break;
+        case Step::MarketOrdersFromLogs:
+            mApp.refreshCharacterMarketOrdersFromLogs(id, parentTask);
+            break;
+        case Step::MiningLedger:
+            mApp.refreshCharacterMiningLedger(id, parentTask);
+            break;
+        case Step::CorpAssets:
+            mApp.refreshCorpAssets(id, parentTask);
+            break;
+        case Step::CorpContracts:
+            mApp.refreshCorpContracts(id, parentTask);
+            break;
+        case Step::CorpWalletJournal:
+            mApp.refreshCorpWalletJournal(id, parentTask);
+            break;
+        case Step::CorpWalletTransactions:
+            mApp.refreshCorpWalletTransactions(id, parentTask);
+            break;
+        case Step::CorpMarketOrdersFromAPI:
+            mApp.refreshCorpMarketOrdersFromAPI(id, parentTask);
+            break;
+        case Step::CorpMarketOrdersFromLogs:
+            mApp.refreshCorpMarketOrdersFromLogs(id, parentTask);
+        }
+    }
+
+    void CharacterRefreshOrchestrator::releaseGuardTask(CharacterState &state)
+    {
+        if (state.mGuardReleased || !state.mPendingSteps.empty() || state.mQueuedSteps != 0)
+            return;
+
+        // ending is queued, so it comes after the start of the last launched step
+        mApp.endTask(state.mGuardTask);
+        state.mGuardReleased = true;
+    }
+
+    void CharacterRefreshOrchestrator::completeTrackedTask(uint taskId)
+    {
+        const auto task = mTrackedTasks.find(taskId);
+        Q_ASSERT(task != std::end(mTrackedTasks));
+
+        const auto key = task->second.mKey;
+        const auto parentTask = task->second.mParentTask;
+
+        mTrackedTasks.erase(task);
+
+        if (parentTask == TaskConstants::invalidTask)
+        {
+            finishStep(key);
+            return;
+        }
+
+        // same as the task list - a parent task ends with its last subtask
+        const auto parent = mTrackedTasks.find(parentTask);
+        if (parent != std::end(mTrackedTasks) && --parent->second.mChildren == 0)
+            completeTrackedTask(parentTask);
+    }
+
+    void CharacterRefreshOrchestrator::finishStep(const StepKey &key)
+    {
+        Q_ASSERT(mRunningSteps > 0);
+        --mRunningSteps;
+
+        const auto character = mCharacters.find(key.mCharacterId);
+        Q_ASSERT(character != std::end(mCharacters));
+
+        auto &state = character->second;
+        state.mActiveSteps.erase(key.mStep);
+        state.mStepLaunches.erase(key.mStep);
+
+        scheduleReadySteps(key.mCharacterId, state);
+
+        if (state.mPendingSteps.empty() && state.mActiveSteps.empty())
+        {
+            mCharacterTasks.erase(state.mTask);
+            mCharacters.erase(character);
+
+            const auto deferred = mDeferredPlan.find(key.mCharacterId);
+            if (deferred != std::end(mDeferredPlan))
+            {
+                Plan plan;
+                plan.emplace(key.mCharacterId, std::move(deferred->second));
+
+                mDeferredPlan.erase(deferred);
+
+                refresh(plan);
+            }
+        }
+
+        launchReadySteps();
+
+        if (mCharacters.empty())
+        {
+            mEarlyEndedTasks.clear();
+            emit refreshFinished();
+        }
+    }
+
+    void CharacterRefreshOrchestrator::timeOutStep(const StepKey &key, quint64 launch)
+    {
+        const auto character = mCharacters.find(key.mCharacterId);
+        if (character == std::end(mCharacters))
+            return;
+
+        auto &state = character->second;
+
+        const auto stepLaunch = state.mStepLaunches.find(key.mStep);
+        if (stepLaunch == std::end(state.mStepLaunches) || stepLaunch->second != launch)
+            return;
+
+        qWarning() << "Refresh step" << static_cast<int>(key.mStep) << "timed out for character" << key.mCharacterId;
+
+        const auto unstarted = std::find(std::begin(state.mLaunchedSteps), std::end(state.mLaunchedSteps), key.mStep);
+        if (unstarted != std::end(state.mLaunchedSteps))
+        {
+            state.mLaunchedSteps.erase(unstarted);
+            --mUnstartedSteps;
+        }
+
+        // forget the step tasks first, so their queued ends don't finish the step twice
+        std::vector<uint> pendingTasks;
+        for (auto task = std::begin(mTrackedTasks); task != std::end(mTrackedTasks);)
+        {
+            if (task->second.mKey.mCharacterId == key.mCharacterId && task->second.mKey.mStep == key.mStep)
+            {
+                if (!task->second.mEnded)
+                    pendingTasks.emplace_back(task->first);
+
+                task = mTrackedTasks.erase(task);
+            }
+            else
+            {
+                ++task;
+            }
+        }
+
+        // ending them lets the task list and headless runner move on as well
+        for (const auto task : pendingTasks)
+            mApp.endTask(task, tr("Refresh of character %1 timed out.").arg(key.mCharacterId));
+
+        finishStep(key);
+    }
+
+    std::vector<CharacterRefreshOrchestrator::Step> CharacterRefreshOrchestrator::getDependencies(Step step)
+    {
+        switch (step) {
+        case Step::CorpAssets:
+        case Step::CorpContracts:
+        case Step::CorpWalletJournal:
+        case Step::CorpWalletTransactions:
+        case Step::CorpMarketOrdersFromAPI:
+        case Step::CorpMarketOrdersFromLogs:
+            // corporation imports use the character corporation, which the character import might change
+            return {Step::Character};
+        default:
+            return {};
+        }
+    }
+}
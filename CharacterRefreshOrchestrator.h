@@ -0,0 +1,131 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <deque>
+
+#include <QObject>
+
+#include "TaskConstants.h"
+#include "Character.h"
+
+namespace Evernus
+{
+    class EvernusApplication;
+
+    // runs character imports as a dependency graph, keeping independent imports of all characters in flight at once
+    class CharacterRefreshOrchestrator
+        : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        enum class Step
+        {
+            Character,
+            Assets,
+            Contracts,
+            WalletJournal,
+            WalletTransactions,
+            MarketOrdersFromAPI,
+            MarketOrdersFromLogs,
+            MiningLedger,
+            CorpAssets,
+            CorpContracts,
+            CorpWalletJournal,
+            CorpWalletTransactions,
+            CorpMarketOrdersFromAPI,
+            CorpMarketOrdersFromLogs
+        };
+
+        using Plan = std::unordered_map<Character::IdType, std::vector<Step>>;
+
+        explicit CharacterRefreshOrchestrator(EvernusApplication &app, QObject *parent = nullptr);
+        virtual ~CharacterRefreshOrchestrator() = default;
+
+        void refresh(const Plan &plan);
+
+        bool isRefreshing() const noexcept;
+
+        static std::vector<Step> getConfiguredSteps();
+
+    signals:
+        void refreshFinished();
+
+    private slots:
+        void startTrackedTask(uint taskId, uint parentTask);
+        void endTrackedTask(uint taskId);
+
+    private:
+        // imports are paginated and post-processed, so this bounds far more than the number of requests in flight
+        static const auto maxRunningSteps = 32u;
+        // a step whose task never ends would otherwise hold its slot and the whole refresh forever
+        static const auto stepTimeout = 15 * 60 * 1000;
+
+        struct StepKey
+        {
+            Character::IdType mCharacterId = Character::invalidId;
+            Step mStep = Step::Character;
+        };
+
+        struct CharacterState
+        {
+            uint mTask = TaskConstants::invalidTask;
+            uint mGuardTask = TaskConstants::invalidTask;
+            bool mGuardReleased = false;
+            std::unordered_set<Step> mPendingSteps, mActiveSteps;
+            std::deque<Step> mLaunchedSteps;
+            std::unordered_map<Step, quint64> mStepLaunches;
+            uint mQueuedSteps = 0;
+        };
+
+        struct TrackedTask
+        {
+            StepKey mKey;
+            uint mParentTask = TaskConstants::invalidTask;
+            uint mChildren = 0;
+            bool mEnded = false;
+        };
+
+        EvernusApplication &mApp;
+
+        std::unordered_map<Character::IdType, CharacterState> mCharacters;
+        std::unordered_map<uint, Character::IdType> mCharacterTasks;
+        std::unordered_map<uint, TrackedTask> mTrackedTasks;
+        std::unordered_set<uint> mEarlyEndedTasks;
+
+        std::deque<StepKey> mReadySteps;
+        uint mRunningSteps = 0;
+        uint mUnstartedSteps = 0;
+        quint64 mNextLaunch = 0;
+        bool mLaunching = false;
+
+        Plan mDeferredPlan;
+
+        void scheduleReadySteps(Character::IdType id, CharacterState &state);
+        void launchReadySteps();
+        void launchStep(const StepKey &key, uint parentTask);
+        void releaseGuardTask(CharacterState &state);
+
+        void completeTrackedTask(uint taskId);
+        void finishStep(const StepKey &key);
+        void timeOutStep(const StepKey &key, quint64 launch);
+
+        static std::vector<Step> getDependencies(Step step);
+    };
+}
@@ -24,5 +24,20 @@ namespace Evernus::CommandLineOptions
     const auto clientSecretArg = QStringLiteral("client-secret");
     const auto maxLogFileSizeArg = QStringLiteral("max-log-file-size");
     const auto maxLogFilesArg = QStringLiteral("max-log-files");
+    const auto logRulesArg = QStringLiteral("log-rules");
+    const auto traceArg = QStringLiteral("trace");
+    const auto esiUrlArg = QStringLiteral("esi-url");
+    const auto esiRecordArg = QStringLiteral("esi-record");
+    const auto esiReplayArg = QStringLiteral("esi-replay");
+    const auto esiReplayPortArg = QStringLiteral("esi-replay-port");
+    const auto esiReplayLatencyArg = QStringLiteral("esi-replay-latency");
+    const auto esiReplayErrorRateArg = QStringLiteral("esi-replay-error-rate");
+    const auto esiReplayPageSizeArg = QStringLiteral("esi-replay-page-size");
     const auto forceSDEUpdateArg = QStringLiteral("force-sde-update");
+    const auto headlessArg = QStringLiteral("headless");
+    const auto headlessTasksArg = QStringLiteral("tasks");
+    const auto headlessCharacterArg = QStringLiteral("character");
+    const auto headlessRegionsArg = QStringLiteral("regions");
+    const auto headlessOutputDirArg = QStringLiteral("output-dir");
+    const auto headlessOutputFormatArg = QStringLiteral("output-format");
 }
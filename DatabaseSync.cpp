@@ -0,0 +1,496 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+#include <array>
+
+#include <boost/throw_exception.hpp>
+
+#include <QCryptographicHash>
+#include <QTemporaryFile>
+#include <QJsonDocument>
+#include <QSqlDatabase>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QHash>
+#include <QtDebug>
+#include <QFile>
+#include <QSet>
+
+#include "SyncStorage.h"
+
+#include "DatabaseSync.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        using GearTable = std::array<quint64, 256>;
+
+        // NOTE: chunk boundaries depend on this table, so it must never change
+        GearTable createGearTable()
+        {
+            GearTable table;
+
+            // splitmix64
+            auto state = Q_UINT64_C(0x6576657276757331);
+            for (auto &value : table)
+            {
+                state += Q_UINT64_C(0x9e3779b97f4a7c15);
+
+                auto z = state;
+                z = (z ^ (z >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+                z = (z ^ (z >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+                value = z ^ (z >> 31);
+            }
+
+            return table;
+        }
+
+        void openFile(QFile &file, QIODevice::OpenMode mode)
+        {
+            if (!file.open(mode))
+                BOOST_THROW_EXCEPTION(std::runtime_error{QStringLiteral("Cannot open %1: %2").arg(file.fileName()).arg(file.errorString()).toStdString()});
+        }
+
+        QByteArray readChunk(QFile &file, const DatabaseSync::Chunk &chunk)
+        {
+            if (!file.seek(chunk.mOffset))
+                BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+            auto data = file.read(chunk.mSize);
+            if (data.size() != chunk.mSize)
+                BOOST_THROW_EXCEPTION(std::runtime_error{QStringLiteral("Short read from %1").arg(file.fileName()).toStdString()});
+
+            return data;
+        }
+
+        void writeChunk(QSaveFile &file, const QByteArray &data)
+        {
+            if (file.write(data) != data.size())
+                BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+        }
+    }
+
+    const QString DatabaseSync::manifestName = QStringLiteral("main.manifest");
+    const QString DatabaseSync::legacyName = QStringLiteral("main.db");
+
+    DatabaseSync::DatabaseSync(SyncStorage &storage, Executor executor)
+        : mStorage{storage}
+        , mExecutor{std::move(executor)}
+    {
+    }
+
+    void DatabaseSync::setProgressCallback(ProgressCallback callback)
+    {
+        mProgressCallback = std::move(callback);
+    }
+
+    void DatabaseSync::cancel()
+    {
+        mCancelled = true;
+    }
+
+    void DatabaseSync::upload(const QString &dbPath)
+    {
+        mCancelled = false;
+
+        QTemporaryFile snapshot{QFileInfo{dbPath}.absolutePath() + QStringLiteral("/sync-XXXXXX.db")};
+        if (!snapshot.open())
+            BOOST_THROW_EXCEPTION(std::runtime_error{snapshot.errorString().toStdString()});
+
+        snapshot.close();
+
+        const auto snapshotPath = snapshot.fileName();
+
+        ChunkList chunks;
+        execute([&] {
+            snapshotDatabase(dbPath, snapshotPath);
+            chunks = chunkFile(snapshotPath);
+        });
+
+        const auto size = QFileInfo{snapshotPath}.size();
+
+        qDebug() << "Database snapshot has" << chunks.size() << "chunks.";
+
+        QSet<QByteArray> remoteChunks;
+
+        ChunkList oldChunks;
+        if (const auto manifest = mStorage.read(manifestName))
+        {
+            qint64 oldSize = 0;
+            oldChunks = parseManifest(*manifest, oldSize);
+
+            for (const auto &chunk : oldChunks)
+                remoteChunks.insert(chunk.mHash);
+        }
+
+        qint64 totalUpload = 0;
+        QSet<QByteArray> pendingChunks;
+
+        for (const auto &chunk : chunks)
+        {
+            if (!remoteChunks.contains(chunk.mHash) && !pendingChunks.contains(chunk.mHash))
+            {
+                pendingChunks.insert(chunk.mHash);
+                totalUpload += chunk.mSize;
+            }
+        }
+
+        qDebug() << "Uploading" << pendingChunks.size() << "new chunks," << totalUpload << "bytes.";
+
+        QFile file{snapshotPath};
+        openFile(file, QIODevice::ReadOnly);
+
+        qint64 uploaded = 0;
+        reportProgress(uploaded, totalUpload);
+
+        for (const auto &chunk : chunks)
+        {
+            if (!pendingChunks.remove(chunk.mHash))
+                continue;
+
+            checkCancelled();
+
+            QByteArray data;
+            execute([&] {
+                data = qCompress(readChunk(file, chunk), compressionLevel);
+            });
+
+            mStorage.write(getChunkPath(chunk.mHash), data);
+
+            uploaded += chunk.mSize;
+            reportProgress(uploaded, totalUpload);
+        }
+
+        mStorage.write(manifestName, serializeManifest(chunks, size));
+
+        // chunks are content-addressed, so only those not referenced by the new manifest can go
+        QSet<QByteArray> usedChunks;
+        for (const auto &chunk : chunks)
+            usedChunks.insert(chunk.mHash);
+
+        for (const auto &chunk : oldChunks)
+        {
+            if (!usedChunks.contains(chunk.mHash))
+            {
+                usedChunks.insert(chunk.mHash);
+
+                try
+                {
+                    mStorage.remove(getChunkPath(chunk.mHash));
+                }
+                catch (const std::exception &e)
+                {
+                    qWarning() << "Cannot remove stale chunk:" << e.what();
+                }
+            }
+        }
+    }
+
+    bool DatabaseSync::download(const QString &dbPath)
+    {
+        mCancelled = false;
+
+        const auto manifest = mStorage.read(manifestName);
+        if (!manifest)
+            return false;
+
+        qint64 size = 0;
+        const auto chunks = parseManifest(*manifest, size);
+
+        // reuse whatever we already have locally
+        QHash<QByteArray, Chunk> localChunks;
+
+        QFile localFile{dbPath};
+        if (localFile.exists())
+        {
+            ChunkList currentChunks;
+            execute([&] {
+                currentChunks = chunkFile(dbPath);
+            });
+
+            for (const auto &chunk : currentChunks)
+                localChunks.insert(chunk.mHash, chunk);
+
+            openFile(localFile, QIODevice::ReadOnly);
+        }
+
+        QSaveFile file{dbPath};
+        openFile(file, QIODevice::WriteOnly);
+
+        qint64 processed = 0, downloaded = 0;
+        reportProgress(processed, size);
+
+        for (const auto &chunk : chunks)
+        {
+            checkCancelled();
+
+            const auto local = localChunks.constFind(chunk.mHash);
+            if (local != std::cend(localChunks))
+            {
+                execute([&] {
+                    writeChunk(file, readChunk(localFile, *local));
+                });
+            }
+            else
+            {
+                const auto compressed = mStorage.read(getChunkPath(chunk.mHash));
+                if (!compressed)
+                    BOOST_THROW_EXCEPTION(std::runtime_error{"Missing remote chunk: " + chunk.mHash.toStdString()});
+
+                execute([&] {
+                    const auto data = qUncompress(*compressed);
+                    if (QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex() != chunk.mHash)
+                        BOOST_THROW_EXCEPTION(std::runtime_error{"Corrupted remote chunk: " + chunk.mHash.toStdString()});
+
+                    writeChunk(file, data);
+                });
+
+                downloaded += chunk.mSize;
+            }
+
+            processed += chunk.mSize;
+            reportProgress(processed, size);
+        }
+
+        qDebug() << "Downloaded" << downloaded << "of" << size << "bytes.";
+
+        localFile.close();
+
+        if (file.size() != size)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Reconstructed database size mismatch."});
+        if (!file.commit())
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+        return true;
+    }
+
+    bool DatabaseSync::downloadLegacy(const QString &dbPath)
+    {
+        mCancelled = false;
+
+        reportProgress(0, 1);
+
+        const auto compressed = mStorage.read(legacyName);
+        if (!compressed)
+            return false;
+
+        checkCancelled();
+
+        QSaveFile file{dbPath};
+        openFile(file, QIODevice::WriteOnly);
+
+        execute([&] {
+            const auto data = qUncompress(*compressed);
+            if (data.isEmpty() && !compressed->isEmpty())
+                BOOST_THROW_EXCEPTION(std::runtime_error{"Corrupted legacy database."});
+
+            writeChunk(file, data);
+        });
+
+        if (!file.commit())
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+        reportProgress(1, 1);
+
+        return true;
+    }
+
+    void DatabaseSync::removeLegacy()
+    {
+        mStorage.remove(legacyName);
+    }
+
+    void DatabaseSync::snapshotDatabase(const QString &dbPath, const QString &snapshotPath)
+    {
+        const auto connectionName = QStringLiteral("sync-snapshot");
+
+        auto snapshotCreated = false;
+
+        {
+            auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+            db.setDatabaseName(dbPath);
+            db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+
+            if (db.open())
+            {
+                // consistent copy without blocking writers for long
+                QSqlQuery query{db};
+                query.prepare(QStringLiteral("VACUUM INTO ?"));
+                query.bindValue(0, snapshotPath);
+
+                snapshotCreated = query.exec();
+                if (!snapshotCreated)
+                    qWarning() << "Cannot snapshot database:" << query.lastError();
+
+                db.close();
+            }
+            else
+            {
+                qWarning() << "Cannot open database for snapshot:" << db.lastError();
+            }
+        }
+
+        QSqlDatabase::removeDatabase(connectionName);
+
+        if (!snapshotCreated)
+        {
+            // older SQLite - fall back to plain copy
+            QFile::remove(snapshotPath);
+            if (!QFile::copy(dbPath, snapshotPath))
+                BOOST_THROW_EXCEPTION(std::runtime_error{"Cannot create database snapshot."});
+        }
+    }
+
+    DatabaseSync::ChunkList DatabaseSync::chunkFile(const QString &path)
+    {
+        static const auto gear = createGearTable();
+        static const auto chunkMask = ~Q_UINT64_C(0) << (64 - chunkBits);
+
+        QFile file{path};
+        openFile(file, QIODevice::ReadOnly);
+
+        ChunkList chunks;
+
+        QCryptographicHash hash{QCryptographicHash::Sha256};
+        quint64 fingerprint = 0;
+        qint64 chunkStart = 0, chunkSize = 0;
+
+        const auto addChunk = [&] {
+            chunks.emplace_back(Chunk{hash.result().toHex(), chunkStart, chunkSize});
+
+            hash.reset();
+            fingerprint = 0;
+            chunkStart += chunkSize;
+            chunkSize = 0;
+        };
+
+        QByteArray buffer;
+        while (!file.atEnd())
+        {
+            buffer = file.read(readBlockSize);
+            if (buffer.isEmpty())
+                BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+            const auto data = buffer.constData();
+            const auto length = buffer.size();
+
+            auto hashStart = 0;
+            for (auto i = 0; i < length; ++i)
+            {
+                fingerprint = (fingerprint << 1) + gear[static_cast<uchar>(data[i])];
+                ++chunkSize;
+
+                if (chunkSize < minChunkSize)
+                    continue;
+
+                if ((fingerprint & chunkMask) == 0 || chunkSize >= maxChunkSize)
+                {
+                    hash.addData(data + hashStart, i + 1 - hashStart);
+                    hashStart = i + 1;
+
+                    addChunk();
+                }
+            }
+
+            hash.addData(data + hashStart, length - hashStart);
+        }
+
+        if (chunkSize > 0)
+            addChunk();
+
+        return chunks;
+    }
+
+    void DatabaseSync::execute(const std::function<void ()> &func) const
+    {
+        if (mExecutor)
+            mExecutor(func);
+        else
+            func();
+    }
+
+    void DatabaseSync::checkCancelled() const
+    {
+        if (mCancelled)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Synchronization cancelled."});
+    }
+
+    void DatabaseSync::reportProgress(qint64 current, qint64 total) const
+    {
+        if (mProgressCallback)
+            mProgressCallback(current, total);
+    }
+
+    QString DatabaseSync::getChunkPath(const QByteArray &hash)
+    {
+        return QStringLiteral("chunks/") + QString::fromLatin1(hash);
+    }
+
+    QByteArray DatabaseSync::serializeManifest(const ChunkList &chunks, qint64 size)
+    {
+        QJsonArray chunkArray;
+        for (const auto &chunk : chunks)
+        {
+            chunkArray.append(QJsonObject{
+                { QStringLiteral("hash"), QString::fromLatin1(chunk.mHash) },
+                { QStringLiteral("size"), chunk.mSize },
+            });
+        }
+
+        return QJsonDocument{QJsonObject{
+            { QStringLiteral("version"), manifestVersion },
+            { QStringLiteral("size"), size },
+            { QStringLiteral("chunks"), chunkArray },
+        }}.toJson(QJsonDocument::Compact);
+    }
+
+    DatabaseSync::ChunkList DatabaseSync::parseManifest(const QByteArray &data, qint64 &size)
+    {
+        const auto manifest = QJsonDocument::fromJson(data).object();
+        if (manifest.value(QStringLiteral("version")).toInt() != manifestVersion)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Unsupported sync manifest version."});
+
+        size = static_cast<qint64>(manifest.value(QStringLiteral("size")).toDouble());
+
+        ChunkList chunks;
+        qint64 offset = 0;
+
+        const auto chunkArray = manifest.value(QStringLiteral("chunks")).toArray();
+        chunks.reserve(chunkArray.size());
+
+        for (const auto &value : chunkArray)
+        {
+            const auto object = value.toObject();
+
+            Chunk chunk;
+            chunk.mHash = object.value(QStringLiteral("hash")).toString().toLatin1();
+            chunk.mOffset = offset;
+            chunk.mSize = static_cast<qint64>(object.value(QStringLiteral("size")).toDouble());
+
+            offset += chunk.mSize;
+            chunks.emplace_back(std::move(chunk));
+        }
+
+        if (offset != size)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Invalid sync manifest."});
+
+        return chunks;
+    }
+}
@@ -0,0 +1,94 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <functional>
+#include <atomic>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+namespace Evernus
+{
+    class SyncStorage;
+
+    // content-defined chunked sync of a database file with remote storage - only changed chunks are transferred
+    class DatabaseSync
+    {
+    public:
+        struct Chunk
+        {
+            QByteArray mHash;
+            qint64 mOffset = 0;
+            qint64 mSize = 0;
+        };
+
+        using ChunkList = std::vector<Chunk>;
+
+        // runs given blocking work, eg. on another thread while keeping the UI alive
+        using Executor = std::function<void (const std::function<void ()> &)>;
+        using ProgressCallback = std::function<void (qint64 current, qint64 total)>;
+
+        static const QString manifestName;
+        // single compressed file uploaded by older versions
+        static const QString legacyName;
+
+        explicit DatabaseSync(SyncStorage &storage, Executor executor = Executor{});
+        DatabaseSync(const DatabaseSync &) = delete;
+        DatabaseSync(DatabaseSync &&) = delete;
+        ~DatabaseSync() = default;
+
+        void setProgressCallback(ProgressCallback callback);
+        void cancel();
+
+        void upload(const QString &dbPath);
+        // returns false if there's nothing to download
+        bool download(const QString &dbPath);
+        bool downloadLegacy(const QString &dbPath);
+        void removeLegacy();
+
+        DatabaseSync &operator =(const DatabaseSync &) = delete;
+        DatabaseSync &operator =(DatabaseSync &&) = delete;
+
+        static void snapshotDatabase(const QString &dbPath, const QString &snapshotPath);
+        static ChunkList chunkFile(const QString &path);
+
+    private:
+        static const auto manifestVersion = 1;
+        static const auto compressionLevel = 6;
+
+        static const qint64 minChunkSize = 256 * 1024;
+        static const qint64 maxChunkSize = 4 * 1024 * 1024;
+        static const qint64 readBlockSize = 1024 * 1024;
+        // ~1MB average chunk size above the minimum
+        static const auto chunkBits = 20;
+
+        SyncStorage &mStorage;
+        Executor mExecutor;
+        ProgressCallback mProgressCallback;
+
+        std::atomic_bool mCancelled{false};
+
+        void execute(const std::function<void ()> &func) const;
+        void checkCancelled() const;
+        void reportProgress(qint64 current, qint64 total) const;
+
+        static QString getChunkPath(const QByteArray &hash);
+
+        static QByteArray serializeManifest(const ChunkList &chunks, qint64 size);
+        static ChunkList parseManifest(const QByteArray &data, qint64 &size);
+    };
+}
@@ -24,6 +24,8 @@
 #include <QtDebug>
 #include <QFile>
 
+#include "LoggingCategories.h"
+
 #include "DatabaseUtils.h"
 
 namespace Evernus::DatabaseUtils
@@ -40,7 +42,7 @@ namespace Evernus::DatabaseUtils
 
     void execQuery(QSqlQuery &query)
     {
-        qDebug() << "SQL:" << query.lastQuery();
+        qCDebug(lcSql) << "SQL:" << query.lastQuery();
         if (!query.exec())
         {
             auto error = query.lastError();
@@ -0,0 +1,84 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+#include <QtDebug>
+
+#include "qdropbox2file.h"
+
+#include "DropboxSyncStorage.h"
+
+namespace Evernus
+{
+    DropboxSyncStorage::DropboxSyncStorage(QDropbox2 &dropbox, QString root)
+        : SyncStorage{}
+        , mDropbox{dropbox}
+        , mRoot{std::move(root)}
+    {
+    }
+
+    std::optional<QByteArray> DropboxSyncStorage::read(const QString &path)
+    {
+        const auto fullPath = getFullPath(path);
+        qDebug() << "Downloading" << fullPath;
+
+        QDropbox2File file{fullPath, &mDropbox};
+        if (!file.open(QIODevice::ReadOnly))
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+        auto data = file.readAll();
+        if (data.isEmpty())
+        {
+            // opening a missing file succeeds, so check if there's anything there
+            file.metadata();
+            if (file.error() == QDropbox2::Error::FileNotFound)
+                return std::nullopt;
+        }
+
+        return data;
+    }
+
+    void DropboxSyncStorage::write(const QString &path, const QByteArray &data)
+    {
+        const auto fullPath = getFullPath(path);
+        qDebug() << "Uploading" << fullPath << data.size();
+
+        QDropbox2File file{fullPath, &mDropbox};
+        file.setOverwrite(true);
+
+        if (!file.open(QIODevice::WriteOnly))
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+        file.write(data);
+        file.close();
+
+        if (file.error() != QDropbox2::Error::NoError)
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+    }
+
+    void DropboxSyncStorage::remove(const QString &path)
+    {
+        QDropbox2File file{getFullPath(path), &mDropbox};
+        if (!file.remove())
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+    }
+
+    QString DropboxSyncStorage::getFullPath(const QString &path) const
+    {
+        return mRoot + QStringLiteral("/") + path;
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QString>
+
+#include "SyncStorage.h"
+
+class QDropbox2;
+
+namespace Evernus
+{
+    class DropboxSyncStorage
+        : public SyncStorage
+    {
+    public:
+        DropboxSyncStorage(QDropbox2 &dropbox, QString root);
+        virtual ~DropboxSyncStorage() = default;
+
+        virtual std::optional<QByteArray> read(const QString &path) override;
+        virtual void write(const QString &path, const QByteArray &data) override;
+        virtual void remove(const QString &path) override;
+
+    private:
+        QDropbox2 &mDropbox;
+        QString mRoot;
+
+        QString getFullPath(const QString &path) const;
+    };
+}
@@ -29,6 +29,9 @@
 
 #include "ESIInterfaceErrorLimiter.h"
 #include "CitadelAccessCache.h"
+#include "MarketImportPlanner.h"
+#include "LoggingCategories.h"
+#include "PerformanceTracer.h"
 #include "NetworkSettings.h"
 #include "CallbackEvent.h"
 #include "ReplyTimeout.h"
@@ -130,25 +133,35 @@ namespace Evernus
 
     void ESIInterface::fetchMarketOrders(uint regionId, EveType::IdType typeId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching market orders for" << regionId << "and" << typeId;
+        qCDebug(lcEsi) << "Fetching market orders for" << regionId << "and" << typeId;
         fetchPaginatedData(QStringLiteral("/v1/markets/%1/orders/").arg(regionId), { { QStringLiteral("type_id"), typeId } }, 1, callback, std::make_shared<PaginatedContext>());
     }
 
     void ESIInterface::fetchMarketOrders(uint regionId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching whole market for" << regionId;
-        fetchPaginatedData(QStringLiteral("/v1/markets/%1/orders/").arg(regionId), {}, 1, callback, std::make_shared<PaginatedContext>());
+        qCDebug(lcEsi) << "Fetching whole market for" << regionId;
+
+        const auto context = std::make_shared<PaginatedContext>();
+        const PaginatedCallback countingCallback = [=](QJsonDocument &&data, bool atEnd, const QString &error, const QDateTime &expires) {
+            // learn region size for future import planning
+            if (atEnd && error.isEmpty())
+                MarketImportPlanner::setPageCount(regionId, context->mFetchedPages);
+
+            callback(std::move(data), atEnd, error, expires);
+        };
+
+        fetchPaginatedData(QStringLiteral("/v1/markets/%1/orders/").arg(regionId), {}, 1, countingCallback, context);
     }
 
     void ESIInterface::fetchMarketHistory(uint regionId, EveType::IdType typeId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching market history for" << regionId << "and" << typeId;
+        qCDebug(lcEsi) << "Fetching market history for" << regionId << "and" << typeId;
         get(QStringLiteral("/v1/markets/%1/history/").arg(regionId), { { QStringLiteral("type_id"), typeId } }, callback, getNumRetries());
     }
 
     void ESIInterface::fetchCitadelMarketOrders(quint64 citadelId, Character::IdType charId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching orders from citadel" << citadelId;
+        qCDebug(lcEsi) << "Fetching orders from citadel" << citadelId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -158,7 +171,7 @@ namespace Evernus
 
         if (!mCitadelAccessCache.isAvailable(charId, citadelId))
         {
-            qDebug() << "Citadel blacklisted:" << charId << citadelId;
+            qCDebug(lcEsi) << "Citadel blacklisted:" << charId << citadelId;
             callback({}, true, {}, {});
             return;
         }
@@ -168,7 +181,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterAssets(Character::IdType charId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching character assets for" << charId;
+        qCDebug(lcEsi) << "Fetching character assets for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -181,7 +194,7 @@ namespace Evernus
 
     void ESIInterface::fetchCorporationAssets(Character::IdType charId, quint64 corpId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching corporation assets for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation assets for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -194,7 +207,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacter(Character::IdType charId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character" << charId;
+        qCDebug(lcEsi) << "Fetching character" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -207,7 +220,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterSkills(Character::IdType charId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character skills for" << charId;
+        qCDebug(lcEsi) << "Fetching character skills for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -220,31 +233,31 @@ namespace Evernus
 
     void ESIInterface::fetchCorporation(quint64 corpId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching corporation" << corpId;
+        qCDebug(lcEsi) << "Fetching corporation" << corpId;
         get(QStringLiteral("/v4/corporations/%1/").arg(corpId), {}, callback, getNumRetries());
     }
 
     void ESIInterface::fetchRaces(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching races";
+        qCDebug(lcEsi) << "Fetching races";
         get(QStringLiteral("/v1/universe/races/"), {}, callback, getNumRetries());
     }
 
     void ESIInterface::fetchBloodlines(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching bloodlines";
+        qCDebug(lcEsi) << "Fetching bloodlines";
         get(QStringLiteral("/v1/universe/bloodlines/"), {}, callback, getNumRetries());
     }
 
     void ESIInterface::fetchAncestries(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching ancestries";
+        qCDebug(lcEsi) << "Fetching ancestries";
         get(QStringLiteral("/v1/universe/ancestries/"), {}, callback, getNumRetries());
     }
 
     void ESIInterface::fetchCharacterWallet(Character::IdType charId, const StringCallback &callback) const
     {
-        qDebug() << "Fetching character wallet for" << charId;
+        qCDebug(lcEsi) << "Fetching character wallet for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -257,7 +270,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterMarketOrders(Character::IdType charId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character market orders for" << charId;
+        qCDebug(lcEsi) << "Fetching character market orders for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -270,7 +283,7 @@ namespace Evernus
 
     void ESIInterface::fetchCorporationMarketOrders(Character::IdType charId, quint64 corpId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching corporation market orders for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation market orders for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -284,7 +297,7 @@ namespace Evernus
     void ESIInterface::fetchCharacterWalletJournal(Character::IdType charId,
                                                    const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching character wallet journal for" << charId;
+        qCDebug(lcEsi) << "Fetching character wallet journal for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -300,7 +313,7 @@ namespace Evernus
                                                      int division,
                                                      const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching corporation wallet journal for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation wallet journal for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -315,7 +328,7 @@ namespace Evernus
                                                         const std::optional<WalletTransaction::IdType> &fromId,
                                                         const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character wallet transactions for" << charId;
+        qCDebug(lcEsi) << "Fetching character wallet transactions for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -336,7 +349,7 @@ namespace Evernus
                                                           const std::optional<WalletJournalEntry::IdType> &fromId,
                                                           const JsonCallback &callback) const
     {
-        qDebug() << "Fetching corporation wallet transactions for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation wallet transactions for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -353,7 +366,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterContracts(Character::IdType charId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character contracts for" << charId;
+        qCDebug(lcEsi) << "Fetching character contracts for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -366,7 +379,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterContractItems(Character::IdType charId, Contract::IdType contractId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching character contract items for" << charId;
+        qCDebug(lcEsi) << "Fetching character contract items for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -379,7 +392,7 @@ namespace Evernus
 
     void ESIInterface::fetchCorporationContracts(Character::IdType charId, quint64 corpId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching corporation contracts for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation contracts for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -392,7 +405,7 @@ namespace Evernus
 
     void ESIInterface::fetchCorporationContractItems(Character::IdType charId, quint64 corpId, Contract::IdType contractId, const JsonCallback &callback) const
     {
-        qDebug() << "Fetching corporation contract items for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation contract items for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -405,7 +418,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterBlueprints(Character::IdType charId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching character blueprints for" << charId;
+        qCDebug(lcEsi) << "Fetching character blueprints for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -418,7 +431,7 @@ namespace Evernus
 
     void ESIInterface::fetchCorporationBlueprints(Character::IdType charId, quint64 corpId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching corporation blueprints for" << charId;
+        qCDebug(lcEsi) << "Fetching corporation blueprints for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -431,7 +444,7 @@ namespace Evernus
 
     void ESIInterface::fetchCharacterMiningLedger(Character::IdType charId, const PaginatedCallback &callback) const
     {
-        qDebug() << "Fetching character mining ledger for" << charId;
+        qCDebug(lcEsi) << "Fetching character mining ledger for" << charId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -444,7 +457,7 @@ namespace Evernus
 
     void ESIInterface::fetchGenericName(quint64 id, const PersistentStringCallback &callback) const
     {
-        qDebug() << "Fetching generic name:" << id;
+        qCDebug(lcEsi) << "Fetching generic name:" << id;
 
         QVariantList idArray;
         idArray << id;
@@ -467,7 +480,7 @@ namespace Evernus
 
     void ESIInterface::fetchGenericNames(const std::vector<quint64> &ids, const PersistentJsonCallback &callback) const
     {
-        qDebug() << "Fetching generic names:" << ids.size();
+        qCDebug(lcEsi) << "Fetching generic names:" << ids.size();
 
         QVariantList idArray;
         std::transform(std::begin(ids), std::end(ids), std::back_inserter(idArray), [](auto id) {
@@ -486,7 +499,7 @@ namespace Evernus
 
     void ESIInterface::fetchMarketPrices(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching market prices.";
+        qCDebug(lcEsi) << "Fetching market prices.";
         get(QStringLiteral("/v1/markets/prices/"), {}, [=](auto &&data, const auto &error, const auto &expires) {
             callback(std::move(data), error, expires);
         }, getNumRetries());
@@ -494,7 +507,7 @@ namespace Evernus
 
     void ESIInterface::fetchIndustryCostIndices(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching industry cost indices.";
+        qCDebug(lcEsi) << "Fetching industry cost indices.";
         get(QStringLiteral("/v1/industry/systems/"), {}, [=](auto &&data, const auto &error, const auto &expires) {
             callback(std::move(data), error, expires);
         }, getNumRetries());
@@ -502,7 +515,7 @@ namespace Evernus
 
     void ESIInterface::fetchSovereigntyStructures(const JsonCallback &callback) const
     {
-        qDebug() << "Fetching sovereignty structures.";
+        qCDebug(lcEsi) << "Fetching sovereignty structures.";
         get(QStringLiteral("/v1/sovereignty/structures/"), {}, [=](auto &&data, const auto &error, const auto &expires) {
             callback(std::move(data), error, expires);
         }, getNumRetries());
@@ -510,7 +523,7 @@ namespace Evernus
 
     void ESIInterface::openMarketDetails(EveType::IdType typeId, Character::IdType charId, const ErrorCallback &errorCallback) const
     {
-        qDebug() << "Opening market details for" << typeId;
+        qCDebug(lcEsi) << "Opening market details for" << typeId;
 
         if (Q_UNLIKELY(charId == Character::invalidId))
         {
@@ -523,7 +536,7 @@ namespace Evernus
 
     void ESIInterface::setDestination(quint64 locationId, Character::IdType charId, const ErrorCallback &errorCallback) const
     {
-        qDebug() << "Setting destination:" << locationId;
+        qCDebug(lcEsi) << "Setting destination:" << locationId;
 
         QVariantMap data;
         data[QStringLiteral("destination_id")] = locationId;
@@ -566,7 +579,7 @@ namespace Evernus
             {
                 if (page == 1)
                 {
-                    qDebug() << "Got number of pages for paginated request:" << pages;
+                    qCDebug(lcEsi) << "Got number of pages for paginated request:" << pages;
 
                     if (pages == 1)
                     {
@@ -654,17 +667,21 @@ namespace Evernus
     void ESIInterface::get(const QString &url, const QVariantMap &parameters, const T &continuation, uint retries) const
     {
         runNowOrLater([=] {
-            auto reply = mOAuth.get(ESIUrls::esiUrl + url, parameters);
+            const auto requestStart = PerformanceTracer::now();
+
+            auto reply = mOAuth.get(ESIUrls::getEsiUrl() + url, parameters);
             Q_ASSERT(reply != nullptr);
 
-            qDebug() << "ESI request:" << reply << "" << url << ":" << parameters;
-            qDebug() << "Retries" << retries;
+            qCDebug(lcEsi) << "ESI request:" << reply << "" << url << ":" << parameters;
+            qCDebug(lcEsi) << "Retries" << retries;
 
             new ReplyTimeout{*reply};
 
             connect(reply, &QNetworkReply::finished, this, [=] {
                 reply->deleteLater();
 
+                PerformanceTracer::recordAsync("esi", "ESI round trip", requestStart, url);
+
                 showReplyDebugInfo(*reply);
 
                 const auto error = reply->error();
@@ -693,8 +710,9 @@ namespace Evernus
                 {
                     const auto data = reply->readAll();
                     if (mLogReplies)
-                        qDebug() << reply << data;
+                        qCDebug(lcEsi) << reply << data;
 
+                    const TraceSpan span{"esi", "ESI reply processing", [&url] { return url; }};
                     TaggedInvoke<ResultTag>::invoke(data, *reply, continuation);
                 }
             });
@@ -711,9 +729,13 @@ namespace Evernus
                            quint64 citadelId) const
     {
         runNowOrLater([=] {
-            mOAuth.get(charId, ESIUrls::esiUrl + url, parameters, [=](auto &reply) {
-                qDebug() << "ESI request:" << url << ":" << parameters;
-                qDebug() << "Retries" << retries;
+            const auto requestStart = PerformanceTracer::now();
+
+            mOAuth.get(charId, ESIUrls::getEsiUrl() + url, parameters, [=](auto &reply) {
+                PerformanceTracer::recordAsync("esi", "ESI round trip", requestStart, url);
+
+                qCDebug(lcEsi) << "ESI request:" << url << ":" << parameters;
+                qCDebug(lcEsi) << "Retries" << retries;
 
                 showReplyDebugInfo(reply);
 
@@ -739,7 +761,7 @@ namespace Evernus
                             {
                                 if (citadelId != 0)
                                 {
-                                    qDebug() << "Blacklisting citadel:" << citadelId << charId;
+                                    qCDebug(lcEsi) << "Blacklisting citadel:" << citadelId << charId;
                                     mCitadelAccessCache.blacklist(charId, citadelId);
                                 }
 
@@ -764,8 +786,9 @@ namespace Evernus
                 {
                     const auto data = reply.readAll();
                     if (mLogReplies)
-                        qDebug() << url << data;
+                        qCDebug(lcEsi) << url << data;
 
+                    const TraceSpan span{"esi", "ESI reply processing", [&url] { return url; }};
                     TaggedInvoke<ResultTag>::invoke(data, reply, continuation);
                 }
             }, [=](const auto &error) {
@@ -778,8 +801,8 @@ namespace Evernus
     void ESIInterface::post(Character::IdType charId, const QString &url, const QVariant &data, T &&errorCallback) const
     {
         runNowOrLater([=] {
-            mOAuth.post(charId, ESIUrls::esiUrl + url, data, [=](auto &reply) {
-                qDebug() << "ESI request:" << url << ":" << data;
+            mOAuth.post(charId, ESIUrls::getEsiUrl() + url, data, [=](auto &reply) {
+                qCDebug(lcEsi) << "ESI request:" << url << ":" << data;
 
                 showReplyDebugInfo(reply);
 
@@ -806,7 +829,7 @@ namespace Evernus
                 {
                     const auto data = reply.readAll();
                     if (mLogReplies)
-                        qDebug() << url << data;
+                        qCDebug(lcEsi) << url << data;
 
                     const auto error = getError(data);
                     if (!error.mMessage.isEmpty())
@@ -822,16 +845,20 @@ namespace Evernus
     void ESIInterface::post(const QString &url, const QVariant &data, ErrorCallback errorCallback, T &&resultCallback) const
     {
         runNowOrLater([=] {
-            auto reply = mOAuth.post(ESIUrls::esiUrl + url, data);
+            const auto requestStart = PerformanceTracer::now();
+
+            auto reply = mOAuth.post(ESIUrls::getEsiUrl() + url, data);
             Q_ASSERT(reply != nullptr);
 
-            qDebug() << "ESI request" << reply << ":" << url << ":" << data;
+            qCDebug(lcEsi) << "ESI request" << reply << ":" << url << ":" << data;
 
             new ReplyTimeout{*reply};
 
             connect(reply, &QNetworkReply::finished, this, [=] {
                 reply->deleteLater();
 
+                PerformanceTracer::recordAsync("esi", "ESI round trip", requestStart, url);
+
                 showReplyDebugInfo(*reply);
 
                 const auto error = reply->error();
@@ -857,7 +884,7 @@ namespace Evernus
                 {
                     const auto resultText = reply->readAll();
                     if (mLogReplies)
-                        qDebug() << url << resultText;
+                        qCDebug(lcEsi) << url << resultText;
 
                     const auto error = getError(resultText);
                     if (!error.mMessage.isEmpty())
@@ -951,7 +978,7 @@ namespace Evernus
 
     void ESIInterface::showReplyDebugInfo(const QNetworkReply &reply)
     {
-        qDebug() << "X-Esi-Ab-Test:" << reply.rawHeader(QByteArrayLiteral("X-Esi-Ab-Test"));
+        qCDebug(lcEsi) << "X-Esi-Ab-Test:" << reply.rawHeader(QByteArrayLiteral("X-Esi-Ab-Test"));
     }
 
     bool ESIInterface::shouldThrottle(int httpStatus)
@@ -0,0 +1,117 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QJsonObject>
+#include <QDateTime>
+#include <QString>
+#include <QHash>
+
+#include "MarketOrder.h"
+
+#include "ESIJsonUtils.h"
+
+namespace Evernus
+{
+    namespace ESIJsonUtils
+    {
+        QDateTime getDateTimeFromString(const QString &value)
+        {
+            auto dt = QDateTime::fromString(value, Qt::ISODate);
+            if (Q_UNLIKELY(!dt.isValid()))
+                dt = QDateTime::currentDateTimeUtc();   // just to be safe
+            else
+                dt.setTimeSpec(Qt::UTC);
+
+            return dt;
+        }
+
+        short getMarketOrderRangeFromString(const QString &range)
+        {
+            static const QHash<QString, short> ranges = {
+                { QStringLiteral("station"), MarketOrder::rangeStation },
+                { QStringLiteral("region"), MarketOrder::rangeRegion },
+                { QStringLiteral("solarsystem"), MarketOrder::rangeSystem },
+            };
+
+            // assume unknown is active, since there shouldn't be non-open orders returned anyway
+            return (ranges.contains(range)) ? (ranges[range]) : (range.toShort());
+        }
+
+        ExternalOrder getExternalOrderFromJson(const QJsonObject &object, uint regionId, const QDateTime &updateTime)
+        {
+            const auto range = object.value(QStringLiteral("range")).toString();
+
+            ExternalOrder order;
+
+            order.setId(object.value(QStringLiteral("order_id")).toDouble()); // https://bugreports.qt.io/browse/QTBUG-28560
+            order.setType((object.value(QStringLiteral("is_buy_order")).toBool()) ? (ExternalOrder::Type::Buy) : (ExternalOrder::Type::Sell));
+            order.setTypeId(object.value(QStringLiteral("type_id")).toDouble());
+            order.setStationId(object.value(QStringLiteral("location_id")).toDouble());
+            order.setRegionId(regionId);
+
+            if (object.contains(QStringLiteral("system_id")))
+                order.setSolarSystemId(object.value(QStringLiteral("system_id")).toDouble());
+
+            if (range == "station")
+                order.setRange(ExternalOrder::rangeStation);
+            else if (range == "system")
+                order.setRange(ExternalOrder::rangeSystem);
+            else if (range == "region")
+                order.setRange(ExternalOrder::rangeRegion);
+            else
+                order.setRange(range.toShort());
+
+            order.setUpdateTime(updateTime);
+            order.setPrice(object.value(QStringLiteral("price")).toDouble());
+            order.setVolumeEntered(object.value(QStringLiteral("volume_total")).toInt());
+            order.setVolumeRemaining(object.value(QStringLiteral("volume_remain")).toInt());
+            order.setMinVolume(object.value(QStringLiteral("min_volume")).toInt());
+            order.setIssued(getDateTimeFromString(object.value(QStringLiteral("issued")).toString()));
+            order.setDuration(object.value(QStringLiteral("duration")).toInt());
+
+            return order;
+        }
+
+        WalletJournalEntry getWalletJournalEntryFromJson(const QJsonObject &object, Character::IdType charId, quint64 corpId)
+        {
+            WalletJournalEntry entry{static_cast<WalletJournalEntry::IdType>(object.value(QStringLiteral("id")).toDouble())};
+            entry.setCharacterId(charId);
+            entry.setCorporationId(corpId);
+            entry.setTimestamp(getDateTimeFromString(object.value(QStringLiteral("date")).toString()));
+            entry.setRefType(object.value(QStringLiteral("ref_type")).toString());
+
+            if (object.contains(QStringLiteral("first_party_id")))
+                entry.setFirstPartyId(object.value(QStringLiteral("first_party_id")).toDouble());
+            if (object.contains(QStringLiteral("second_party_id")))
+                entry.setSecondPartyId(object.value(QStringLiteral("second_party_id")).toDouble());
+
+            entry.setReason(object.value(QStringLiteral("reason")).toString());
+
+            if (object.contains(QStringLiteral("amount")))
+                entry.setAmount(object.value(QStringLiteral("amount")).toDouble());
+            if (object.contains(QStringLiteral("balance")))
+                entry.setBalance(object.value(QStringLiteral("balance")).toDouble());
+            if (object.contains(QStringLiteral("tax_reciever_id")))
+                entry.setTaxReceiverId(object.value(QStringLiteral("tax_reciever_id")).toDouble());
+            if (object.contains(QStringLiteral("tax")))
+                entry.setTaxAmount(object.value(QStringLiteral("tax")).toDouble());
+            if (object.contains(QStringLiteral("context_id")))
+                entry.setContextId(object.value(QStringLiteral("context_id")).toDouble());
+            if (object.contains(QStringLiteral("context_id_type")))
+                entry.setContextIdType(object.value(QStringLiteral("context_id_type")).toString());
+
+            return entry;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "WalletJournalEntry.h"
+#include "ExternalOrder.h"
+#include "Character.h"
+
+class QJsonObject;
+class QDateTime;
+class QString;
+
+namespace Evernus
+{
+    namespace ESIJsonUtils
+    {
+        QDateTime getDateTimeFromString(const QString &value);
+        short getMarketOrderRangeFromString(const QString &range);
+
+        // solar system is left unset when ESI doesn't report it
+        ExternalOrder getExternalOrderFromJson(const QJsonObject &object, uint regionId, const QDateTime &updateTime);
+        WalletJournalEntry getWalletJournalEntryFromJson(const QJsonObject &object, Character::IdType charId, quint64 corpId);
+    }
+}
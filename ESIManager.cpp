@@ -12,6 +12,7 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <unordered_set>
 #include <algorithm>
 #include <atomic>
 #include <limits>
@@ -38,6 +39,7 @@
 #include "EveDataProvider.h"
 #include "NetworkSettings.h"
 #include "ExternalOrder.h"
+#include "ESIJsonUtils.h"
 #include "ReplyTimeout.h"
 #include "MiningLedger.h"
 #include "Blueprint.h"
@@ -148,239 +150,76 @@ namespace Evernus
 
     void ESIManager::fetchCharacter(Character::IdType charId, const Callback<Character> &callback) const
     {
+        struct CharacterFetchState
+        {
+            QJsonObject mPublicData;
+            QJsonObject mCorpData;
+            QJsonDocument mSkillData;
+            QString mWallet;
+            QDateTime mExpires;
+            uint mPendingRequests = 3;
+            bool mFailed = false;
+        };
+
+        // only the corporation depends on other data, so the rest is requested at once
+        const auto state = std::make_shared<CharacterFetchState>();
+
+        const auto fail = [=](const auto &error, const auto &expires) {
+            if (state->mFailed)
+                return;
+
+            state->mFailed = true;
+            callback({}, error, expires);
+        };
+        const auto finish = [=] {
+            if (--state->mPendingRequests != 0 || state->mFailed)
+                return;
+
+            callback(getCharacterFromJson(charId, state->mPublicData, state->mCorpData, state->mSkillData, state->mWallet), {}, state->mExpires);
+        };
+
         getInterface().fetchCharacter(charId, [=](auto &&publicData, const auto &error, const auto &expires) {
             if (Q_UNLIKELY(!error.isEmpty()))
             {
-                callback({}, error, expires);
+                fail(error, expires);
                 return;
             }
 
-            getInterface().fetchCharacterSkills(
-                charId, [=, publicData = std::move(publicData)](auto &&skillData, const auto &error, const auto &expires) {
+            state->mPublicData = publicData.object();
+
+            getInterface().fetchCorporation(
+                state->mPublicData.value(QStringLiteral("corporation_id")).toDouble(),
+                [=](auto &&corpData, const auto &error, const auto &expires) {
                     if (Q_UNLIKELY(!error.isEmpty()))
                     {
-                        callback({}, error, expires);
+                        fail(error, expires);
                         return;
                     }
 
-                    const auto publicDataObj = publicData.object();
-
-                    getInterface().fetchCorporation(
-                        publicDataObj.value(QStringLiteral("corporation_id")).toDouble(),
-                        [=, publicDataObj = std::move(publicDataObj), skillData = std::move(skillData)](auto &&corpData, const auto &error, const auto &expires) {
-                            if (Q_UNLIKELY(!error.isEmpty()))
-                            {
-                                callback({}, error, expires);
-                                return;
-                            }
-
-                            getInterface().fetchCharacterWallet(
-                                charId,
-                                [=, corpData = std::move(corpData), publicDataObj = std::move(publicDataObj), skillData = std::move(skillData)](auto &&walletData, const auto &error, const auto &expires) {
-                                    if (Q_UNLIKELY(!error.isEmpty()))
-                                    {
-                                        callback({}, error, expires);
-                                        return;
-                                    }
-
-                                    const auto corpDataObj = corpData.object();
-
-                                    Character character{charId};
-                                    character.setName(publicDataObj.value(QStringLiteral("name")).toString());
-                                    character.setCorporationName(corpDataObj.value(QStringLiteral("name")).toString());
-                                    character.setCorporationId(publicDataObj.value(QStringLiteral("corporation_id")).toDouble());
-                                    character.setRace(mDataProvider.getRaceName(publicDataObj.value(QStringLiteral("race_id")).toDouble()));
-                                    character.setBloodline(mDataProvider.getBloodlineName(publicDataObj.value(QStringLiteral("bloodline_id")).toDouble()));
-                                    character.setAncestry(mDataProvider.getAncestryName(publicDataObj.value(QStringLiteral("ancestry_id")).toDouble()));
-                                    character.setGender(publicDataObj.value(QStringLiteral("gender")).toString());
-                                    character.setISK(walletData.toDouble());
-
-                                    CharacterData::OrderAmountSkills orderAmountSkills;
-                                    CharacterData::TradeRangeSkills tradeRangeSkills;
-                                    CharacterData::FeeSkills feeSkills;
-                                    CharacterData::ContractSkills contractSkills;
-                                    CharacterData::ReprocessingSkills reprocessingSkills;
-                                    CharacterData::IndustrySkills industrySkills;
-
-                                    const auto skillLevelProperty = QStringLiteral("active_skill_level");
-
-                                    const auto skills = skillData.object().value(QStringLiteral("skills")).toArray();
-                                    for (const auto &skill : skills)
-                                    {
-                                        const auto skillObj = skill.toObject();
-                                        switch (skillObj.value(QStringLiteral("skill_id")).toInt()) {
-                                        case 3443:
-                                            orderAmountSkills.mTrade = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3444:
-                                            orderAmountSkills.mRetail = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16596:
-                                            orderAmountSkills.mWholesale = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 18580:
-                                            orderAmountSkills.mTycoon = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16598:
-                                            tradeRangeSkills.mMarketing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16594:
-                                            tradeRangeSkills.mProcurement = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16595:
-                                            tradeRangeSkills.mDaytrading = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3447:
-                                            tradeRangeSkills.mVisibility = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16622:
-                                            feeSkills.mAccounting = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3446:
-                                            feeSkills.mBrokerRelations = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 16597:
-                                            feeSkills.mMarginTrading = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 25235:
-                                            contractSkills.mContracting = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12180:
-                                            reprocessingSkills.mArkonorProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12181:
-                                            reprocessingSkills.mBistotProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12182:
-                                            reprocessingSkills.mCrokiteProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12183:
-                                            reprocessingSkills.mDarkOchreProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12185:
-                                            reprocessingSkills.mHedbergiteProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12186:
-                                            reprocessingSkills.mHemorphiteProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 18025:
-                                            reprocessingSkills.mIceProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12187:
-                                            reprocessingSkills.mJaspetProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12188:
-                                            reprocessingSkills.mKerniteProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12189:
-                                            reprocessingSkills.mMercoxitProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12190:
-                                            reprocessingSkills.mOmberProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12191:
-                                            reprocessingSkills.mPlagioclaseProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12192:
-                                            reprocessingSkills.mPyroxeresProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3385:
-                                            reprocessingSkills.mReprocessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3389:
-                                            reprocessingSkills.mReprocessingEfficiency = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12193:
-                                            reprocessingSkills.mScorditeProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12196:
-                                            reprocessingSkills.mScrapmetalProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12194:
-                                            reprocessingSkills.mSpodumainProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 12195:
-                                            reprocessingSkills.mVeldsparProcessing = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3380:
-                                            industrySkills.mIndustry = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3388:
-                                            industrySkills.mAdvancedIndustry = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3398:
-                                            industrySkills.mAdvancedLargeShipConstruction = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3397:
-                                            industrySkills.mAdvancedMediumShipConstruction = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3395:
-                                            industrySkills.mAdvancedSmallShipConstruction = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11444:
-                                            industrySkills.mAmarrStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 3396:
-                                            industrySkills.mAvancedIndustrialShipConstruction = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11454:
-                                            industrySkills.mCaldariStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11448:
-                                            industrySkills.mElectromagneticPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11453:
-                                            industrySkills.mElectronicEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11450:
-                                            industrySkills.mGallenteStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11446:
-                                            industrySkills.mGravitonPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11433:
-                                            industrySkills.mHighEnergyPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11443:
-                                            industrySkills.mHydromagneticPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11447:
-                                            industrySkills.mLaserPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11452:
-                                            industrySkills.mMechanicalEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11445:
-                                            industrySkills.mMinmatarStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11529:
-                                            industrySkills.mMolecularEngineering = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11451:
-                                            industrySkills.mNuclearPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11441:
-                                            industrySkills.mPlasmaPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11455:
-                                            industrySkills.mQuantumPhysics = skillObj.value(skillLevelProperty).toInt();
-                                            break;
-                                        case 11449:
-                                            industrySkills.mRocketScience = skillObj.value(skillLevelProperty).toInt();
-                                        }
-                                    }
-
-                                    character.setOrderAmountSkills(std::move(orderAmountSkills));
-                                    character.setTradeRangeSkills(std::move(tradeRangeSkills));
-                                    character.setFeeSkills(std::move(feeSkills));
-                                    character.setContractSkills(std::move(contractSkills));
-                                    character.setReprocessingSkills(std::move(reprocessingSkills));
-                                    character.setIndustrySkills(std::move(industrySkills));
-
-                                    callback(std::move(character), {}, expires);
-                            });
-                    });
-            });
+                    state->mCorpData = corpData.object();
+                    finish();
+                });
+        });
+        getInterface().fetchCharacterSkills(charId, [=](auto &&skillData, const auto &error, const auto &expires) {
+            if (Q_UNLIKELY(!error.isEmpty()))
+            {
+                fail(error, expires);
+                return;
+            }
+
+            state->mSkillData = std::move(skillData);
+            finish();
+        });
+        getInterface().fetchCharacterWallet(charId, [=](auto &&walletData, const auto &error, const auto &expires) {
+            if (Q_UNLIKELY(!error.isEmpty()))
+            {
+                fail(error, expires);
+                return;
+            }
+
+            state->mWallet = std::move(walletData);
+            state->mExpires = expires;
+            finish();
         });
     }
 
@@ -572,12 +411,15 @@ namespace Evernus
             std::unordered_map<quint64, QString> mResult;
             QString mError;
             bool mEmittedError = false;
+            std::size_t mRemainingRequests = 0;
         };
 
         auto state = std::make_shared<SharedState>();
+        state->mRemainingRequests = (ids.size() + maxPerRequest - 1) / maxPerRequest;
+
         auto current = 0u;
 
-        const auto transformCallback = [=, totalSize = ids.size()](auto &&data, const auto &error) {
+        const auto transformCallback = [=](auto &&data, const auto &error) {
             if (state->mError.isEmpty() && !error.isEmpty())
                 state->mError = error;
 
@@ -601,7 +443,8 @@ namespace Evernus
                 return std::make_pair(static_cast<quint64>(nameObj.value(QStringLiteral("id")).toDouble()), nameObj.value(QStringLiteral("name")).toString());
             });
 
-            if (state->mResult.size() == totalSize)
+            // ids which cannot be resolved are simply missing from the response
+            if (--state->mRemainingRequests == 0)
                 callback(std::move(state->mResult), {});
         };
 
@@ -613,7 +456,7 @@ namespace Evernus
             );
         }
 
-        if (current < ids.size())
+        if (current * maxPerRequest < ids.size())
             getInterface().fetchGenericNames(std::vector<quint64>(std::begin(ids) + current * maxPerRequest, std::end(ids)), transformCallback);
     }
 
@@ -812,41 +655,205 @@ namespace Evernus
         );
     }
 
-    ExternalOrder ESIManager::getExternalOrderFromJson(const QJsonObject &object, uint regionId, const QDateTime &updateTime) const
+    Character ESIManager::getCharacterFromJson(Character::IdType charId,
+                                               const QJsonObject &publicDataObj,
+                                               const QJsonObject &corpDataObj,
+                                               const QJsonDocument &skillData,
+                                               const QString &walletData) const
     {
-        const auto range = object.value(QStringLiteral("range")).toString();
-
-        ExternalOrder order;
-
-        order.setId(object.value(QStringLiteral("order_id")).toDouble()); // https://bugreports.qt.io/browse/QTBUG-28560
-        order.setType((object.value(QStringLiteral("is_buy_order")).toBool()) ? (ExternalOrder::Type::Buy) : (ExternalOrder::Type::Sell));
-        order.setTypeId(object.value(QStringLiteral("type_id")).toDouble());
-        order.setStationId(object.value(QStringLiteral("location_id")).toDouble());
-        order.setRegionId(regionId);
-
-        if (object.contains(QStringLiteral("system_id")))
-            order.setSolarSystemId(object.value(QStringLiteral("system_id")).toDouble());
-        else
-            order.setSolarSystemId(mDataProvider.getStationSolarSystemId(order.getStationId()));
-
-        if (range == "station")
-            order.setRange(ExternalOrder::rangeStation);
-        else if (range == "system")
-            order.setRange(ExternalOrder::rangeSystem);
-        else if (range == "region")
-            order.setRange(ExternalOrder::rangeRegion);
-        else
-            order.setRange(range.toShort());
-
-        order.setUpdateTime(updateTime);
-        order.setPrice(object.value(QStringLiteral("price")).toDouble());
-        order.setVolumeEntered(object.value(QStringLiteral("volume_total")).toInt());
-        order.setVolumeRemaining(object.value(QStringLiteral("volume_remain")).toInt());
-        order.setMinVolume(object.value(QStringLiteral("min_volume")).toInt());
-        order.setIssued(getDateTimeFromString(object.value(QStringLiteral("issued")).toString()));
-        order.setDuration(object.value(QStringLiteral("duration")).toInt());
-
-        return order;
+        Character character{charId};
+        character.setName(publicDataObj.value(QStringLiteral("name")).toString());
+        character.setCorporationName(corpDataObj.value(QStringLiteral("name")).toString());
+        character.setCorporationId(publicDataObj.value(QStringLiteral("corporation_id")).toDouble());
+        character.setRace(mDataProvider.getRaceName(publicDataObj.value(QStringLiteral("race_id")).toDouble()));
+        character.setBloodline(mDataProvider.getBloodlineName(publicDataObj.value(QStringLiteral("bloodline_id")).toDouble()));
+        character.setAncestry(mDataProvider.getAncestryName(publicDataObj.value(QStringLiteral("ancestry_id")).toDouble()));
+        character.setGender(publicDataObj.value(QStringLiteral("gender")).toString());
+        character.setISK(walletData.toDouble());
+
+        CharacterData::OrderAmountSkills orderAmountSkills;
+        CharacterData::TradeRangeSkills tradeRangeSkills;
+        CharacterData::FeeSkills feeSkills;
+        CharacterData::ContractSkills contractSkills;
+        CharacterData::ReprocessingSkills reprocessingSkills;
+        CharacterData::IndustrySkills industrySkills;
+
+        const auto skillLevelProperty = QStringLiteral("active_skill_level");
+
+        const auto skills = skillData.object().value(QStringLiteral("skills")).toArray();
+        for (const auto &skill : skills)
+        {
+            const auto skillObj = skill.toObject();
+            switch (skillObj.value(QStringLiteral("skill_id")).toInt()) {
+            case 3443:
+                orderAmountSkills.mTrade = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3444:
+                orderAmountSkills.mRetail = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16596:
+                orderAmountSkills.mWholesale = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 18580:
+                orderAmountSkills.mTycoon = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16598:
+                tradeRangeSkills.mMarketing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16594:
+                tradeRangeSkills.mProcurement = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16595:
+                tradeRangeSkills.mDaytrading = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3447:
+                tradeRangeSkills.mVisibility = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16622:
+                feeSkills.mAccounting = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3446:
+                feeSkills.mBrokerRelations = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 16597:
+                feeSkills.mMarginTrading = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 25235:
+                contractSkills.mContracting = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12180:
+                reprocessingSkills.mArkonorProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12181:
+                reprocessingSkills.mBistotProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12182:
+                reprocessingSkills.mCrokiteProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12183:
+                reprocessingSkills.mDarkOchreProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12185:
+                reprocessingSkills.mHedbergiteProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12186:
+                reprocessingSkills.mHemorphiteProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 18025:
+                reprocessingSkills.mIceProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12187:
+                reprocessingSkills.mJaspetProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12188:
+                reprocessingSkills.mKerniteProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12189:
+                reprocessingSkills.mMercoxitProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12190:
+                reprocessingSkills.mOmberProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12191:
+                reprocessingSkills.mPlagioclaseProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12192:
+                reprocessingSkills.mPyroxeresProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3385:
+                reprocessingSkills.mReprocessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3389:
+                reprocessingSkills.mReprocessingEfficiency = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12193:
+                reprocessingSkills.mScorditeProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12196:
+                reprocessingSkills.mScrapmetalProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12194:
+                reprocessingSkills.mSpodumainProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 12195:
+                reprocessingSkills.mVeldsparProcessing = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3380:
+                industrySkills.mIndustry = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3388:
+                industrySkills.mAdvancedIndustry = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3398:
+                industrySkills.mAdvancedLargeShipConstruction = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3397:
+                industrySkills.mAdvancedMediumShipConstruction = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3395:
+                industrySkills.mAdvancedSmallShipConstruction = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11444:
+                industrySkills.mAmarrStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 3396:
+                industrySkills.mAvancedIndustrialShipConstruction = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11454:
+                industrySkills.mCaldariStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11448:
+                industrySkills.mElectromagneticPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11453:
+                industrySkills.mElectronicEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11450:
+                industrySkills.mGallenteStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11446:
+                industrySkills.mGravitonPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11433:
+                industrySkills.mHighEnergyPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11443:
+                industrySkills.mHydromagneticPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11447:
+                industrySkills.mLaserPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11452:
+                industrySkills.mMechanicalEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11445:
+                industrySkills.mMinmatarStarshipEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11529:
+                industrySkills.mMolecularEngineering = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11451:
+                industrySkills.mNuclearPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11441:
+                industrySkills.mPlasmaPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11455:
+                industrySkills.mQuantumPhysics = skillObj.value(skillLevelProperty).toInt();
+                break;
+            case 11449:
+                industrySkills.mRocketScience = skillObj.value(skillLevelProperty).toInt();
+            }
+        }
+
+        character.setOrderAmountSkills(std::move(orderAmountSkills));
+        character.setTradeRangeSkills(std::move(tradeRangeSkills));
+        character.setFeeSkills(std::move(feeSkills));
+        character.setContractSkills(std::move(contractSkills));
+        character.setReprocessingSkills(std::move(reprocessingSkills));
+        character.setIndustrySkills(std::move(industrySkills));
+
+        return character;
     }
 
     ESIInterface::PaginatedCallback ESIManager::getMarketOrderCallback(uint regionId, const MarketOrderCallback &callback) const
@@ -868,7 +875,11 @@ namespace Evernus
             std::atomic_size_t nextIndex{curSize};
 
             const auto parseItem = [&](const auto &item) {
-                (*orders)[nextIndex++] = getExternalOrderFromJson(item.toObject(), regionId, updateTime);
+                auto order = ESIJsonUtils::getExternalOrderFromJson(item.toObject(), regionId, updateTime);
+                if (order.getSolarSystemId() == 0)
+                    order.setSolarSystemId(mDataProvider.getStationSolarSystemId(order.getStationId()));
+
+                (*orders)[nextIndex++] = std::move(order);
             };
 
             QtConcurrent::blockingMap(items, parseItem);
@@ -894,7 +905,7 @@ namespace Evernus
             QtConcurrent::blockingMap(orderArray, [&, charId](const auto &order) {
                 const auto orderObj = order.toObject();
 
-                const auto issued = getDateTimeFromString(orderObj.value("issued").toString());
+                const auto issued = ESIJsonUtils::getDateTimeFromString(orderObj.value("issued").toString());
 
                 auto &curOrder = orders[index++];
                 curOrder.setId(orderObj.value(QStringLiteral("order_id")).toDouble());
@@ -905,7 +916,7 @@ namespace Evernus
                 curOrder.setMinVolume(orderObj.value(QStringLiteral("min_volume")).toDouble());
                 curOrder.setState(MarketOrder::State::Active);  // ESI returns only open orders
                 curOrder.setTypeId(orderObj.value(QStringLiteral("type_id")).toDouble());
-                curOrder.setRange(getMarketOrderRangeFromString(orderObj.value(QStringLiteral("range")).toString()));
+                curOrder.setRange(ESIJsonUtils::getMarketOrderRangeFromString(orderObj.value(QStringLiteral("range")).toString()));
                 curOrder.setDuration(orderObj.value(QStringLiteral("duration")).toInt());
                 curOrder.setEscrow(orderObj.value(QStringLiteral("escrow")).toDouble());
                 curOrder.setPrice(orderObj.value(QStringLiteral("price")).toDouble());
@@ -922,62 +933,97 @@ namespace Evernus
     {
         struct AssetProcessingData
         {
-            std::vector<AssetList::ItemType> mAllItems;
-            std::unordered_map<Item::IdType, Item *> mItemMap;
-        };
+            std::vector<QFuture<AssetList::ItemList>> mPages;
+            std::size_t mNextPage = 0;
 
-        auto allItems = std::make_shared<AssetProcessingData>();
-        return [=, allItems = std::move(allItems)](auto &&data, auto atEnd, const auto &error, const auto &expires) {
-            if (Q_UNLIKELY(!error.isEmpty()))
+            AssetList::ItemList mAllItems;
+            std::unordered_set<Item::IdType> mItemIds;
+
+            void takePage(AssetList::ItemList &&items)
             {
-                callback({}, error, expires);
-                return;
+                mAllItems.reserve(mAllItems.size() + items.size());
+                mItemIds.reserve(mItemIds.size() + items.size());
+
+                for (auto &item : items)
+                {
+                    mItemIds.emplace(item.getId());
+                    mAllItems.emplace_back(std::move(item));
+                }
             }
 
-            const auto assets = data.array();
+            // takes parsed pages in order, without waiting for ones still in progress
+            void takeFinishedPages()
+            {
+                while (mNextPage < mPages.size() && mPages[mNextPage].isFinished())
+                    takePage(mPages[mNextPage++].result());
+            }
 
-            allItems->mAllItems.reserve(allItems->mAllItems.size() + assets.size());
-            allItems->mItemMap.reserve(allItems->mItemMap.size() + assets.size());
+            void takeAllPages()
+            {
+                while (mNextPage < mPages.size())
+                    takePage(mPages[mNextPage++].result());
+            }
+        };
+
+        const auto parsePage = [](const QJsonArray &assets) {
+            AssetList::ItemList items;
+            items.reserve(assets.size());
 
             for (const auto &itemObj : assets)
             {
                 const auto item = itemObj.toObject();
                 const int rawQuantity = item.value(QStringLiteral("quantity")).toDouble();
 
-                auto newItem = std::make_unique<Item>(static_cast<Item::IdType>(item.value(QStringLiteral("item_id")).toDouble()));
-                newItem->setLocationId(item.value(QStringLiteral("location_id")).toDouble());
-                newItem->setTypeId(item.value(QStringLiteral("type_id")).toDouble());
-                newItem->setRawQuantity(rawQuantity);
-                newItem->setBPCFlag(item.value(QStringLiteral("is_blueprint_copy")).toBool());
+                Item newItem{static_cast<Item::IdType>(item.value(QStringLiteral("item_id")).toDouble())};
+                newItem.setLocationId(item.value(QStringLiteral("location_id")).toDouble());
+                newItem.setTypeId(item.value(QStringLiteral("type_id")).toDouble());
+                newItem.setRawQuantity(rawQuantity);
+                newItem.setBPCFlag(item.value(QStringLiteral("is_blueprint_copy")).toBool());
                 // https://forums.eveonline.com/t/esi-assets-blueprints-and-quantities/19345/4
-                newItem->setQuantity((rawQuantity < 0) ? (1) : (rawQuantity));
+                newItem.setQuantity((rawQuantity < 0) ? (1) : (rawQuantity));
 
-                allItems->mItemMap.emplace(newItem->getId(), newItem.get());
-                allItems->mAllItems.emplace_back(std::move(newItem));
+                items.emplace_back(std::move(newItem));
             }
 
-            if (atEnd)
+            return items;
+        };
+
+        auto allItems = std::make_shared<AssetProcessingData>();
+        return [=, allItems = std::move(allItems)](auto &&data, auto atEnd, const auto &error, const auto &expires) {
+            if (Q_UNLIKELY(!error.isEmpty()))
             {
-                AssetList list;
-                list.setCharacterId(charId);
+                callback({}, error, expires);
+                return;
+            }
+
+            // parse pages on workers as they arrive, so parsing overlaps waiting for the next ones
+            allItems->mPages.emplace_back(QtConcurrent::run([=, assets = data.array()] {
+                return parsePage(assets);
+            }));
 
-                // make tree
-                for (auto &item : allItems->mAllItems)
+            if (!atEnd)
+            {
+                allItems->takeFinishedPages();
+                return;
+            }
+
+            allItems->takeAllPages();
+
+            // make tree - items located in other items become their children
+            const auto &itemIds = allItems->mItemIds;
+            QtConcurrent::blockingMap(allItems->mAllItems, [&](auto &item) {
+                const auto locationId = item.getLocationId();
+                if (locationId && itemIds.find(*locationId) != std::end(itemIds))
                 {
-                    const auto parent = allItems->mItemMap.find(*item->getLocationId());
-                    if (parent != std::end(allItems->mItemMap))
-                    {
-                        item->setLocationId({});
-                        parent->second->addItem(std::move(item));
-                    }
-                    else
-                    {
-                        list.addItem(std::move(item));
-                    }
+                    item.setParentId(*locationId);
+                    item.setLocationId({});
                 }
+            });
 
-                callback(std::move(list), {}, expires);
-            }
+            AssetList list{std::move(allItems->mAllItems)};
+            list.setCharacterId(charId);
+
+            callback(std::move(list), {}, expires);
         };
     }
 
@@ -1013,8 +1059,8 @@ namespace Evernus
                 curContract.setTitle(contractObj.value(QStringLiteral("title")).toString());
                 curContract.setForCorp(contractObj.value(QStringLiteral("for_corporation")).toBool());
                 curContract.setAvailability(getContractAvailabilityFromString(contractObj.value(QStringLiteral("availability")).toString()));
-                curContract.setIssued(getDateTimeFromString(contractObj.value(QStringLiteral("date_issued")).toString()));
-                curContract.setExpired(getDateTimeFromString(contractObj.value(QStringLiteral("date_expired")).toString()));
+                curContract.setIssued(ESIJsonUtils::getDateTimeFromString(contractObj.value(QStringLiteral("date_issued")).toString()));
+                curContract.setExpired(ESIJsonUtils::getDateTimeFromString(contractObj.value(QStringLiteral("date_expired")).toString()));
                 curContract.setNumDays(contractObj.value(QStringLiteral("days_to_complete")).toDouble());
                 curContract.setPrice(contractObj.value(QStringLiteral("price")).toDouble());
                 curContract.setReward(contractObj.value(QStringLiteral("reward")).toDouble());
@@ -1023,9 +1069,9 @@ namespace Evernus
                 curContract.setVolume(contractObj.value(QStringLiteral("volume")).toDouble());
 
                 if (contractObj.contains(QStringLiteral("date_accepted")))
-                    curContract.setAccepted(getDateTimeFromString(contractObj.value(QStringLiteral("date_accepted")).toString()));
+                    curContract.setAccepted(ESIJsonUtils::getDateTimeFromString(contractObj.value(QStringLiteral("date_accepted")).toString()));
                 if (contractObj.contains(QStringLiteral("date_completed")))
-                    curContract.setCompleted(getDateTimeFromString(contractObj.value(QStringLiteral("date_completed")).toString()));
+                    curContract.setCompleted(ESIJsonUtils::getDateTimeFromString(contractObj.value(QStringLiteral("date_completed")).toString()));
             });
 
             callback(std::move(result), {}, expires);
@@ -1084,35 +1130,10 @@ namespace Evernus
                 [&](const auto &value) {
                     const auto entryObj = value.toObject();
 
-                    WalletJournalEntry entry{static_cast<WalletJournalEntry::IdType>(entryObj.value(QStringLiteral("id")).toDouble())};
-
-                    const auto id = entry.getId();
+                    const auto id = static_cast<WalletJournalEntry::IdType>(entryObj.value(QStringLiteral("id")).toDouble());
                     if (id > tillId)
                     {
-                        entry.setCharacterId(charId);
-                        entry.setCorporationId(corpId);
-                        entry.setTimestamp(getDateTimeFromString(entryObj.value(QStringLiteral("date")).toString()));
-                        entry.setRefType(entryObj.value(QStringLiteral("ref_type")).toString());
-
-                        if (entryObj.contains(QStringLiteral("first_party_id")))
-                            entry.setFirstPartyId(entryObj.value(QStringLiteral("first_party_id")).toDouble());
-                        if (entryObj.contains(QStringLiteral("second_party_id")))
-                            entry.setSecondPartyId(entryObj.value(QStringLiteral("second_party_id")).toDouble());
-
-                        entry.setReason(entryObj.value(QStringLiteral("reason")).toString());
-
-                        if (entryObj.contains(QStringLiteral("amount")))
-                            entry.setAmount(entryObj.value(QStringLiteral("amount")).toDouble());
-                        if (entryObj.contains(QStringLiteral("balance")))
-                            entry.setBalance(entryObj.value(QStringLiteral("balance")).toDouble());
-                        if (entryObj.contains(QStringLiteral("tax_reciever_id")))
-                            entry.setTaxReceiverId(entryObj.value(QStringLiteral("tax_reciever_id")).toDouble());
-                        if (entryObj.contains(QStringLiteral("tax")))
-                            entry.setTaxAmount(entryObj.value(QStringLiteral("tax")).toDouble());
-                        if (entryObj.contains(QStringLiteral("context_id")))
-                            entry.setContextId(entryObj.value(QStringLiteral("context_id")).toDouble());
-                        if (entryObj.contains(QStringLiteral("context_id_type")))
-                            entry.setContextIdType(entryObj.value(QStringLiteral("context_id_type")).toString());
+                        auto entry = ESIJsonUtils::getWalletJournalEntryFromJson(entryObj, charId, corpId);
 
                         std::lock_guard<std::mutex> lock{resultMutex};
                         journal->emplace(std::move(entry));
@@ -1161,7 +1182,7 @@ namespace Evernus
                     {
                         transaction.setCharacterId(charId);
                         transaction.setCorporationId(corpId);
-                        transaction.setTimestamp(getDateTimeFromString(transactionObj.value(QStringLiteral("date")).toString()));
+                        transaction.setTimestamp(ESIJsonUtils::getDateTimeFromString(transactionObj.value(QStringLiteral("date")).toString()));
                         transaction.setQuantity(transactionObj.value(QStringLiteral("quantity")).toDouble());
                         transaction.setTypeId(transactionObj.value(QStringLiteral("type_id")).toDouble());
                         transaction.setPrice(transactionObj.value(QStringLiteral("unit_price")).toDouble());
@@ -1317,29 +1338,6 @@ namespace Evernus
         return mInterfaceManager.getInterface();
     }
 
-    short ESIManager::getMarketOrderRangeFromString(const QString &range)
-    {
-        static const QHash<QString, short> ranges = {
-            { QStringLiteral("station"), MarketOrder::rangeStation },
-            { QStringLiteral("region"), MarketOrder::rangeRegion },
-            { QStringLiteral("solarsystem"), MarketOrder::rangeSystem },
-        };
-
-        // assume unknown is active, since there shouldn't be non-open orders returned anyway
-        return (ranges.contains(range)) ? (ranges[range]) : (range.toShort());
-    }
-
-    QDateTime ESIManager::getDateTimeFromString(const QString &value)
-    {
-        auto dt = QDateTime::fromString(value, Qt::ISODate);
-        if (Q_UNLIKELY(!dt.isValid()))
-            dt = QDateTime::currentDateTimeUtc();   // just to be safe
-        else
-            dt.setTimeSpec(Qt::UTC);
-
-        return dt;
-    }
-
     Contract::Type ESIManager::getContractTypeFromString(const QString &type)
     {
         if (type == "item_exchange")
@@ -42,6 +42,7 @@
 #include "Contract.h"
 #include "EveType.h"
 
+class QJsonDocument;
 class QJsonObject;
 class QDateTime;
 
@@ -169,7 +170,11 @@ namespace Evernus
                                                 std::shared_ptr<WalletTransactions> &&transactions,
                                                 const WalletTransactionsCallback &callback) const;
 
-        ExternalOrder getExternalOrderFromJson(const QJsonObject &object, uint regionId, const QDateTime &updateTime) const;
+        Character getCharacterFromJson(Character::IdType charId,
+                                       const QJsonObject &publicDataObj,
+                                       const QJsonObject &corpDataObj,
+                                       const QJsonDocument &skillData,
+                                       const QString &walletData) const;
         ESIInterface::PaginatedCallback getMarketOrderCallback(uint regionId, const MarketOrderCallback &callback) const;
         ESIInterface::JsonCallback getMarketOrdersCallback(Character::IdType charId, const MarketOrdersCallback &callback) const;
         ESIInterface::PaginatedCallback getAssetListCallback(Character::IdType charId, const AssetCallback &callback) const;
@@ -193,9 +198,6 @@ namespace Evernus
 
         const ESIInterface &getInterface() const;
 
-        static short getMarketOrderRangeFromString(const QString &range);
-        static QDateTime getDateTimeFromString(const QString &value);
-
         static Contract::Type getContractTypeFromString(const QString &type);
         static Contract::Status getContractStatusFromString(const QString &status);
         static Contract::Availability getContractAvailabilityFromString(const QString &availability);
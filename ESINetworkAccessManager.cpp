@@ -12,9 +12,11 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <QNetworkReply>
 #include <QSettings>
 
 #include "NetworkSettings.h"
+#include "ESIReplyArchive.h"
 #include "ReplyTimeout.h"
 
 #include "ESINetworkAccessManager.h"
@@ -39,9 +41,23 @@ namespace Evernus
         if (!request.hasRawHeader(QByteArrayLiteral("Authorization")))
             request.setRawHeader(QByteArrayLiteral("Authorization"), mAutorization);
 
+        const auto recording = ESIReplyArchive::isRecording();
+
+        QByteArray requestBody;
+        if (recording && outgoingData != nullptr && !outgoingData->isSequential())
+            requestBody = outgoingData->peek(outgoingData->size());
+
         const auto reply = QNetworkAccessManager::createRequest(op, request, outgoingData);
         new ReplyTimeout{*reply};
 
+        // connected before anyone else gets the reply, so the whole body is still available
+        if (recording)
+        {
+            connect(reply, &QNetworkReply::finished, reply, [=] {
+                ESIReplyArchive::record(*reply, requestBody);
+            });
+        }
+
         return reply;
     }
 }
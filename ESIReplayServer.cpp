@@ -0,0 +1,289 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <random>
+
+#include <QtDebug>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHostAddress>
+#include <QDateTime>
+#include <QLocale>
+#include <QTimer>
+#include <QHash>
+#include <QUrl>
+
+#include "ESIReplyArchive.h"
+
+#include "qxthttpserverconnector.h"
+#include "qxtabstractwebservice.h"
+#include "qxtwebcontent.h"
+#include "qxtwebevent.h"
+
+#include "ESIReplayServer.h"
+
+namespace Evernus
+{
+    class ESIReplayServer::ReplayWebService
+        : public QxtAbstractWebService
+    {
+    public:
+        ReplayWebService(QxtAbstractWebSessionManager *manager,
+                         QString archivePath,
+                         std::chrono::milliseconds latency,
+                         double errorRate,
+                         uint pageSize,
+                         QObject *parent)
+            : QxtAbstractWebService{manager, parent}
+            , mArchivePath{std::move(archivePath)}
+            , mLatency{latency}
+            , mPageSize{pageSize}
+            , mErrorDistribution{std::clamp(errorRate, 0., 1.)}
+        {
+        }
+
+        virtual ~ReplayWebService() = default;
+
+        virtual void pageRequestedEvent(QxtWebRequestEvent *event) override
+        {
+            Q_ASSERT(event != nullptr);
+
+            QByteArray body;
+            if (event->content != nullptr)
+            {
+                event->content->waitForAllContent();
+                body = event->content->readAll();
+            }
+
+            const auto response = createResponse(event->sessionID, event->requestID, event->method.toLatin1(), event->url, body);
+            if (mLatency.count() > 0)
+                QTimer::singleShot(mLatency, this, [=] { postEvent(response); });
+            else
+                postEvent(response);
+        }
+
+    private:
+        struct PaginatedData
+        {
+            ESIReplyArchive::Entry mFirstPage;
+            QJsonArray mItems;
+        };
+
+        static const auto injectedErrorResetSeconds = 1;
+
+        QString mArchivePath;
+        std::chrono::milliseconds mLatency;
+        uint mPageSize = 0;
+
+        // fixed seed, so runs are reproducible
+        std::mt19937 mRandom;
+        std::bernoulli_distribution mErrorDistribution;
+        std::bernoulli_distribution mErrorKindDistribution;
+
+        QHash<QString, PaginatedData> mPaginatedData;
+
+        QxtWebPageEvent *createResponse(int sessionId, int requestId, const QByteArray &method, const QUrl &url, const QByteArray &body)
+        {
+            if (mErrorDistribution(mRandom))
+                return createInjectedError(sessionId, requestId);
+
+            const auto key = ESIReplyArchive::getRequestKey(method, url, body);
+            const auto page = ESIReplyArchive::getPage(url);
+
+            auto pageCount = 0u;
+            auto entry = (mPageSize > 0 && method == "GET") ? (getRepaginatedEntry(key, page, pageCount)) : (ESIReplyArchive::load(mArchivePath, key, page));
+            if (!entry)
+            {
+                qWarning() << "ESI replay miss:" << key << "page" << page;
+                return createJsonResponse(sessionId, requestId, 404, QByteArrayLiteral("Not Found"), QStringLiteral("Not found in replay archive"));
+            }
+
+            const auto response = new QxtWebPageEvent{sessionId, requestId, entry->mBody};
+            response->status = entry->mStatus;
+            response->statusMessage = getStatusMessage(entry->mStatus);
+
+            // shift cache times as if the responses were fresh
+            const auto timeOffset = (entry->mRecorded.isValid()) ? (entry->mRecorded.secsTo(QDateTime::currentDateTimeUtc())) : (0);
+
+            for (const auto &header : entry->mHeaders)
+            {
+                const auto name = header.first.toLower();
+                auto value = header.second;
+
+                if (name == "content-type")
+                {
+                    response->contentType = value;
+                    continue;
+                }
+
+                if (name == "x-pages" && pageCount > 0)
+                {
+                    value = QByteArray::number(pageCount);
+                }
+                else if (timeOffset != 0 && (name == "expires" || name == "last-modified" || name == "date"))
+                {
+                    const auto time = QDateTime::fromString(QString::fromLatin1(value), Qt::RFC2822Date);
+                    if (time.isValid())
+                        value = QLocale::c().toString(time.toUTC().addSecs(timeOffset), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'")).toLatin1();
+                }
+
+                response->headers.insert(QString::fromLatin1(header.first), QString::fromLatin1(value));
+            }
+
+            return response;
+        }
+
+        // merges all recorded pages and splits them again using configured page size
+        std::optional<ESIReplyArchive::Entry> getRepaginatedEntry(const QString &key, uint page, uint &pageCount)
+        {
+            auto data = mPaginatedData.find(key);
+            if (data == std::end(mPaginatedData))
+            {
+                auto firstPage = ESIReplyArchive::load(mArchivePath, key, 1);
+                if (!firstPage)
+                    return std::nullopt;
+
+                const auto isPaginated = std::any_of(std::begin(firstPage->mHeaders), std::end(firstPage->mHeaders), [](const auto &header) {
+                    return header.first.toLower() == "x-pages";
+                });
+                if (!isPaginated)
+                {
+                    if (page != 1)
+                        return std::nullopt;
+
+                    return firstPage;
+                }
+
+                auto items = QJsonDocument::fromJson(firstPage->mBody).array();
+                for (auto nextPage = 2u; ; ++nextPage)
+                {
+                    const auto entry = ESIReplyArchive::load(mArchivePath, key, nextPage);
+                    if (!entry)
+                        break;
+
+                    const auto pageItems = QJsonDocument::fromJson(entry->mBody).array();
+                    for (const auto &item : pageItems)
+                        items.append(item);
+                }
+
+                data = mPaginatedData.insert(key, PaginatedData{std::move(*firstPage), std::move(items)});
+            }
+
+            const auto itemCount = static_cast<uint>(data->mItems.size());
+
+            pageCount = std::max((itemCount + mPageSize - 1) / mPageSize, 1u);
+            if (page > pageCount)
+                return std::nullopt;
+
+            QJsonArray pageItems;
+
+            const auto end = std::min(page * mPageSize, itemCount);
+            for (auto i = (page - 1) * mPageSize; i < end; ++i)
+                pageItems.append(data->mItems.at(static_cast<int>(i)));
+
+            auto entry = data->mFirstPage;
+            entry.mPage = page;
+            entry.mBody = QJsonDocument{pageItems}.toJson(QJsonDocument::Compact);
+
+            return entry;
+        }
+
+        QxtWebPageEvent *createInjectedError(int sessionId, int requestId)
+        {
+            // emulate both kinds of throttling ESI can respond with
+            if (mErrorKindDistribution(mRandom))
+            {
+                const auto response = createJsonResponse(sessionId,
+                                                         requestId,
+                                                         ESIReplyArchive::errorLimitCode,
+                                                         QByteArrayLiteral("Error Limited"),
+                                                         QStringLiteral("This software has exceeded the error limit for ESI."));
+                response->headers.insert(QStringLiteral("X-Esi-Error-Limit-Remain"), QStringLiteral("0"));
+                response->headers.insert(QStringLiteral("X-Esi-Error-Limit-Reset"), QString::number(injectedErrorResetSeconds));
+
+                return response;
+            }
+
+            const auto response = createJsonResponse(sessionId,
+                                                     requestId,
+                                                     ESIReplyArchive::requestThrottledCode,
+                                                     QByteArrayLiteral("Too Many Requests"),
+                                                     QStringLiteral("Too many requests."));
+            response->headers.insert(QStringLiteral("Retry-After"), QString::number(injectedErrorResetSeconds));
+
+            return response;
+        }
+
+        static QxtWebPageEvent *createJsonResponse(int sessionId, int requestId, int status, const QByteArray &statusMessage, const QString &error)
+        {
+            const auto response = new QxtWebPageEvent{
+                sessionId,
+                requestId,
+                QJsonDocument{QJsonObject{{ QStringLiteral("error"), error }}}.toJson(QJsonDocument::Compact)
+            };
+            response->status = status;
+            response->statusMessage = statusMessage;
+            response->contentType = QByteArrayLiteral("application/json; charset=UTF-8");
+
+            return response;
+        }
+
+        static QByteArray getStatusMessage(int status)
+        {
+            switch (status) {
+            case 200:
+                return QByteArrayLiteral("OK");
+            case 204:
+                return QByteArrayLiteral("No Content");
+            case 304:
+                return QByteArrayLiteral("Not Modified");
+            case 400:
+                return QByteArrayLiteral("Bad Request");
+            case 403:
+                return QByteArrayLiteral("Forbidden");
+            case 404:
+                return QByteArrayLiteral("Not Found");
+            default:
+                return (status >= 500) ? (QByteArrayLiteral("Server Error")) : (QByteArrayLiteral("Replayed"));
+            }
+        }
+    };
+
+    ESIReplayServer::ESIReplayServer(QString archivePath,
+                                     std::chrono::milliseconds latency,
+                                     double errorRate,
+                                     uint pageSize,
+                                     QObject *parent)
+        : QObject{parent}
+        , mServer{this}
+    {
+        qInfo() << "ESI replay from" << archivePath << "latency:" << latency.count() << "ms, error rate:" << errorRate << ", page size:" << pageSize;
+
+        mServer.setListenInterface(QHostAddress::LocalHost);
+        mServer.setAutoCreateSession(false);
+        mServer.setStaticContentService(new ReplayWebService{&mServer, std::move(archivePath), latency, errorRate, pageSize, this});
+        mServer.setConnector(new QxtHttpServerConnector{this});
+    }
+
+    bool ESIReplayServer::start(quint16 port)
+    {
+        mServer.setPort(port);
+        return mServer.start();
+    }
+}
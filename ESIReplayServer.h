@@ -0,0 +1,53 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+
+#include <QObject>
+#include <QString>
+
+#include "qxthttpsessionmanager.h"
+
+namespace Evernus
+{
+    // local stand-in for ESI serving responses recorded by ESIReplyArchive
+    class ESIReplayServer final
+        : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        ESIReplayServer(QString archivePath,
+                        std::chrono::milliseconds latency,
+                        double errorRate,
+                        uint pageSize,
+                        QObject *parent = nullptr);
+        ESIReplayServer(const ESIReplayServer &) = delete;
+        ESIReplayServer(ESIReplayServer &&) = delete;
+        virtual ~ESIReplayServer() = default;
+
+        // invokable, so it can be started in the thread the server lives in
+        Q_INVOKABLE bool start(quint16 port);
+
+        ESIReplayServer &operator =(const ESIReplayServer &) = delete;
+        ESIReplayServer &operator =(ESIReplayServer &&) = delete;
+
+    private:
+        class ReplayWebService;
+
+        QxtHttpSessionManager mServer;
+    };
+}
@@ -0,0 +1,173 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <QtDebug>
+
+#include <QCryptographicHash>
+#include <QNetworkReply>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QUrlQuery>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QUrl>
+
+#include "ESIUrls.h"
+
+#include "ESIReplyArchive.h"
+
+namespace Evernus
+{
+    QString ESIReplyArchive::mRecordingPath;
+
+    QString ESIReplyArchive::getRecordingPath()
+    {
+        return mRecordingPath;
+    }
+
+    void ESIReplyArchive::setRecordingPath(const QString &path)
+    {
+        mRecordingPath = path;
+
+        if (!mRecordingPath.isEmpty() && !QDir{}.mkpath(mRecordingPath))
+            qWarning() << "Cannot create ESI recording directory:" << mRecordingPath;
+    }
+
+    bool ESIReplyArchive::isRecording() noexcept
+    {
+        return !mRecordingPath.isEmpty();
+    }
+
+    void ESIReplyArchive::record(QNetworkReply &reply, const QByteArray &requestBody)
+    {
+        const auto url = reply.request().url();
+
+        // skip SSO and other non-ESI traffic
+        if (url.host() != QUrl{ESIUrls::getEsiUrl()}.host())
+            return;
+
+        const auto status = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // no status means there was no response at all; error limits are injected on replay instead of recorded
+        if (status == 0 || status == errorLimitCode || status == requestThrottledCode)
+            return;
+
+        QByteArray method;
+        switch (reply.operation()) {
+        case QNetworkAccessManager::GetOperation:
+            method = QByteArrayLiteral("GET");
+            break;
+        case QNetworkAccessManager::PostOperation:
+            method = QByteArrayLiteral("POST");
+            break;
+        default:
+            return;
+        }
+
+        QJsonObject headers;
+
+        const auto &pairs = reply.rawHeaderPairs();
+        for (const auto &header : pairs)
+        {
+            // transfer-level headers are regenerated when serving
+            const auto name = header.first.toLower();
+            if (name == "content-length" || name == "content-encoding" || name == "transfer-encoding" || name == "connection" || name == "set-cookie")
+                continue;
+
+            headers[QString::fromLatin1(header.first)] = QString::fromLatin1(header.second);
+        }
+
+        const auto key = getRequestKey(method, url, requestBody);
+        const auto page = getPage(url);
+
+        QJsonObject entry;
+        entry[QStringLiteral("key")] = key;
+        entry[QStringLiteral("page")] = static_cast<int>(page);
+        entry[QStringLiteral("status")] = status;
+        entry[QStringLiteral("recorded")] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        entry[QStringLiteral("headers")] = headers;
+        // peek, so the reply can still be read by its owner
+        entry[QStringLiteral("body")] = QString::fromUtf8(reply.peek(reply.bytesAvailable()));
+
+        QSaveFile file{getFilePath(mRecordingPath, key, page)};
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument{entry}.toJson(QJsonDocument::Compact)) == -1 || !file.commit())
+            qWarning() << "Cannot record ESI reply:" << file.fileName() << file.errorString();
+    }
+
+    std::optional<ESIReplyArchive::Entry> ESIReplyArchive::load(const QString &archivePath, const QString &key, uint page)
+    {
+        QFile file{getFilePath(archivePath, key, page)};
+        if (!file.open(QIODevice::ReadOnly))
+            return std::nullopt;
+
+        const auto object = QJsonDocument::fromJson(file.readAll()).object();
+        if (Q_UNLIKELY(object.isEmpty()))
+        {
+            qWarning() << "Invalid ESI archive entry:" << file.fileName();
+            return std::nullopt;
+        }
+
+        Entry entry;
+        entry.mKey = object.value(QStringLiteral("key")).toString();
+        entry.mPage = page;
+        entry.mStatus = object.value(QStringLiteral("status")).toInt(200);
+        entry.mRecorded = QDateTime::fromString(object.value(QStringLiteral("recorded")).toString(), Qt::ISODate);
+        entry.mBody = object.value(QStringLiteral("body")).toString().toUtf8();
+
+        const auto headers = object.value(QStringLiteral("headers")).toObject();
+        for (auto header = std::begin(headers); header != std::end(headers); ++header)
+            entry.mHeaders.emplace_back(header.key().toLatin1(), header.value().toString().toLatin1());
+
+        return entry;
+    }
+
+    QString ESIReplyArchive::getRequestKey(const QByteArray &method, const QUrl &url, const QByteArray &body)
+    {
+        auto items = QUrlQuery{url}.queryItems(QUrl::FullyDecoded);
+        items.erase(std::remove_if(std::begin(items), std::end(items), [](const auto &item) {
+            return item.first == QStringLiteral("page");
+        }), std::end(items));
+
+        std::sort(std::begin(items), std::end(items));
+
+        QStringList query;
+        for (const auto &item : items)
+            query << item.first + '=' + item.second;
+
+        auto key = QString::fromLatin1(method) + ' ' + url.path() + '?' + query.join('&');
+        if (!body.isEmpty())
+        {
+            // bodies are JSON, so ignore formatting differences
+            const auto document = QJsonDocument::fromJson(body);
+            key += ' ' + QString::fromUtf8((document.isNull()) ? (body) : (document.toJson(QJsonDocument::Compact)));
+        }
+
+        return key;
+    }
+
+    uint ESIReplyArchive::getPage(const QUrl &url)
+    {
+        return std::max(QUrlQuery{url}.queryItemValue(QStringLiteral("page")).toUInt(), 1u);
+    }
+
+    QString ESIReplyArchive::getFilePath(const QString &archivePath, const QString &key, uint page)
+    {
+        const auto hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+        return QDir{archivePath}.filePath(QStringLiteral("%1-%2.json").arg(QString::fromLatin1(hash)).arg(page));
+    }
+}
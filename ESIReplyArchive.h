@@ -0,0 +1,70 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <utility>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+class QNetworkReply;
+class QUrl;
+
+namespace Evernus
+{
+    // on-disk archive of ESI responses, used for offline replay
+    // each response is stored as <sha1 of request key>-<page>.json
+    class ESIReplyArchive final
+    {
+    public:
+        using HeaderList = std::vector<std::pair<QByteArray, QByteArray>>;
+
+        struct Entry
+        {
+            QString mKey;
+            uint mPage = 1;
+            int mStatus = 200;
+            QDateTime mRecorded;
+            HeaderList mHeaders;
+            QByteArray mBody;
+        };
+
+        static const int errorLimitCode = 420;
+        static const int requestThrottledCode = 429;
+
+        ESIReplyArchive() = delete;
+
+        // recording is enabled when the path is not empty; must be set before any requests are made
+        static QString getRecordingPath();
+        static void setRecordingPath(const QString &path);
+        static bool isRecording() noexcept;
+
+        static void record(QNetworkReply &reply, const QByteArray &requestBody);
+
+        static std::optional<Entry> load(const QString &archivePath, const QString &key, uint page);
+
+        // identifies a request regardless of page and parameter order
+        static QString getRequestKey(const QByteArray &method, const QUrl &url, const QByteArray &body);
+        static uint getPage(const QUrl &url);
+
+    private:
+        static QString mRecordingPath;
+
+        static QString getFilePath(const QString &archivePath, const QString &key, uint page);
+    };
+}
@@ -23,5 +23,9 @@ namespace Evernus
         const auto esiUrl = QStringLiteral("https://esi.evetech.net");
         const auto callbackUrl = QStringLiteral("https://evernus.com/sso-authentication-2/");
         const auto verifyUrl = QStringLiteral("https://login.eveonline.com/oauth/verify");
+
+        // base url used for ESI requests - esiUrl unless overridden (must be set before any requests are made)
+        QString getEsiUrl();
+        void setEsiUrl(QString url);
     }
 }
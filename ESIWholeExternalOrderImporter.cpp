@@ -35,6 +35,17 @@ namespace Evernus
     }
 
     void ESIWholeExternalOrderImporter::fetchExternalOrders(Character::IdType id, const TypeLocationPairs &target) const
+    {
+        std::unordered_set<uint> regions;
+        for (const auto &pair : target)
+            regions.insert(mDataProvider.getStationRegionId(pair.second));
+
+        fetchExternalOrders(id, target, regions);
+    }
+
+    void ESIWholeExternalOrderImporter::fetchExternalOrders(Character::IdType id,
+                                                            const TypeLocationPairs &target,
+                                                            const std::unordered_set<uint> &wholeRegions) const
     {
         if (target.empty())
         {
@@ -51,6 +62,8 @@ namespace Evernus
         mCounter.resetBatchIfEmpty();
 
         std::unordered_set<uint> regions;
+        TypeLocationPairs individualTarget;
+
         for (const auto &pair : target)
         {
             const auto regionId = mDataProvider.getStationRegionId(pair.second);
@@ -58,20 +71,30 @@ namespace Evernus
             {
                 regions.insert(regionId);
                 mCurrentTarget.insert(std::make_pair(pair.first, regionId));
+
+                if (wholeRegions.find(regionId) == std::end(wholeRegions))
+                    individualTarget.insert(std::make_pair(pair.first, regionId));
             }
         }
 
-        mCounter.setCount(regions.size());
+        const auto wholeRegionCount = std::count_if(std::begin(regions), std::end(regions), [&](auto region) {
+            return wholeRegions.find(region) != std::end(wholeRegions);
+        });
+
+        mCounter.setCount(static_cast<size_t>(wholeRegionCount) + individualTarget.size());
 
         QSettings settings;
         const auto importCitadels = settings.value(OrderSettings::importFromCitadelsKey, OrderSettings::importFromCitadelsDefault).toBool();
 
         for (const auto region : regions)
         {
-            mManager.fetchMarketOrders(region, [=](auto &&orders, const auto &error, const auto &expires) {
-                Q_UNUSED(expires);
-                processResult(std::move(orders), error);
-            });
+            if (wholeRegions.find(region) != std::end(wholeRegions))
+            {
+                mManager.fetchMarketOrders(region, [=](auto &&orders, const auto &error, const auto &expires) {
+                    Q_UNUSED(expires);
+                    processResult(std::move(orders), error);
+                });
+            }
 
             if (importCitadels)
             {
@@ -96,6 +119,16 @@ namespace Evernus
             processEvents();
         }
 
+        for (const auto &pair : individualTarget)
+        {
+            mManager.fetchMarketOrders(pair.second, pair.first, [=](auto &&orders, const auto &error, const auto &expires) {
+                Q_UNUSED(expires);
+                processResult(std::move(orders), error);
+            });
+
+            processEvents();
+        }
+
         qDebug() << "Making" << mCounter.getCount() << "ESI requests...";
 
         if (mCounter.isEmpty())
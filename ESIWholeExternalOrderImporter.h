@@ -14,6 +14,8 @@
  */
 #pragma once
 
+#include <unordered_set>
+
 #include "ESIExternalOrderImporter.h"
 
 namespace Evernus
@@ -28,6 +30,10 @@ namespace Evernus
         virtual ~ESIWholeExternalOrderImporter() = default;
 
         virtual void fetchExternalOrders(Character::IdType id, const TypeLocationPairs &target) const override;
+        // types outside given regions are fetched individually
+        void fetchExternalOrders(Character::IdType id,
+                                 const TypeLocationPairs &target,
+                                 const std::unordered_set<uint> &wholeRegions) const;
 
     private:
         const EveDataProvider &mDataProvider;
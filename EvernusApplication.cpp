@@ -50,6 +50,7 @@
 #include "LanguageSelectDialog.h"
 #include "SovereigntyStructure.h"
 #include "StatisticsSettings.h"
+#include "SettingsSnapshot.h"
 #include "UpdaterSettings.h"
 #include "NetworkSettings.h"
 #include "ImportSettings.h"
@@ -82,7 +83,8 @@ namespace Evernus
                                            QString clientId,
                                            QString clientSecret,
                                            const QString &forcedVersion,
-                                           bool dontUpdate)
+                                           bool dontUpdate,
+                                           bool headless)
         : QApplication{argc, argv}
         , ExternalOrderImporterRegistry{}
         , CacheTimerProvider{}
@@ -91,6 +93,7 @@ namespace Evernus
         , LMeveDataProvider{}
         , TaskManager{}
         , EveDataManagerProvider{}
+        , mHeadless{headless}
     {
         QSettings settings;
 
@@ -100,16 +103,20 @@ namespace Evernus
             lang = QLocale{}.name();
             updateTranslator(lang);
 
-            LanguageSelectDialog dlg;
-            if (dlg.exec() == QDialog::Accepted)
+            // nobody to ask when headless - use the system language without remembering the choice
+            if (!mHeadless)
             {
-                lang = dlg.getSelectedLanguage();
-                settings.setValue(UISettings::languageKey, lang);
-                updateTranslator(lang);
-            }
-            else
-            {
-                settings.setValue(UISettings::languageKey, lang);
+                LanguageSelectDialog dlg;
+                if (dlg.exec() == QDialog::Accepted)
+                {
+                    lang = dlg.getSelectedLanguage();
+                    settings.setValue(UISettings::languageKey, lang);
+                    updateTranslator(lang);
+                }
+                else
+                {
+                    settings.setValue(UISettings::languageKey, lang);
+                }
             }
         }
         else
@@ -123,24 +130,29 @@ namespace Evernus
         setProxySettings();
 
 #ifdef EVERNUS_DROPBOX_ENABLED
-        if (settings.value(SyncSettings::enabledOnStartupKey, SyncSettings::enabledOnStartupDefault).toBool())
+        if (!mHeadless && settings.value(SyncSettings::enabledOnStartupKey, SyncSettings::enabledOnStartupDefault).toBool())
         {
             SyncDialog syncDlg{SyncDialog::Mode::Download};
             syncDlg.exec();
         }
 #endif
 
-        QSplashScreen splash{QPixmap{":/images/splash.png"}};
-        splash.show();
-        showSplashMessage(tr("Loading..."), splash);
+        std::unique_ptr<QSplashScreen> splash;
+        if (!mHeadless)
+        {
+            splash = std::make_unique<QSplashScreen>(QPixmap{":/images/splash.png"});
+            splash->show();
+        }
+
+        showSplashMessage(tr("Loading..."), splash.get());
 
-        showSplashMessage(tr("Creating databases..."), splash);
+        showSplashMessage(tr("Creating databases..."), splash.get());
         createDb();
 
-        showSplashMessage(tr("Creating schemas..."), splash);
+        showSplashMessage(tr("Creating schemas..."), splash.get());
         createDbSchema();
 
-        showSplashMessage(tr("Creating data providers..."), splash);
+        showSplashMessage(tr("Creating data providers..."), splash.get());
 
         mCharacterAssetProvider = std::make_unique<CachingAssetProvider>(*mCharacterRepository,
                                                                          *mAssetListRepository,
@@ -170,6 +182,7 @@ namespace Evernus
                                                                  *mCorpMarketOrderRepository,
                                                                  *mMarketGroupRepository,
                                                                  *mCitadelRepository,
+                                                                 *mGenericNameRepository,
                                                                  *this,
                                                                  mEveDatabaseConnectionProvider);
 
@@ -178,29 +191,39 @@ namespace Evernus
                                                                      getCharacterRepository(),
                                                                      *mDataProvider);
 
-        showSplashMessage(tr("Precaching timers..."), splash);
+        showSplashMessage(tr("Precaching timers..."), splash.get());
         precacheCacheTimers();
         precacheUpdateTimers();
 
-        showSplashMessage(tr("Precaching jump map..."), splash);
+        showSplashMessage(tr("Precaching jump map..."), splash.get());
         mDataProvider->precacheJumpMap();
 
-        showSplashMessage(tr("Clearing old wallet entries..."), splash);
+        showSplashMessage(tr("Clearing old wallet entries..."), splash.get());
         deleteOldWalletEntries();
 
-        showSplashMessage(tr("Clearing old market orders..."), splash);
+        showSplashMessage(tr("Clearing old market orders..."), splash.get());
         deleteOldMarketOrders();
 
-        showSplashMessage(tr("Setting up HTTP service..."), splash);
+        showSplashMessage(tr("Setting up HTTP service..."), splash.get());
         auto httpService = new HttpService{*mCombinedOrderProvider,
                                            *mCorpOrderProvider,
                                            *mDataProvider,
                                            *mCharacterRepository,
                                            *this,
                                            *this,
+                                           *mCharacterAssetProvider,
+                                           *this,
                                            &mHttpSessionManager,
                                            this};
 
+        connect(this, &EvernusApplication::characterMarketOrdersChanged, httpService, &HttpService::invalidateOrders);
+        connect(this, &EvernusApplication::corpMarketOrdersChanged, httpService, &HttpService::invalidateCorpOrders);
+        connect(this, &EvernusApplication::characterAssetsChanged, httpService, &HttpService::invalidateAssets);
+        connect(this, &EvernusApplication::characterAssetsUpdated, httpService, &HttpService::invalidateAssets);
+        connect(this, &EvernusApplication::characterWalletJournalChanged, httpService, &HttpService::invalidateWalletJournal);
+        connect(this, &EvernusApplication::characterWalletTransactionsChanged, httpService, &HttpService::invalidateWalletTransactions);
+        connect(this, &EvernusApplication::marketAnalysisResultsChanged, httpService, &HttpService::setAnalysisResults);
+
         mHttpSessionManager.setPort(settings.value(HttpSettings::portKey, HttpSettings::portDefault).value<quint16>());
         mHttpSessionManager.setStaticContentService(httpService);
         mHttpSessionManager.setConnector(QxtHttpSessionManager::HttpServer);
@@ -208,7 +231,7 @@ namespace Evernus
         if (settings.value(HttpSettings::enabledKey, HttpSettings::enabledDefault).toBool())
             mHttpSessionManager.start();
 
-        showSplashMessage(tr("Updating..."), splash);
+        showSplashMessage(tr("Updating..."), splash.get());
 
         if (dontUpdate)
         {
@@ -221,7 +244,7 @@ namespace Evernus
                                                            mESIInterfaceManager->getCitadelAccessCache());
         }
 
-        showSplashMessage(tr("Loading..."), splash);
+        showSplashMessage(tr("Loading..."), splash.get());
 
         settings.setValue(versionKey, applicationVersion());
 
@@ -234,7 +257,7 @@ namespace Evernus
         connect(&mSmtp, &QxtSmtp::finished, &mSmtp, &QxtSmtp::disconnectFromHost);
         setSmtpSettings();
 
-        if (settings.value(UpdaterSettings::autoUpdateKey, UpdaterSettings::autoUpdateDefault).toBool())
+        if (!mHeadless && settings.value(UpdaterSettings::autoUpdateKey, UpdaterSettings::autoUpdateDefault).toBool())
             Updater::getInstance().checkForUpdates(true);
 
         connect(mESIInterfaceManager.get(), &ESIInterfaceManager::ssoAuthRequested, this, &EvernusApplication::ssoAuthRequested);
@@ -300,47 +323,26 @@ namespace Evernus
 
     std::shared_ptr<ItemCost> EvernusApplication::fetchForCharacterAndType(Character::IdType characterId, EveType::IdType typeId) const
     {
-        const auto it = mCharacterItemCostCache.find(std::make_pair(characterId, typeId));
-        if (it != std::end(mCharacterItemCostCache))
-            return it->second;
+        loadItemCosts();
+        return findIndexedItemCost(characterId, typeId, SettingsSnapshotUtils::getSnapshot()->mShareCosts);
+    }
 
-        ItemCostRepository::EntityPtr cost;
+    ItemCostProvider::CostMap EvernusApplication::fetchForCharacterAndTypes(const std::vector<CharacterTypePair> &keys) const
+    {
+        loadItemCosts();
 
-        try
-        {
-            cost = mItemCostRepository->fetchForCharacterAndType(characterId, typeId);
-        }
-        catch (const ItemCostRepository::NotFoundException &)
-        {
-            QSettings settings;
-            if (settings.value(PriceSettings::shareCostsKey, PriceSettings::shareCostsDefault).toBool())
-            {
-                const auto it = mTypeItemCostCache.find(typeId);
-                if (it != std::end(mTypeItemCostCache))
-                {
-                    mCharacterItemCostCache.emplace(std::make_pair(characterId, typeId), it->second);
-                    return it->second;
-                }
+        const auto shareCosts = SettingsSnapshotUtils::getSnapshot()->mShareCosts;
 
-                try
-                {
-                    cost = mItemCostRepository->fetchLatestForType(typeId);
-                }
-                catch (const ItemCostRepository::NotFoundException &)
-                {
-                    cost = std::make_shared<ItemCost>();
-                }
+        CostMap result;
+        result.reserve(keys.size());
 
-                mTypeItemCostCache.emplace(typeId, cost);
-            }
-            else
-            {
-                cost = std::make_shared<ItemCost>();
-            }
+        for (const auto &key : keys)
+        {
+            if (result.find(key) == std::end(result))
+                result.emplace(key, findIndexedItemCost(key.first, key.second, shareCosts));
         }
 
-        mCharacterItemCostCache.emplace(std::make_pair(characterId, typeId), cost);
-        return cost;
+        return result;
     }
 
     ItemCostProvider::CostList EvernusApplication::fetchForCharacter(Character::IdType characterId) const
@@ -357,8 +359,8 @@ namespace Evernus
 
         mItemCostRepository->store(*cost);
 
-        mCharacterItemCostCache[std::make_pair(characterId, typeId)] = cost;
-        mTypeItemCostCache[typeId] = cost;
+        if (mItemCostsLoaded)
+            indexItemCost(cost);
 
         if (!mItemCostUpdateScheduled)
         {
@@ -375,8 +377,13 @@ namespace Evernus
     void EvernusApplication::removeItemCost(ItemCost::IdType id) const
     {
         mItemCostRepository->remove(id);
-        mCharacterItemCostCache.clear();
-        mTypeItemCostCache.clear();
+
+        if (mItemCostsLoaded)
+        {
+            unindexItemCosts([=](const auto &cost) {
+                return cost.getId() == id;
+            });
+        }
 
         emit itemCostsChanged();
     }
@@ -385,10 +392,8 @@ namespace Evernus
     {
         mItemCostRepository->store(cost);
 
-        auto sharedCost = std::make_shared<ItemCost>(cost);
-
-        mCharacterItemCostCache[std::make_pair(cost.getCharacterId(), cost.getTypeId())] = sharedCost;
-        mTypeItemCostCache[cost.getTypeId()] = sharedCost;
+        if (mItemCostsLoaded)
+            indexItemCost(std::make_shared<ItemCost>(cost));
 
         emit itemCostsChanged();
     }
@@ -396,8 +401,13 @@ namespace Evernus
     void EvernusApplication::removeAllItemCosts(Character::IdType characterId) const
     {
         mItemCostRepository->removeForCharacter(characterId);
-        mCharacterItemCostCache.clear();
-        mTypeItemCostCache.clear();
+
+        if (mItemCostsLoaded)
+        {
+            unindexItemCosts([=](const auto &cost) {
+                return cost.getCharacterId() == characterId;
+            });
+        }
 
         emit itemCostsChanged();
     }
@@ -649,20 +659,42 @@ namespace Evernus
         return *mDataProvider;
     }
 
-    void EvernusApplication::refreshCharacters()
+    bool EvernusApplication::isRefreshingCharacterData() const noexcept
+    {
+        return mCharacterRefreshOrchestrator.isRefreshing();
+    }
+
+    void EvernusApplication::refreshAllCharacters(const std::vector<Character::IdType> &dataIds)
     {
         qDebug() << "Refreshing characters...";
 
+        CharacterRefreshOrchestrator::Plan plan;
+
         const auto characters = mCharacterRepository->fetchAll();
         for (const auto &character : characters)
         {
             Q_ASSERT(character);
+            plan[character->getId()] = {CharacterRefreshOrchestrator::Step::Character};
+        }
 
-            const auto task = startTask(tr("Fetching character %1...").arg(character->getId()));
-            processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto steps = CharacterRefreshOrchestrator::getConfiguredSteps();
+        for (const auto id : dataIds)
+            plan[id] = steps;
 
-            importCharacter(character->getId(), task);
-        }
+        mCharacterRefreshOrchestrator.refresh(plan);
+    }
+
+    void EvernusApplication::refreshCharacterData(const std::vector<Character::IdType> &ids)
+    {
+        qDebug() << "Refreshing character data...";
+
+        CharacterRefreshOrchestrator::Plan plan;
+
+        const auto steps = CharacterRefreshOrchestrator::getConfiguredSteps();
+        for (const auto id : ids)
+            plan[id] = steps;
+
+        mCharacterRefreshOrchestrator.refresh(plan);
     }
 
     void EvernusApplication::refreshCharacter(Character::IdType id, uint parentTask)
@@ -682,7 +714,8 @@ namespace Evernus
         qDebug() << "Refreshing assets: " << id;
 
         const auto assetSubtask = startTask(parentTask, tr("Fetching assets for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::AssetList, assetSubtask))
             return;
@@ -710,8 +743,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing contracts: " << id;
 
-        const auto task = startTask(tr("Fetching contracts for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching contracts for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::Contracts, task))
             return;
@@ -773,8 +807,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing wallet journal: " << id;
 
-        const auto task = startTask(tr("Fetching wallet journal for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching wallet journal for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::WalletJournal, task))
             return;
@@ -806,8 +841,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing wallet transactions: " << id;
 
-        const auto task = startTask(tr("Fetching wallet transactions for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching wallet transactions for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!force && !checkImportAndEndTask(id, TimerType::WalletTransactions, task))
             return;
@@ -839,8 +875,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing market orders from API: " << id;
 
-        const auto task = startTask(tr("Fetching market orders for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching market orders for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::MarketOrders, task))
             return;
@@ -868,8 +905,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing market orders from logs:" << id;
 
-        const auto task = startTask(tr("Fetching market orders for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching market orders for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         importMarketOrdersFromLogs(id, task, false);
 
@@ -880,8 +918,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing mining ledger:" << id;
 
-        const auto task = startTask(tr("Fetching mining ledger for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching mining ledger for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::MiningLedger, task))
             return;
@@ -919,7 +958,8 @@ namespace Evernus
         qDebug() << "Refreshing corp assets:" << id;
 
         const auto assetSubtask = startTask(parentTask, tr("Fetching corporation assets for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::CorpAssetList, assetSubtask))
             return;
@@ -942,9 +982,10 @@ namespace Evernus
 
                 if (error.isEmpty())
                 {
-                    mCorpAssetListRepository->deleteForCharacter(id);
+                    mCorpItemRepository->fillCustomValues(data);
+
+                    const auto changes = mCorpAssetListRepository->syncForCharacter(data);
                     mCorpAssetProvider->setForCharacter(id, data);
-                    mCorpAssetListRepository->store(data);
 
                     QSettings settings;
 
@@ -957,6 +998,7 @@ namespace Evernus
                     setUtcCacheTimer(id, TimerType::CorpAssetList, expires);
                     saveUpdateTimer(Evernus::TimerType::CorpAssetList, mUpdateTimes[Evernus::TimerType::CorpAssetList], id);
 
+                    emit corpAssetsUpdated(id, changes);
                     emit corpAssetsChanged();
                 }
 
@@ -973,8 +1015,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing corp contracts: " << id;
 
-        const auto task = startTask(tr("Fetching corporation contracts for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching corporation contracts for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::CorpContracts, task))
             return;
@@ -1018,8 +1061,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing corp wallet journal: " << id;
 
-        const auto task = startTask(tr("Fetching corporation wallet journal for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching corporation wallet journal for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::CorpWalletJournal, task))
             return;
@@ -1100,8 +1144,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing corp wallet transactions: " << id;
 
-        const auto task = startTask(tr("Fetching corporation wallet transactions for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching corporation wallet transactions for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!force && !checkImportAndEndTask(id, TimerType::CorpWalletTransactions, task))
             return;
@@ -1165,8 +1210,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing corp market orders from API: " << id;
 
-        const auto task = startTask(tr("Fetching corporation market orders for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching corporation market orders for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         if (!checkImportAndEndTask(id, TimerType::CorpMarketOrders, task))
             return;
@@ -1203,8 +1249,9 @@ namespace Evernus
     {
         qDebug() << "Refreshing corp market orders from logs: " << id;
 
-        const auto task = startTask(tr("Fetching corporation market orders for character %1...").arg(id));
-        processEvents(QEventLoop::ExcludeUserInputEvents);
+        const auto task = startTask(parentTask, tr("Fetching corporation market orders for character %1...").arg(id));
+        if (parentTask == TaskConstants::invalidTask)
+            processEvents(QEventLoop::ExcludeUserInputEvents);
 
         importMarketOrdersFromLogs(id, task, true);
 
@@ -1324,7 +1371,6 @@ namespace Evernus
         if (settings.value(HttpSettings::enabledKey, HttpSettings::enabledDefault).toBool())
             mHttpSessionManager.start();
 
-        mCharacterItemCostCache.clear();
         mDataProvider->handleNewPreferences();
 
         setSmtpSettings();
@@ -1559,6 +1605,10 @@ namespace Evernus
     void EvernusApplication::updateCharacters()
     {
         mCharacterUpdateScheduled = false;
+
+        // removed characters take their costs with them
+        mItemCostsLoaded = false;
+
         emit charactersChanged();
     }
 
@@ -1606,6 +1656,12 @@ namespace Evernus
 
     void EvernusApplication::showSmtpError(const QByteArray &message)
     {
+        if (mHeadless)
+        {
+            qWarning() << "SMTP error:" << message;
+            return;
+        }
+
         QMessageBox::warning(activeWindow(), tr("SMTP Error"), tr("Error sending email: %1").arg(QString{message}));
     }
 
@@ -1614,6 +1670,12 @@ namespace Evernus
         Q_UNUSED(mailID);
         Q_UNUSED(errorCode);
 
+        if (mHeadless)
+        {
+            qWarning() << "Mail error:" << message;
+            return;
+        }
+
         QMessageBox::warning(activeWindow(), tr("Mail Error"), tr("Error sending email: %1").arg(QString{message}));
     }
 
@@ -1665,6 +1727,7 @@ namespace Evernus
         mMarketOrderValueSnapshotRepository.reset(new MarketOrderValueSnapshotRepository{mMainDatabaseConnectionProvider});
         mCorpMarketOrderValueSnapshotRepository.reset(new CorpMarketOrderValueSnapshotRepository{mMainDatabaseConnectionProvider});
         mFilterTextRepository.reset(new FilterTextRepository{mMainDatabaseConnectionProvider});
+        mGenericNameRepository.reset(new GenericNameRepository{mMainDatabaseConnectionProvider});
         mOrderScriptRepository.reset(new OrderScriptRepository{mMainDatabaseConnectionProvider});
         mFavoriteItemRepository.reset(new FavoriteItemRepository{mMainDatabaseConnectionProvider});
         mLocationBookmarkRepository.reset(new LocationBookmarkRepository{mMainDatabaseConnectionProvider});
@@ -1707,6 +1770,7 @@ namespace Evernus
         mMarketOrderValueSnapshotRepository->create(*mCharacterRepository);
         mCorpMarketOrderValueSnapshotRepository->create();
         mFilterTextRepository->create();
+        mGenericNameRepository->create();
         mOrderScriptRepository->create();
         mFavoriteItemRepository->create();
         mLocationBookmarkRepository->create();
@@ -2161,7 +2225,10 @@ namespace Evernus
         }
         catch (const CharacterRepository::NotFoundException &)
         {
-            QMessageBox::warning(activeWindow(), tr("Evernus"), tr("Couldn't find character for order import!"));
+            if (mHeadless)
+                qWarning() << "Couldn't find character for order import:" << id;
+            else
+                QMessageBox::warning(activeWindow(), tr("Evernus"), tr("Couldn't find character for order import!"));
         }
     }
 
@@ -2211,9 +2278,9 @@ namespace Evernus
     void EvernusApplication::updateCharacterAssets(Character::IdType id, AssetList &list)
     {
         mItemRepository->fillCustomValues(list);
-        mAssetListRepository->deleteForCharacter(id);
+
+        const auto changes = mAssetListRepository->syncForCharacter(list);
         mCharacterAssetProvider->setForCharacter(id, list);
-        mAssetListRepository->store(list);
 
         QSettings settings;
 
@@ -2225,6 +2292,7 @@ namespace Evernus
 
         saveUpdateTimer(TimerType::AssetList, mUpdateTimes[TimerType::AssetList], id);
 
+        emit characterAssetsUpdated(id, changes);
         emit characterAssetsChanged();
     }
 
@@ -2379,9 +2447,7 @@ namespace Evernus
         if (customValue)
             return *customValue;
 
-        QSettings settings;
-        const auto throwOnUnavailable
-            = settings.value(ImportSettings::updateOnlyFullAssetValueKey, ImportSettings::updateOnlyFullAssetValueDefault).toBool();
+        const auto throwOnUnavailable = SettingsSnapshotUtils::getSnapshot()->mUpdateOnlyFullAssetValue;
 
         auto price
             = mDataProvider->getTypeSellPrice(item.getTypeId(), locationId, !throwOnUnavailable)->getPrice() * item.getQuantity();
@@ -2449,6 +2515,88 @@ namespace Evernus
         }
     }
 
+    void EvernusApplication::loadItemCosts() const
+    {
+        if (mItemCostsLoaded)
+            return;
+
+        const auto costs = mItemCostRepository->fetchAll();
+
+        mItemCostIndex.clear();
+        mItemCostIndex.reserve(costs.size());
+        mLatestTypeItemCosts.clear();
+
+        for (const auto &cost : costs)
+            indexItemCost(cost);
+
+        mItemCostsLoaded = true;
+    }
+
+    void EvernusApplication::indexItemCost(const ItemCostRepository::EntityPtr &cost) const
+    {
+        Q_ASSERT(cost);
+
+        mItemCostIndex[std::make_pair(cost->getCharacterId(), cost->getTypeId())] = cost;
+
+        // mirrors ItemCostRepository::fetchLatestForType() - newest row wins
+        auto &latest = mLatestTypeItemCosts[cost->getTypeId()];
+        if (!latest || latest->getId() <= cost->getId())
+            latest = cost;
+    }
+
+    template<class Predicate>
+    void EvernusApplication::unindexItemCosts(Predicate predicate) const
+    {
+        std::unordered_set<EveType::IdType> affectedTypes;
+
+        for (auto it = std::begin(mItemCostIndex); it != std::end(mItemCostIndex);)
+        {
+            if (predicate(*it->second))
+            {
+                affectedTypes.emplace(it->first.second);
+                it = mItemCostIndex.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (affectedTypes.empty())
+            return;
+
+        for (const auto type : affectedTypes)
+            mLatestTypeItemCosts.erase(type);
+
+        for (const auto &cost : mItemCostIndex)
+        {
+            if (affectedTypes.find(cost.first.second) == std::end(affectedTypes))
+                continue;
+
+            auto &latest = mLatestTypeItemCosts[cost.first.second];
+            if (!latest || latest->getId() <= cost.second->getId())
+                latest = cost.second;
+        }
+    }
+
+    ItemCostRepository::EntityPtr EvernusApplication::findIndexedItemCost(Character::IdType characterId,
+                                                                          EveType::IdType typeId,
+                                                                          bool shareCosts) const
+    {
+        const auto it = mItemCostIndex.find(std::make_pair(characterId, typeId));
+        if (it != std::end(mItemCostIndex))
+            return it->second;
+
+        if (shareCosts)
+        {
+            const auto latest = mLatestTypeItemCosts.find(typeId);
+            if (latest != std::end(mLatestTypeItemCosts))
+                return latest->second;
+        }
+
+        return std::make_shared<ItemCost>();
+    }
+
     void EvernusApplication::setSmtpSettings()
     {
         SimpleCrypt crypt{ImportSettings::smtpCryptKey};
@@ -2660,9 +2808,15 @@ namespace Evernus
             mStationGroupTypeIds.emplace(query.value(0).value<EveType::IdType>());
     }
 
-    void EvernusApplication::showSplashMessage(const QString &message, QSplashScreen &splash)
+    void EvernusApplication::showSplashMessage(const QString &message, QSplashScreen *splash)
     {
-        splash.showMessage(message, Qt::AlignBottom | Qt::AlignRight, Qt::white);
+        if (splash == nullptr)
+        {
+            qInfo() << message;
+            return;
+        }
+
+        splash->showMessage(message, Qt::AlignBottom | Qt::AlignRight, Qt::white);
         processEvents();
     }
 
@@ -29,6 +29,7 @@
 #include "IndustryManufacturingSetupRepository.h"
 #include "MarketOrderValueSnapshotRepository.h"
 #include "CorpAssetValueSnapshotRepository.h"
+#include "CharacterRefreshOrchestrator.h"
 #include "MainDatabaseConnectionProvider.h"
 #include "ExternalOrderImporterRegistry.h"
 #include "RegionStationPresetRepository.h"
@@ -47,6 +48,7 @@
 #include "FavoriteItemRepository.h"
 #include "CachingEveDataProvider.h"
 #include "ContractItemRepository.h"
+#include "GenericNameRepository.h"
 #include "MiningLedgerRepository.h"
 #include "ExternalOrderImporter.h"
 #include "MarketGroupRepository.h"
@@ -71,6 +73,7 @@
 #include "LMeveDataProvider.h"
 #include "ItemCostProvider.h"
 #include "LMeveAPIManager.h"
+#include "HttpApiResponse.h"
 #include "CitadelManager.h"
 #include "ItemRepository.h"
 #include "TaskConstants.h"
@@ -106,7 +109,8 @@ namespace Evernus
                            QString clientId,
                            QString clientSecret,
                            const QString &forcedVersion,
-                           bool dontUpdate);
+                           bool dontUpdate,
+                           bool headless);
         virtual ~EvernusApplication();
 
         virtual void registerImporter(const std::string &name, std::unique_ptr<ExternalOrderImporter> &&importer) override;
@@ -117,6 +121,7 @@ namespace Evernus
         virtual QDateTime getLocalUpdateTimer(Character::IdType id, TimerType type) const override;
 
         virtual std::shared_ptr<ItemCost> fetchForCharacterAndType(Character::IdType characterId, EveType::IdType typeId) const override;
+        virtual CostMap fetchForCharacterAndTypes(const std::vector<CharacterTypePair> &keys) const override;
         virtual CostList fetchForCharacter(Character::IdType characterId) const override;
         virtual void setForCharacterAndType(Character::IdType characterId, EveType::IdType typeId, double value) override;
 
@@ -178,6 +183,8 @@ namespace Evernus
 
         EveDataProvider &getDataProvider() noexcept;
 
+        bool isRefreshingCharacterData() const noexcept;
+
     signals:
         void taskStarted(uint taskId, const QString &description);
         void taskStarted(uint taskId, uint parentTask, const QString &description);
@@ -187,6 +194,7 @@ namespace Evernus
         void citadelsChanged();
         void charactersChanged();
         void characterAssetsChanged();
+        void characterAssetsUpdated(Character::IdType id, const AssetListChanges &changes);
         void externalOrdersChanged();
         void externalOrdersChangedWithMarketOrders();
         void characterWalletJournalChanged();
@@ -195,6 +203,7 @@ namespace Evernus
         void characterContractsChanged();
         void characterMiningLedgerChanged();
         void corpAssetsChanged();
+        void corpAssetsUpdated(Character::IdType id, const AssetListChanges &changes);
         void corpWalletJournalChanged();
         void corpWalletTransactionsChanged();
         void corpMarketOrdersChanged();
@@ -205,6 +214,8 @@ namespace Evernus
 
         void snapshotsTaken();
 
+        void marketAnalysisResultsChanged(uint regionId, const HttpApiTable &table);
+
         void openMarginTool();
 
         void ssoError(const QString &info);
@@ -212,7 +223,8 @@ namespace Evernus
         void ssoAuthRequested(Character::IdType charId, const QUrl &url);
 
     public slots:
-        void refreshCharacters();
+        void refreshAllCharacters(const std::vector<Character::IdType> &dataIds);
+        void refreshCharacterData(const std::vector<Character::IdType> &ids);
         void refreshCharacter(Character::IdType id, uint parentTask = TaskConstants::invalidTask);
         void refreshCharacterAssets(Character::IdType id, uint parentTask = TaskConstants::invalidTask);
         void refreshCharacterContracts(Character::IdType id, uint parentTask = TaskConstants::invalidTask);
@@ -272,7 +284,6 @@ namespace Evernus
         void showMailError(int mailID, int errorCode, const QByteArray &message);
 
     private:
-        using CharacterTypePair = std::pair<Character::IdType, EveType::IdType>;
         using CharacterTimerMap = std::unordered_map<Character::IdType, QDateTime>;
         using TypedCharacterTimerMap = std::unordered_map<TimerType, CharacterTimerMap>;
         using TransactionFetcher = std::function<WalletTransactionRepository::EntityList (const QDateTime &, const QDateTime &, EveType::IdType)>;
@@ -297,6 +308,7 @@ namespace Evernus
         std::unique_ptr<MarketOrderValueSnapshotRepository> mMarketOrderValueSnapshotRepository;
         std::unique_ptr<CorpMarketOrderValueSnapshotRepository> mCorpMarketOrderValueSnapshotRepository;
         std::unique_ptr<FilterTextRepository> mFilterTextRepository;
+        std::unique_ptr<GenericNameRepository> mGenericNameRepository;
         std::unique_ptr<OrderScriptRepository> mOrderScriptRepository;
         std::unique_ptr<FavoriteItemRepository> mFavoriteItemRepository;
         std::unique_ptr<LocationBookmarkRepository> mLocationBookmarkRepository;
@@ -314,6 +326,8 @@ namespace Evernus
 
         std::unique_ptr<ESIInterfaceManager> mESIInterfaceManager;
 
+        bool mHeadless = false;
+
         LMeveAPIManager mLMeveAPIManager;
         CitadelManager mCitadelManager;
 
@@ -340,9 +354,11 @@ namespace Evernus
 
         std::unique_ptr<CachingContractProvider> mCharacterContractProvider, mCorpContractProvider;
 
+        // all stored item costs, loaded in bulk and kept in sync with the repository
         mutable std::unordered_map<CharacterTypePair, ItemCostRepository::EntityPtr, boost::hash<CharacterTypePair>>
-        mCharacterItemCostCache;
-        mutable std::unordered_map<EveType::IdType, ItemCostRepository::EntityPtr> mTypeItemCostCache;
+        mItemCostIndex;
+        mutable std::unordered_map<EveType::IdType, ItemCostRepository::EntityPtr> mLatestTypeItemCosts;
+        mutable bool mItemCostsLoaded = false;
 
         QTranslator mTranslator, mQtTranslator, mQtBaseTranslator, mQtScriptTranslator;
 
@@ -365,6 +381,8 @@ namespace Evernus
         std::vector<ContractItem> mPendingCharacterContractItems;
         std::vector<ContractItem> mPendingCorpContractItems;
 
+        CharacterRefreshOrchestrator mCharacterRefreshOrchestrator{*this};
+
         void updateTranslator(const QString &lang);
 
         void createDb();
@@ -398,6 +416,14 @@ namespace Evernus
                               const MarketOrderProvider::OrderList &orders,
                               const TransactionFetcher &transFetcher);
 
+        void loadItemCosts() const;
+        void indexItemCost(const ItemCostRepository::EntityPtr &cost) const;
+        template<class Predicate>
+        void unindexItemCosts(Predicate predicate) const;
+        ItemCostRepository::EntityPtr findIndexedItemCost(Character::IdType characterId,
+                                                          EveType::IdType typeId,
+                                                          bool shareCosts) const;
+
         void setSmtpSettings();
 
         void createWalletSnapshot(Character::IdType characterId, double balance);
@@ -426,7 +452,7 @@ namespace Evernus
 
         void fetchStationTypeIds();
 
-        static void showSplashMessage(const QString &message, QSplashScreen &splash);
+        static void showSplashMessage(const QString &message, QSplashScreen *splash);
         static QString getCharacterImportMessage(Character::IdType id);
 
         static void setProxySettings();
@@ -12,10 +12,148 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <charconv>
+
+#include <QByteArray>
+
 #include "ExternalOrder.h"
 
 namespace Evernus
 {
+    namespace
+    {
+        const auto priceColumn = 0;
+        const auto volRemainingColumn = 1;
+        const auto typeColumn = 2;
+        const auto rangeColumn = 3;
+        const auto idColumn = 4;
+        const auto volEnteredColumn = 5;
+        const auto minVolColumn = 6;
+        const auto bidColumn = 7;
+        const auto issuedColumn = 8;
+        const auto durationColumn = 9;
+        const auto stationColumn = 10;
+        const auto regionColumn = 11;
+        const auto systemColumn = 12;
+
+        template<class T>
+        T parseInteger(std::string_view value) noexcept
+        {
+            // stays 0 on error, like QString::toUInt() and friends
+            T result{};
+            std::from_chars(value.data(), value.data() + value.size(), result);
+
+            return result;
+        }
+
+        double parseDouble(std::string_view value)
+        {
+            // logs only contain plain decimals - when both the digits and the power of ten are exact doubles, a single
+            // division rounds the same as a full conversion
+            static const double powersOf10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            const auto maxDigits = 15;
+
+            auto it = std::begin(value);
+            const auto end = std::end(value);
+
+            const auto negative = it != end && *it == '-';
+            if (negative)
+                ++it;
+
+            quint64 mantissa = 0;
+            auto digits = 0, fractionDigits = 0;
+
+            const auto readDigits = [&](auto &counter) {
+                for (; it != end && *it >= '0' && *it <= '9'; ++it)
+                {
+                    mantissa = mantissa * 10 + static_cast<quint64>(*it - '0');
+                    ++digits;
+                    ++counter;
+                }
+            };
+
+            auto integerDigits = 0;
+            readDigits(integerDigits);
+
+            if (it != end && *it == '.')
+            {
+                ++it;
+                readDigits(fractionDigits);
+            }
+
+            if (Q_LIKELY(it == end && digits > 0 && digits <= maxDigits))
+            {
+                const auto result = mantissa / powersOf10[fractionDigits];
+                return (negative) ? (-result) : (result);
+            }
+
+            // exponents, long mantissas - take the slow path
+            return QByteArray{value.data(), static_cast<int>(value.size())}.toDouble();
+        }
+
+        QDateTime parseIssued(std::string_view value)
+        {
+            // yyyy-MM-dd HH:mm:ss.zzz, or sometimes just yyyy-MM-dd
+            const auto field = [&](auto pos, auto length) {
+                return parseInteger<int>(value.substr(pos, length));
+            };
+
+            if (value.size() >= 10 && value[4] == '-' && value[7] == '-')
+            {
+                const QDate date{field(0, 4), field(5, 2), field(8, 2)};
+
+                QTime time{0, 0};
+                if (value.size() >= 19 && value[10] == ' ' && value[13] == ':' && value[16] == ':')
+                    time = QTime{field(11, 2), field(14, 2), field(17, 2), (value.size() >= 23 && value[19] == '.') ? (field(20, 3)) : (0)};
+
+                if (date.isValid() && time.isValid())
+                    return QDateTime{date, time, Qt::UTC};
+            }
+
+            // thank CCP
+            return QDateTime::currentDateTimeUtc();
+        }
+
+        ExternalOrder parseLogValues(const QStringList &values)
+        {
+            const auto eveDateFormat = "yyyy-MM-dd HH:mm:ss.zzz";
+
+            ExternalOrder order{values[idColumn].toULongLong()};
+            order.setStationId(values[stationColumn].toULongLong());
+            order.setSolarSystemId(values[systemColumn].toUInt());
+            order.setRegionId(values[regionColumn].toUInt());
+            order.setRange(values[rangeColumn].toShort());
+            order.setType((values[bidColumn] == "True") ? (ExternalOrder::Type::Buy) : (ExternalOrder::Type::Sell));
+            order.setTypeId(values[typeColumn].toULongLong());
+            order.setPrice(values[priceColumn].toDouble());
+            order.setVolumeEntered(values[volEnteredColumn].toUInt());
+            order.setVolumeRemaining(values[volRemainingColumn].toDouble());
+            order.setMinVolume(values[minVolColumn].toUInt());
+            order.setDuration(values[durationColumn].toShort());
+
+            auto dt = QDateTime::fromString(values[issuedColumn], eveDateFormat);
+            if (!dt.isValid())
+            {
+                const auto altEveDateFormat = "yyyy-MM-dd";
+                dt = QDateTime::fromString(values[issuedColumn], altEveDateFormat);
+                if (!dt.isValid())
+                {
+                    // thank CCP
+                    dt = QDateTime::currentDateTimeUtc();
+                }
+            }
+            dt.setTimeSpec(Qt::UTC);
+
+            order.setIssued(dt);
+
+            return order;
+        }
+    }
+
     ExternalOrder::Type ExternalOrder::getType() const noexcept
     {
         return mType;
@@ -147,49 +285,24 @@ namespace Evernus
 
     ExternalOrder ExternalOrder::parseLogLine(const QStringList &values)
     {
-        const auto eveDateFormat = "yyyy-MM-dd HH:mm:ss.zzz";
-
-        const auto priceColumn = 0;
-        const auto volRemainingColumn = 1;
-        const auto typeColumn = 2;
-        const auto rangeColumn = 3;
-        const auto idColumn = 4;
-        const auto volEnteredColumn = 5;
-        const auto minVolColumn = 6;
-        const auto bidColumn = 7;
-        const auto issuedColumn = 8;
-        const auto durationColumn = 9;
-        const auto stationColumn = 10;
-        const auto regionColumn = 11;
-        const auto systemColumn = 12;
+        return parseLogValues(values);
+    }
 
-        ExternalOrder order{values[idColumn].toULongLong()};
-        order.setStationId(values[stationColumn].toULongLong());
-        order.setSolarSystemId(values[systemColumn].toUInt());
-        order.setRegionId(values[regionColumn].toUInt());
-        order.setRange(values[rangeColumn].toShort());
+    ExternalOrder ExternalOrder::parseLogLine(const LogLineTokens &values)
+    {
+        ExternalOrder order{parseInteger<IdType>(values[idColumn])};
+        order.setStationId(parseInteger<quint64>(values[stationColumn]));
+        order.setSolarSystemId(parseInteger<uint>(values[systemColumn]));
+        order.setRegionId(parseInteger<uint>(values[regionColumn]));
+        order.setRange(parseInteger<short>(values[rangeColumn]));
         order.setType((values[bidColumn] == "True") ? (ExternalOrder::Type::Buy) : (ExternalOrder::Type::Sell));
-        order.setTypeId(values[typeColumn].toULongLong());
-        order.setPrice(values[priceColumn].toDouble());
-        order.setVolumeEntered(values[volEnteredColumn].toUInt());
-        order.setVolumeRemaining(values[volRemainingColumn].toDouble());
-        order.setMinVolume(values[minVolColumn].toUInt());
-        order.setDuration(values[durationColumn].toShort());
-
-        auto dt = QDateTime::fromString(values[issuedColumn], eveDateFormat);
-        if (!dt.isValid())
-        {
-            const auto altEveDateFormat = "yyyy-MM-dd";
-            dt = QDateTime::fromString(values[issuedColumn], altEveDateFormat);
-            if (!dt.isValid())
-            {
-                // thank CCP
-                dt = QDateTime::currentDateTimeUtc();
-            }
-        }
-        dt.setTimeSpec(Qt::UTC);
-
-        order.setIssued(dt);
+        order.setTypeId(parseInteger<TypeIdType>(values[typeColumn]));
+        order.setPrice(parseDouble(values[priceColumn]));
+        order.setVolumeEntered(parseInteger<uint>(values[volEnteredColumn]));
+        order.setVolumeRemaining(parseDouble(values[volRemainingColumn]));
+        order.setMinVolume(parseInteger<uint>(values[minVolColumn]));
+        order.setDuration(parseInteger<short>(values[durationColumn]));
+        order.setIssued(parseIssued(values[issuedColumn]));
 
         return order;
     }
@@ -14,7 +14,9 @@
  */
 #pragma once
 
+#include <string_view>
 #include <memory>
+#include <array>
 
 #include <QStringList>
 #include <QDateTime>
@@ -29,8 +31,11 @@ namespace Evernus
         : public Entity<quint64>
     {
     public:
+        static const auto logColumns = 14;
+
         using TypeIdType = ItemData::TypeIdType;
         using Type = PriceType;
+        using LogLineTokens = std::array<std::string_view, logColumns>;
 
         struct LowToHigh
         {
@@ -102,6 +107,8 @@ namespace Evernus
         ExternalOrder &operator =(ExternalOrder &&) = default;
 
         static ExternalOrder parseLogLine(const QStringList &values);
+        // tokens can be views into a mapped log file - they are parsed in place, without copying
+        static ExternalOrder parseLogLine(const LogLineTokens &values);
 
         static std::shared_ptr<ExternalOrder> nullOrder();
 
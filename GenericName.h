@@ -0,0 +1,46 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QString>
+
+#include "Entity.h"
+
+namespace Evernus
+{
+    class GenericName
+        : public Entity<quint64>
+    {
+    public:
+        using Entity::Entity;
+
+        GenericName() = default;
+        GenericName(IdType id, QString name);
+        GenericName(const GenericName &) = default;
+        GenericName(GenericName &&) = default;
+        virtual ~GenericName() = default;
+
+        GenericName &operator =(const GenericName &) = default;
+        GenericName &operator =(GenericName &&) = default;
+
+        QString getName() const &;
+        QString &&getName() && noexcept;
+        void setName(const QString &name);
+        void setName(QString &&name);
+
+    private:
+        QString mName;
+    };
+}
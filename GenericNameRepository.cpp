@@ -0,0 +1,72 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QSqlRecord>
+#include <QSqlQuery>
+
+#include "GenericNameRepository.h"
+
+namespace Evernus
+{
+    QString GenericNameRepository::getTableName() const
+    {
+        return QStringLiteral("generic_names");
+    }
+
+    QString GenericNameRepository::getIdColumn() const
+    {
+        return QStringLiteral("id");
+    }
+
+    GenericNameRepository::EntityPtr GenericNameRepository::populate(const QSqlRecord &record) const
+    {
+        auto name = std::make_shared<GenericName>(record.value(QStringLiteral("id")).value<GenericName::IdType>());
+        name->setName(record.value(QStringLiteral("name")).toString());
+        name->setNew(false);
+
+        return name;
+    }
+
+    void GenericNameRepository::create() const
+    {
+        exec(QStringLiteral("CREATE TABLE IF NOT EXISTS %1 ("
+            "id BIGINT PRIMARY KEY,"
+            "name TEXT NOT NULL"
+        ")").arg(getTableName()));
+    }
+
+    QStringList GenericNameRepository::getColumns() const
+    {
+        return {
+            QStringLiteral("id"),
+            QStringLiteral("name"),
+        };
+    }
+
+    void GenericNameRepository::bindValues(const GenericName &entity, QSqlQuery &query) const
+    {
+        if (entity.getId() != GenericName::invalidId)
+            query.bindValue(QStringLiteral(":id"), entity.getId());
+
+        query.bindValue(QStringLiteral(":name"), entity.getName());
+    }
+
+    void GenericNameRepository::bindPositionalValues(const GenericName &entity, QSqlQuery &query) const
+    {
+        if (entity.getId() != GenericName::invalidId)
+            query.addBindValue(entity.getId());
+
+        query.addBindValue(entity.getName());
+    }
+}
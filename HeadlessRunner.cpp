@@ -0,0 +1,480 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <QAbstractItemModel>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QSettings>
+#include <QtDebug>
+#include <QFile>
+#include <QDir>
+
+#include "MarketAnalysisSettings.h"
+#include "CharacterRepository.h"
+#include "EvernusApplication.h"
+#include "EveTypeRepository.h"
+#include "ImportSettings.h"
+#include "qxtcsvmodel.h"
+
+#include "HeadlessRunner.h"
+
+namespace Evernus
+{
+    HeadlessRunner::HeadlessRunner(EvernusApplication &app,
+                                   std::vector<Task> tasks,
+                                   Character::IdType characterId,
+                                   std::vector<uint> regions,
+                                   QString outputDir,
+                                   OutputFormat outputFormat,
+                                   QObject *parent)
+        : QObject{parent}
+        , mApp{app}
+        , mTasks{std::move(tasks)}
+        , mCharacterId{characterId}
+        , mRegions{std::move(regions)}
+        , mOutputDir{std::move(outputDir)}
+        , mOutputFormat{outputFormat}
+        , mDataFetcher{mApp.getDataProvider(), mApp.getESIInterfaceManager()}
+        , mAnalysisModel{mApp.getDataProvider()}
+    {
+        connect(&mApp, QOverload<uint, const QString &>::of(&EvernusApplication::taskStarted),
+                this, &HeadlessRunner::startTrackedTask);
+        connect(&mApp, QOverload<uint, uint, const QString &>::of(&EvernusApplication::taskStarted),
+                this, &HeadlessRunner::startTrackedTask);
+        connect(&mApp, &EvernusApplication::taskEnded,
+                this, &HeadlessRunner::endTrackedTask);
+        connect(&mApp, &EvernusApplication::ssoError,
+                this, [=](const auto &info) {
+            qWarning() << "ESI error:" << info;
+            mErrors << info;
+        });
+        connect(&mApp, &EvernusApplication::ssoAuthRequested,
+                this, [=](auto charId, const auto &url) {
+            Q_UNUSED(url);
+
+            // there's nobody to log in, so give up on this character instead of waiting forever
+            qWarning() << "Character requires SSO authorization, skipping:" << charId;
+            mErrors << tr("Character %1 requires SSO authorization.").arg(charId);
+            mApp.cancelSsoAuth(charId);
+        });
+
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::orderStatusUpdated,
+                this, [](const auto &text) {
+            qInfo() << text;
+        });
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::historyStatusUpdated,
+                this, [](const auto &text) {
+            qInfo() << text;
+        });
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::orderImportEnded,
+                this, &HeadlessRunner::endOrderImport);
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::historyImportEnded,
+                this, &HeadlessRunner::endHistoryImport);
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::genericError,
+                this, [=](const auto &text) {
+            qWarning() << "Analysis import error:" << text;
+            mErrors << text;
+        });
+
+        QSettings settings;
+
+        mAnalysisModel.discardBogusOrders(
+            settings.value(MarketAnalysisSettings::discardBogusOrdersKey, MarketAnalysisSettings::discardBogusOrdersDefault).toBool());
+        mAnalysisModel.setBogusOrderThreshold(
+            settings.value(MarketAnalysisSettings::bogusOrderThresholdKey, MarketAnalysisSettings::bogusOrderThresholdDefault).toDouble());
+        connect(&mAnalysisModel, &TypeAggregatedMarketDataModel::calculationFinished,
+                this, &HeadlessRunner::exportCurrentRegion);
+
+        mIdleTimer.setInterval(idleCheckInterval);
+        connect(&mIdleTimer, &QTimer::timeout, this, &HeadlessRunner::checkIdle);
+    }
+
+    std::vector<HeadlessRunner::Task> HeadlessRunner::parseTasks(const QString &list)
+    {
+        std::vector<Task> result;
+
+        const auto names = list.split(QLatin1Char(','), QString::SkipEmptyParts);
+        for (const auto &name : names)
+        {
+            const auto trimmed = name.trimmed().toLower();
+            if (trimmed == QStringLiteral("characters"))
+                result.emplace_back(Task::Characters);
+            else if (trimmed == QStringLiteral("prices"))
+                result.emplace_back(Task::Prices);
+            else if (trimmed == QStringLiteral("analysis"))
+                result.emplace_back(Task::Analysis);
+            else
+                qWarning() << "Unknown headless task:" << name;
+        }
+
+        return result;
+    }
+
+    std::vector<uint> HeadlessRunner::parseRegions(const QString &list)
+    {
+        std::vector<uint> result;
+
+        const auto ids = list.split(QLatin1Char(','), QString::SkipEmptyParts);
+        for (const auto &id : ids)
+        {
+            auto ok = false;
+            const auto region = id.trimmed().toUInt(&ok);
+
+            if (ok)
+                result.emplace_back(region);
+            else
+                qWarning() << "Invalid region id:" << id;
+        }
+
+        return result;
+    }
+
+    HeadlessRunner::OutputFormat HeadlessRunner::parseOutputFormat(const QString &format)
+    {
+        return (format.compare(QStringLiteral("json"), Qt::CaseInsensitive) == 0) ? (OutputFormat::JSON) : (OutputFormat::CSV);
+    }
+
+    void HeadlessRunner::run()
+    {
+        qInfo() << "Starting headless run with" << mTasks.size() << "tasks.";
+
+        if (!QDir{}.mkpath(mOutputDir))
+        {
+            qCritical() << "Cannot create output directory:" << mOutputDir;
+            QCoreApplication::exit(1);
+            return;
+        }
+
+        mCurrentTask = 0;
+        runNextTask();
+    }
+
+    void HeadlessRunner::startTrackedTask(uint taskId)
+    {
+        // tasks can end before their queued start notification arrives
+        if (mEndedTasks.erase(taskId) == 0)
+            mPendingTasks.emplace(taskId);
+    }
+
+    void HeadlessRunner::endTrackedTask(uint taskId, const QString &error)
+    {
+        if (!error.isEmpty())
+        {
+            qWarning() << "Task" << taskId << "failed:" << error;
+            mErrors << error;
+        }
+
+        if (mPendingTasks.erase(taskId) == 0)
+            mEndedTasks.emplace(taskId);
+    }
+
+    void HeadlessRunner::checkIdle()
+    {
+        if (!mPendingTasks.empty() || mApp.isRefreshingCharacterData() || QThreadPool::globalInstance()->activeThreadCount() > 0)
+        {
+            mIdleChecks = 0;
+            return;
+        }
+
+        // require two quiet checks in a row, since finished tasks often schedule follow-up ones
+        if (++mIdleChecks < 2)
+            return;
+
+        mIdleTimer.stop();
+
+        auto continuation = std::move(mIdleContinuation);
+        mIdleContinuation = nullptr;
+
+        if (continuation)
+            continuation();
+    }
+
+    void HeadlessRunner::endOrderImport(const MarketAnalysisDataFetcher::OrderResultType &orders, const QString &error)
+    {
+        Q_ASSERT(orders);
+        mOrders = orders;
+        mOrdersImported = true;
+
+        if (!error.isEmpty())
+        {
+            qWarning() << "Analysis order import failed:" << error;
+            mErrors << error;
+        }
+
+        if (mHistoryImported && !mDataFetcher.hasPendingOrderRequests() && !mDataFetcher.hasPendingHistoryRequests())
+            finishAnalysisImport();
+    }
+
+    void HeadlessRunner::endHistoryImport(const MarketAnalysisDataFetcher::HistoryResultType &history, const QString &error)
+    {
+        Q_ASSERT(history);
+        mHistory = history;
+        mHistoryImported = true;
+
+        if (!error.isEmpty())
+        {
+            qWarning() << "Analysis history import failed:" << error;
+            mErrors << error;
+        }
+
+        if (mOrdersImported && !mDataFetcher.hasPendingOrderRequests() && !mDataFetcher.hasPendingHistoryRequests())
+            finishAnalysisImport();
+    }
+
+    void HeadlessRunner::exportCurrentRegion()
+    {
+        Q_ASSERT(mCurrentRegion < mRegions.size());
+
+        exportModel(mAnalysisModel, QStringLiteral("analysis-%1").arg(mRegions[mCurrentRegion]));
+
+        ++mCurrentRegion;
+        analyzeNextRegion();
+    }
+
+    void HeadlessRunner::runNextTask()
+    {
+        if (mCurrentTask >= mTasks.size())
+        {
+            waitForIdle([=] {
+                finish();
+            });
+            return;
+        }
+
+        switch (mTasks[mCurrentTask++]) {
+        case Task::Characters:
+            refreshCharacters();
+            break;
+        case Task::Prices:
+            importPrices();
+            break;
+        case Task::Analysis:
+            importAnalysisData();
+        }
+    }
+
+    void HeadlessRunner::refreshCharacters()
+    {
+        qInfo() << "Refreshing characters...";
+
+        mApp.refreshCharacterData(getCharacterIds());
+        mApp.refreshCitadels();
+
+        waitForIdle([=] {
+            runNextTask();
+        });
+    }
+
+    void HeadlessRunner::importPrices()
+    {
+        const auto ids = getCharacterIds();
+        if (ids.empty())
+        {
+            qWarning() << "No character available for price import.";
+            mErrors << tr("No character available for price import.");
+            runNextTask();
+            return;
+        }
+
+        qInfo() << "Importing prices...";
+
+        mApp.refreshAllExternalOrders(ids.front());
+
+        waitForIdle([=] {
+            runNextTask();
+        });
+    }
+
+    void HeadlessRunner::importAnalysisData()
+    {
+        if (mRegions.empty())
+        {
+            qWarning() << "No regions given for analysis.";
+            mErrors << tr("No regions given for analysis.");
+            runNextTask();
+            return;
+        }
+
+        const auto ids = getCharacterIds();
+        const auto charId = (ids.empty()) ? (Character::invalidId) : (ids.front());
+
+        if (charId != Character::invalidId)
+        {
+            try
+            {
+                mAnalysisModel.setCharacter(mApp.getCharacterRepository().find(charId));
+            }
+            catch (const CharacterRepository::NotFoundException &)
+            {
+            }
+        }
+
+        const auto types = mApp.getEveTypeRepository().fetchAllTradeableIds();
+
+        TypeLocationPairs pairs;
+        for (const auto region : mRegions)
+        {
+            for (const auto type : types)
+                pairs.emplace(type, region);
+        }
+
+        qInfo() << "Importing analysis data for" << pairs.size() << "type/region pairs...";
+
+        mOrders.reset();
+        mHistory.reset();
+        mOrdersImported = false;
+        mHistoryImported = false;
+
+        mDataFetcher.importData(pairs, TypeLocationPairs{}, charId);
+    }
+
+    void HeadlessRunner::finishAnalysisImport()
+    {
+        Q_ASSERT(mOrders);
+        Q_ASSERT(mHistory);
+
+        QSettings settings;
+        if (!settings.value(MarketAnalysisSettings::dontSaveLargeOrdersKey, MarketAnalysisSettings::dontSaveLargeOrdersDefault).toBool())
+            mApp.updateExternalOrdersAndAssetValue(*mOrders);
+
+        mCurrentRegion = 0;
+        analyzeNextRegion();
+    }
+
+    void HeadlessRunner::analyzeNextRegion()
+    {
+        if (mCurrentRegion >= mRegions.size())
+        {
+            runNextTask();
+            return;
+        }
+
+        static const TypeAggregatedMarketDataModel::HistoryMap emptyHistory;
+
+        const auto region = mRegions[mCurrentRegion];
+
+        qInfo() << "Analyzing region" << region;
+
+        const auto history = mHistory->find(region);
+        mAnalysisModel.setOrderData(*mOrders,
+                                    (history == std::end(*mHistory)) ? (emptyHistory) : (history->second),
+                                    region,
+                                    PriceType::Buy,
+                                    PriceType::Sell);
+    }
+
+    void HeadlessRunner::finish()
+    {
+        qInfo() << "Headless run finished with" << mErrors.size() << "errors.";
+        QCoreApplication::exit((mErrors.isEmpty()) ? (0) : (1));
+    }
+
+    void HeadlessRunner::waitForIdle(std::function<void ()> continuation)
+    {
+        mIdleContinuation = std::move(continuation);
+        mIdleChecks = 0;
+        mIdleTimer.start();
+    }
+
+    void HeadlessRunner::exportModel(const QAbstractItemModel &model, const QString &name)
+    {
+        const auto rows = model.rowCount();
+        const auto columns = model.columnCount();
+
+        // prefer raw values over the locale-formatted display ones
+        const auto getValue = [&](auto row, auto column) {
+            const auto index = model.index(row, column);
+            const auto value = model.data(index, Qt::UserRole);
+
+            return (value.isValid()) ? (value) : (model.data(index));
+        };
+
+        QDir dir{mOutputDir};
+
+        if (mOutputFormat == OutputFormat::JSON)
+        {
+            QJsonArray result;
+
+            for (auto row = 0; row < rows; ++row)
+            {
+                QJsonObject object;
+                for (auto column = 0; column < columns; ++column)
+                    object[model.headerData(column, Qt::Horizontal).toString()] = QJsonValue::fromVariant(getValue(row, column));
+
+                result.append(object);
+            }
+
+            const auto fileName = dir.filePath(name + QStringLiteral(".json"));
+
+            QFile file{fileName};
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+                qWarning() << "Cannot write" << fileName;
+                mErrors << tr("Cannot write %1").arg(fileName);
+                return;
+            }
+
+            file.write(QJsonDocument{result}.toJson());
+            qInfo() << "Written" << fileName;
+        }
+        else
+        {
+            QSettings settings;
+
+            auto separator = settings.value(ImportSettings::csvSeparatorKey, ImportSettings::csvSeparatorDefault).toString();
+            if (separator.length() != 1)
+                separator = ImportSettings::csvSeparatorDefault;
+
+            QxtCsvModel csv;
+            csv.insertRows(0, rows);
+            csv.insertColumns(0, columns);
+
+            for (auto column = 0; column < columns; ++column)
+                csv.setHeaderText(column, model.headerData(column, Qt::Horizontal).toString());
+
+            for (auto row = 0; row < rows; ++row)
+            {
+                for (auto column = 0; column < columns; ++column)
+                    csv.setData(csv.index(row, column), getValue(row, column));
+            }
+
+            const auto fileName = dir.filePath(name + QStringLiteral(".csv"));
+
+            csv.toCSV(fileName, true, separator[0]);
+            qInfo() << "Written" << fileName;
+        }
+    }
+
+    std::vector<Character::IdType> HeadlessRunner::getCharacterIds() const
+    {
+        if (mCharacterId != Character::invalidId)
+            return { mCharacterId };
+
+        std::vector<Character::IdType> result;
+
+        const auto &repo = mApp.getCharacterRepository();
+        const auto idName = repo.getIdColumn();
+        auto query = repo.getEnabledQuery();
+
+        while (query.next())
+            result.emplace_back(query.value(idName).value<Character::IdType>());
+
+        return result;
+    }
+}
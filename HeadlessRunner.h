@@ -0,0 +1,129 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <unordered_set>
+#include <functional>
+#include <vector>
+
+#include <QStringList>
+#include <QObject>
+#include <QTimer>
+
+#include "TypeAggregatedMarketDataModel.h"
+#include "MarketAnalysisDataFetcher.h"
+#include "Character.h"
+
+class QAbstractItemModel;
+
+namespace Evernus
+{
+    class EvernusApplication;
+
+    // runs scheduled imports and analysis without any windows, exporting results to files
+    class HeadlessRunner
+        : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        enum class Task
+        {
+            Characters,
+            Prices,
+            Analysis
+        };
+
+        enum class OutputFormat
+        {
+            CSV,
+            JSON
+        };
+
+        HeadlessRunner(EvernusApplication &app,
+                       std::vector<Task> tasks,
+                       Character::IdType characterId,
+                       std::vector<uint> regions,
+                       QString outputDir,
+                       OutputFormat outputFormat,
+                       QObject *parent = nullptr);
+        virtual ~HeadlessRunner() = default;
+
+        static std::vector<Task> parseTasks(const QString &list);
+        static std::vector<uint> parseRegions(const QString &list);
+        static OutputFormat parseOutputFormat(const QString &format);
+
+    public slots:
+        void run();
+
+    private slots:
+        void startTrackedTask(uint taskId);
+        void endTrackedTask(uint taskId, const QString &error);
+
+        void checkIdle();
+
+        void endOrderImport(const MarketAnalysisDataFetcher::OrderResultType &orders, const QString &error);
+        void endHistoryImport(const MarketAnalysisDataFetcher::HistoryResultType &history, const QString &error);
+
+        void exportCurrentRegion();
+
+    private:
+        static const auto idleCheckInterval = 1000;
+
+        EvernusApplication &mApp;
+
+        std::vector<Task> mTasks;
+        std::size_t mCurrentTask = 0;
+
+        Character::IdType mCharacterId = Character::invalidId;
+        std::vector<uint> mRegions;
+
+        QString mOutputDir;
+        OutputFormat mOutputFormat = OutputFormat::CSV;
+
+        std::unordered_set<uint> mPendingTasks, mEndedTasks;
+        QTimer mIdleTimer;
+        uint mIdleChecks = 0;
+        std::function<void ()> mIdleContinuation;
+
+        MarketAnalysisDataFetcher mDataFetcher;
+        TypeAggregatedMarketDataModel mAnalysisModel;
+
+        MarketAnalysisDataFetcher::OrderResultType mOrders;
+        MarketAnalysisDataFetcher::HistoryResultType mHistory;
+        bool mOrdersImported = false;
+        bool mHistoryImported = false;
+        std::size_t mCurrentRegion = 0;
+
+        QStringList mErrors;
+
+        void runNextTask();
+
+        void refreshCharacters();
+        void importPrices();
+        void importAnalysisData();
+
+        void finishAnalysisImport();
+        void analyzeNextRegion();
+
+        void finish();
+
+        void waitForIdle(std::function<void ()> continuation);
+
+        void exportModel(const QAbstractItemModel &model, const QString &name);
+
+        std::vector<Character::IdType> getCharacterIds() const;
+    };
+}
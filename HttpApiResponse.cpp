@@ -0,0 +1,201 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <array>
+
+#include <QCryptographicHash>
+#include <QAbstractItemModel>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QtEndian>
+
+#include "HttpApiResponse.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        quint32 crc32(const QByteArray &data)
+        {
+            static const auto table = [] {
+                std::array<quint32, 256> result;
+                for (quint32 i = 0; i < result.size(); ++i)
+                {
+                    auto value = i;
+                    for (auto bit = 0; bit < 8; ++bit)
+                        value = (value & 1) ? (0xedb88320u ^ (value >> 1)) : (value >> 1);
+
+                    result[i] = value;
+                }
+
+                return result;
+            }();
+
+            auto crc = 0xffffffffu;
+            for (const auto byte : data)
+                crc = table[(crc ^ static_cast<quint8>(byte)) & 0xff] ^ (crc >> 8);
+
+            return crc ^ 0xffffffffu;
+        }
+
+        QByteArray escapeCsv(QString value)
+        {
+            if (value.contains(QLatin1Char(',')) ||
+                value.contains(QLatin1Char('"')) ||
+                value.contains(QLatin1Char('\n')) ||
+                value.contains(QLatin1Char('\r')))
+            {
+                value.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+                value = QLatin1Char('"') + value + QLatin1Char('"');
+            }
+
+            return value.toUtf8();
+        }
+    }
+
+    HttpApiResponse::HttpApiResponse(const HttpApiTable &table, Format format)
+        : mFormat{format}
+        , mBody{(format == Format::CSV) ? (toCsv(table)) : (toJson(table))}
+        , mGzipBody{gzip(mBody)}
+    {
+        const auto hash = QCryptographicHash::hash(mBody, QCryptographicHash::Sha1).toHex();
+
+        mETag = '"' + hash + '"';
+        mGzipETag = '"' + hash + "-gzip\"";
+    }
+
+    QByteArray HttpApiResponse::getContentType() const
+    {
+        return (mFormat == Format::CSV) ? (QByteArrayLiteral("text/csv; charset=utf-8")) : (QByteArrayLiteral("application/json"));
+    }
+
+    QByteArray HttpApiResponse::getETag(bool gzip) const
+    {
+        return (gzip) ? (mGzipETag) : (mETag);
+    }
+
+    QByteArray HttpApiResponse::getBody() const
+    {
+        return mBody;
+    }
+
+    QByteArray HttpApiResponse::getGzipBody() const
+    {
+        return mGzipBody;
+    }
+
+    QByteArray HttpApiResponse::gzip(const QByteArray &data)
+    {
+        // qCompress() gives a 4-byte size followed by a zlib stream - strip the zlib header and adler32 trailer
+        // to get raw deflate data and wrap it in a gzip header and trailer instead
+        const auto compressed = qCompress(data);
+
+        const auto sizePrefix = 4;
+        const auto zlibHeader = 2;
+        const auto zlibTrailer = 4;
+
+        QByteArray result;
+        result.reserve(compressed.size() + 10);
+
+        result.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+        result.append(compressed.constData() + sizePrefix + zlibHeader, compressed.size() - sizePrefix - zlibHeader - zlibTrailer);
+
+        uchar trailer[8];
+        qToLittleEndian(crc32(data), trailer);
+        qToLittleEndian(static_cast<quint32>(data.size()), trailer + 4);
+
+        result.append(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+        return result;
+    }
+
+    HttpApiTable HttpApiResponse::tableFromModel(const QAbstractItemModel &model)
+    {
+        HttpApiTable table;
+
+        const auto rows = model.rowCount();
+        const auto columns = model.columnCount();
+
+        for (auto column = 0; column < columns; ++column)
+            table.mColumns << model.headerData(column, Qt::Horizontal).toString();
+
+        table.mRows.reserve(rows);
+
+        for (auto row = 0; row < rows; ++row)
+        {
+            QVariantList values;
+            values.reserve(columns);
+
+            for (auto column = 0; column < columns; ++column)
+            {
+                const auto index = model.index(row, column);
+                const auto value = model.data(index, Qt::UserRole);
+
+                values << ((value.isValid()) ? (value) : (model.data(index)));
+            }
+
+            table.mRows.emplace_back(std::move(values));
+        }
+
+        return table;
+    }
+
+    QByteArray HttpApiResponse::toJson(const HttpApiTable &table)
+    {
+        QJsonArray result;
+
+        for (const auto &row : table.mRows)
+        {
+            Q_ASSERT(row.size() == table.mColumns.size());
+
+            QJsonObject object;
+            for (auto column = 0; column < row.size(); ++column)
+                object[table.mColumns[column]] = QJsonValue::fromVariant(row[column]);
+
+            result.append(object);
+        }
+
+        return QJsonDocument{result}.toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray HttpApiResponse::toCsv(const HttpApiTable &table)
+    {
+        QByteArray result;
+
+        const auto appendLine = [&](const auto &values, auto converter) {
+            for (auto column = 0; column < values.size(); ++column)
+            {
+                if (column != 0)
+                    result.append(',');
+
+                result.append(escapeCsv(converter(values[column])));
+            }
+
+            result.append("\r\n");
+        };
+
+        appendLine(table.mColumns, [](const auto &value) {
+            return value;
+        });
+
+        for (const auto &row : table.mRows)
+        {
+            appendLine(row, [](const auto &value) {
+                return value.toString();
+            });
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+
+#include <QVariantList>
+#include <QStringList>
+#include <QByteArray>
+
+class QAbstractItemModel;
+
+namespace Evernus
+{
+    struct HttpApiTable
+    {
+        QStringList mColumns;
+        std::vector<QVariantList> mRows;
+    };
+
+    // serialized, compressed and tagged API payload - immutable once created, so it can be shared between requests
+    class HttpApiResponse final
+    {
+    public:
+        enum class Format
+        {
+            JSON,
+            CSV
+        };
+
+        HttpApiResponse(const HttpApiTable &table, Format format);
+        HttpApiResponse(const HttpApiResponse &) = default;
+        HttpApiResponse(HttpApiResponse &&) = default;
+        ~HttpApiResponse() = default;
+
+        QByteArray getContentType() const;
+        // each representation has its own tag, since caches see them as different entities under Vary: Accept-Encoding
+        QByteArray getETag(bool gzip) const;
+
+        QByteArray getBody() const;
+        QByteArray getGzipBody() const;
+
+        HttpApiResponse &operator =(const HttpApiResponse &) = default;
+        HttpApiResponse &operator =(HttpApiResponse &&) = default;
+
+        static QByteArray gzip(const QByteArray &data);
+
+        // header names become columns; raw (Qt::UserRole) values are preferred over display ones
+        static HttpApiTable tableFromModel(const QAbstractItemModel &model);
+
+    private:
+        Format mFormat = Format::JSON;
+        QByteArray mBody, mGzipBody;
+        QByteArray mETag, mGzipETag;
+
+        static QByteArray toJson(const HttpApiTable &table);
+        static QByteArray toCsv(const HttpApiTable &table);
+    };
+}
@@ -12,13 +12,25 @@
  *  You should have received a copy of the GNU Http Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <optional>
+
+#include <QtConcurrent>
+
+#include <QFutureWatcher>
 #include <QSettings>
 #include <QUrlQuery>
+#include <QDateTime>
 #include <QLocale>
 #include <QColor>
 
+#include "WalletJournalEntryRepository.h"
+#include "WalletTransactionRepository.h"
 #include "CharacterRepository.h"
+#include "MarketOrderProvider.h"
+#include "RepositoryProvider.h"
+#include "AssetProvider.h"
 #include "HttpSettings.h"
+#include "AssetList.h"
 
 #include "qxthttpsessionmanager.h"
 #include "qxtwebevent.h"
@@ -27,7 +39,17 @@
 
 namespace Evernus
 {
+    namespace
+    {
+        template<class T>
+        QVariant toVariant(const std::optional<T> &value)
+        {
+            return (value) ? (QVariant::fromValue(*value)) : (QVariant{});
+        }
+    }
+
     const QString HttpService::characterIdName = "characterId";
+    const QString HttpService::regionIdName = "regionId";
 
     HttpService::HttpService(MarketOrderProvider &orderProvider,
                              MarketOrderProvider &corpOrderProvider,
@@ -35,10 +57,16 @@ namespace Evernus
                              const CharacterRepository &characterRepo,
                              const CacheTimerProvider &cacheTimerProvider,
                              const ItemCostProvider &itemCostProvider,
+                             const AssetProvider &assetProvider,
+                             const RepositoryProvider &repositoryProvider,
                              QxtHttpSessionManager *sm,
                              QObject *parent)
         : QxtWebSlotService(sm, parent)
+        , mOrderProvider(orderProvider)
+        , mCorpOrderProvider(corpOrderProvider)
         , mCharacterRepo(characterRepo)
+        , mAssetProvider(assetProvider)
+        , mRepositoryProvider(repositoryProvider)
         , mCrypt(HttpSettings::cryptKey)
         , mSellModel(orderProvider, dataProvider, itemCostProvider, cacheTimerProvider, characterRepo, false)
         , mCorpSellModel(corpOrderProvider, dataProvider, itemCostProvider, cacheTimerProvider, characterRepo, true)
@@ -144,6 +172,147 @@ namespace Evernus
         renderOrders(event, mCorpBuyModelProxy, mCorpSellModelProxy, mCorpOrdersTemplate);
     }
 
+    void HttpService::api(QxtWebRequestEvent *event, const QString &resource)
+    {
+        ApiResource apiResource;
+        if (resource == QLatin1String("orders"))
+            apiResource = ApiResource::Orders;
+        else if (resource == QLatin1String("corporationOrders"))
+            apiResource = ApiResource::CorpOrders;
+        else if (resource == QLatin1String("assets"))
+            apiResource = ApiResource::Assets;
+        else if (resource == QLatin1String("journal"))
+            apiResource = ApiResource::WalletJournal;
+        else if (resource == QLatin1String("transactions"))
+            apiResource = ApiResource::WalletTransactions;
+        else if (resource == QLatin1String("analysis"))
+            apiResource = ApiResource::Analysis;
+        else
+        {
+            postEvent(new QxtWebErrorEvent{event->sessionID, event->requestID, 404, "Not Found"});
+            return;
+        }
+
+        QUrlQuery query{event->url.query()};
+
+        quint64 id = 0;
+        if (apiResource == ApiResource::Analysis)
+        {
+            if (!query.hasQueryItem(regionIdName))
+            {
+                postEvent(new QxtWebErrorEvent{event->sessionID, event->requestID, 400, "Bad Request"});
+                return;
+            }
+
+            id = query.queryItemValue(regionIdName).toUInt();
+            if (mAnalysisResults.find(id) == std::end(mAnalysisResults))
+            {
+                postEvent(new QxtWebErrorEvent{event->sessionID, event->requestID, 404, "Not Found"});
+                return;
+            }
+        }
+        else
+        {
+            id = getCharacterId(event);
+        }
+
+        const auto csv = query.queryItemValue(QStringLiteral("format")) == QLatin1String("csv");
+        const auto key = std::make_pair(id, csv);
+
+        PendingApiRequest request;
+        request.mSessionId = event->sessionID;
+        request.mRequestId = event->requestID;
+        request.mGzip = event->headers.value(QStringLiteral("Accept-Encoding")).contains(QLatin1String("gzip"));
+        request.mETag = event->headers.value(QStringLiteral("If-None-Match"));
+
+        auto &entry = mApiCache[apiResource][key];
+        if (entry.mResponse)
+        {
+            postApiResponse(request, *entry.mResponse);
+            return;
+        }
+
+        entry.mPendingRequests.emplace_back(std::move(request));
+
+        // someone else is already waiting for this response
+        if (entry.mPendingRequests.size() > 1)
+            return;
+
+        HttpApiTable table;
+
+        try
+        {
+            table = getApiTable(apiResource, id);
+        }
+        catch (const CharacterRepository::NotFoundException &)
+        {
+            for (const auto &pending : entry.mPendingRequests)
+                postEvent(new QxtWebErrorEvent{pending.mSessionId, pending.mRequestId, 404, "Not Found"});
+
+            entry.mPendingRequests.clear();
+            return;
+        }
+
+        // only data gathering happens here, serialization and compression are done in the background
+        const auto generation = mApiGenerations[apiResource];
+        const auto format = (csv) ? (HttpApiResponse::Format::CSV) : (HttpApiResponse::Format::JSON);
+
+        auto watcher = new QFutureWatcher<ApiResponsePtr>{this};
+        connect(watcher, &QFutureWatcher<ApiResponsePtr>::finished, this, [=] {
+            watcher->deleteLater();
+
+            const auto response = watcher->result();
+            Q_ASSERT(response);
+
+            auto &entry = mApiCache[apiResource][key];
+            for (const auto &pending : entry.mPendingRequests)
+                postApiResponse(pending, *response);
+
+            entry.mPendingRequests.clear();
+
+            // don't cache if data has changed in the meantime
+            if (mApiGenerations[apiResource] == generation)
+                entry.mResponse = response;
+        });
+
+        watcher->setFuture(QtConcurrent::run([table = std::move(table), format]() -> ApiResponsePtr {
+            return std::make_shared<HttpApiResponse>(table, format);
+        }));
+    }
+
+    void HttpService::invalidateOrders()
+    {
+        invalidateApiResource(ApiResource::Orders);
+    }
+
+    void HttpService::invalidateCorpOrders()
+    {
+        // character orders are combined with corporation ones
+        invalidateApiResource(ApiResource::Orders);
+        invalidateApiResource(ApiResource::CorpOrders);
+    }
+
+    void HttpService::invalidateAssets()
+    {
+        invalidateApiResource(ApiResource::Assets);
+    }
+
+    void HttpService::invalidateWalletJournal()
+    {
+        invalidateApiResource(ApiResource::WalletJournal);
+    }
+
+    void HttpService::invalidateWalletTransactions()
+    {
+        invalidateApiResource(ApiResource::WalletTransactions);
+    }
+
+    void HttpService::setAnalysisResults(uint regionId, const HttpApiTable &table)
+    {
+        mAnalysisResults[regionId] = table;
+        invalidateApiResource(ApiResource::Analysis);
+    }
+
     void HttpService::pageRequestedEvent(QxtWebRequestEvent *event)
     {
         auto authHeader = event->headers.value("Authorization");
@@ -167,7 +336,11 @@ namespace Evernus
                 password == mCrypt.decryptToByteArray(settings.value(HttpSettings::passwordKey).toString()))
             {
                 QUrlQuery query{event->url.query()};
-                if (!query.hasQueryItem(characterIdName) && !isIndexAction(event))
+                if (!query.hasQueryItem(characterIdName) && isApiAction(event) && !isAnalysisApiAction(event))
+                {
+                    postEvent(new QxtWebErrorEvent{event->sessionID, event->requestID, 400, "Bad Request"});
+                }
+                else if (!query.hasQueryItem(characterIdName) && !isIndexAction(event))
                 {
                     postEvent(new QxtWebRedirectEvent{event->sessionID, event->requestID, "/"});
                 }
@@ -278,18 +451,295 @@ namespace Evernus
         postEvent(pageEvent);
     }
 
-    bool HttpService::isIndexAction(QxtWebRequestEvent *event)
+    HttpApiTable HttpService::getApiTable(ApiResource resource, quint64 id) const
+    {
+        if (resource == ApiResource::Analysis)
+        {
+            const auto results = mAnalysisResults.find(static_cast<uint>(id));
+            return (results == std::end(mAnalysisResults)) ? (HttpApiTable{}) : (results->second);
+        }
+
+        const Character::IdType characterId = id;
+
+        HttpApiTable table;
+
+        const auto addOrders = [&](const MarketOrderProvider::OrderList &orders) {
+            for (const auto &order : orders)
+            {
+                Q_ASSERT(order);
+                table.mRows.emplace_back(QVariantList{
+                    order->getId(),
+                    order->getCharacterId(),
+                    (order->getType() == MarketOrder::Type::Buy) ? (QStringLiteral("buy")) : (QStringLiteral("sell")),
+                    order->getTypeId(),
+                    order->getEffectiveStationId(),
+                    order->getVolumeEntered(),
+                    order->getVolumeRemaining(),
+                    order->getMinVolume(),
+                    static_cast<int>(order->getState()),
+                    order->getRange(),
+                    order->getDuration(),
+                    order->getEscrow(),
+                    order->getPrice(),
+                    order->getIssued().toString(Qt::ISODate),
+                    order->getFirstSeen().toString(Qt::ISODate),
+                    order->getLastSeen().toString(Qt::ISODate),
+                    order->getCorporationId()
+                });
+            }
+        };
+
+        switch (resource) {
+        case ApiResource::Orders:
+        case ApiResource::CorpOrders:
+            table.mColumns = QStringList{
+                QStringLiteral("id"),
+                QStringLiteral("characterId"),
+                QStringLiteral("type"),
+                QStringLiteral("typeId"),
+                QStringLiteral("stationId"),
+                QStringLiteral("volumeEntered"),
+                QStringLiteral("volumeRemaining"),
+                QStringLiteral("minVolume"),
+                QStringLiteral("state"),
+                QStringLiteral("range"),
+                QStringLiteral("duration"),
+                QStringLiteral("escrow"),
+                QStringLiteral("price"),
+                QStringLiteral("issued"),
+                QStringLiteral("firstSeen"),
+                QStringLiteral("lastSeen"),
+                QStringLiteral("corporationId")
+            };
+
+            if (resource == ApiResource::Orders)
+            {
+                addOrders(mOrderProvider.getSellOrders(characterId));
+                addOrders(mOrderProvider.getBuyOrders(characterId));
+            }
+            else
+            {
+                const auto corporationId = mCharacterRepo.getCorporationId(characterId);
+
+                addOrders(mCorpOrderProvider.getSellOrdersForCorporation(corporationId));
+                addOrders(mCorpOrderProvider.getBuyOrdersForCorporation(corporationId));
+            }
+            break;
+        case ApiResource::Assets:
+            {
+                table.mColumns = QStringList{
+                    QStringLiteral("id"),
+                    QStringLiteral("parentId"),
+                    QStringLiteral("typeId"),
+                    QStringLiteral("locationId"),
+                    QStringLiteral("quantity"),
+                    QStringLiteral("rawQuantity"),
+                    QStringLiteral("customValue"),
+                    QStringLiteral("bpc")
+                };
+
+                const auto assets = mAssetProvider.fetchAssetsForCharacter(characterId);
+                if (assets)
+                {
+                    const auto &items = assets->getAllItems();
+                    table.mRows.reserve(items.size());
+
+                    for (const auto &item : items)
+                    {
+                        table.mRows.emplace_back(QVariantList{
+                            item.getId(),
+                            toVariant(item.getParentId()),
+                            item.getTypeId(),
+                            toVariant(item.getLocationId()),
+                            item.getQuantity(),
+                            item.getRawQuantity(),
+                            toVariant(item.getCustomValue()),
+                            toVariant(item.getBPCFlag())
+                        });
+                    }
+                }
+            }
+            break;
+        case ApiResource::WalletJournal:
+            {
+                table.mColumns = QStringList{
+                    QStringLiteral("id"),
+                    QStringLiteral("timestamp"),
+                    QStringLiteral("refType"),
+                    QStringLiteral("firstPartyId"),
+                    QStringLiteral("secondPartyId"),
+                    QStringLiteral("amount"),
+                    QStringLiteral("balance"),
+                    QStringLiteral("reason"),
+                    QStringLiteral("taxReceiverId"),
+                    QStringLiteral("taxAmount"),
+                    QStringLiteral("contextId"),
+                    QStringLiteral("contextIdType")
+                };
+
+                const auto till = QDateTime::currentDateTimeUtc();
+                const auto entries = mRepositoryProvider.getWalletJournalEntryRepository().fetchForCharacterInRange(
+                    characterId, till.addDays(-walletHistoryDays), till, WalletJournalEntryRepository::EntryType::All);
+
+                table.mRows.reserve(entries.size());
+
+                for (const auto &entry : entries)
+                {
+                    table.mRows.emplace_back(QVariantList{
+                        entry->getId(),
+                        entry->getTimestamp().toString(Qt::ISODate),
+                        entry->getRefType(),
+                        toVariant(entry->getFirstPartyId()),
+                        toVariant(entry->getSecondPartyId()),
+                        toVariant(entry->getAmount()),
+                        toVariant(entry->getBalance()),
+                        entry->getReason(),
+                        toVariant(entry->getTaxReceiverId()),
+                        toVariant(entry->getTaxAmount()),
+                        toVariant(entry->getContextId()),
+                        entry->getContextIdType()
+                    });
+                }
+            }
+            break;
+        case ApiResource::WalletTransactions:
+            {
+                table.mColumns = QStringList{
+                    QStringLiteral("id"),
+                    QStringLiteral("timestamp"),
+                    QStringLiteral("type"),
+                    QStringLiteral("typeId"),
+                    QStringLiteral("quantity"),
+                    QStringLiteral("price"),
+                    QStringLiteral("clientId"),
+                    QStringLiteral("locationId"),
+                    QStringLiteral("journalId")
+                };
+
+                const auto till = QDateTime::currentDateTimeUtc();
+                const auto transactions = mRepositoryProvider.getWalletTransactionRepository().fetchForCharacterInRange(
+                    characterId, till.addDays(-walletHistoryDays), till, WalletTransactionRepository::EntryType::All);
+
+                table.mRows.reserve(transactions.size());
+
+                for (const auto &transaction : transactions)
+                {
+                    table.mRows.emplace_back(QVariantList{
+                        transaction->getId(),
+                        transaction->getTimestamp().toString(Qt::ISODate),
+                        (transaction->getType() == WalletTransaction::Type::Buy) ? (QStringLiteral("buy")) : (QStringLiteral("sell")),
+                        transaction->getTypeId(),
+                        transaction->getQuantity(),
+                        transaction->getPrice(),
+                        transaction->getClientId(),
+                        transaction->getLocationId(),
+                        transaction->getJournalId()
+                    });
+                }
+            }
+            break;
+        case ApiResource::Analysis:
+            break;
+        }
+
+        return table;
+    }
+
+    void HttpService::invalidateApiResource(ApiResource resource)
+    {
+        ++mApiGenerations[resource];
+
+        auto &cache = mApiCache[resource];
+        for (auto it = std::begin(cache); it != std::end(cache);)
+        {
+            if (it->second.mPendingRequests.empty())
+            {
+                it = cache.erase(it);
+            }
+            else
+            {
+                it->second.mResponse.reset();
+                ++it;
+            }
+        }
+    }
+
+    void HttpService::postApiResponse(const PendingApiRequest &request, const HttpApiResponse &response)
+    {
+        const auto etag = response.getETag(request.mGzip);
+        if (!request.mETag.isEmpty() && matchesETag(request.mETag, etag))
+        {
+            auto pageEvent = new QxtWebPageEvent{request.mSessionId, request.mRequestId, QByteArray{}};
+            pageEvent->status = 304;
+            pageEvent->statusMessage = "Not Modified";
+            pageEvent->headers.insert(QStringLiteral("ETag"), QString::fromLatin1(etag));
+
+            postEvent(pageEvent);
+            return;
+        }
+
+        auto pageEvent = new QxtWebPageEvent{request.mSessionId,
+                                             request.mRequestId,
+                                             (request.mGzip) ? (response.getGzipBody()) : (response.getBody())};
+        pageEvent->contentType = response.getContentType();
+        pageEvent->headers.insert(QStringLiteral("ETag"), QString::fromLatin1(etag));
+        pageEvent->headers.insert(QStringLiteral("Vary"), QStringLiteral("Accept-Encoding"));
+
+        if (request.mGzip)
+            pageEvent->headers.insert(QStringLiteral("Content-Encoding"), QStringLiteral("gzip"));
+
+        postEvent(pageEvent);
+    }
+
+    QByteArray HttpService::getAction(QxtWebRequestEvent *event)
     {
         auto args = event->url.path().split('/');
         args.removeFirst();
         if (args.at(args.count() - 1).isEmpty())
             args.removeLast();
 
-        if (args.count() == 0)
-            return true;
+        return (args.count() == 0) ? (QByteArray{}) : (args.at(0).toUtf8().trimmed());
+    }
+
+    bool HttpService::isIndexAction(QxtWebRequestEvent *event)
+    {
+        const auto action = getAction(event);
+        return action.isEmpty() || action == "index";
+    }
+
+    bool HttpService::isApiAction(QxtWebRequestEvent *event)
+    {
+        return getAction(event) == "api";
+    }
+
+    bool HttpService::isAnalysisApiAction(QxtWebRequestEvent *event)
+    {
+        const auto args = event->url.path().split('/', QString::SkipEmptyParts);
+        return args.count() > 1 && args.at(0) == QLatin1String("api") && args.at(1) == QLatin1String("analysis");
+    }
+
+    bool HttpService::matchesETag(const QString &ifNoneMatch, const QByteArray &etag)
+    {
+        // If-None-Match uses weak comparison and can list several tags
+        const auto opaqueTag = [](QString tag) {
+            tag = tag.trimmed();
+            if (tag.startsWith(QLatin1String("W/")))
+                tag.remove(0, 2);
+
+            return tag;
+        };
+
+        const auto expected = opaqueTag(QString::fromLatin1(etag));
+
+        const auto tags = ifNoneMatch.split(QLatin1Char(','), QString::SkipEmptyParts);
+        for (const auto &tag : tags)
+        {
+            const auto value = opaqueTag(tag);
+            if (value == QLatin1String("*") || value == expected)
+                return true;
+        }
 
-        const auto action = args.at(0).toUtf8();
-        return action.trimmed().isEmpty() || action == "index";
+        return false;
     }
 
     Character::IdType HttpService::getCharacterId(QxtWebRequestEvent *event)
@@ -14,9 +14,17 @@
  */
 #pragma once
 
+#include <unordered_map>
+#include <utility>
+#include <memory>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
 #include "MarketOrderFilterProxyModel.h"
 #include "MarketOrderSellModel.h"
 #include "MarketOrderBuyModel.h"
+#include "HttpApiResponse.h"
 #include "SimpleCrypt.h"
 
 #include "qxtwebslotservice.h"
@@ -28,9 +36,11 @@ namespace Evernus
 {
     class CharacterRepository;
     class MarketOrderProvider;
+    class RepositoryProvider;
     class CacheTimerProvider;
     class ItemCostProvider;
     class EveDataProvider;
+    class AssetProvider;
 
     class HttpService
         : public QxtWebSlotService
@@ -44,6 +54,8 @@ namespace Evernus
                     const CharacterRepository &characterRepo,
                     const CacheTimerProvider &cacheTimerProvider,
                     const ItemCostProvider &itemCostProvider,
+                    const AssetProvider &assetProvider,
+                    const RepositoryProvider &repositoryProvider,
                     QxtHttpSessionManager *sm,
                     QObject *parent = nullptr);
         virtual ~HttpService() = default;
@@ -52,6 +64,15 @@ namespace Evernus
         void index(QxtWebRequestEvent *event);
         void characterOrders(QxtWebRequestEvent *event);
         void corporationOrders(QxtWebRequestEvent *event);
+        void api(QxtWebRequestEvent *event, const QString &resource);
+
+        void invalidateOrders();
+        void invalidateCorpOrders();
+        void invalidateAssets();
+        void invalidateWalletJournal();
+        void invalidateWalletTransactions();
+
+        void setAnalysisResults(uint regionId, const HttpApiTable &table);
 
     protected:
         virtual void pageRequestedEvent(QxtWebRequestEvent *event) override;
@@ -59,9 +80,49 @@ namespace Evernus
     private:
         typedef std::pair<MarketOrderFilterProxyModel::StatusFilters, MarketOrderFilterProxyModel::PriceStatusFilters> FilterPair;
 
+        enum class ApiResource
+        {
+            Orders,
+            CorpOrders,
+            Assets,
+            WalletJournal,
+            WalletTransactions,
+            Analysis
+        };
+
+        using ApiResponsePtr = std::shared_ptr<const HttpApiResponse>;
+
+        struct PendingApiRequest
+        {
+            int mSessionId = 0;
+            int mRequestId = 0;
+            bool mGzip = false;
+            QString mETag;
+        };
+
+        struct ApiCacheEntry
+        {
+            ApiResponsePtr mResponse;
+            std::vector<PendingApiRequest> mPendingRequests;
+        };
+
+        // character (or region, for analysis) id + whether it's CSV
+        using ApiCacheKey = std::pair<quint64, bool>;
+        using ApiCache = std::unordered_map<ApiCacheKey, ApiCacheEntry, boost::hash<ApiCacheKey>>;
+
         static const QString characterIdName;
+        static const QString regionIdName;
+        static const auto walletHistoryDays = 30;
 
+        MarketOrderProvider &mOrderProvider, &mCorpOrderProvider;
         const CharacterRepository &mCharacterRepo;
+        const AssetProvider &mAssetProvider;
+        const RepositoryProvider &mRepositoryProvider;
+
+        std::unordered_map<ApiResource, ApiCache> mApiCache;
+        std::unordered_map<ApiResource, uint> mApiGenerations;
+
+        std::unordered_map<uint, HttpApiTable> mAnalysisResults;
 
         SimpleCrypt mCrypt;
 
@@ -80,7 +141,15 @@ namespace Evernus
         void renderContent(QxtWebRequestEvent *event, const QString &content);
         void postUnauthorized(QxtWebRequestEvent *event);
 
+        HttpApiTable getApiTable(ApiResource resource, quint64 id) const;
+        void invalidateApiResource(ApiResource resource);
+        void postApiResponse(const PendingApiRequest &request, const HttpApiResponse &response);
+
+        static QByteArray getAction(QxtWebRequestEvent *event);
         static bool isIndexAction(QxtWebRequestEvent *event);
+        static bool isApiAction(QxtWebRequestEvent *event);
+        static bool isAnalysisApiAction(QxtWebRequestEvent *event);
+        static bool matchesETag(const QString &ifNoneMatch, const QByteArray &etag);
         static Character::IdType getCharacterId(QxtWebRequestEvent *event);
         static FilterPair getFilters(QxtWebRequestEvent *event);
 
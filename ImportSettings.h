@@ -104,6 +104,7 @@ namespace Evernus::ImportSettings
     const auto importAllCharactersKey = QStringLiteral("import/allCharacters");
     const auto corpWalletDivisionKey = QStringLiteral("import/corp/walletDivision");
     const auto marketOrderImportTypeKey = QStringLiteral("import/marketOrderType");
+    const auto marketRegionPageCountGroup = QStringLiteral("import/marketRegionPageCount");
     const auto itemPricesFileDirKey = QStringLiteral("import/costs/fileDir");
     const auto csvSeparatorKey = QStringLiteral("import/csvSeparator");
     const auto maxCitadelAccessAgeKey = QStringLiteral("import/citadelAccess/maxAge");
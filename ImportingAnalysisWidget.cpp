@@ -95,7 +95,7 @@ namespace Evernus
 
         mAnalysisDaysEdit = new QSpinBox{this};
         toolBarLayout->addWidget(mAnalysisDaysEdit);
-        mAnalysisDaysEdit->setRange(1, 365);
+        mAnalysisDaysEdit->setRange(1, ImportingDataModel::maxAnalysisDays);
         mAnalysisDaysEdit->setSuffix(tr(" days"));
         mAnalysisDaysEdit->setToolTip(tr("The number of days going back from today, to use for analysis. If the destination has been in use for shorter time, be sure to adjust this accordingly."));
         mAnalysisDaysEdit->setValue(
@@ -105,7 +105,7 @@ namespace Evernus
 
         mAggrDaysEdit = new QSpinBox{this};
         toolBarLayout->addWidget(mAggrDaysEdit);
-        mAggrDaysEdit->setRange(1, 365);
+        mAggrDaysEdit->setRange(1, ImportingDataModel::maxAnalysisDays);
         mAggrDaysEdit->setSuffix(tr(" days"));
         mAggrDaysEdit->setToolTip(tr("The number of days to aggregate movement over. This should reflect how fast you want your stock to sell."));
         mAggrDaysEdit->setValue(
@@ -347,6 +347,7 @@ namespace Evernus
 
     void ImportingAnalysisWidget::completeImport()
     {
+        mDataModel.invalidateCache();
         mImportedNewData = true;
     }
 
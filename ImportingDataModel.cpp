@@ -12,30 +12,25 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <type_traits>
-#include <future>
+#include <unordered_set>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <cmath>
-#include <mutex>
-#include <set>
 
-#include <QCoreApplication>
-#include <QSettings>
 #include <QLocale>
 #include <QColor>
 #include <QIcon>
 
 #include <QtConcurrent>
 
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/accumulators.hpp>
 #include <boost/range/adaptor/reversed.hpp>
-#include <boost/range/adaptor/filtered.hpp>
 #include <boost/scope_exit.hpp>
 
-#include "MarketAnalysisSettings.h"
+#include "PerformanceTracer.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
-#include "PriceSettings.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
 #include "TextUtils.h"
@@ -43,8 +38,6 @@
 
 #include "ImportingDataModel.h"
 
-using namespace boost::accumulators;
-
 namespace Evernus
 {
     ImportingDataModel::ImportingDataModel(const EveDataProvider &dataProvider, QObject *parent)
@@ -242,6 +235,8 @@ namespace Evernus
                                           PriceType collateralType,
                                           bool hideEmptySell)
     {
+        const TraceSpan span{"analysis", "ImportingDataModel::setOrderData"};
+
         beginResetModel();
 
         BOOST_SCOPE_EXIT(this_) {
@@ -250,250 +245,277 @@ namespace Evernus
 
         mData.clear();
 
-        const auto dstHistory = history.find(mDataProvider.getStationRegionId(dstStation));
-        if (dstHistory == std::end(history))
-            return;
+        const auto dstRegionId = mDataProvider.getStationRegionId(dstStation);
+        const auto srcRegionId = mDataProvider.getStationRegionId(srcStation);
 
-        const auto srcHistory = history.find(mDataProvider.getStationRegionId(srcStation));
-        if (srcHistory == std::end(history))
+        if (history.find(dstRegionId) == std::end(history) || history.find(srcRegionId) == std::end(history))
             return;
 
-        struct TypeMapData
-        {
-            quint64 mTotalVolume = 0;
-            quint64 mMedianVolume = 0;
-            double mDstPrice = 0.;
-            double mSrcPrice = 0.;
-            quint64 mSrcOrderCount = 0;
-            quint64 mDstOrderCount = 0;
-        };
+        // stage 1: filter and group orders per station - both sides are kept, so price type changes are free
+        cacheStationOrders(orders, srcStation, dstStation);
 
-        TypeMap<TypeMapData> typeMap;
-        TypeMap<quint64> srcVolumes, dstVolumes, dstSellVolumes;
-        TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, ExternalOrder::LowToHigh>> dstOrders;
-        TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, ExternalOrder::HighToLow>> srcOrders;
+        // stage 2: aggregate history per region - independent of any analysis parameters
+        const auto &dstHistory = getHistoryAggregates(history, dstRegionId);
+        const auto &srcHistory = getHistoryAggregates(history, srcRegionId);
 
-        // gather prices and volumes from dst orders - we need those to calculate percentile dst price
-        auto dstFuture = std::async(std::launch::async, [&] {
-            const auto dstOrderFilter = [=](const auto &order) {
-                return order.getStationId() == dstStation;
-            };
+        auto &dstStationOrders = mStationOrderCache[dstStation];
+        auto &srcStationOrders = mStationOrderCache[srcStation];
 
-            for (const auto &order : orders | boost::adaptors::filtered(dstOrderFilter))
-            {
-                const auto typeId = order.getTypeId();
-                const auto type = order.getType();
+        const auto volumePercentile = 0.05;
+        const auto preferredMargin = SettingsSnapshotUtils::getSnapshot()->mPreferredMargin / 100.;
 
-                if (dstPriceType == type)
-                {
-                    dstOrders[typeId].emplace(std::cref(order));
-                    dstVolumes[typeId] += order.getVolumeRemaining();
-                }
+        PriceUtils::Taxes taxes;
 
-                if (type == ExternalOrder::Type::Sell)
-                    dstSellVolumes[typeId] += order.getVolumeRemaining();
-            }
-        });
+        const auto useSkillsForDifference = mCharacter && SettingsSnapshotUtils::getSnapshot()->mUseSkillsForDifference;
 
-        // gather prices and volumes from src orders - we need those to calculate percentile src price
-        auto srcFuture = std::async(std::launch::async, [&] {
-            const auto srcOrderFilter = [=](const auto &order) {
-                return order.getStationId() == srcStation && srcPriceType == order.getType();
-            };
+        if (useSkillsForDifference)
+            taxes = PriceUtils::calculateTaxes(*mCharacter);
 
-            for (const auto &order : orders | boost::adaptors::filtered(srcOrderFilter))
-            {
-                const auto typeId = order.getTypeId();
-                srcOrders[typeId].emplace(std::cref(order));
-                srcVolumes[typeId] += order.getVolumeRemaining();
-            }
-        });
+        hideEmptySell = hideEmptySell && srcPriceType == PriceType::Sell;
 
-        const auto historyLimit = QDate::currentDate().addDays(-analysisDays + 1);
+        const auto discardBogusOrders = mDiscardBogusOrders;
+        const auto bogusOrderThreshold = mBogusOrderThreshold;
 
-        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+        // returns number of points in the analysis period, since ages are sorted
+        const auto getPeriodSize = [=](const auto &aggregates) {
+            return static_cast<std::size_t>(std::distance(
+                std::begin(aggregates.mAges),
+                std::lower_bound(std::begin(aggregates.mAges), std::end(aggregates.mAges), analysisDays)
+            ));
+        };
 
-        dstFuture.get();
-        srcFuture.get();
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
 
-        QSettings settings;
+        // stage 3: compute prices and margins for every type
+        // NOTE: using std::function because QtConcurrent::mapped cannot infer the result type properly
+        const std::function<TypeData (EveType::IdType)> calculateType = [&](auto typeId) {
+            // each type touches only its own order lists, so they can be reordered concurrently
+            auto &typeSrcOrders = srcStationOrders.find(typeId)->second;
+            auto &typeDstOrders = dstStationOrders.find(typeId)->second;
 
-        const auto volumePercentile = 0.05;
-        const auto preferredMargin
-            = settings.value(PriceSettings::preferredMarginKey, PriceSettings::preferredMarginDefault).toDouble() / 100.;
+            auto &srcList = (srcPriceType == PriceType::Buy) ? (typeSrcOrders.mBuyOrders) : (typeSrcOrders.mSellOrders);
+            auto &dstList = (dstPriceType == PriceType::Buy) ? (typeDstOrders.mBuyOrders) : (typeDstOrders.mSellOrders);
 
-        // fill our type map with order data
-        for (const auto &order : orders)
-        {
-            const auto typeId = order.getTypeId();
-            const auto type = typeMap.find(typeId);
-            if (type != std::end(typeMap))
-                continue;
+            if (hideEmptySell && srcList.empty())
+                return TypeData{};
 
-            auto &data = typeMap[typeId];
+            TypeData data;
+            data.mId = typeId;
+            data.mSrcOrderCount = srcList.size();
+            data.mDstOrderCount = dstList.size();
+            data.mDstVolume = typeDstOrders.mSellVolume;
 
-            accumulator_set<double, stats<tag::mean>> dstPriceAcc;
-            accumulator_set<double, stats<tag::mean>> srcPriceAcc;
+            quint64 totalVolume = 0;
+            auto dstAvgPrice = nan;
 
             std::vector<quint64> historyVolumes(analysisDays);
-            auto curHistoryVolume = std::begin(historyVolumes);
 
-            // go through dst history to calculate avg price and total trade volume
-            const auto dstTypeHistory = dstHistory->second.find(typeId);
-            if (Q_LIKELY(dstTypeHistory != std::end(dstHistory->second)))
+            const auto dstTypeHistory = dstHistory.find(typeId);
+            if (Q_LIKELY(dstTypeHistory != std::end(dstHistory)))
             {
-                for (const auto &timePoint : boost::adaptors::reverse(dstTypeHistory->second))
-                {
-                    if (Q_UNLIKELY(timePoint.first < historyLimit))
-                        break;
+                const auto &aggregates = dstTypeHistory->second;
+                const auto size = getPeriodSize(aggregates);
 
-                    data.mTotalVolume += timePoint.second.mVolume;
-                    dstPriceAcc(timePoint.second.mAvgPrice);
+                totalVolume = aggregates.mVolumeSums[size];
+                if (size > 0)
+                    dstAvgPrice = aggregates.mPriceSums[size] / size;
 
-                    *(curHistoryVolume++) = timePoint.second.mVolume;
-                }
+                std::copy(std::begin(aggregates.mVolumes), std::next(std::begin(aggregates.mVolumes), size), std::begin(historyVolumes));
             }
 
             std::nth_element(std::begin(historyVolumes), std::begin(historyVolumes) + historyVolumes.size() / 2, std::end(historyVolumes));
             data.mMedianVolume = historyVolumes[historyVolumes.size() / 2];
 
-            const auto srcTypeHistory = srcHistory->second.find(typeId);
-            if (Q_LIKELY(srcTypeHistory != std::end(srcHistory->second)))
+            data.mAvgVolume = static_cast<double>(totalVolume) * aggrDays / analysisDays;
+
+            auto absDeviationSum = 0.;
+
+            if (Q_LIKELY(dstTypeHistory != std::end(dstHistory)))
             {
-                for (const auto &timePoint : boost::adaptors::reverse(srcTypeHistory->second))
-                {
-                    if (Q_UNLIKELY(timePoint.first < historyLimit))
-                        break;
+                const auto &aggregates = dstTypeHistory->second;
+                const auto size = getPeriodSize(aggregates);
 
-                    srcPriceAcc(timePoint.second.mAvgPrice);
-                }
+                for (auto i = 0u; i < size; ++i)
+                    absDeviationSum += std::abs(aggregates.mVolumes[i] - data.mAvgVolume);
             }
 
-            const auto &typeSrcOrders = srcOrders[typeId];
-            const auto &typeDstOrders = dstOrders[typeId];
+            data.mVolumeMAD = absDeviationSum / analysisDays;
 
-            data.mSrcOrderCount = typeSrcOrders.size();
-            data.mDstOrderCount = typeDstOrders.size();
+            auto srcAvgPrice = nan;
 
-            // dst orders are by default sorted from lowest price, which means we need to reverse them if we
-            // want to sell to buy orders, which are highest first
-            if (dstPriceType == PriceType::Sell)
-            {
-                data.mDstPrice = MathUtils::calcPercentile(typeDstOrders,
-                                                           dstVolumes[typeId] * volumePercentile,
-                                                           mean(dstPriceAcc),
-                                                           mDiscardBogusOrders,
-                                                           mBogusOrderThreshold);
-            }
-            else
+            const auto srcTypeHistory = srcHistory.find(typeId);
+            if (Q_LIKELY(srcTypeHistory != std::end(srcHistory)))
             {
-                data.mDstPrice = MathUtils::calcPercentile(boost::adaptors::reverse(typeDstOrders),
-                                                           dstVolumes[typeId] * volumePercentile,
-                                                           mean(dstPriceAcc),
-                                                           mDiscardBogusOrders,
-                                                           mBogusOrderThreshold);
+                const auto &aggregates = srcTypeHistory->second;
+                const auto size = getPeriodSize(aggregates);
+
+                if (size > 0)
+                    srcAvgPrice = aggregates.mPriceSums[size] / size;
             }
 
-            // same logic for src orders
-            if (srcPriceType == PriceType::Buy)
+            auto dstPrice = MathUtils::calcPercentile(dstList,
+                                                      dstPriceType,
+                                                      ((dstPriceType == PriceType::Buy) ? (typeDstOrders.mBuyVolume) : (typeDstOrders.mSellVolume)) * volumePercentile,
+                                                      dstAvgPrice,
+                                                      discardBogusOrders,
+                                                      bogusOrderThreshold);
+            const auto srcPrice = MathUtils::calcPercentile(srcList,
+                                                            srcPriceType,
+                                                            ((srcPriceType == PriceType::Buy) ? (typeSrcOrders.mBuyVolume) : (typeSrcOrders.mSellVolume)) * volumePercentile,
+                                                            srcAvgPrice,
+                                                            discardBogusOrders,
+                                                            bogusOrderThreshold);
+
+            // check if this was traded at all
+            if (qFuzzyIsNull(dstPrice))
+                dstPrice = srcPrice * (1 + preferredMargin);
+
+            if (useSkillsForDifference)
             {
-                data.mSrcPrice = MathUtils::calcPercentile(typeSrcOrders,
-                                                           srcVolumes[typeId] * volumePercentile,
-                                                           mean(srcPriceAcc),
-                                                           mDiscardBogusOrders,
-                                                           mBogusOrderThreshold);
+                data.mDstPrice = (dstPriceType == PriceType::Sell) ?
+                                 (PriceUtils::getSellPrice(dstPrice, taxes)) :
+                                 (PriceUtils::getSellPrice(dstPrice, taxes, false));
+                data.mSrcPrice = (srcPriceType == PriceType::Buy) ?
+                                 (PriceUtils::getBuyPrice(srcPrice, taxes)) :
+                                 (PriceUtils::getBuyPrice(srcPrice, taxes, false));
             }
             else
             {
-                data.mSrcPrice = MathUtils::calcPercentile(boost::adaptors::reverse(typeSrcOrders),
-                                                           srcVolumes[typeId] * volumePercentile,
-                                                           mean(srcPriceAcc),
-                                                           mDiscardBogusOrders,
-                                                           mBogusOrderThreshold);
+                data.mDstPrice = dstPrice;
+                data.mSrcPrice = srcPrice;
             }
 
-            // check if this was traded at all
-            if (qFuzzyIsNull(data.mDstPrice))
-                data.mDstPrice = data.mSrcPrice * (1 + preferredMargin);
+            const auto collateralPrice = (collateralType == PriceType::Buy) ? (data.mSrcPrice) : (data.mDstPrice);
+
+            data.mImportPrice = data.mSrcPrice + collateralPrice * collateral + mDataProvider.getTypeVolume(data.mId) * pricePerM3;
+            data.mPriceDifference = data.mDstPrice - data.mImportPrice;
+            data.mMargin = (qFuzzyIsNull(data.mDstPrice)) ? (0.) : (100. * data.mPriceDifference / data.mDstPrice);
+            data.mProjectedProfit = data.mAvgVolume * data.mPriceDifference;
 
-            QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+            return data;
+        };
+
+        const auto fillData = [](auto &result, const auto &data) {
+            if (data.mId != EveType::invalidId)
+                result.emplace_back(data);
+        };
+
+        // make sure all lists exist up front, so workers don't modify the maps themselves
+        for (const auto typeId : mOrderTypes)
+        {
+            srcStationOrders[typeId];
+            dstStationOrders[typeId];
         }
 
-        PriceUtils::Taxes taxes;
+        mData = QtConcurrent::blockingMappedReduced<decltype(mData)>(mOrderTypes, calculateType, fillData, QtConcurrent::UnorderedReduce);
+    }
 
-        const auto useSkillsForDifference = mCharacter && settings.value(
-            MarketAnalysisSettings::useSkillsForDifferenceKey, MarketAnalysisSettings::useSkillsForDifferenceDefault).toBool();
+    void ImportingDataModel::reset()
+    {
+        beginResetModel();
+        mData.clear();
+        endResetModel();
 
-        if (useSkillsForDifference)
-            taxes = PriceUtils::calculateTaxes(*mCharacter);
+        invalidateCache();
+    }
 
-        mData.reserve(typeMap.size());
+    void ImportingDataModel::invalidateCache()
+    {
+        mStationOrderCache.clear();
+        mHistoryCache.clear();
+        mOrderTypes.clear();
+    }
 
-        hideEmptySell = hideEmptySell && srcPriceType == PriceType::Sell;
+    void ImportingDataModel::cacheStationOrders(const std::vector<ExternalOrder> &orders, quint64 srcStation, quint64 dstStation)
+    {
+        const auto cacheSrc = mStationOrderCache.find(srcStation) == std::end(mStationOrderCache);
+        const auto cacheDst = dstStation != srcStation && mStationOrderCache.find(dstStation) == std::end(mStationOrderCache);
 
-        std::mutex dataMutex;
+        if (!cacheSrc && !cacheDst && !mOrderTypes.empty())
+            return;
 
-        QtConcurrent::blockingMap(typeMap, [&](const auto &type) {
-            if (hideEmptySell && type.second.mSrcOrderCount == 0)
-                return;
+        auto &srcOrders = mStationOrderCache[srcStation];
+        auto &dstOrders = mStationOrderCache[dstStation];
 
-            const auto dstVolume = dstSellVolumes.find(type.first);
+        const auto fillTypes = mOrderTypes.empty();
+        std::unordered_set<EveType::IdType> types;
 
-            TypeData data;
-            data.mId = type.first;
-            data.mAvgVolume = static_cast<double>(type.second.mTotalVolume) * aggrDays / analysisDays;
-            data.mMedianVolume = type.second.mMedianVolume;
-            data.mDstVolume = (dstVolume == std::end(dstSellVolumes)) ? (0) : (dstVolume->second);
-            data.mSrcOrderCount = type.second.mSrcOrderCount;
-            data.mDstOrderCount = type.second.mDstOrderCount;
+        for (const auto &order : orders)
+        {
+            const auto typeId = order.getTypeId();
 
-            auto absDeviationSum = 0.;
+            if (fillTypes)
+                types.insert(typeId);
 
-            const auto dstTypeHistory = dstHistory->second.find(data.mId);
-            if (Q_LIKELY(dstTypeHistory != std::end(dstHistory->second)))
+            const auto stationId = order.getStationId();
+            if ((stationId == srcStation && cacheSrc) || (stationId == dstStation && cacheDst))
             {
-                for (const auto &timePoint : boost::adaptors::reverse(dstTypeHistory->second))
-                {
-                    if (Q_UNLIKELY(timePoint.first < historyLimit))
-                        break;
+                auto &typeOrders = (stationId == srcStation) ? (srcOrders[typeId]) : (dstOrders[typeId]);
+                const auto volume = order.getVolumeRemaining();
 
-                    absDeviationSum += std::abs(timePoint.second.mVolume - data.mAvgVolume);
+                if (order.getType() == ExternalOrder::Type::Buy)
+                {
+                    typeOrders.mBuyOrders.emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                    typeOrders.mBuyVolume += volume;
+                }
+                else
+                {
+                    typeOrders.mSellOrders.emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                    typeOrders.mSellVolume += volume;
                 }
             }
+        }
 
-            data.mVolumeMAD = absDeviationSum / analysisDays;
+        if (fillTypes)
+            mOrderTypes.assign(std::begin(types), std::end(types));
+    }
 
-            if (useSkillsForDifference)
-            {
-                data.mDstPrice = (dstPriceType == PriceType::Sell) ?
-                                 (PriceUtils::getSellPrice(type.second.mDstPrice, taxes)) :
-                                 (PriceUtils::getSellPrice(type.second.mDstPrice, taxes, false));
-                data.mSrcPrice = (srcPriceType == PriceType::Buy) ?
-                                 (PriceUtils::getBuyPrice(type.second.mSrcPrice, taxes)) :
-                                 (PriceUtils::getBuyPrice(type.second.mSrcPrice, taxes, false));
-            }
-            else
-            {
-                data.mDstPrice = type.second.mDstPrice;
-                data.mSrcPrice = type.second.mSrcPrice;
-            }
+    const ImportingDataModel::HistoryAggregateMap &ImportingDataModel
+    ::getHistoryAggregates(const HistoryRegionMap &history, uint regionId)
+    {
+        const auto today = QDate::currentDate();
+        if (mHistoryCacheDate != today)
+        {
+            mHistoryCache.clear();
+            mHistoryCacheDate = today;
+        }
 
-            const auto collateralPrice = (collateralType == PriceType::Buy) ? (data.mSrcPrice) : (data.mDstPrice);
+        const auto cached = mHistoryCache.find(regionId);
+        if (cached != std::end(mHistoryCache))
+            return cached->second;
 
-            data.mImportPrice = data.mSrcPrice + collateralPrice * collateral + mDataProvider.getTypeVolume(data.mId) * pricePerM3;
-            data.mPriceDifference = data.mDstPrice - data.mImportPrice;
-            data.mMargin = (qFuzzyIsNull(data.mDstPrice)) ? (0.) : (100. * data.mPriceDifference / data.mDstPrice);
-            data.mProjectedProfit = data.mAvgVolume * data.mPriceDifference;
+        auto &result = mHistoryCache[regionId];
+
+        const auto regionHistory = history.find(regionId);
+        if (regionHistory == std::end(history))
+            return result;
 
-            std::lock_guard<std::mutex> lock{dataMutex};
-            mData.emplace_back(std::move(data));
+        std::vector<EveType::IdType> types;
+        types.reserve(regionHistory->second.size());
+
+        for (const auto &type : regionHistory->second)
+        {
+            types.emplace_back(type.first);
+            result[type.first];
+        }
+
+        QtConcurrent::blockingMap(types, [&](auto typeId) {
+            const auto &typeHistory = regionHistory->second.find(typeId)->second;
+            auto &aggregates = result.find(typeId)->second;
+
+            for (const auto &timePoint : boost::adaptors::reverse(typeHistory))
+            {
+                const auto age = timePoint.first.daysTo(today);
+                if (Q_UNLIKELY(age >= maxAnalysisDays))
+                    break;
+
+                aggregates.mAges.emplace_back(age);
+                aggregates.mVolumes.emplace_back(timePoint.second.mVolume);
+                aggregates.mVolumeSums.emplace_back(aggregates.mVolumeSums.back() + timePoint.second.mVolume);
+                aggregates.mPriceSums.emplace_back(aggregates.mPriceSums.back() + timePoint.second.mAvgPrice);
+            }
         });
-    }
 
-    void ImportingDataModel::reset()
-    {
-        beginResetModel();
-        mData.clear();
-        endResetModel();
+        return result;
     }
 }
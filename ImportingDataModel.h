@@ -24,6 +24,7 @@
 
 #include "ModelWithTypes.h"
 #include "MarketHistory.h"
+#include "MathUtils.h"
 #include "Character.h"
 #include "PriceType.h"
 
@@ -66,6 +67,8 @@ namespace Evernus
         using HistoryTypeMap = TypeMap<MarketHistory>;
         using HistoryRegionMap = RegionMap<HistoryTypeMap>;
 
+        static const auto maxAnalysisDays = 365;
+
         explicit ImportingDataModel(const EveDataProvider &dataProvider, QObject *parent = nullptr);
         ImportingDataModel(const ImportingDataModel &) = default;
         ImportingDataModel(ImportingDataModel &&) = default;
@@ -96,6 +99,7 @@ namespace Evernus
                           bool hideEmptySell);
 
         void reset();
+        void invalidateCache();
 
         ImportingDataModel &operator =(const ImportingDataModel &) = default;
         ImportingDataModel &operator =(ImportingDataModel &&) = default;
@@ -118,13 +122,41 @@ namespace Evernus
             quint64 mDstOrderCount = 0;
         };
 
+        struct StationTypeOrders
+        {
+            MathUtils::PriceVolumeList mBuyOrders;
+            MathUtils::PriceVolumeList mSellOrders;
+            quint64 mBuyVolume = 0;
+            quint64 mSellVolume = 0;
+        };
+
+        // history points newest first, with running sums, so any analysis period is a prefix lookup
+        struct TypeHistoryAggregates
+        {
+            std::vector<int> mAges;
+            std::vector<quint64> mVolumes;
+            std::vector<quint64> mVolumeSums{0};
+            std::vector<double> mPriceSums{0.};
+        };
+
+        using StationOrderMap = TypeMap<StationTypeOrders>;
+        using HistoryAggregateMap = TypeMap<TypeHistoryAggregates>;
+
         const EveDataProvider &mDataProvider;
 
         std::shared_ptr<Character> mCharacter;
 
         std::vector<TypeData> mData;
 
+        std::unordered_map<quint64, StationOrderMap> mStationOrderCache;
+        RegionMap<HistoryAggregateMap> mHistoryCache;
+        std::vector<EveType::IdType> mOrderTypes;
+        QDate mHistoryCacheDate;
+
         bool mDiscardBogusOrders = true;
         double mBogusOrderThreshold = 0.9;
+
+        void cacheStationOrders(const std::vector<ExternalOrder> &orders, quint64 srcStation, quint64 dstStation);
+        const HistoryAggregateMap &getHistoryAggregates(const HistoryRegionMap &history, uint regionId);
     };
 }
@@ -17,8 +17,6 @@
 #include <future>
 #include <cmath>
 
-#include <boost/range/algorithm/max_element.hpp>
-#include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/scope_exit.hpp>
 
@@ -60,24 +58,8 @@ namespace Evernus
 
     quint64 IndustryManufacturingSetupModel::TreeItem::getEffectiveQuantityRequired() const
     {
-        if (Q_UNLIKELY(isOutput()))
-            return 0;
-
-        const auto &settings = mSetup.getTypeSettings(mTypeId);
-        if (settings.mSource == IndustryManufacturingSetup::InventorySource::Manufacture ||
-            settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
-        {
-            return getEffectiveRuns() * mManufacturingInfo.mQuantity;
-        }
-
-        auto required = getQuantityRequiredForParent();
-        if (settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyAtCustomCost ||
-            settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyFromSource)
-        {
-            required -= mAssetQuantity;
-        }
-
-        return required;
+        ensureQuantitiesEvaluated();
+        return mEvaluation.mQuantityRequired;
     }
 
     uint IndustryManufacturingSetupModel::TreeItem::getQuantityRequired() const noexcept
@@ -87,7 +69,7 @@ namespace Evernus
 
     quint64 IndustryManufacturingSetupModel::TreeItem::getQuantityRequiredForParent() const
     {
-        return IndustryUtils::getRequiredQuantity(mParent->getEffectiveRuns(),
+        return IndustryUtils::getRequiredQuantity(mParent->getCurrentRuns(),
                                                   mQuantityRequired,
                                                   mParent->getMaterialEfficiency(),
                                                   mModel.mFacilityType,
@@ -107,28 +89,17 @@ namespace Evernus
 
     void IndustryManufacturingSetupModel::TreeItem::setAssetQuantity(quint64 value) noexcept
     {
+        if (mAssetQuantity == value)
+            return;
+
         mAssetQuantity = value;
+        mModel.invalidate(*this);
     }
 
     uint IndustryManufacturingSetupModel::TreeItem::getEffectiveRuns() const
     {
-        if (Q_UNLIKELY(isOutput()))
-            return mRuns;
-
-        const auto &settings = mSetup.getTypeSettings(mTypeId);
-        if (settings.mSource == IndustryManufacturingSetup::InventorySource::Manufacture ||
-            settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
-        {
-            double required = getQuantityRequiredForParent();
-            if (settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
-                required -= mAssetQuantity;
-
-            Q_ASSERT(mManufacturingInfo.mQuantity > 0);
-            return std::ceil(required / mManufacturingInfo.mQuantity);
-        }
-
-        // we're buying this stuff, so no production
-        return 0;
+        ensureQuantitiesEvaluated();
+        return mEvaluation.mRuns;
     }
 
     uint IndustryManufacturingSetupModel::TreeItem::getRuns() const noexcept
@@ -143,84 +114,20 @@ namespace Evernus
 
     std::chrono::seconds IndustryManufacturingSetupModel::TreeItem::getEffectiveTime() const
     {
-        if (Q_UNLIKELY(isOutput()))
-            return getTimeToManufacture();
-
-        const auto &settings = mSetup.getTypeSettings(mTypeId);
-        if (settings.mSource == IndustryManufacturingSetup::InventorySource::Manufacture ||
-            settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
-        {
-            return getTimeToManufacture();
-        }
-
-        // we're buying this stuff
-        return 0s;
+        ensureQuantitiesEvaluated();
+        return mEvaluation.mTime;
     }
 
     std::chrono::seconds IndustryManufacturingSetupModel::TreeItem::getEffectiveTotalTime() const
     {
-        const std::function<std::chrono::seconds (const TreeItemPtr &)> transform{[](const auto &child) {
-            Q_ASSERT(child);
-            return child->getEffectiveTotalTime();
-        }};
-        const auto maxChildTime = boost::max_element<boost::range_return_value::return_found_end>(
-            mChildItems | boost::adaptors::transformed(transform)
-        );
-        const auto childTime = (maxChildTime.empty()) ? (0s) : (maxChildTime.front());
-
-        return getEffectiveRuns() * getEffectiveTime() + childTime;
+        ensureTotalsEvaluated();
+        return mEvaluation.mTotalTime;
     }
 
     QVariantMap IndustryManufacturingSetupModel::TreeItem::getCost() const
     {
-        double jobFee = 0.;
-        double jobTax = 0.;
-        MarketInfo totalCost{0., true};
-        double childrenCost = 0.;
-
-        const auto computeManufacturingCost = [&] {
-            childrenCost = std::accumulate(std::begin(mChildItems), std::end(mChildItems), 0., [](auto value, const auto &child) {
-                return value + child->getCost()[QStringLiteral("totalCost")].toDouble();
-            });
-
-            jobFee = getJobCost();
-            jobTax = mModel.getJobTax(jobFee);
-            totalCost.mPrice = jobFee + jobTax + childrenCost;
-        };
-
-        if (Q_UNLIKELY(isOutput()))
-        {
-            computeManufacturingCost();
-        }
-        else
-        {
-            const auto &settings = mSetup.getTypeSettings(mTypeId);
-            switch (settings.mSource) {
-            case IndustryManufacturingSetup::InventorySource::AcquireForFree:
-                break;
-            case IndustryManufacturingSetup::InventorySource::BuyAtCustomCost:
-            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyAtCustomCost:
-                Q_ASSERT(mModel.mCharacter);
-                totalCost.mPrice = mModel.mCostProvider.fetchForCharacterAndType(mModel.mCharacter->getId(), mTypeId)->getAdjustedCost() *
-                                   getEffectiveQuantityRequired();
-                break;
-            case IndustryManufacturingSetup::InventorySource::BuyFromSource:
-            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyFromSource:
-                totalCost = mModel.getSrcPrice(mTypeId, getEffectiveQuantityRequired());
-                break;
-            case IndustryManufacturingSetup::InventorySource::Manufacture:
-            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture:
-                computeManufacturingCost();
-            }
-        }
-
-        return {
-            { QStringLiteral("children"), childrenCost },
-            { QStringLiteral("jobFee"), jobFee },
-            { QStringLiteral("jobTax"), jobTax },
-            { QStringLiteral("totalVolumeBought"), totalCost.mAllVolumeMoved },
-            { totalCostKey, totalCost.mPrice },
-        };
+        ensureTotalsEvaluated();
+        return mEvaluation.mCost;
     }
 
     QVariantMap IndustryManufacturingSetupModel::TreeItem::getProfit() const
@@ -275,6 +182,209 @@ namespace Evernus
         mChildItems.clear();
     }
 
+    bool IndustryManufacturingSetupModel::TreeItem::isEvaluated() const noexcept
+    {
+        return mEvaluation.mValid;
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::invalidate() noexcept
+    {
+        mEvaluation.mValid = false;
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::invalidateChildren() noexcept
+    {
+        for (const auto &child : mChildItems)
+        {
+            Q_ASSERT(child);
+
+            child->invalidate();
+            child->invalidateChildren();
+        }
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::evaluateQuantities()
+    {
+        // parent is either already evaluated or evaluated before us in this pass
+        mEvaluation.mQuantityError = (mParent == nullptr) ? (nullptr) : (mParent->mEvaluation.mQuantityError);
+        if (mEvaluation.mQuantityError)
+            return;
+
+        try
+        {
+            if (Q_UNLIKELY(isOutput()))
+            {
+                mEvaluation.mRuns = mRuns;
+                mEvaluation.mQuantityRequired = 0;
+                mEvaluation.mTime = getTimeToManufacture();
+                return;
+            }
+
+            const auto &settings = mSetup.getTypeSettings(mTypeId);
+            const auto requiredForParent = IndustryUtils::getRequiredQuantity(mParent->mEvaluation.mRuns,
+                                                                              mQuantityRequired,
+                                                                              mParent->getMaterialEfficiency(),
+                                                                              mModel.mFacilityType,
+                                                                              mModel.mSecurityStatus,
+                                                                              mModel.mMaterialRigType);
+
+            if (settings.mSource == IndustryManufacturingSetup::InventorySource::Manufacture ||
+                settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
+            {
+                double required = requiredForParent;
+                if (settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
+                    required -= mAssetQuantity;
+
+                Q_ASSERT(mManufacturingInfo.mQuantity > 0);
+
+                mEvaluation.mRuns = std::ceil(required / mManufacturingInfo.mQuantity);
+                mEvaluation.mQuantityRequired = mEvaluation.mRuns * mManufacturingInfo.mQuantity;
+                mEvaluation.mTime = getTimeToManufacture();
+            }
+            else
+            {
+                // we're buying this stuff, so no production
+                mEvaluation.mRuns = 0;
+                mEvaluation.mQuantityRequired = requiredForParent;
+                mEvaluation.mTime = 0s;
+
+                if (settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyAtCustomCost ||
+                    settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyFromSource)
+                {
+                    mEvaluation.mQuantityRequired -= mAssetQuantity;
+                }
+            }
+        }
+        catch (const IndustryManufacturingSetup::NotSourceTypeException &)
+        {
+            mEvaluation.mQuantityError = std::current_exception();
+        }
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::evaluateTotals()
+    {
+        // children are either already evaluated or evaluated before us in this pass
+        mEvaluation.mValid = true;
+        mEvaluation.mTotalsError = mEvaluation.mQuantityError;
+
+        auto maxChildTime = 0s;
+        for (const auto &child : mChildItems)
+        {
+            Q_ASSERT(child);
+
+            if (child->mEvaluation.mTotalsError)
+                mEvaluation.mTotalsError = child->mEvaluation.mTotalsError;
+            else
+                maxChildTime = std::max(maxChildTime, child->mEvaluation.mTotalTime);
+        }
+
+        if (mEvaluation.mTotalsError)
+            return;
+
+        try
+        {
+            mEvaluation.mTotalTime = mEvaluation.mRuns * mEvaluation.mTime + maxChildTime;
+            mEvaluation.mCost = calculateCost();
+            mEvaluation.mTotalCost = mEvaluation.mCost[totalCostKey].toDouble();
+        }
+        catch (const IndustryManufacturingSetup::NotSourceTypeException &)
+        {
+            mEvaluation.mTotalsError = std::current_exception();
+        }
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::ensureQuantitiesEvaluated() const
+    {
+        if (!mEvaluation.mValid)
+            mModel.evaluate();
+
+        if (mEvaluation.mQuantityError)
+            std::rethrow_exception(mEvaluation.mQuantityError);
+    }
+
+    void IndustryManufacturingSetupModel::TreeItem::ensureTotalsEvaluated() const
+    {
+        if (!mEvaluation.mValid)
+            mModel.evaluate();
+
+        if (mEvaluation.mTotalsError)
+            std::rethrow_exception(mEvaluation.mTotalsError);
+    }
+
+    uint IndustryManufacturingSetupModel::TreeItem::getCurrentRuns() const
+    {
+        // note: doesn't use evaluated values, since assets are redistributed between evaluations
+        if (Q_UNLIKELY(isOutput()))
+            return mRuns;
+
+        const auto &settings = mSetup.getTypeSettings(mTypeId);
+        if (settings.mSource == IndustryManufacturingSetup::InventorySource::Manufacture ||
+            settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
+        {
+            double required = getQuantityRequiredForParent();
+            if (settings.mSource == IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture)
+                required -= mAssetQuantity;
+
+            Q_ASSERT(mManufacturingInfo.mQuantity > 0);
+            return std::ceil(required / mManufacturingInfo.mQuantity);
+        }
+
+        // we're buying this stuff, so no production
+        return 0;
+    }
+
+    QVariantMap IndustryManufacturingSetupModel::TreeItem::calculateCost() const
+    {
+        double jobFee = 0.;
+        double jobTax = 0.;
+        MarketInfo totalCost{0., true};
+        double childrenCost = 0.;
+
+        const auto computeManufacturingCost = [&] {
+            childrenCost = std::accumulate(std::begin(mChildItems), std::end(mChildItems), 0., [](auto value, const auto &child) {
+                return value + child->mEvaluation.mTotalCost;
+            });
+
+            jobFee = getJobCost();
+            jobTax = mModel.getJobTax(jobFee);
+            totalCost.mPrice = jobFee + jobTax + childrenCost;
+        };
+
+        if (Q_UNLIKELY(isOutput()))
+        {
+            computeManufacturingCost();
+        }
+        else
+        {
+            const auto &settings = mSetup.getTypeSettings(mTypeId);
+            switch (settings.mSource) {
+            case IndustryManufacturingSetup::InventorySource::AcquireForFree:
+                break;
+            case IndustryManufacturingSetup::InventorySource::BuyAtCustomCost:
+            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyAtCustomCost:
+                Q_ASSERT(mModel.mCharacter);
+                totalCost.mPrice = mModel.mCostProvider.fetchForCharacterAndType(mModel.mCharacter->getId(), mTypeId)->getAdjustedCost() *
+                                   mEvaluation.mQuantityRequired;
+                break;
+            case IndustryManufacturingSetup::InventorySource::BuyFromSource:
+            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenBuyFromSource:
+                totalCost = mModel.getSrcPrice(mTypeId, mEvaluation.mQuantityRequired);
+                break;
+            case IndustryManufacturingSetup::InventorySource::Manufacture:
+            case IndustryManufacturingSetup::InventorySource::TakeAssetsThenManufacture:
+                computeManufacturingCost();
+            }
+        }
+
+        return {
+            { QStringLiteral("children"), childrenCost },
+            { QStringLiteral("jobFee"), jobFee },
+            { QStringLiteral("jobTax"), jobTax },
+            { QStringLiteral("totalVolumeBought"), totalCost.mAllVolumeMoved },
+            { totalCostKey, totalCost.mPrice },
+        };
+    }
+
     uint IndustryManufacturingSetupModel::TreeItem::getMaterialEfficiency() const
     {
         if (Q_UNLIKELY(isOutput()))
@@ -338,7 +448,7 @@ namespace Evernus
         );
 
         const auto omegaCost = baseJobCost * mModel.getSystemCostIndex();
-        return ((mModel.mCharacter->isAlphaClone()) ? (omegaCost + baseJobCost * 0.02) : (omegaCost)) * getEffectiveRuns();
+        return ((mModel.mCharacter->isAlphaClone()) ? (omegaCost + baseJobCost * 0.02) : (omegaCost)) * mEvaluation.mRuns;
     }
 
     IndustryManufacturingSetupModel::IndustryManufacturingSetupModel(IndustryManufacturingSetup &setup,
@@ -529,6 +639,7 @@ namespace Evernus
 
         mRoot.clearChildren();
         mTypeItemMap.clear();
+        mEvaluationOrder.clear();
 
         const auto &output = mSetup.getOutputTypes();
         for (const auto &outputType : output)
@@ -537,6 +648,7 @@ namespace Evernus
             fillChildren(*child);
 
             mTypeItemMap.emplace(outputType.first, std::ref(*child));
+            mEvaluationOrder.emplace_back(std::ref(*child));
             mRoot.appendChild(std::move(child));
         }
 
@@ -593,6 +705,7 @@ namespace Evernus
                 Q_ASSERT(item);
 
                 item->setRuns(runs);
+                invalidate(*item);
                 fillItemAssets();
 
                 // note: don't emit manufacturing roles change, because this will propagate from children
@@ -618,6 +731,7 @@ namespace Evernus
     void IndustryManufacturingSetupModel::setTimeEfficiency(EveType::IdType id, uint value)
     {
         mSetup.setTimeEfficiency(id, value);
+        invalidate(id);
         signalTimeChange(id);
         signalRoleChange(id, { TimeEfficiencyRole });
     }
@@ -665,6 +779,7 @@ namespace Evernus
 
         mRoot.clearChildren();
         mTypeItemMap.clear();
+        mEvaluationOrder.clear();
         mAssetQuantities.clear();
     }
 
@@ -819,6 +934,7 @@ namespace Evernus
 
     void IndustryManufacturingSetupModel::signalTimeEfficiencyExternallyChanged(EveType::IdType id)
     {
+        invalidate(id);
         signalTimeChange(id);
         signalRoleChange(id, { TimeEfficiencyRole, TimeEfficiencyEditRole });
     }
@@ -832,10 +948,55 @@ namespace Evernus
             fillChildren(*child);
 
             mTypeItemMap.emplace(source.mMaterialId, std::ref(*child));
+            mEvaluationOrder.emplace_back(std::ref(*child));
             item.appendChild(std::move(child));
         }
     }
 
+    void IndustryManufacturingSetupModel::evaluate()
+    {
+        // evaluation order lists children before parents, so quantities are propagated down in reverse and totals are
+        // accumulated up in order, each in a single pass over invalidated items
+        for (auto item = mEvaluationOrder.rbegin(); item != mEvaluationOrder.rend(); ++item)
+        {
+            if (!item->get().isEvaluated())
+                item->get().evaluateQuantities();
+        }
+
+        for (auto &item : mEvaluationOrder)
+        {
+            if (!item.get().isEvaluated())
+                item.get().evaluateTotals();
+        }
+    }
+
+    void IndustryManufacturingSetupModel::invalidate(TreeItem &item) noexcept
+    {
+        // quantities depend on parents, while times and costs depend on children
+        item.invalidate();
+        item.invalidateChildren();
+
+        auto parent = item.getParent();
+        while (parent != nullptr && parent != &mRoot)
+        {
+            parent->invalidate();
+            parent = parent->getParent();
+        }
+    }
+
+    void IndustryManufacturingSetupModel::invalidate(EveType::IdType typeId) noexcept
+    {
+        const auto items = mTypeItemMap.equal_range(typeId);
+        for (auto item = items.first; item != items.second; ++item)
+            invalidate(item->second.get());
+    }
+
+    void IndustryManufacturingSetupModel::invalidateAll() noexcept
+    {
+        for (auto &item : mEvaluationOrder)
+            item.get().invalidate();
+    }
+
     IndustryManufacturingSetupModel::TreeItemPtr IndustryManufacturingSetupModel
     ::createOutputItem(EveType::IdType typeId, const IndustryManufacturingSetup::OutputSettings &settings)
     {
@@ -913,6 +1074,9 @@ namespace Evernus
 
     void IndustryManufacturingSetupModel::signalRoleChange(const QVector<int> &roles)
     {
+        // global changes can affect any evaluated value
+        invalidateAll();
+
         for (const auto &item : mTypeItemMap)
             signalRoleChange(item.second.get(), roles);
     }
@@ -990,6 +1154,7 @@ namespace Evernus
 
     void IndustryManufacturingSetupModel::roleAndQuantityChange(EveType::IdType typeId, const QVector<int> &roles)
     {
+        invalidate(typeId);
         fillItemAssets();
         signalRoleChange(typeId, roles);
     }
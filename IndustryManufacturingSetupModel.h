@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <exception>
 #include <vector>
 #include <memory>
 #include <chrono>
@@ -168,6 +169,13 @@ namespace Evernus
             void appendChild(std::unique_ptr<TreeItem> child);
             void clearChildren() noexcept;
 
+            bool isEvaluated() const noexcept;
+            void invalidate() noexcept;
+            void invalidateChildren() noexcept;
+
+            void evaluateQuantities();
+            void evaluateTotals();
+
             inline auto begin() noexcept
             {
                 return std::begin(mChildItems);
@@ -189,6 +197,20 @@ namespace Evernus
             }
 
         private:
+            // values computed by the model evaluation pass, valid until invalidated
+            struct Evaluation
+            {
+                quint64 mQuantityRequired = 0;
+                uint mRuns = 0;
+                std::chrono::seconds mTime{0};
+                std::chrono::seconds mTotalTime{0};
+                double mTotalCost = 0.;
+                QVariantMap mCost;
+                std::exception_ptr mQuantityError;
+                std::exception_ptr mTotalsError;
+                bool mValid = false;
+            };
+
             IndustryManufacturingSetupModel &mModel;
             const IndustryManufacturingSetup &mSetup;
             TreeItem *mParent = nullptr;
@@ -198,6 +220,13 @@ namespace Evernus
             uint mRuns = 1;
             Evernus::EveDataProvider::ManufacturingInfo mManufacturingInfo;
             std::vector<TreeItemPtr> mChildItems;
+            Evaluation mEvaluation;
+
+            void ensureQuantitiesEvaluated() const;
+            void ensureTotalsEvaluated() const;
+
+            uint getCurrentRuns() const;
+            QVariantMap calculateCost() const;
 
             uint getMaterialEfficiency() const;
             uint getTimeEfficiency() const;
@@ -236,6 +265,7 @@ namespace Evernus
         std::unordered_map<uint, int> mCharacterManufacturingSkills;
 
         std::unordered_multimap<EveType::IdType, std::reference_wrapper<TreeItem>> mTypeItemMap;
+        std::vector<std::reference_wrapper<TreeItem>> mEvaluationOrder;
 
         TypeMap<AssetQuantity> mAssetQuantities;
 
@@ -268,6 +298,11 @@ namespace Evernus
 
         void fillChildren(TreeItem &item);
 
+        void evaluate();
+        void invalidate(TreeItem &item) noexcept;
+        void invalidate(EveType::IdType typeId) noexcept;
+        void invalidateAll() noexcept;
+
         TreeItemPtr createOutputItem(EveType::IdType typeId,
                                      const IndustryManufacturingSetup::OutputSettings &settings);
         TreeItemPtr createSourceItem(const EveDataProvider::MaterialInfo &materialInfo);
@@ -12,10 +12,7 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <set>
-
 #include <QEventLoop>
-#include <QSettings>
 #include <QLocale>
 #include <QColor>
 #include <QIcon>
@@ -25,7 +22,8 @@
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
-#include "MarketAnalysisSettings.h"
+#include "PerformanceTracer.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
@@ -197,6 +195,8 @@ namespace Evernus
                                                   PriceType srcType,
                                                   PriceType dstType)
     {
+        const TraceSpan span{"analysis", "InterRegionMarketDataModel::setOrderData"};
+
         beginResetModel();
 
         mData.clear();
@@ -204,8 +204,7 @@ namespace Evernus
         mSrcPriceType = srcType;
         mDstPriceType = dstType;
 
-        RegionMap<TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, ExternalOrder::LowToHigh>>> sellOrders;
-        RegionMap<TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, ExternalOrder::HighToLow>>> buyOrders;
+        RegionMap<TypeMap<MathUtils::PriceVolumeList>> sellOrders, buyOrders;
 
         RegionMap<TypeMap<quint64>> sellVolumes, buyVolumes;
 
@@ -226,15 +225,17 @@ namespace Evernus
                 continue;
             }
 
+            const auto volume = order.getVolumeRemaining();
+
             if (order.getType() == ExternalOrder::Type::Buy)
             {
-                buyOrders[regionId][typeId].insert(std::cref(order));
-                buyVolumes[regionId][typeId] += order.getVolumeRemaining();
+                buyOrders[regionId][typeId].emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                buyVolumes[regionId][typeId] += volume;
             }
             else
             {
-                sellOrders[regionId][typeId].insert(std::cref(order));
-                sellVolumes[regionId][typeId] += order.getVolumeRemaining();
+                sellOrders[regionId][typeId].emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                sellVolumes[regionId][typeId] += volume;
             }
 
             loop.processEvents(QEventLoop::ExcludeUserInputEvents);
@@ -272,18 +273,20 @@ namespace Evernus
 
                 const auto avgPrice30 = mean(priceAcc);
 
-                const auto &typeBuyOrders = buyOrders[regionHistory.first][type.first];
-                const auto &typeSellOrders = sellOrders[regionHistory.first][type.first];
+                auto &typeBuyOrders = buyOrders[regionHistory.first][type.first];
+                auto &typeSellOrders = sellOrders[regionHistory.first][type.first];
 
                 data.mVolume /= 30;
                 data.mBuyOrderCount = typeBuyOrders.size();
                 data.mSellOrderCount = typeSellOrders.size();
                 data.mBuyPrice = MathUtils::calcPercentile(typeBuyOrders,
+                                                           PriceType::Buy,
                                                            buyVolumes[regionHistory.first][type.first] * 0.05,
                                                            avgPrice30,
                                                            mDiscardBogusOrders,
                                                            mBogusOrderThreshold);
                 data.mSellPrice = MathUtils::calcPercentile(typeSellOrders,
+                                                            PriceType::Sell,
                                                             sellVolumes[regionHistory.first][type.first] * 0.05,
                                                             avgPrice30,
                                                             mDiscardBogusOrders,
@@ -297,9 +300,7 @@ namespace Evernus
 
         PriceUtils::Taxes taxes;
 
-        QSettings settings;
-        const auto useSkillsForDifference = mCharacter && settings.value(
-            MarketAnalysisSettings::useSkillsForDifferenceKey, MarketAnalysisSettings::useSkillsForDifferenceDefault).toBool();
+        const auto useSkillsForDifference = mCharacter && SettingsSnapshotUtils::getSnapshot()->mUseSkillsForDifference;
 
         if (useSkillsForDifference)
             taxes = PriceUtils::calculateTaxes(*mCharacter);
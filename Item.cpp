@@ -16,18 +16,6 @@
 
 namespace Evernus
 {
-    Item::Item(const Item &other)
-        : Entity{other}
-        , mParentId{other.mParentId}
-        , mListId{other.mListId}
-        , mData{other.mData}
-        , mCustomValue{other.mCustomValue}
-        , mIsBPC{other.mIsBPC}
-    {
-        for (const auto &item : other)
-            addItem(std::make_unique<Item>(*item));
-    }
-
     Item::ParentIdType Item::getParentId() const noexcept
     {
         return mParentId;
@@ -46,9 +34,6 @@ namespace Evernus
     void Item::setListId(uint id) noexcept
     {
         mListId = id;
-
-        for (auto &item : mContents)
-            item->setListId(mListId);
     }
 
     ItemData::TypeIdType Item::getTypeId() const
@@ -113,22 +98,22 @@ namespace Evernus
 
     Item::ItemIterator Item::begin() noexcept
     {
-        return mContents.begin();
+        return ItemIterator{(mFirstChildOffset != 0) ? (this + mFirstChildOffset) : (nullptr)};
     }
 
     Item::ConstItemIterator Item::begin() const noexcept
     {
-        return mContents.begin();
+        return ConstItemIterator{(mFirstChildOffset != 0) ? (this + mFirstChildOffset) : (nullptr)};
     }
 
     Item::ItemIterator Item::end() noexcept
     {
-        return mContents.end();
+        return ItemIterator{};
     }
 
     Item::ConstItemIterator Item::end() const noexcept
     {
-        return mContents.end();
+        return ConstItemIterator{};
     }
 
     Item::CustomValueType Item::getCustomValue() const
@@ -153,16 +138,7 @@ namespace Evernus
 
     size_t Item::getChildCount() const noexcept
     {
-        return mContents.size();
-    }
-
-    void Item::addItem(std::unique_ptr<Item> &&item)
-    {
-        Q_ASSERT(item);
-
-        item->setParentId(getId());
-        item->setListId(getListId());
-        mContents.emplace_back(std::move(item));
+        return mChildCount;
     }
 
     bool Item::isBPC() const noexcept
@@ -170,18 +146,13 @@ namespace Evernus
         return mIsBPC && *mIsBPC;
     }
 
-    Item &Item::operator =(const Item &other)
+    Item *Item::getNextSibling() noexcept
     {
-        using std::swap;
-
-        Item copy{other};
-        swap(static_cast<Entity &>(*this), static_cast<Entity &>(copy));
-        swap(mParentId, copy.mParentId);
-        swap(mListId, copy.mListId);
-        swap(mData, copy.mData);
-        swap(mContents, copy.mContents);
-        swap(mCustomValue, copy.mCustomValue);
+        return (mNextSiblingOffset != 0) ? (this + mNextSiblingOffset) : (nullptr);
+    }
 
-        return *this;
+    const Item *Item::getNextSibling() const noexcept
+    {
+        return (mNextSiblingOffset != 0) ? (this + mNextSiblingOffset) : (nullptr);
     }
 }
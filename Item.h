@@ -14,9 +14,8 @@
  */
 #pragma once
 
-#include <vector>
-#include <memory>
-
+#include <iterator>
+#include <cstddef>
 #include <optional>
 
 #include "ItemData.h"
@@ -24,13 +23,65 @@
 
 namespace Evernus
 {
+    class AssetList;
+
+    // items are stored flat in their AssetList, linked by relative first child/next sibling offsets
     class Item
         : public Entity<ItemData::IdType>
     {
+        friend class AssetList;
+
     public:
-        using ItemList = std::vector<std::unique_ptr<Item>>;
-        using ItemIterator = ItemList::iterator;
-        using ConstItemIterator = ItemList::const_iterator;
+        template<class T>
+        class SiblingIterator final
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T *;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T **;
+            using reference = T *;
+
+            SiblingIterator() = default;
+            explicit SiblingIterator(T *item) noexcept
+                : mItem{item}
+            {
+            }
+
+            reference operator *() const noexcept
+            {
+                return mItem;
+            }
+
+            SiblingIterator &operator ++() noexcept
+            {
+                mItem = mItem->getNextSibling();
+                return *this;
+            }
+
+            SiblingIterator operator ++(int) noexcept
+            {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator ==(const SiblingIterator &other) const noexcept
+            {
+                return mItem == other.mItem;
+            }
+
+            bool operator !=(const SiblingIterator &other) const noexcept
+            {
+                return mItem != other.mItem;
+            }
+
+        private:
+            T *mItem = nullptr;
+        };
+
+        using ItemIterator = SiblingIterator<Item>;
+        using ConstItemIterator = SiblingIterator<const Item>;
 
         using ParentIdType = std::optional<ItemData::IdType>;
         using CustomValueType = std::optional<double>;
@@ -39,7 +90,7 @@ namespace Evernus
         using Entity::Entity;
 
         Item() = default;
-        Item(const Item &other);
+        Item(const Item &) = default;
         Item(Item &&) = default;
         virtual ~Item() = default;
 
@@ -79,19 +130,24 @@ namespace Evernus
 
         size_t getChildCount() const noexcept;
 
-        void addItem(std::unique_ptr<Item> &&item);
-
         bool isBPC() const noexcept;
 
-        Item &operator =(const Item &other);
+        Item &operator =(const Item &) = default;
         Item &operator =(Item &&) = default;
 
     private:
         ParentIdType mParentId;
         uint mListId = 0;
         ItemData mData;
-        ItemList mContents;
         CustomValueType mCustomValue;
         BPCType mIsBPC;
+
+        // 0 means none - an item is never its own child or sibling
+        std::ptrdiff_t mFirstChildOffset = 0;
+        std::ptrdiff_t mNextSiblingOffset = 0;
+        uint mChildCount = 0;
+
+        Item *getNextSibling() noexcept;
+        const Item *getNextSibling() const noexcept;
     };
 }
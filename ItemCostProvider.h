@@ -14,9 +14,13 @@
  */
 #pragma once
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <memory>
 
+#include <boost/functional/hash.hpp>
+
 #include "ItemCost.h"
 
 namespace Evernus
@@ -26,12 +30,16 @@ namespace Evernus
     public:
         typedef std::vector<std::shared_ptr<ItemCost>> CostList;
 
+        using CharacterTypePair = std::pair<Character::IdType, EveType::IdType>;
+        using CostMap = std::unordered_map<CharacterTypePair, std::shared_ptr<ItemCost>, boost::hash<CharacterTypePair>>;
+
         struct NotFoundException : std::exception { };
 
         ItemCostProvider() = default;
         virtual ~ItemCostProvider() = default;
 
         virtual std::shared_ptr<ItemCost> fetchForCharacterAndType(Character::IdType characterId, EveType::IdType typeId) const = 0;
+        virtual CostMap fetchForCharacterAndTypes(const std::vector<CharacterTypePair> &keys) const = 0;
         virtual CostList fetchForCharacter(Character::IdType characterId) const = 0;
         virtual void setForCharacterAndType(Character::IdType characterId, EveType::IdType typeId, double value) = 0;
 
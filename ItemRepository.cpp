@@ -43,22 +43,27 @@ namespace Evernus
     }
 
     ItemRepository::EntityPtr ItemRepository::populate(const QSqlRecord &record) const
+    {
+        return std::make_shared<Item>(populateItem(record));
+    }
+
+    Item ItemRepository::populateItem(const QSqlRecord &record) const
     {
         const auto locationId = record.value(QStringLiteral("location_id"));
         const auto parentId = record.value(QStringLiteral("parent_id"));
         const auto customValue = record.value(QStringLiteral("custom_value"));
         const auto bpc = record.value(QStringLiteral("bpc"));
 
-        auto item = std::make_shared<Item>(record.value(QStringLiteral("id")).value<Item::IdType>());
-        item->setListId(record.value(QStringLiteral("asset_list_id")).value<AssetList::IdType>());
-        item->setParentId((parentId.isNull()) ? (Item::ParentIdType{}) : (parentId.value<Item::IdType>()));
-        item->setTypeId(record.value(QStringLiteral("type_id")).toUInt());
-        item->setLocationId((locationId.isNull()) ? (ItemData::LocationIdType{}) : (locationId.value<ItemData::LocationIdType::value_type>()));
-        item->setQuantity(record.value(QStringLiteral("quantity")).toUInt());
-        item->setRawQuantity(record.value(QStringLiteral("raw_quantity")).toInt());
-        item->setCustomValue((customValue.isNull()) ? (Item::CustomValueType{}) : (customValue.value<Item::CustomValueType::value_type>()));
-        item->setBPCFlag((bpc.isNull()) ? (Item::BPCType{}) : (bpc.value<Item::BPCType::value_type>()));
-        item->setNew(false);
+        Item item{record.value(QStringLiteral("id")).value<Item::IdType>()};
+        item.setListId(record.value(QStringLiteral("asset_list_id")).value<AssetList::IdType>());
+        item.setParentId((parentId.isNull()) ? (Item::ParentIdType{}) : (parentId.value<Item::IdType>()));
+        item.setTypeId(record.value(QStringLiteral("type_id")).toUInt());
+        item.setLocationId((locationId.isNull()) ? (ItemData::LocationIdType{}) : (locationId.value<ItemData::LocationIdType::value_type>()));
+        item.setQuantity(record.value(QStringLiteral("quantity")).toUInt());
+        item.setRawQuantity(record.value(QStringLiteral("raw_quantity")).toInt());
+        item.setCustomValue((customValue.isNull()) ? (Item::CustomValueType{}) : (customValue.value<Item::CustomValueType::value_type>()));
+        item.setBPCFlag((bpc.isNull()) ? (Item::BPCType{}) : (bpc.value<Item::BPCType::value_type>()));
+        item.setNew(false);
 
         return item;
     }
@@ -136,21 +141,64 @@ namespace Evernus
         }
     }
 
+    void ItemRepository::batchUpdate(const std::vector<const Item *> &items) const
+    {
+        if (items.empty())
+            return;
+
+        QStringList assignments;
+        for (const auto &column : getColumns())
+        {
+            if (column != getIdColumn())
+                assignments << QStringLiteral("%1 = :%1").arg(column);
+        }
+
+        auto query = prepare(QStringLiteral("UPDATE %1 SET %2 WHERE %3 = :%3")
+            .arg(getTableName())
+            .arg(assignments.join(QStringLiteral(", ")))
+            .arg(getIdColumn())
+        );
+
+        for (const auto item : items)
+        {
+            bindValues(*item, query);
+            DatabaseUtils::execQuery(query);
+        }
+    }
+
+    void ItemRepository::batchRemove(const std::vector<Item::IdType> &ids) const
+    {
+        if (ids.empty())
+            return;
+
+        const auto batchSize = maxSqliteBoundVariables;
+        const auto baseQueryStr = QStringLiteral("DELETE FROM %1 WHERE %2 IN (%3)").arg(getTableName()).arg(getIdColumn());
+
+        for (std::size_t batch = 0; batch < ids.size(); batch += batchSize)
+        {
+            const auto end = std::min(batch + batchSize, ids.size());
+
+            QStringList placeholders;
+            std::fill_n(std::back_inserter(placeholders), end - batch, QStringLiteral("?"));
+
+            auto query = prepare(baseQueryStr.arg(placeholders.join(QStringLiteral(", "))));
+            for (auto i = batch; i < end; ++i)
+                query.addBindValue(ids[i]);
+
+            DatabaseUtils::execQuery(query);
+        }
+    }
+
     void ItemRepository::fillCustomValues(AssetList &assets) const
     {
         QStringList ids;
         std::unordered_map<Item::IdType, std::reference_wrapper<Item>> items;
 
-        const std::function<void (Item &)> fillItems = [&](Item &item) {
+        for (auto &item : assets.getAllItems())
+        {
             ids << QString::number(item.getId());
             items.emplace(item.getId(), std::ref(item));
-
-            for (const auto &child : item)
-                fillItems(*child);
-        };
-
-        for (const auto &item : assets)
-            fillItems(*item);
+        }
 
         const auto sql = QStringLiteral("SELECT id, custom_value FROM %1 WHERE %2 IN (%3)")
             .arg(getTableName())
@@ -229,9 +277,6 @@ namespace Evernus
         map[QStringLiteral("raw_quantity")] << entity.getRawQuantity();
         map[QStringLiteral("custom_value")] << ((customValue) ? (*customValue) : (QVariant{QVariant::Double}));
         map[QStringLiteral("bpc")] << ((bpc) ? (*bpc) : (QVariant{QVariant::Bool}));
-
-        for (const auto &item : entity)
-            fillProperties(*item, map);
     }
 
     QStringList ItemRepository::getColumns() const
@@ -38,9 +38,12 @@ namespace Evernus
         virtual QString getIdColumn() const override;
 
         virtual EntityPtr populate(const QSqlRecord &record) const override;
+        Item populateItem(const QSqlRecord &record) const;
 
         void create(const Repository<AssetList> &assetRepo) const;
         void batchStore(const PropertyMap &map) const;
+        void batchUpdate(const std::vector<const Item *> &items) const;
+        void batchRemove(const std::vector<Item::IdType> &ids) const;
 
         void fillCustomValues(AssetList &assets) const;
 
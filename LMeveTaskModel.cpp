@@ -12,13 +12,12 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <QSettings>
 #include <QLocale>
 #include <QColor>
 
 #include "ItemCostProvider.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
-#include "PriceSettings.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
 #include "TextUtils.h"
@@ -167,8 +166,7 @@ namespace Evernus
                 const auto price = mDataProvider.getTypeStationSellPrice(data->getTypeId(), mStationId);
                 if (!price->isNew())
                 {
-                    QSettings settings;
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                     {
                         return tr("Price data is too old (valid on %1).")
@@ -190,8 +188,7 @@ namespace Evernus
                 const auto price = mDataProvider.getTypeStationSellPrice(data->getTypeId(), mStationId);
                 if (!price->isNew())
                 {
-                    QSettings settings;
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                         return QColor{255, 255, 192};
                 }
@@ -0,0 +1,62 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+
+#include <boost/throw_exception.hpp>
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QFile>
+
+#include "LocalSyncStorage.h"
+
+namespace Evernus
+{
+    LocalSyncStorage::LocalSyncStorage(const QString &root)
+        : SyncStorage{}
+        , mRoot{root}
+    {
+    }
+
+    std::optional<QByteArray> LocalSyncStorage::read(const QString &path)
+    {
+        QFile file{mRoot.filePath(path)};
+        if (!file.exists())
+            return std::nullopt;
+
+        if (!file.open(QIODevice::ReadOnly))
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+
+        return file.readAll();
+    }
+
+    void LocalSyncStorage::write(const QString &path, const QByteArray &data)
+    {
+        const auto fullPath = mRoot.filePath(path);
+        if (!mRoot.mkpath(QFileInfo{fullPath}.absolutePath()))
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Cannot create directory for: " + fullPath.toStdString()});
+
+        QSaveFile file{fullPath};
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+    }
+
+    void LocalSyncStorage::remove(const QString &path)
+    {
+        QFile file{mRoot.filePath(path)};
+        if (file.exists() && !file.remove())
+            BOOST_THROW_EXCEPTION(std::runtime_error{file.errorString().toStdString()});
+    }
+}
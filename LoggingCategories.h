@@ -0,0 +1,24 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QLoggingCategory>
+
+namespace Evernus
+{
+    // hot path categories - can be turned off with filter rules, eg. "evernus.sql.debug=false"
+    Q_DECLARE_LOGGING_CATEGORY(lcSql)
+    Q_DECLARE_LOGGING_CATEGORY(lcEsi)
+}
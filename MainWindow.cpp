@@ -19,6 +19,7 @@
 #include <QNetworkInterface>
 #include <QDesktopServices>
 #include <QApplication>
+#include <QFileDialog>
 #include <QCloseEvent>
 #include <QMessageBox>
 #include <QScrollArea>
@@ -51,18 +52,19 @@
 #include "ActiveTasksDialog.h"
 #include "PreferencesDialog.h"
 #include "MarketOrderWidget.h"
+#include "PerformanceTracer.h"
 #include "MarginToolDialog.h"
 #include "StatisticsWidget.h"
 #include "CharacterWidget.h"
 #include "CustomFPCDialog.h"
 #include "EveDataProvider.h"
+#include "SettingsSnapshot.h"
 #include "IndustryWidget.h"
 #include "ContractWidget.h"
 #include "ItemCostWidget.h"
 #include "ImportSettings.h"
 #include "ClickableLabel.h"
 #include "MenuBarWidget.h"
-#include "PriceSettings.h"
 #include "SSOMessageBox.h"
 #include "SyncSettings.h"
 #include "HttpSettings.h"
@@ -195,6 +197,9 @@ namespace Evernus
 
         dlg.exec();
 
+        // publish new settings before anyone reacts to the change
+        SettingsSnapshotUtils::refreshSnapshot();
+
         setUpAutoImportTimer();
         mFPCController.handleNewPreferences();
 
@@ -364,29 +369,22 @@ namespace Evernus
 
     void MainWindow::refreshAll()
     {
-        emit refreshCharacters();
-        emit refreshCitadels();
-
-        refreshWalletJournal();
+        std::vector<Character::IdType> ids;
 
         QSettings settings;
+        if (settings.value(ImportSettings::importAllCharactersKey, ImportSettings::importAllCharactersDefault).toBool())
+        {
+            enumerateEnabledCharacters([&](auto id) {
+                ids.emplace_back(id);
+            });
+        }
+        else if (mCurrentCharacterId != Character::invalidId)
+        {
+            ids.emplace_back(mCurrentCharacterId);
+        }
 
-        const auto marketOrderSource = static_cast<ImportSettings::MarketOrderImportSource>(
-            settings.value(ImportSettings::marketOrderImportSourceKey, static_cast<int>(ImportSettings::marketOrderImportSourceDefault)).toInt());
-        if (marketOrderSource == ImportSettings::MarketOrderImportSource::Logs)
-            refreshMarketOrdersFromLogs();
-        else
-            refreshMarketOrdersFromAPI();
-
-        if (!settings.value(PriceSettings::autoAddCustomItemCostKey, PriceSettings::autoAddCustomItemCostDefault).toBool())
-            refreshWalletTransactions();
-
-        if (settings.value(ImportSettings::importAssetsKey, ImportSettings::importAssetsDefault).toBool())
-            refreshAssets();
-        if (settings.value(ImportSettings::importContractsKey, ImportSettings::importContractsDefault).toBool())
-            refreshContracts();
-        if (settings.value(ImportSettings::importMiningLedgerKey, ImportSettings::importMiningLedgerDefault).toBool())
-            refreshMiningLedger();
+        emit refreshAllCharacters(ids);
+        emit refreshCitadels();
     }
 
     void MainWindow::characterDataChanged()
@@ -482,6 +480,27 @@ namespace Evernus
         }
     }
 
+    void MainWindow::togglePerformanceTracing(bool enabled)
+    {
+        if (enabled)
+            PerformanceTracer::clear();
+
+        PerformanceTracer::setEnabled(enabled);
+    }
+
+    void MainWindow::exportPerformanceTrace()
+    {
+        const auto fileName = QFileDialog::getSaveFileName(this,
+                                                           tr("Export performance trace"),
+                                                           QStringLiteral("evernus-trace.json"),
+                                                           tr("Chrome trace (*.json)"));
+        if (fileName.isEmpty())
+            return;
+
+        if (!PerformanceTracer::exportChromeTrace(fileName))
+            QMessageBox::warning(this, tr("Export performance trace"), tr("Couldn't save trace file."));
+    }
+
     void MainWindow::copyHTTPLink()
     {
         const auto addresses = QNetworkInterface::allAddresses();
@@ -624,6 +643,13 @@ namespace Evernus
         toolsMenu->addAction(tr("Custom &Fast Price Copy"), this, &MainWindow::showCustomFPC);
         toolsMenu->addSeparator();
         toolsMenu->addAction(tr("Copy HTTP link"), this, &MainWindow::copyHTTPLink);
+        toolsMenu->addSeparator();
+
+        auto traceMenu = toolsMenu->addMenu(tr("Performance trace"));
+        auto traceAction = traceMenu->addAction(tr("Record"), this, &MainWindow::togglePerformanceTracing);
+        traceAction->setCheckable(true);
+        traceAction->setChecked(PerformanceTracer::isEnabled());
+        traceMenu->addAction(tr("Export..."), this, &MainWindow::exportPerformanceTrace);
 #ifdef EVERNUS_DROPBOX_ENABLED
         toolsMenu->addSeparator();
         toolsMenu->addAction(QIcon{":/images/arrow_refresh.png"}, tr("Upload data to cloud..."), this, &MainWindow::performSync);
@@ -740,7 +766,7 @@ namespace Evernus
         connect(assetsTab, &AssetsWidget::setDestinationInEve, this, &MainWindow::setWaypoint);
         connect(assetsTab, &AssetsWidget::showInEve, this, &MainWindow::showInEve);
         connect(this, &MainWindow::citadelsChanged, assetsTab, &AssetsWidget::updateData);
-        connect(this, &MainWindow::characterAssetsChanged, assetsTab, &AssetsWidget::updateData);
+        connect(this, &MainWindow::characterAssetsUpdated, assetsTab, &AssetsWidget::applyChanges);
         connect(this, &MainWindow::externalOrdersChanged, assetsTab, &AssetsWidget::updateData);
         connect(this, &MainWindow::externalOrdersChangedWithMarketOrders, assetsTab, &AssetsWidget::updateData);
         connect(this, &MainWindow::itemVolumeChanged, assetsTab, &AssetsWidget::updateData);
@@ -771,6 +797,7 @@ namespace Evernus
         connect(this, &MainWindow::externalOrdersChanged, orderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::citadelsChanged, orderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::itemCostsChanged, orderTab, &MarketOrderWidget::updateData);
+        connect(this, &MainWindow::preferencesChanged, orderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::charactersChanged, orderTab, &MarketOrderWidget::updateCharacters);
 
         auto journalTab = new WalletJournalWidget{mRepositoryProvider.getWalletJournalEntryRepository(),
@@ -822,7 +849,7 @@ namespace Evernus
         connect(corpAssetsTab, &AssetsWidget::setDestinationInEve, this, &MainWindow::setWaypoint);
         connect(corpAssetsTab, &AssetsWidget::showInEve, this, &MainWindow::showInEve);
         connect(this, &MainWindow::citadelsChanged, corpAssetsTab, &AssetsWidget::updateData);
-        connect(this, &MainWindow::corpAssetsChanged, corpAssetsTab, &AssetsWidget::updateData);
+        connect(this, &MainWindow::corpAssetsUpdated, corpAssetsTab, &AssetsWidget::applyChanges);
         connect(this, &MainWindow::externalOrdersChanged, corpAssetsTab, &AssetsWidget::updateData);
         connect(this, &MainWindow::externalOrdersChangedWithMarketOrders, corpAssetsTab, &AssetsWidget::updateData);
         connect(this, &MainWindow::itemVolumeChanged, corpAssetsTab, &AssetsWidget::updateData);
@@ -852,6 +879,7 @@ namespace Evernus
         connect(this, &MainWindow::externalOrdersChanged, corpOrderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::citadelsChanged, corpOrderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::itemCostsChanged, corpOrderTab, &MarketOrderWidget::updateData);
+        connect(this, &MainWindow::preferencesChanged, corpOrderTab, &MarketOrderWidget::updateData);
         connect(this, &MainWindow::charactersChanged, corpOrderTab, &MarketOrderWidget::updateCharacters);
 
         auto corpJournalTab = new WalletJournalWidget{mRepositoryProvider.getCorpWalletJournalEntryRepository(),
@@ -956,6 +984,7 @@ namespace Evernus
                                                           this};
         connect(marketAnalysisTab, &MarketAnalysisWidget::updateExternalOrders, this, &MainWindow::updateExternalOrders);
         connect(marketAnalysisTab, &MarketAnalysisWidget::showInEve, this, &MainWindow::showInEve);
+        connect(marketAnalysisTab, &MarketAnalysisWidget::analysisResultsChanged, this, &MainWindow::marketAnalysisResultsChanged);
         connect(this, &MainWindow::preferencesChanged, marketAnalysisTab, &MarketAnalysisWidget::preferencesChanged);
         addTab(marketAnalysisTab, tr("Market analysis"), TabType::Other);
 
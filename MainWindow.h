@@ -25,6 +25,7 @@
 
 #include "ExternalOrderImporter.h"
 #include "FPCController.h"
+#include "HttpApiResponse.h"
 #include "SSOAuthDialog.h"
 #include "Character.h"
 
@@ -49,6 +50,7 @@ namespace Evernus
     class CitadelAccessCache;
     class ActiveTasksDialog;
     class LMeveDataProvider;
+    struct AssetListChanges;
     class MarginToolDialog;
     class ItemCostProvider;
     class ContractProvider;
@@ -85,13 +87,14 @@ namespace Evernus
         void showAsSaved();
 
     signals:
-        void refreshCharacters();
+        void refreshAllCharacters(const std::vector<Character::IdType> &dataIds);
         void refreshCitadels();
 
         void citadelsChanged();
         void citadelsEdited();
         void charactersChanged();
         void characterAssetsChanged();
+        void characterAssetsUpdated(Character::IdType id, const AssetListChanges &changes);
         void externalOrdersChanged();
         void externalOrdersChangedWithMarketOrders();
         void characterWalletJournalChanged();
@@ -104,6 +107,7 @@ namespace Evernus
         void corpMarketOrdersChanged();
         void corpContractsChanged();
         void corpAssetsChanged();
+        void corpAssetsUpdated(Character::IdType id, const AssetListChanges &changes);
         void itemCostsChanged();
         void itemVolumeChanged();
         void lMeveTasksChanged();
@@ -144,6 +148,8 @@ namespace Evernus
 
         void updateExternalOrders(const std::vector<ExternalOrder> &orders);
 
+        void marketAnalysisResultsChanged(uint regionId, const HttpApiTable &table);
+
         void clearCorpWalletData();
         void clearRefreshTokens();
 
@@ -195,6 +201,9 @@ namespace Evernus
         void activateTrayIcon(QSystemTrayIcon::ActivationReason reason);
         void copyHTTPLink();
 
+        void togglePerformanceTracing(bool enabled);
+        void exportPerformanceTrace();
+
         void showMarketBrowser(EveType::IdType typeId);
 
         void performSync();
@@ -13,11 +13,13 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <functional>
+#include <exception>
 #include <algorithm>
 #include <memory>
-#include <thread>
 #include <cmath>
 
+#include <QtConcurrent>
+
 #include <QDialogButtonBox>
 #include <QStringBuilder>
 #include <QDesktopWidget>
@@ -108,6 +110,11 @@ namespace Evernus
 
         setUpWatcher();
         connect(&mWatcher, &QFileSystemWatcher::directoryChanged, this, &MarginToolDialog::refreshData);
+        connect(&mWatcher, &QFileSystemWatcher::fileChanged, this, &MarginToolDialog::handleLogFileChange);
+
+        mLogSettleTimer.setSingleShot(true);
+        connect(&mLogSettleTimer, &QTimer::timeout, this, &MarginToolDialog::checkLogSettled);
+        connect(&mLogParser, &QFutureWatcher<LogData>::finished, this, &MarginToolDialog::publishLogData);
 
         setWindowTitle(tr("Margin tool"));
         setAttribute(Qt::WA_DeleteOnClose);
@@ -180,172 +187,134 @@ namespace Evernus
 
         mKnownFiles << targetFile;
 
-        const QString logFile = path % "/" % targetFile;
-
-        qDebug() << "Calculating margin from file: " << logFile;
-
-        QSettings settings;
-        QFile file{logFile};
-        QFileInfo info{file};
-
-#ifdef Q_OS_WIN
-        if (settings.value(PriceSettings::priceAltImportKey, PriceSettings::priceAltImportDefault).toBool())
-        {
-            while (!file.open(QIODevice::ReadWrite))
-                std::this_thread::sleep_for(std::chrono::milliseconds{10});
-        }
-        else
-        {
-#endif
-            const auto modTimeDelay = settings.value(PriceSettings::importLogWaitTimeKey, PriceSettings::importLogWaitTimeDefault).toUInt();
-
-            // wait for Eve to finish dumping data
-            forever
-            {
-                const auto modTime = info.lastModified();
-                if (modTime.msecsTo(QDateTime::currentDateTime()) >= modTimeDelay)
-                    break;
-            }
-
-            if (!file.open(QIODevice::ReadOnly))
-                return;
-#ifdef Q_OS_WIN
-        }
-#endif
-
-        file.readLine();
+        releasePendingLogFile();
 
-        auto buy = -1.;
-        auto sell = -1.;
+        mPendingLogFile = path % "/" % targetFile;
+        mPendingLogSize = -1;
 
-        uint buyVol = 0, buyInit = 0;
-        uint sellVol = 0, sellInit = 0;
+        qDebug() << "Waiting for market log to settle: " << mPendingLogFile;
 
-        auto buyCount = 0u;
-        auto sellCount = 0u;
-        auto buyout = 0.;
+        // file change notifications only restart the settle check - the actual wait is driven by the timer
+        mWatcher.addPath(mPendingLogFile);
 
-        QString name;
-        const auto priceTime = info.created();
+        checkLogSettled();
+    }
 
-        auto typeId = EveType::invalidId;
+    void MarginToolDialog::refreshDataByEdits()
+    {
+        const auto curLocale = locale();
+        updateInfo(curLocale.toDouble(mBestBuyEdit->text()), curLocale.toDouble(mBestSellEdit->text()), false);
+    }
 
-        const auto logColumns = 14;
+    void MarginToolDialog::handleLogFileChange(const QString &path)
+    {
+        if (path == mPendingLogFile)
+            checkLogSettled();
+    }
 
-        const auto volRemainingColumn = 1;
-        const auto volEnteredColumn = 5;
-        const auto jumpsColumn = 13;
+    void MarginToolDialog::checkLogSettled()
+    {
+        if (mPendingLogFile.isEmpty())
+            return;
 
-        const auto ignoreMinVolume
-            = settings.value(PriceSettings::ignoreOrdersWithMinVolumeKey, PriceSettings::ignoreOrdersWithMinVolumeDefault).toBool();
+        if (mLogParser.isRunning())
+        {
+            mLogSettleTimer.start(altImportRetryDelay);
+            return;
+        }
 
-        const auto rangeThreshold = mRangeThresholdEdit->value();
+        const QFileInfo info{mPendingLogFile};
+        if (!info.exists())
+        {
+            releasePendingLogFile();
+            return;
+        }
 
-        std::vector<ExternalOrder> parsedOrders;
+        QSettings settings;
 
-        while (!file.atEnd())
+#ifdef Q_OS_WIN
+        if (settings.value(PriceSettings::priceAltImportKey, PriceSettings::priceAltImportDefault).toBool())
         {
-            const QString line = file.readLine();
-            const auto values = line.split(',');
-
-            if (values.count() >= logColumns)
+            QFile file{mPendingLogFile};
+            if (!file.open(QIODevice::ReadWrite))
             {
-                ExternalOrder order = ExternalOrder::parseLogLine(values);
-
-                if (ignoreMinVolume && order.getMinVolume() > 1)
-                    continue;
-
-                order.setUpdateTime(priceTime);
-
-                if (typeId == EveType::invalidId)
-                {
-                    typeId = order.getTypeId();
-                    name = mDataProvider.getTypeName(typeId);
-                }
-
-                const auto jumps = values[jumpsColumn].toInt();
-
-                if (order.getType() == ExternalOrder::Type::Buy)
-                {
-                    // warning: this does not take into account orders in the same system, but different station -
-                    //          there's no way to check if the station matches
-                    if (jumps != 0)
-                    {
-                        const int range = order.getRange();
-                        if (jumps - std::max(range, 0) > rangeThreshold)
-                        {
-                            parsedOrders.emplace_back(std::move(order));
-                            continue;
-                        }
-                    }
-
-                    if (order.getPrice() > buy)
-                        buy = order.getPrice();
-
-                    buyVol += static_cast<uint>(values[volRemainingColumn].toDouble());
-                    buyInit += static_cast<uint>(values[volEnteredColumn].toDouble());
-
-                    ++buyCount;
-                }
-                else if (jumps <= rangeThreshold)
-                {
-                    const auto price = order.getPrice();
-                    if (price < sell || sell < 0.)
-                        sell = price;
-
-                    const auto remaining = static_cast<uint>(values[volRemainingColumn].toDouble());
+                mLogSettleTimer.start(altImportRetryDelay);
+                return;
+            }
+        }
+        else
+        {
+#endif
+            const auto modTimeDelay = settings.value(PriceSettings::importLogWaitTimeKey, PriceSettings::importLogWaitTimeDefault).toLongLong();
 
-                    buyout += remaining * price;
-                    sellVol += remaining;
-                    sellInit += static_cast<uint>(values[volEnteredColumn].toDouble());
+            // wait for Eve to finish dumping data - both mtime and size have to stay put
+            const auto size = info.size();
+            const auto age = info.lastModified().msecsTo(QDateTime::currentDateTime());
+            const auto sizeChanged = mPendingLogSize >= 0 && size != mPendingLogSize;
 
-                    ++sellCount;
-                }
+            mPendingLogSize = size;
 
-                parsedOrders.emplace_back(std::move(order));
+            if (age < modTimeDelay || sizeChanged)
+            {
+                mLogSettleTimer.start(static_cast<int>(std::max<qint64>(modTimeDelay - std::max<qint64>(age, 0), altImportRetryDelay)));
+                return;
             }
+#ifdef Q_OS_WIN
         }
+#endif
 
-        mDataProvider.updateExternalOrders(parsedOrders);
+        startLogParsing();
+    }
 
+    void MarginToolDialog::publishLogData()
+    {
+        const auto data = mLogParser.result();
+
+        QSettings settings;
         if (settings.value(PathSettings::deleteLogsKey, PathSettings::deleteLogsDefault).toBool())
         {
             mWatcher.blockSignals(true);
-            file.remove();
+            QFile::remove(mParsedLogFile);
             mWatcher.blockSignals(false);
         }
 
-        if (mItemCostSourceBtn->isChecked())
-        {
-            const auto cost = mItemCostProvider.fetchForCharacterAndType(mCharacterId, typeId);
-            if (!cost->isNew())
-                buy = cost->getAdjustedCost() - PriceUtils::getPriceDelta();
-        }
-        else if (mStationSourceBtn->isChecked())
-        {
-            const auto station = mStationView->getStationId();
-            if (station == 0)
-                buy = 0.;
-            else
-                buy = mDataProvider.getTypeBuyPrice(typeId, station)->getPrice();
-        }
+        mParsedLogFile.clear();
+
+        if (!data.mOpened)
+            return;
 
         const auto curLocale = locale();
 
-        mNameLabel->setText(name);
-        mBuyOrdersLabel->setText(curLocale.toString(buyCount));
-        mSellOrdersLabel->setText(curLocale.toString(sellCount));
-        mBuyVolLabel->setText(QString{"%1/%2"}.arg(curLocale.toString(buyVol)).arg(curLocale.toString(buyInit - buyVol)));
-        mSellVolLabel->setText(QString{"%1/%2"}.arg(curLocale.toString(sellVol)).arg(curLocale.toString(sellInit - sellVol)));
-        mBuyoutLabel->setText(TextUtils::currencyToString(buyout, curLocale));
+        mNameLabel->setText((data.mTypeId == EveType::invalidId) ? (QString{}) : (mDataProvider.getTypeName(data.mTypeId)));
+        mBuyOrdersLabel->setText(curLocale.toString(data.mBuyCount));
+        mSellOrdersLabel->setText(curLocale.toString(data.mSellCount));
+        mBuyVolLabel->setText(QString{"%1/%2"}.arg(curLocale.toString(data.mBuyVol)).arg(curLocale.toString(data.mBuyInit - data.mBuyVol)));
+        mSellVolLabel->setText(QString{"%1/%2"}.arg(curLocale.toString(data.mSellVol)).arg(curLocale.toString(data.mSellInit - data.mSellVol)));
+        mBuyoutLabel->setText(TextUtils::currencyToString(data.mBuyout, curLocale));
+
+        // station buy prices come from the cache, which gets refreshed after the orders below are stored
+        mStationPriceTypeId = (mStationSourceBtn->isChecked()) ? (data.mTypeId) : (EveType::invalidId);
+        mLastSellPrice = data.mSell;
+
+        updateInfo(getCostSourceBuyPrice(data.mTypeId, data.mBuy), data.mSell, true);
 
-        updateInfo(buy, sell, true);
+        // margins are already visible - storing orders can happen in the background
+        storeExternalOrders(data.mOrders);
+
+        if (!mPendingLogFile.isEmpty())
+            checkLogSettled();
     }
 
-    void MarginToolDialog::refreshDataByEdits()
+    void MarginToolDialog::refreshStationBuyPrice()
     {
-        const auto curLocale = locale();
-        updateInfo(curLocale.toDouble(mBestBuyEdit->text()), curLocale.toDouble(mBestSellEdit->text()), false);
+        if (mStationPriceTypeId == EveType::invalidId)
+            return;
+
+        const auto typeId = mStationPriceTypeId;
+        mStationPriceTypeId = EveType::invalidId;
+
+        if (mStationSourceBtn->isChecked())
+            updateInfo(getCostSourceBuyPrice(typeId, -1.), mLastSellPrice, true);
     }
 
     void MarginToolDialog::saveCopyMode()
@@ -811,6 +780,7 @@ namespace Evernus
 
     void MarginToolDialog::setUpWatcher()
     {
+        releasePendingLogFile();
         mWatcher.removePaths(mWatcher.directories());
 
         const auto logPath = PathUtils::getMarketLogsPath();
@@ -835,6 +805,77 @@ namespace Evernus
         }
     }
 
+    void MarginToolDialog::startLogParsing()
+    {
+        mParsedLogFile = mPendingLogFile;
+        releasePendingLogFile();
+
+        qDebug() << "Calculating margin from file: " << mParsedLogFile;
+
+        QSettings settings;
+
+        const auto ignoreMinVolume
+            = settings.value(PriceSettings::ignoreOrdersWithMinVolumeKey, PriceSettings::ignoreOrdersWithMinVolumeDefault).toBool();
+
+        mLogParser.setFuture(QtConcurrent::run(&MarginToolDialog::parseLogFile, mParsedLogFile, ignoreMinVolume, mRangeThresholdEdit->value()));
+    }
+
+    void MarginToolDialog::releasePendingLogFile()
+    {
+        mLogSettleTimer.stop();
+
+        if (!mPendingLogFile.isEmpty())
+        {
+            mWatcher.removePath(mPendingLogFile);
+            mPendingLogFile.clear();
+        }
+
+        mPendingLogSize = -1;
+    }
+
+    void MarginToolDialog::storeExternalOrders(const std::vector<ExternalOrder> &orders)
+    {
+        // only the cached prices need updating - a full external order refresh would recompute asset values on every log
+        auto &dataProvider = mDataProvider;
+
+        auto watcher = new QFutureWatcher<void>{this};
+        connect(watcher, &QFutureWatcher<void>::finished, this, [=] {
+            watcher->deleteLater();
+            refreshStationBuyPrice();
+        });
+
+        watcher->setFuture(QtConcurrent::run([&dataProvider, orders] {
+            try
+            {
+                dataProvider.updateExternalOrders(orders);
+            }
+            catch (const std::exception &e)
+            {
+                qWarning() << "Error storing margin tool orders:" << e.what();
+            }
+        }));
+    }
+
+    double MarginToolDialog::getCostSourceBuyPrice(EveType::IdType typeId, double orderBuyPrice) const
+    {
+        if (mItemCostSourceBtn->isChecked())
+        {
+            const auto cost = mItemCostProvider.fetchForCharacterAndType(mCharacterId, typeId);
+            if (!cost->isNew())
+                return cost->getAdjustedCost() - PriceUtils::getPriceDelta();
+        }
+        else if (mStationSourceBtn->isChecked())
+        {
+            const auto station = mStationView->getStationId();
+            if (station == 0)
+                return 0.;
+
+            return mDataProvider.getTypeBuyPrice(typeId, station)->getPrice();
+        }
+
+        return orderBuyPrice;
+    }
+
     QString MarginToolDialog::getNewFile(const QString &path) const
     {
         QDirIterator files{path, { QStringLiteral("*.txt") }, QDir::Files | QDir::Readable};
@@ -925,4 +966,85 @@ namespace Evernus
 
         return out;
     }
+
+    MarginToolDialog::LogData MarginToolDialog::parseLogFile(const QString &logFile, bool ignoreMinVolume, int rangeThreshold)
+    {
+        LogData data;
+
+        QFile file{logFile};
+        if (!file.open(QIODevice::ReadOnly))
+            return data;
+
+        data.mOpened = true;
+
+        file.readLine();
+
+        const auto priceTime = QFileInfo{file}.created();
+
+        const auto volRemainingColumn = 1;
+        const auto volEnteredColumn = 5;
+        const auto jumpsColumn = 13;
+
+        while (!file.atEnd())
+        {
+            const QString line = file.readLine();
+            const auto values = line.split(',');
+
+            if (values.count() >= ExternalOrder::logColumns)
+            {
+                ExternalOrder order = ExternalOrder::parseLogLine(values);
+
+                if (ignoreMinVolume && order.getMinVolume() > 1)
+                    continue;
+
+                order.setUpdateTime(priceTime);
+
+                if (data.mTypeId == EveType::invalidId)
+                    data.mTypeId = order.getTypeId();
+
+                const auto jumps = values[jumpsColumn].toInt();
+
+                if (order.getType() == ExternalOrder::Type::Buy)
+                {
+                    // warning: this does not take into account orders in the same system, but different station -
+                    //          there's no way to check if the station matches
+                    if (jumps != 0)
+                    {
+                        const int range = order.getRange();
+                        if (jumps - std::max(range, 0) > rangeThreshold)
+                        {
+                            data.mOrders.emplace_back(std::move(order));
+                            continue;
+                        }
+                    }
+
+                    if (order.getPrice() > data.mBuy)
+                        data.mBuy = order.getPrice();
+
+                    data.mBuyVol += static_cast<uint>(values[volRemainingColumn].toDouble());
+                    data.mBuyInit += static_cast<uint>(values[volEnteredColumn].toDouble());
+
+                    ++data.mBuyCount;
+                }
+                else if (jumps <= rangeThreshold)
+                {
+                    const auto price = order.getPrice();
+                    if (price < data.mSell || data.mSell < 0.)
+                        data.mSell = price;
+
+                    const auto remaining = static_cast<uint>(values[volRemainingColumn].toDouble());
+
+                    data.mBuyout += remaining * price;
+                    data.mSellVol += remaining;
+                    data.mSellInit += static_cast<uint>(values[volEnteredColumn].toDouble());
+
+                    ++data.mSellCount;
+                }
+
+                data.mOrders.emplace_back(std::move(order));
+            }
+        }
+
+        return data;
+    }
 }
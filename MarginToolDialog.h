@@ -18,8 +18,10 @@
 #include <vector>
 
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include <QDateTime>
 #include <QDialog>
+#include <QTimer>
 #include <QSet>
 
 #include "ExternalOrder.h"
@@ -71,6 +73,11 @@ namespace Evernus
         void refreshData(const QString &path);
         void refreshDataByEdits();
 
+        void handleLogFileChange(const QString &path);
+        void checkLogSettled();
+        void publishLogData();
+        void refreshStationBuyPrice();
+
         void saveCopyMode();
         void saveSelectedStation(quint64 id);
 
@@ -80,7 +87,23 @@ namespace Evernus
     private:
         using FileList = QSet<QString>;
 
+        struct LogData
+        {
+            bool mOpened = false;
+
+            EveType::IdType mTypeId = EveType::invalidId;
+
+            double mBuy = -1., mSell = -1.;
+            uint mBuyVol = 0, mBuyInit = 0;
+            uint mSellVol = 0, mSellInit = 0;
+            uint mBuyCount = 0, mSellCount = 0;
+            double mBuyout = 0.;
+
+            std::vector<ExternalOrder> mOrders;
+        };
+
         static const auto samples = 100000000;
+        static const auto altImportRetryDelay = 10;
 
         static const QString settingsGeometryKey;
 
@@ -123,6 +146,16 @@ namespace Evernus
 
         FileList mKnownFiles;
 
+        QTimer mLogSettleTimer;
+        QString mPendingLogFile;
+        qint64 mPendingLogSize = -1;
+
+        QFutureWatcher<LogData> mLogParser;
+        QString mParsedLogFile;
+
+        EveType::IdType mStationPriceTypeId = EveType::invalidId;
+        double mLastSellPrice = -1.;
+
         Character::IdType mCharacterId = Character::invalidId;
 
         double mBuyPrice = 0., mSellPrice = 0.;
@@ -140,8 +173,16 @@ namespace Evernus
 
         QString getNewFile(const QString &path) const;
 
+        void startLogParsing();
+        void releasePendingLogFile();
+        void storeExternalOrders(const std::vector<ExternalOrder> &orders);
+
+        double getCostSourceBuyPrice(EveType::IdType typeId, double orderBuyPrice) const;
+
         static void fillSampleData(QTableWidget &table, double revenue, double cos, int multiplier);
 
         static FileList getKnownFiles(const QString &path);
+
+        static LogData parseLogFile(const QString &logFile, bool ignoreMinVolume, int rangeThreshold);
     };
 }
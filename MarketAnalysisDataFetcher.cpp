@@ -20,10 +20,11 @@
 #include <QSettings>
 #include <QtDebug>
 
+#include "MarketImportPlanner.h"
+#include "PerformanceTracer.h"
 #include "EveDataProvider.h"
 #include "ImportSettings.h"
 #include "OrderSettings.h"
-#include "SSOUtils.h"
 
 #include "MarketAnalysisDataFetcher.h"
 
@@ -53,6 +54,8 @@ namespace Evernus
                                                const TypeLocationPairs &ignored,
                                                Character::IdType charId)
     {
+        const TraceSpan span{"analysis", "MarketAnalysisDataFetcher::importData"};
+
         mPreparingRequests = true;
         BOOST_SCOPE_EXIT(this_) {
             this_->mPreparingRequests = false;
@@ -62,26 +65,23 @@ namespace Evernus
         {
             mOrders = std::make_shared<OrderResultType::element_type>();
             mOrderCounter.resetBatch();
+            mOrderImportStart = PerformanceTracer::now();
         }
 
         if (mHistoryCounter.isEmpty())
         {
             mHistory = std::make_shared<HistoryResultType::element_type>();
             mHistoryCounter.resetBatch();
+            mHistoryImportStart = PerformanceTracer::now();
         }
 
         QSettings settings;
         const auto marketImportType = static_cast<ImportSettings::MarketOrderImportType>(
             settings.value(ImportSettings::marketOrderImportTypeKey, static_cast<int>(ImportSettings::marketOrderImportTypeDefault)).toInt());
-        auto useWholeMarketImport = marketImportType == ImportSettings::MarketOrderImportType::Whole;
-
-        if (!useWholeMarketImport && marketImportType == ImportSettings::MarketOrderImportType::Auto)
-            useWholeMarketImport = SSOUtils::useWholeMarketImport(pairs, mDataProvider);
+        const auto plan = MarketImportPlanner::planImport(pairs, marketImportType);
 
-        if (useWholeMarketImport)
-            importWholeMarketData(pairs, ignored);
-        else
-            importIndividualData(pairs, ignored);
+        importWholeMarketData(plan.mWholeRegionPairs, ignored);
+        importIndividualData(plan.mIndividualPairs, ignored);
 
         if (settings.value(OrderSettings::importFromCitadelsKey, OrderSettings::importFromCitadelsDefault).toBool())
             importCitadelData(pairs, ignored, charId);
@@ -91,14 +91,30 @@ namespace Evernus
         emit orderStatusUpdated(tr("Waiting for %1 order server replies...").arg(mOrderCounter.getCount()));
         emit historyStatusUpdated(tr("Waiting for %1 history server replies...").arg(mHistoryCounter.getCount()));
 
+        // some replies might have arrived while requests were being made
+        for (auto region = std::begin(mPendingRegionRequests); region != std::end(mPendingRegionRequests);)
+        {
+            if (region->second == 0)
+            {
+                emit regionImportEnded(region->first, mOrders, mHistory);
+                region = mPendingRegionRequests.erase(region);
+            }
+            else
+            {
+                ++region;
+            }
+        }
+
         if (mOrderCounter.isEmpty())
             finishOrderImport();
         if (mHistoryCounter.isEmpty())
             finishHistoryImport();
     }
 
-    void MarketAnalysisDataFetcher::processOrders(std::vector<ExternalOrder> &&orders, const QString &errorText)
+    void MarketAnalysisDataFetcher::processOrders(uint regionId, std::vector<ExternalOrder> &&orders, const QString &errorText)
     {
+        const TraceSpan span{"analysis", "MarketAnalysisDataFetcher::processOrders"};
+
         if (mOrderCounter.advanceAndCheckBatch())
             emit orderStatusUpdated(tr("Waiting for %1 order server replies...").arg(mOrderCounter.getCount()));
 
@@ -108,6 +124,8 @@ namespace Evernus
         {
             mAggregatedOrderErrors << errorText;
 
+            finishRegionRequest(regionId);
+
             if (mOrderCounter.isEmpty())
                 finishOrderImport();
 
@@ -119,6 +137,8 @@ namespace Evernus
                         std::make_move_iterator(std::begin(orders)),
                         std::make_move_iterator(std::end(orders)));
 
+        finishRegionRequest(regionId);
+
         if (mOrderCounter.isEmpty() && !mPreparingRequests)
             finishOrderImport();
     }
@@ -126,6 +146,8 @@ namespace Evernus
     void MarketAnalysisDataFetcher
     ::processHistory(uint regionId, EveType::IdType typeId, std::map<QDate, MarketHistoryEntry> &&history, const QString &errorText)
     {
+        const TraceSpan span{"analysis", "MarketAnalysisDataFetcher::processHistory"};
+
         if (mHistoryCounter.advanceAndCheckBatch())
             emit historyStatusUpdated(tr("Waiting for %1 history server replies...").arg(mHistoryCounter.getCount()));
 
@@ -135,6 +157,8 @@ namespace Evernus
         {
             mAggregatedHistoryErrors << errorText;
 
+            finishRegionRequest(regionId);
+
             if (mHistoryCounter.isEmpty())
                 finishHistoryImport();
 
@@ -143,6 +167,8 @@ namespace Evernus
 
         (*mHistory)[regionId][typeId] = std::move(history);
 
+        finishRegionRequest(regionId);
+
         if (mHistoryCounter.isEmpty() && !mPreparingRequests)
             finishHistoryImport();
     }
@@ -157,6 +183,8 @@ namespace Evernus
                 continue;
 
             mHistoryCounter.incCount();
+            ++mPendingRegionRequests[pair.second];
+
             mESIManager.fetchMarketHistory(pair.second, pair.first, [=](auto &&history, const auto &error, const auto &expires) {
                 Q_UNUSED(expires);
                 processHistory(pair.second, pair.first, std::move(history), error);
@@ -170,11 +198,13 @@ namespace Evernus
 
         for (const auto region : regions)
         {
+            ++mPendingRegionRequests[region];
+
             mESIManager.fetchMarketOrders(region, [=](auto &&orders, const auto &error, const auto &expires) {
                 Q_UNUSED(expires);
 
                 filterOrders(orders, pairs);
-                processOrders(std::move(orders), error);
+                processOrders(region, std::move(orders), error);
             });
 
             processEvents();
@@ -192,9 +222,11 @@ namespace Evernus
             mOrderCounter.incCount();
             mHistoryCounter.incCount();
 
+            mPendingRegionRequests[pair.second] += 2;
+
             mESIManager.fetchMarketOrders(pair.second, pair.first, [=](auto &&orders, const auto &error, const auto &expires) {
                 Q_UNUSED(expires);
-                processOrders(std::move(orders), error);
+                processOrders(pair.second, std::move(orders), error);
             });
 
             mESIManager.fetchMarketHistory(pair.second, pair.first, [=](auto &&history, const auto &error, const auto &expires) {
@@ -230,11 +262,13 @@ namespace Evernus
                     continue;
 
                 mOrderCounter.incCount();
+                ++mPendingRegionRequests[region];
+
                 mESIManager.fetchCitadelMarketOrders(citadel->getId(), region, charId, [=](auto &&orders, const auto &error, const auto &expires) {
                     Q_UNUSED(expires);
 
                     filterOrders(orders, pairs);
-                    processOrders(std::move(orders), error);
+                    processOrders(region, std::move(orders), error);
                 });
 
                 processEvents();
@@ -246,6 +280,8 @@ namespace Evernus
     {
         qDebug() << "Finished market order import at" << QDateTime::currentDateTime() << mOrders->size();
 
+        PerformanceTracer::recordAsync("analysis", "Market order import", mOrderImportStart);
+
         emit orderImportEnded(mOrders, mAggregatedOrderErrors.join("\n"));
         mAggregatedOrderErrors.clear();
     }
@@ -254,10 +290,26 @@ namespace Evernus
     {
         qDebug() << "Finished history import at" << QDateTime::currentDateTime() << mHistory->size();
 
+        PerformanceTracer::recordAsync("analysis", "Market history import", mHistoryImportStart);
+
         emit historyImportEnded(mHistory, mAggregatedHistoryErrors.join("\n"));
         mAggregatedHistoryErrors.clear();
     }
 
+    void MarketAnalysisDataFetcher::finishRegionRequest(uint regionId)
+    {
+        const auto region = mPendingRegionRequests.find(regionId);
+        Q_ASSERT(region != std::end(mPendingRegionRequests) && region->second > 0);
+
+        if (--region->second == 0 && !mPreparingRequests)
+        {
+            mPendingRegionRequests.erase(region);
+
+            qDebug() << "Finished market data import for region" << regionId;
+            emit regionImportEnded(regionId, mOrders, mHistory);
+        }
+    }
+
     void MarketAnalysisDataFetcher::processEvents()
     {
         mEventProcessor.processEvents();
@@ -265,6 +317,8 @@ namespace Evernus
 
     void MarketAnalysisDataFetcher::filterOrders(std::vector<ExternalOrder> &orders, const TypeLocationPairs &pairs)
     {
+        const TraceSpan span{"analysis", "MarketAnalysisDataFetcher::filterOrders"};
+
         orders.erase(std::remove_if(std::begin(orders), std::end(orders), [&](const auto &order) {
             return pairs.find(std::make_pair(order.getTypeId(), order.getRegionId())) == std::end(pairs);
         }), std::end(orders));
@@ -14,6 +14,7 @@
  */
 #pragma once
 
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <map>
@@ -56,6 +57,8 @@ namespace Evernus
         void orderStatusUpdated(const QString &text);
         void historyStatusUpdated(const QString &text);
 
+        // all data for given region has arrived; results are still being filled for other regions
+        void regionImportEnded(uint regionId, const OrderResultType &orders, const HistoryResultType &history);
         void orderImportEnded(const OrderResultType &result, const QString &error);
         void historyImportEnded(const HistoryResultType &result, const QString &error);
 
@@ -74,6 +77,10 @@ namespace Evernus
         ProgressiveCounter mOrderCounter, mHistoryCounter;
         bool mPreparingRequests = false;
 
+        qint64 mOrderImportStart = 0, mHistoryImportStart = 0;
+
+        std::unordered_map<uint, uint> mPendingRegionRequests;
+
         QStringList mAggregatedOrderErrors, mAggregatedHistoryErrors;
 
         OrderResultType mOrders;
@@ -81,7 +88,7 @@ namespace Evernus
 
         AggregatedEventProcessor mEventProcessor;
 
-        void processOrders(std::vector<ExternalOrder> &&orders, const QString &errorText);
+        void processOrders(uint regionId, std::vector<ExternalOrder> &&orders, const QString &errorText);
         void processHistory(uint regionId, EveType::IdType typeId, std::map<QDate, MarketHistoryEntry> &&history, const QString &errorText);
 
         void importWholeMarketData(const TypeLocationPairs &pairs,
@@ -92,6 +99,7 @@ namespace Evernus
                                const TypeLocationPairs &ignored,
                                Character::IdType charId);
 
+        void finishRegionRequest(uint regionId);
         void finishOrderImport();
         void finishHistoryImport();
 
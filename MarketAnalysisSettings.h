@@ -48,6 +48,10 @@ namespace Evernus
         const auto typeAggregatedChartDurationDefault = 90;
         const auto ignorePricePercetilesDefault = false;
         const auto avgDaysDefault = 30;
+        const auto screenerAnalysisDaysDefault = 90;
+        const auto screenerMaxRSIDefault = 30.;
+        const auto screenerMinRSIDefault = 70.;
+        const auto screenerMinVolumeDeviationDefault = 2.;
 
         const auto dontSaveLargeOrdersKey = QStringLiteral("marketAnalysis/dontSaveOrders");
         const auto minVolumeFilterKey = QStringLiteral("marketAnalysis/filter/minVolume");
@@ -99,5 +103,15 @@ namespace Evernus
         const auto reprocessingCustomStationTaxValueKey = QStringLiteral("marketAnalysis/reprocessing/customStationTaxValue");
         const auto typeAggregatedChartDurationKey = QStringLiteral("marketAnalysis/typeAggregatedChart/duration");
         const auto volumeGraphTypeKey = QStringLiteral("marketAnalysis/typeAggregatedChart/volumeType");
+        const auto screenerAnalysisDaysKey = QStringLiteral("marketAnalysis/screener/analysisDays");
+        const auto screenerUseMaxRSIKey = QStringLiteral("marketAnalysis/screener/useMaxRSI");
+        const auto screenerMaxRSIKey = QStringLiteral("marketAnalysis/screener/maxRSI");
+        const auto screenerUseMinRSIKey = QStringLiteral("marketAnalysis/screener/useMinRSI");
+        const auto screenerMinRSIKey = QStringLiteral("marketAnalysis/screener/minRSI");
+        const auto screenerBelowLowerBollingerKey = QStringLiteral("marketAnalysis/screener/belowLowerBollinger");
+        const auto screenerAboveUpperBollingerKey = QStringLiteral("marketAnalysis/screener/aboveUpperBollinger");
+        const auto screenerMACDAboveSignalKey = QStringLiteral("marketAnalysis/screener/macdAboveSignal");
+        const auto screenerUseVolumeSpikeKey = QStringLiteral("marketAnalysis/screener/useVolumeSpike");
+        const auto screenerMinVolumeDeviationKey = QStringLiteral("marketAnalysis/screener/minVolumeDeviation");
     }
 }
@@ -32,8 +32,10 @@
 #include "MarketAnalysisSettings.h"
 #include "MarketOrderRepository.h"
 #include "RegionAnalysisWidget.h"
+#include "MarketScreenerWidget.h"
 #include "CharacterRepository.h"
 #include "PriceTypeComboBox.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "SSOMessageBox.h"
 #include "TaskManager.h"
@@ -72,6 +74,8 @@ namespace Evernus
                 this, &MarketAnalysisWidget::updateOrderTask);
         connect(&mDataFetcher, &MarketAnalysisDataFetcher::historyStatusUpdated,
                 this, &MarketAnalysisWidget::updateHistoryTask);
+        connect(&mDataFetcher, &MarketAnalysisDataFetcher::regionImportEnded,
+                this, &MarketAnalysisWidget::processRegionData);
         connect(&mDataFetcher, &MarketAnalysisDataFetcher::orderImportEnded,
                 this, &MarketAnalysisWidget::endOrderTask);
         connect(&mDataFetcher, &MarketAnalysisDataFetcher::historyImportEnded,
@@ -187,6 +191,8 @@ namespace Evernus
             QSettings settings;
             settings.setValue(MarketAnalysisSettings::useSkillsForDifferenceKey, checked);
 
+            SettingsSnapshotUtils::refreshSnapshot();
+
             recalculateAllData();
         });
 
@@ -198,6 +204,7 @@ namespace Evernus
 
         mRegionAnalysisWidget = new RegionAnalysisWidget{mDataProvider, *this, tabs};
         connect(mRegionAnalysisWidget, &RegionAnalysisWidget::showInEve, this, &MarketAnalysisWidget::showInEve);
+        connect(mRegionAnalysisWidget, &RegionAnalysisWidget::analysisResultsChanged, this, &MarketAnalysisWidget::analysisResultsChanged);
         mRegionAnalysisWidget->setPriceTypes(src, dst);
         mRegionAnalysisWidget->setBogusOrderThreshold(bogusThresholdValue);
         mRegionAnalysisWidget->discardBogusOrders(discardBogusOrders);
@@ -232,11 +239,17 @@ namespace Evernus
         connect(mScrapmetalReprocessingArbitrageWidget, &ScrapmetalReprocessingArbitrageWidget::showInEve,
                 this, &MarketAnalysisWidget::showInEve);
 
+        mMarketScreenerWidget = new MarketScreenerWidget{mDataProvider, *this, tabs};
+        connect(mMarketScreenerWidget, &MarketScreenerWidget::showInEve, this, &MarketAnalysisWidget::showInEve);
+        connect(this, &MarketAnalysisWidget::preferencesChanged,
+                mMarketScreenerWidget, &MarketScreenerWidget::preferencesChanged);
+
         tabs->addTab(mRegionAnalysisWidget, tr("Region"));
         tabs->addTab(mInterRegionAnalysisWidget, tr("Inter-Region"));
         tabs->addTab(mImportingAnalysisWidget, tr("Importing"));
         tabs->addTab(mOreReprocessingArbitrageWidget, tr("Ore reprocessing arbitrage"));
         tabs->addTab(mScrapmetalReprocessingArbitrageWidget, tr("Scrapmetal reprocessing arbitrage"));
+        tabs->addTab(mMarketScreenerWidget, tr("Screener"));
     }
 
     const MarketAnalysisWidget::HistoryMap *MarketAnalysisWidget::getHistory(uint regionId) const
@@ -271,6 +284,7 @@ namespace Evernus
         mImportingAnalysisWidget->setCharacter(character);
         mOreReprocessingArbitrageWidget->setCharacter(character);
         mScrapmetalReprocessingArbitrageWidget->setCharacter(character);
+        mMarketScreenerWidget->setCharacter(character);
     }
 
     void MarketAnalysisWidget::prepareOrderImport()
@@ -290,6 +304,7 @@ namespace Evernus
         mImportingAnalysisWidget->clearData();
         mOreReprocessingArbitrageWidget->clearData();
         mScrapmetalReprocessingArbitrageWidget->clearData();
+        mMarketScreenerWidget->clearData();
 
         if (!mDataFetcher.hasPendingOrderRequests() && !mDataFetcher.hasPendingHistoryRequests())
         {
@@ -343,6 +358,25 @@ namespace Evernus
         mTaskManager.updateTask(mHistorySubtask, text);
     }
 
+    void MarketAnalysisWidget::processRegionData(uint regionId,
+                                                 const MarketAnalysisDataFetcher::OrderResultType &orders,
+                                                 const MarketAnalysisDataFetcher::HistoryResultType &history)
+    {
+        Q_ASSERT(orders);
+        Q_ASSERT(history);
+
+        // results are shared with the fetcher and keep growing until the whole import ends
+        mOrders = orders;
+        mHistory = history;
+
+        mRegionAnalysisWidget->showForRegion(regionId);
+
+        // remaining views calculate on demand, so only mark them as having new data
+        mInterRegionAnalysisWidget->completeImport();
+        mImportingAnalysisWidget->completeImport();
+        mMarketScreenerWidget->completeImport();
+    }
+
     void MarketAnalysisWidget::endOrderTask(const MarketAnalysisDataFetcher::OrderResultType &orders, const QString &error)
     {
         Q_ASSERT(orders);
@@ -390,6 +424,7 @@ namespace Evernus
             showForCurrentRegion();
             mInterRegionAnalysisWidget->completeImport();
             mImportingAnalysisWidget->completeImport();
+            mMarketScreenerWidget->completeImport();
         }
     }
 
@@ -19,6 +19,7 @@
 #include "MarketAnalysisDataFetcher.h"
 #include "ExternalOrderImporter.h"
 #include "MarketDataProvider.h"
+#include "HttpApiResponse.h"
 #include "ExternalOrder.h"
 #include "TaskConstants.h"
 #include "Character.h"
@@ -38,6 +39,7 @@ namespace Evernus
     class MarketOrderRepository;
     class MarketGroupRepository;
     class RegionAnalysisWidget;
+    class MarketScreenerWidget;
     class CharacterRepository;
     class PriceTypeComboBox;
     class EveTypeRepository;
@@ -74,6 +76,8 @@ namespace Evernus
 
         void showInEve(EveType::IdType id, Character::IdType ownerId);
 
+        void analysisResultsChanged(uint regionId, const HttpApiTable &table);
+
     public slots:
         void setCharacter(Character::IdType id);
         void showForCurrentRegion();
@@ -87,6 +91,9 @@ namespace Evernus
         void updateOrderTask(const QString &text);
         void updateHistoryTask(const QString &text);
 
+        void processRegionData(uint regionId,
+                               const MarketAnalysisDataFetcher::OrderResultType &orders,
+                               const MarketAnalysisDataFetcher::HistoryResultType &history);
         void endOrderTask(const MarketAnalysisDataFetcher::OrderResultType &orders, const QString &error);
         void endHistoryTask(const MarketAnalysisDataFetcher::HistoryResultType &history, const QString &error);
 
@@ -105,6 +112,7 @@ namespace Evernus
         ImportingAnalysisWidget *mImportingAnalysisWidget = nullptr;
         OreReprocessingArbitrageWidget *mOreReprocessingArbitrageWidget = nullptr;
         ScrapmetalReprocessingArbitrageWidget *mScrapmetalReprocessingArbitrageWidget = nullptr;
+        MarketScreenerWidget *mMarketScreenerWidget = nullptr;
 
         DontSaveImportedOrdersCheckBox *mDontSaveBtn = nullptr;
         QCheckBox *mIgnoreExistingOrdersBtn = nullptr;
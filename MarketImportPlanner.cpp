@@ -0,0 +1,129 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <unordered_map>
+#include <mutex>
+
+#include <QSettings>
+#include <QtDebug>
+
+#include "MarketImportPlanner.h"
+
+namespace Evernus
+{
+    namespace MarketImportPlanner
+    {
+        namespace
+        {
+            std::mutex pageCountMutex;
+            std::unordered_map<uint, uint> pageCounts;
+            bool pageCountsLoaded = false;
+
+            // requires pageCountMutex to be locked
+            void loadPageCounts()
+            {
+                if (pageCountsLoaded)
+                    return;
+
+                pageCountsLoaded = true;
+
+                QSettings settings;
+                settings.beginGroup(ImportSettings::marketRegionPageCountGroup);
+
+                const auto keys = settings.childKeys();
+                for (const auto &key : keys)
+                    pageCounts[key.toUInt()] = settings.value(key).toUInt();
+
+                settings.endGroup();
+            }
+        }
+
+        ImportPlan planImport(const TypeLocationPairs &pairs, ImportSettings::MarketOrderImportType importType)
+        {
+            ImportPlan plan;
+
+            switch (importType) {
+            case ImportSettings::MarketOrderImportType::Individual:
+                plan.mIndividualPairs = pairs;
+                break;
+            case ImportSettings::MarketOrderImportType::Whole:
+                plan.mWholeRegionPairs = pairs;
+
+                for (const auto &pair : pairs)
+                    plan.mWholeRegions.insert(pair.second);
+
+                break;
+            default:
+                {
+                    // one request per type vs one request per page
+                    std::unordered_map<uint, uint> typeCounts;
+                    for (const auto &pair : pairs)
+                        ++typeCounts[pair.second];
+
+                    for (const auto &region : typeCounts)
+                    {
+                        const auto pageCount = getPageCount(region.first);
+                        if (pageCount)
+                        {
+                            qDebug() << "Import cost for region" << region.first << ":" << *pageCount << "whole vs" << region.second << "individual";
+
+                            if (*pageCount < region.second)
+                                plan.mWholeRegions.insert(region.first);
+                        }
+                        else if (region.second > 1)
+                        {
+                            // the only way to learn the size of a region is to fetch it as a whole once
+                            qDebug() << "Unknown import cost for region" << region.first << "- importing as a whole";
+                            plan.mWholeRegions.insert(region.first);
+                        }
+                    }
+
+                    for (const auto &pair : pairs)
+                    {
+                        if (plan.mWholeRegions.find(pair.second) != std::end(plan.mWholeRegions))
+                            plan.mWholeRegionPairs.insert(pair);
+                        else
+                            plan.mIndividualPairs.insert(pair);
+                    }
+                }
+            }
+
+            return plan;
+        }
+
+        std::optional<uint> getPageCount(uint regionId)
+        {
+            std::lock_guard<std::mutex> lock{pageCountMutex};
+            loadPageCounts();
+
+            const auto pageCount = pageCounts.find(regionId);
+            return (pageCount != std::end(pageCounts)) ? (std::make_optional(pageCount->second)) : (std::nullopt);
+        }
+
+        void setPageCount(uint regionId, uint pages)
+        {
+            std::lock_guard<std::mutex> lock{pageCountMutex};
+            loadPageCounts();
+
+            auto &pageCount = pageCounts[regionId];
+            if (pageCount == pages)
+                return;
+
+            pageCount = pages;
+
+            QSettings settings;
+            settings.setValue(QStringLiteral("%1/%2").arg(ImportSettings::marketRegionPageCountGroup).arg(regionId), pages);
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <unordered_set>
+#include <optional>
+
+#include "TypeLocationPairs.h"
+#include "ImportSettings.h"
+
+namespace Evernus
+{
+    // chooses between whole-region and per-type order requests using region sizes learned from ESI
+    namespace MarketImportPlanner
+    {
+        struct ImportPlan
+        {
+            std::unordered_set<uint> mWholeRegions;
+            TypeLocationPairs mWholeRegionPairs;
+            TypeLocationPairs mIndividualPairs;
+        };
+
+        // pairs are type-region pairs
+        ImportPlan planImport(const TypeLocationPairs &pairs, ImportSettings::MarketOrderImportType importType);
+
+        // empty for regions never imported as a whole
+        std::optional<uint> getPageCount(uint regionId);
+        void setPageCount(uint regionId, uint pages);
+    }
+}
@@ -12,6 +12,11 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <functional>
+#include <algorithm>
+
+#include <QtConcurrent>
+
 #include <QStringBuilder>
 #include <QFileInfo>
 #include <QSettings>
@@ -38,8 +43,6 @@ namespace Evernus
         const QDir basePath{logPath};
         const auto files = basePath.entryList(QStringList{"*.txt"}, QDir::Files | QDir::Readable);
 
-        ExternalOrderList result;
-
         QSettings settings;
         const auto deleteLogs = settings.value(PathSettings::deleteLogsKey, PathSettings::deleteLogsDefault).toBool();
 
@@ -52,59 +55,126 @@ namespace Evernus
             Qt::CaseInsensitive,
             QRegExp::Wildcard};
 
-        LogTimeMap timeMap;
-
+        QStringList logFiles;
         for (const auto &file : files)
         {
-            if (isInterruptionRequested())
-                break;
+            if (!charLogWildcard.exactMatch(file) && !corpLogWildcard.exactMatch(file))
+                logFiles << logPath % "/" % file;
+        }
 
-            if (charLogWildcard.exactMatch(file) || corpLogWildcard.exactMatch(file))
-                continue;
+        // files are independent, so parse them all at once and resolve which ones are the newest afterwards
+        // NOTE: using std::function because QtConcurrent::mapped cannot infer the result type properly
+        const std::function<LogFileOrders (const QString &)> parseLog = [=](const auto &file) {
+            return (isInterruptionRequested()) ? (LogFileOrders{}) : (getExternalOrders(file, deleteLogs));
+        };
 
-            getExternalOrder(logPath % "/" % file, result, deleteLogs, timeMap);
-        }
+        auto logs = QtConcurrent::blockingMapped<std::vector<LogFileOrders>>(logFiles, parseLog);
 
-        emit finished(result);
+        emit finished(mergeNewestFirst(logs));
     }
 
-    void MarketLogExternalOrderImporterThread::getExternalOrder(const QString &logPath, ExternalOrderList &orders, bool deleteLog, LogTimeMap &timeMap)
+    MarketLogExternalOrderImporterThread::LogFileOrders MarketLogExternalOrderImporterThread::getExternalOrders(const QString &logPath, bool deleteLog)
     {
+        LogFileOrders result;
+
         QFile file{logPath};
         if (!file.open(QIODevice::ReadOnly))
-            return;
+            return result;
 
-        file.readLine();
+        result.mPriceTime = QFileInfo{file}.created().toUTC();
 
-        QFileInfo info{file};
+        const auto size = file.size();
+        if (size > 0)
+        {
+            const auto mapped = file.map(0, size);
 
-        const auto priceTime = info.created().toUTC();
-        const auto logColumns = 14;
+            // some file systems don't support mapping - fall back to reading everything at once
+            QByteArray contents;
+            if (mapped == nullptr)
+                contents = file.readAll();
 
-        while (!file.atEnd())
-        {
-            const QString line = file.readLine();
-            const auto values = line.split(',');
+            const auto data = (mapped != nullptr) ? (reinterpret_cast<const char *>(mapped)) : (contents.constData());
+            const auto end = data + ((mapped != nullptr) ? (size) : (contents.size()));
+
+            // skip header
+            auto line = std::find(data, end, '\n');
 
-            if (values.count() >= logColumns)
+            // tokens only point into the mapped file and are reused for every line, so nothing gets copied
+            ExternalOrder::LogLineTokens tokens;
+
+            while (line != end)
             {
-                auto order = ExternalOrder::parseLogLine(values);
-                if (order.getId() == ExternalOrder::invalidId)
-                    continue;
+                ++line;
+
+                const auto lineEnd = std::find(line, end, '\n');
 
-                const auto it = timeMap.find(order.getTypeId());
-                if (it != std::end(timeMap) && priceTime < it->second)
-                    return;
+                auto column = 0;
+                auto token = line;
 
-                timeMap[order.getTypeId()] = priceTime;
+                while (column < ExternalOrder::logColumns)
+                {
+                    const auto tokenEnd = std::find(token, lineEnd, ',');
+                    tokens[column++] = std::string_view{token, static_cast<std::size_t>(tokenEnd - token)};
 
-                order.setUpdateTime(priceTime);
+                    if (tokenEnd == lineEnd)
+                        break;
 
-                orders.emplace_back(std::move(order));
+                    token = tokenEnd + 1;
+                }
+
+                if (column == ExternalOrder::logColumns)
+                {
+                    auto order = ExternalOrder::parseLogLine(tokens);
+                    if (order.getId() != ExternalOrder::invalidId)
+                    {
+                        order.setUpdateTime(result.mPriceTime);
+                        result.mOrders.emplace_back(std::move(order));
+                    }
+                }
+
+                line = lineEnd;
             }
+
+            if (mapped != nullptr)
+                file.unmap(mapped);
         }
 
         if (deleteLog)
             file.remove();
+
+        return result;
+    }
+
+    MarketLogExternalOrderImporterThread::ExternalOrderList MarketLogExternalOrderImporterThread::mergeNewestFirst(std::vector<LogFileOrders> &logs)
+    {
+        // only the newest log for a given type counts
+        LogTimeMap timeMap;
+        auto count = 0u;
+
+        for (const auto &log : logs)
+        {
+            for (const auto &order : log.mOrders)
+            {
+                auto &time = timeMap[order.getTypeId()];
+                if (!time.isValid() || time < log.mPriceTime)
+                    time = log.mPriceTime;
+            }
+
+            count += log.mOrders.size();
+        }
+
+        ExternalOrderList result;
+        result.reserve(count);
+
+        for (auto &log : logs)
+        {
+            for (auto &order : log.mOrders)
+            {
+                if (timeMap[order.getTypeId()] == log.mPriceTime)
+                    result.emplace_back(std::move(order));
+            }
+        }
+
+        return result;
     }
 }
@@ -46,7 +46,14 @@ namespace Evernus
     private:
         typedef std::unordered_map<EveType::IdType, QDateTime> LogTimeMap;
 
-        static void getExternalOrder(const QString &logPath, ExternalOrderList &prices, bool deleteLog, LogTimeMap &timeMap);
+        struct LogFileOrders
+        {
+            QDateTime mPriceTime;
+            ExternalOrderList mOrders;
+        };
+
+        static LogFileOrders getExternalOrders(const QString &logPath, bool deleteLog);
+        static ExternalOrderList mergeNewestFirst(std::vector<LogFileOrders> &logs);
     };
 }
 
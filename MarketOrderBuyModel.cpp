@@ -21,9 +21,9 @@
 #include "MarketOrderProvider.h"
 #include "CacheTimerProvider.h"
 #include "ItemCostProvider.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "PriceSettings.h"
-#include "OrderSettings.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
 #include "IconUtils.h"
@@ -79,7 +79,7 @@ namespace Evernus
         case Qt::ToolTipRole:
             if (column == priceColumn)
             {
-                const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (price->isNew())
                     return tr("No price data -> Please import prices from Orders/Assets tab or by using Margin tool.");
 
@@ -92,8 +92,7 @@ namespace Evernus
                         .arg(TextUtils::currencyToString(price->getPrice() - data->getPrice(), locale));
                 }
 
-                QSettings settings;
-                const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                 if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                 {
                     return tr("Price data is too old (valid on %1).\nPlease import prices from Orders/Assets tab or by using Margin tool.")
@@ -106,15 +105,14 @@ namespace Evernus
         case Qt::DecorationRole:
             if (column == priceColumn)
             {
-                const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (price->isNew())
                     return QIcon{":/images/error.png"};
 
                 if (price->getPrice() > data->getPrice())
                     return QIcon{":/images/exclamation.png"};
 
-                QSettings settings;
-                const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                 if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                     return QIcon{":/images/error.png"};
 
@@ -139,12 +137,11 @@ namespace Evernus
                 return data->getPrice();
             case priceStatusColumn:
                 {
-                    const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                    const auto &price = item->getMarketSnapshot().mPrice;
                     if (price->isNew())
                         return 1;
 
-                    QSettings settings;
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                         return 2;
 
@@ -152,7 +149,7 @@ namespace Evernus
                 }
             case priceDifferenceColumn:
                 {
-                    const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                    const auto &price = item->getMarketSnapshot().mPrice;
                     if (price->isNew())
                         break;
 
@@ -165,9 +162,9 @@ namespace Evernus
             case deltaColumn:
                 return data->getDelta();
             case marginColumn:
-                return getMargin(*data);
+                return getMargin(*data, item->getMarketSnapshot());
             case newMarginColumn:
-                return getNewMargin(*data);
+                return getNewMargin(*data, item->getMarketSnapshot());
             case rangeColumn:
                 return data->getRange();
             case minQuantityColumn:
@@ -247,19 +244,18 @@ namespace Evernus
                     return TextUtils::currencyToString(data->getPrice(), locale);
                 case priceStatusColumn:
                     {
-                        const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                        const auto &price = item->getMarketSnapshot().mPrice;
                         if (price->isNew())
                             return tr("No price data");
 
-                        QSettings settings;
-                        const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                        const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                         if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                             return tr("Data too old");
                     }
                     break;
                 case priceDifferenceColumn:
                     {
-                        const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                        const auto &price = item->getMarketSnapshot().mPrice;
                         if (price->isNew())
                             break;
 
@@ -274,9 +270,9 @@ namespace Evernus
                         return locale.toString(data->getDelta());
                     break;
                 case marginColumn:
-                    return QString{"%1%2"}.arg(locale.toString(getMargin(*data), 'f', 2)).arg(locale.percent());
+                    return QString{"%1%2"}.arg(locale.toString(getMargin(*data, item->getMarketSnapshot()), 'f', 2)).arg(locale.percent());
                 case newMarginColumn:
-                    return QString{"%1%2"}.arg(locale.toString(getNewMargin(*data), 'f', 2)).arg(locale.percent());
+                    return QString{"%1%2"}.arg(locale.toString(getNewMargin(*data, item->getMarketSnapshot()), 'f', 2)).arg(locale.percent());
                 case rangeColumn:
                     {
                         const auto range = data->getRange();
@@ -352,22 +348,20 @@ namespace Evernus
         case Qt::BackgroundRole:
             if (column == priceColumn && data->getState() == MarketOrder::State::Active)
             {
-                const auto price = mDataProvider.getTypeBuyPrice(data->getTypeId(), data->getEffectiveStationId(), data->getRange());
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (!price->isNew())
                 {
                     if (price->getPrice() > data->getPrice())
                         return QColor{255, 192, 192};
 
-                    QSettings settings;
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                         return QColor{255, 255, 192};
                 }
             }
             else if (column == firstSeenColumn)
             {
-                QSettings settings;
-                const auto maxAge = settings.value(OrderSettings::marketOrderMaxAgeKey, OrderSettings::marketOrderMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mMarketOrderMaxAge;
                 if (data->getFirstSeen() < QDateTime::currentDateTimeUtc().addDays(-maxAge))
                     return QColor{255, 255, 192};
             }
@@ -399,9 +393,9 @@ namespace Evernus
             case priceStatusColumn:
                 return QColor{Qt::darkRed};
             case marginColumn:
-                return TextUtils::getMarginColor(getMargin(*data));
+                return TextUtils::getMarginColor(getMargin(*data, item->getMarketSnapshot()));
             case newMarginColumn:
-                return TextUtils::getMarginColor(getNewMargin(*data));
+                return TextUtils::getMarginColor(getNewMargin(*data, item->getMarketSnapshot()));
             }
             break;
         case Qt::TextAlignmentRole:
@@ -603,13 +597,22 @@ namespace Evernus
         mOrderProvider.removeOrder(order.getId());
     }
 
-    double MarketOrderBuyModel::getMargin(const MarketOrder &order) const
+    MarketOrderBuyModel::MarketSnapshot MarketOrderBuyModel::createMarketSnapshot(const MarketOrder &order) const
+    {
+        MarketSnapshot snapshot;
+        snapshot.mPrice = mDataProvider.getTypeBuyPrice(order.getTypeId(), order.getEffectiveStationId(), order.getRange());
+        snapshot.mReferencePrice = mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getEffectiveStationId());
+
+        return snapshot;
+    }
+
+    double MarketOrderBuyModel::getMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const
     {
         const auto character = mCharacters.find(order.getCharacterId());
         if (Q_UNLIKELY(character == std::end(mCharacters)))
             return 0.;
 
-        const auto price = mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getEffectiveStationId());
+        const auto &price = snapshot.mReferencePrice;
         if (price->isNew())
             return 100.;
 
@@ -617,20 +620,19 @@ namespace Evernus
         return PriceUtils::getMargin(order.getPrice(), price->getPrice() - PriceUtils::getPriceDelta(), taxes);
     }
 
-    double MarketOrderBuyModel::getNewMargin(const MarketOrder &order) const
+    double MarketOrderBuyModel::getNewMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const
     {
         const auto character = mCharacters.find(order.getCharacterId());
         if (Q_UNLIKELY(character == std::end(mCharacters)))
             return 0.;
 
-        const auto price = mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getEffectiveStationId());
+        const auto &price = snapshot.mReferencePrice;
         if (price->isNew())
             return 100.;
 
         const auto delta = PriceUtils::getPriceDelta();
 
-        auto newPrice
-            = mDataProvider.getTypeBuyPrice(order.getTypeId(), order.getEffectiveStationId(), order.getRange())->getPrice();
+        auto newPrice = snapshot.mPrice->getPrice();
         if (newPrice < 0.01)
             newPrice = order.getPrice();
         else
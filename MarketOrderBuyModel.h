@@ -97,8 +97,10 @@ namespace Evernus
         virtual void handleAllCharacters() override;
         virtual void handleOrderRemoval(const MarketOrder &order) override;
 
-        double getMargin(const MarketOrder &order) const;
-        double getNewMargin(const MarketOrder &order) const;
+        virtual MarketSnapshot createMarketSnapshot(const MarketOrder &order) const override;
+
+        double getMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const;
+        double getNewMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const;
         QString getCharacterName(Character::IdType id) const;
     };
 }
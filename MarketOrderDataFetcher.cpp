@@ -21,10 +21,10 @@
 #include <QSettings>
 #include <QtDebug>
 
+#include "MarketImportPlanner.h"
 #include "EveDataProvider.h"
 #include "ImportSettings.h"
 #include "OrderSettings.h"
-#include "SSOUtils.h"
 
 #include "MarketOrderDataFetcher.h"
 
@@ -61,15 +61,10 @@ namespace Evernus
         QSettings settings;
         const auto marketImportType = static_cast<ImportSettings::MarketOrderImportType>(
             settings.value(ImportSettings::marketOrderImportTypeKey, static_cast<int>(ImportSettings::marketOrderImportTypeDefault)).toInt());
-        auto useWholeMarketImport = marketImportType == ImportSettings::MarketOrderImportType::Whole;
+        const auto plan = MarketImportPlanner::planImport(pairs, marketImportType);
 
-        if (!useWholeMarketImport && marketImportType == ImportSettings::MarketOrderImportType::Auto)
-            useWholeMarketImport = SSOUtils::useWholeMarketImport(pairs, mDataProvider);
-
-        if (useWholeMarketImport)
-            importWholeMarketData(pairs);
-        else
-            importIndividualData(pairs);
+        importWholeMarketData(plan.mWholeRegionPairs);
+        importIndividualData(plan.mIndividualPairs);
 
         if (settings.value(OrderSettings::importFromCitadelsKey, OrderSettings::importFromCitadelsDefault).toBool())
             importCitadelData(pairs, charId);
@@ -17,10 +17,9 @@
 
 #include "MarketOrderModel.h"
 #include "ItemCostProvider.h"
+#include "SettingsSnapshot.h"
 #include "CommonScriptAPI.h"
 #include "EveDataProvider.h"
-#include "PriceSettings.h"
-#include "OrderSettings.h"
 #include "ExternalOrder.h"
 #include "MarketOrder.h"
 #include "ScriptUtils.h"
@@ -175,7 +174,6 @@ namespace Evernus
         if (type == MarketOrderModel::Type::Neither)
             return true;
 
-        QSettings settings;
         std::shared_ptr<ExternalOrder> price;
 
         if (type == MarketOrderModel::Type::Buy)
@@ -184,7 +182,7 @@ namespace Evernus
         }
         else
         {
-           if (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool())
+           if (SettingsSnapshotUtils::getSnapshot()->mLimitSellToStation)
                price = mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getStationId());
            else
                price = mDataProvider.getTypeRegionSellPrice(order.getTypeId(), mDataProvider.getStationRegionId(order.getStationId()));
@@ -193,7 +191,7 @@ namespace Evernus
         if (price->isNew())
             return mPriceStatusFilter & NoData;
 
-        const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+        const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
         const auto tooOld = price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge);
 
         if ((mPriceStatusFilter & DataTooOld) && (tooOld))
@@ -220,8 +218,7 @@ namespace Evernus
             break;
         case MarketOrderModel::Type::Sell:
             {
-                QSettings settings;
-                overbidOrder = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
+                overbidOrder = (SettingsSnapshotUtils::getSnapshot()->mLimitSellToStation) ?
                                (mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getStationId())) :
                                (mDataProvider.getTypeRegionSellPrice(order.getTypeId(), mDataProvider.getStationRegionId(order.getStationId())));
             }
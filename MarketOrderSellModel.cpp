@@ -22,9 +22,9 @@
 #include "CharacterRepository.h"
 #include "CacheTimerProvider.h"
 #include "ItemCostProvider.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "PriceSettings.h"
-#include "OrderSettings.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
 #include "IconUtils.h"
@@ -83,11 +83,7 @@ namespace Evernus
         case Qt::ToolTipRole:
             if (column == priceColumn)
             {
-                QSettings settings;
-
-                const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                   (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                   (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (price->isNew())
                     return tr("No price data -> Please import prices from Orders/Assets tab or by using Margin tool.");
 
@@ -100,7 +96,7 @@ namespace Evernus
                         .arg(TextUtils::currencyToString(price->getPrice() - data->getPrice(), locale));
                 }
 
-                const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                 if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                 {
                     return tr("Price data is too old (valid on %1).\nPlease import prices from Orders/Assets tab or by using Margin tool.")
@@ -113,18 +109,14 @@ namespace Evernus
         case Qt::DecorationRole:
             if (column == priceColumn)
             {
-                QSettings settings;
-
-                const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                   (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                   (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (price->isNew())
                     return QIcon{":/images/error.png"};
 
                 if (price->getPrice() < data->getPrice())
                     return QIcon{":/images/exclamation.png"};
 
-                const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                 if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                     return QIcon{":/images/error.png"};
 
@@ -146,20 +138,16 @@ namespace Evernus
             case statusColumn:
                 return static_cast<int>(data->getState());
             case customCostColumn:
-                return mItemCostProvider.fetchForCharacterAndType(data->getCharacterId(), data->getTypeId())->getAdjustedCost();
+                return item->getMarketSnapshot().mCost->getAdjustedCost();
             case priceColumn:
                 return data->getPrice();
             case priceStatusColumn:
                 {
-                    QSettings settings;
-
-                    const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                       (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                       (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                    const auto &price = item->getMarketSnapshot().mPrice;
                     if (price->isNew())
                         return 1;
 
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                         return 2;
 
@@ -167,11 +155,7 @@ namespace Evernus
                 }
             case priceDifferenceColumn:
                 {
-                    QSettings settings;
-
-                    const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                       (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                       (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                    const auto &price = item->getMarketSnapshot().mPrice;
                     if (price->isNew())
                         break;
 
@@ -179,14 +163,11 @@ namespace Evernus
                 }
             case priceDifferencePercentColumn:
                 {
-                    const auto cost = mItemCostProvider.fetchForCharacterAndType(data->getCharacterId(), data->getTypeId());
+                    const auto &cost = item->getMarketSnapshot().mCost;
                     if (cost->isNew() || qFuzzyIsNull(cost->getAdjustedCost()))
                         break;
 
-                    QSettings settings;
-                    const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                       (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                       (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                    const auto &price = item->getMarketSnapshot().mPrice;
 
                     return (price->getPrice() - data->getPrice()) / cost->getAdjustedCost();
                 }
@@ -197,9 +178,9 @@ namespace Evernus
             case deltaColumn:
                 return data->getDelta();
             case marginColumn:
-                return getMargin(*data);
+                return getMargin(*data, item->getMarketSnapshot());
             case newMarginColumn:
-                return getNewMargin(*data);
+                return getNewMargin(*data, item->getMarketSnapshot());
             case profitColumn:
                 if (character != std::end(mCharacters))
                     return getProfitForVolume(data->getVolumeRemaining(), *character->second, *data);
@@ -285,8 +266,8 @@ namespace Evernus
                     break;
                 case customCostColumn:
                     {
-                        const auto cost
-                            = mItemCostProvider.fetchForCharacterAndType(data->getCharacterId(), data->getTypeId());
+                        const auto &cost
+                            = item->getMarketSnapshot().mCost;
                         if (!cost->isNew())
                             return TextUtils::currencyToString(cost->getAdjustedCost(), locale);
                     }
@@ -295,26 +276,18 @@ namespace Evernus
                     return TextUtils::currencyToString(data->getPrice(), locale);
                 case priceStatusColumn:
                     {
-                        QSettings settings;
-
-                        const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                           (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                           (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                        const auto &price = item->getMarketSnapshot().mPrice;
                         if (price->isNew())
                             return tr("No price data");
 
-                        const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                        const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                         if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                             return tr("Data too old");
                     }
                     break;
                 case priceDifferenceColumn:
                     {
-                        QSettings settings;
-
-                        const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                           (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                           (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                        const auto &price = item->getMarketSnapshot().mPrice;
                         if (price->isNew())
                             break;
 
@@ -322,16 +295,12 @@ namespace Evernus
                     }
                 case priceDifferencePercentColumn:
                     {
-                        const auto cost
-                            = mItemCostProvider.fetchForCharacterAndType(data->getCharacterId(), data->getTypeId());
+                        const auto &cost
+                            = item->getMarketSnapshot().mCost;
                         if (cost->isNew() || qFuzzyIsNull(cost->getAdjustedCost()))
                             break;
 
-                        QSettings settings;
-
-                        const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                           (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                           (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                        const auto &price = item->getMarketSnapshot().mPrice;
 
                         return QString{"%1%2"}
                             .arg(locale.toString(100. * (price->getPrice() - data->getPrice()) / cost->getAdjustedCost(), 'f', 2))
@@ -346,9 +315,9 @@ namespace Evernus
                         return locale.toString(data->getDelta());
                     break;
                 case marginColumn:
-                    return QString{"%1%2"}.arg(locale.toString(getMargin(*data), 'f', 2)).arg(locale.percent());
+                    return QString{"%1%2"}.arg(locale.toString(getMargin(*data, item->getMarketSnapshot()), 'f', 2)).arg(locale.percent());
                 case newMarginColumn:
-                    return QString{"%1%2"}.arg(locale.toString(getNewMargin(*data), 'f', 2)).arg(locale.percent());
+                    return QString{"%1%2"}.arg(locale.toString(getNewMargin(*data, item->getMarketSnapshot()), 'f', 2)).arg(locale.percent());
                 case profitColumn:
                     if (character != std::end(mCharacters))
                         return TextUtils::currencyToString(getProfitForVolume(data->getVolumeRemaining(), *character->second, *data), locale);
@@ -420,26 +389,20 @@ namespace Evernus
         case Qt::BackgroundRole:
             if (column == priceColumn && data->getState() == MarketOrder::State::Active)
             {
-                QSettings settings;
-
-                const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                                   (mDataProvider.getTypeStationSellPrice(data->getTypeId(), data->getEffectiveStationId())) :
-                                   (mDataProvider.getTypeRegionSellPrice(data->getTypeId(), mDataProvider.getStationRegionId(data->getEffectiveStationId())));
+                const auto &price = item->getMarketSnapshot().mPrice;
                 if (!price->isNew())
                 {
                     if (price->getPrice() < data->getPrice())
                         return QColor{255, 192, 192};
 
-                    const auto maxAge = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+                    const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mPriceMaxAge;
                     if (price->getUpdateTime() < QDateTime::currentDateTimeUtc().addSecs(-3600 * maxAge))
                         return QColor{255, 255, 192};
                 }
             }
             else if (column == firstSeenColumn)
             {
-                QSettings settings;
-                const auto maxAge
-                    = settings.value(OrderSettings::marketOrderMaxAgeKey, OrderSettings::marketOrderMaxAgeDefault).toInt();
+                const auto maxAge = SettingsSnapshotUtils::getSnapshot()->mMarketOrderMaxAge;
                 if (data->getFirstSeen() < QDateTime::currentDateTimeUtc().addDays(-maxAge))
                     return QColor{255, 255, 192};
             }
@@ -472,9 +435,9 @@ namespace Evernus
             case priceStatusColumn:
                 return QColor{Qt::darkRed};
             case marginColumn:
-                return TextUtils::getMarginColor(getMargin(*data));
+                return TextUtils::getMarginColor(getMargin(*data, item->getMarketSnapshot()));
             case newMarginColumn:
-                return TextUtils::getMarginColor(getNewMargin(*data));
+                return TextUtils::getMarginColor(getNewMargin(*data, item->getMarketSnapshot()));
             case profitColumn:
             case totalProfitColumn:
             case profitPerItemColumn:
@@ -568,7 +531,7 @@ namespace Evernus
 
         QSettings settings;
 
-        const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
+        const auto price = (SettingsSnapshotUtils::getSnapshot()->mLimitSellToStation) ?
                            (mDataProvider.getTypeStationSellPrice(order->getTypeId(), order->getEffectiveStationId())) :
                            (mDataProvider.getTypeRegionSellPrice(order->getTypeId(), mDataProvider.getStationRegionId(order->getEffectiveStationId())));
 
@@ -750,38 +713,41 @@ namespace Evernus
         return mDataProvider.getGenericName(id);
     }
 
-    double MarketOrderSellModel::getMargin(const MarketOrder &order) const
+    MarketOrderSellModel::MarketSnapshot MarketOrderSellModel::createMarketSnapshot(const MarketOrder &order) const
+    {
+        MarketSnapshot snapshot;
+        snapshot.mPrice = (SettingsSnapshotUtils::getSnapshot()->mLimitSellToStation) ?
+                          (mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getEffectiveStationId())) :
+                          (mDataProvider.getTypeRegionSellPrice(order.getTypeId(), mDataProvider.getStationRegionId(order.getEffectiveStationId())));
+        snapshot.mCost = mItemCostProvider.fetchForCharacterAndType(order.getCharacterId(), order.getTypeId());
+
+        return snapshot;
+    }
+
+    double MarketOrderSellModel::getMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const
     {
         const auto character = mCharacters.find(order.getCharacterId());
         if (Q_UNLIKELY(character == std::end(mCharacters)))
             return 0.;
 
         const auto taxes = PriceUtils::calculateTaxes(*character->second);
-        const auto cost = mItemCostProvider.fetchForCharacterAndType(order.getCharacterId(), order.getTypeId());
-        return PriceUtils::getMargin(cost->getAdjustedCost(), order.getPrice(), taxes);
+        return PriceUtils::getMargin(snapshot.mCost->getAdjustedCost(), order.getPrice(), taxes);
     }
 
-    double MarketOrderSellModel::getNewMargin(const MarketOrder &order) const
+    double MarketOrderSellModel::getNewMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const
     {
         const auto character = mCharacters.find(order.getCharacterId());
         if (Q_UNLIKELY(character == std::end(mCharacters)))
             return 0.;
 
-        QSettings settings;
-
-        const auto price = (settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool()) ?
-                           (mDataProvider.getTypeStationSellPrice(order.getTypeId(), order.getEffectiveStationId())) :
-                           (mDataProvider.getTypeRegionSellPrice(order.getTypeId(), mDataProvider.getStationRegionId(order.getEffectiveStationId())));
-        auto newPrice = price->getPrice();
+        auto newPrice = snapshot.mPrice->getPrice();
         if (qFuzzyIsNull(newPrice))
             newPrice = order.getPrice();
         else
             newPrice -= PriceUtils::getPriceDelta();
 
-        const auto cost = mItemCostProvider.fetchForCharacterAndType(order.getCharacterId(), order.getTypeId());
-
         const auto taxes = PriceUtils::calculateTaxes(*character->second);
-        return PriceUtils::getMargin(cost->getAdjustedCost(), newPrice, taxes);
+        return PriceUtils::getMargin(snapshot.mCost->getAdjustedCost(), newPrice, taxes);
     }
 
     double MarketOrderSellModel
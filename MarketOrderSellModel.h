@@ -111,8 +111,10 @@ namespace Evernus
 
         QString getCharacterName(Character::IdType id) const;
 
-        double getMargin(const MarketOrder &order) const;
-        double getNewMargin(const MarketOrder &order) const;
+        virtual MarketSnapshot createMarketSnapshot(const MarketOrder &order) const override;
+
+        double getMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const;
+        double getNewMargin(const MarketOrder &order, const MarketSnapshot &snapshot) const;
         double getProfitForVolume(uint volume, const Character &character, const MarketOrder &order) const;
     };
 }
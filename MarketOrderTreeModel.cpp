@@ -51,6 +51,16 @@ namespace Evernus
         mOrder = order;
     }
 
+    const MarketOrderTreeModel::MarketSnapshot &MarketOrderTreeModel::TreeItem::getMarketSnapshot() const noexcept
+    {
+        return mMarketSnapshot;
+    }
+
+    void MarketOrderTreeModel::TreeItem::setMarketSnapshot(MarketSnapshot snapshot) noexcept
+    {
+        mMarketSnapshot = std::move(snapshot);
+    }
+
     QString MarketOrderTreeModel::TreeItem::getGroupName() const
     {
         return mGroupName;
@@ -277,6 +287,7 @@ namespace Evernus
         {
             auto item = std::make_unique<TreeItem>();
             item->setOrder(order);
+            item->setMarketSnapshot(createMarketSnapshot(*order));
 
             if (mGrouping != Grouping::None)
             {
@@ -332,6 +343,11 @@ namespace Evernus
     {
     }
 
+    MarketOrderTreeModel::MarketSnapshot MarketOrderTreeModel::createMarketSnapshot(const MarketOrder & /* order */) const
+    {
+        return MarketSnapshot{};
+    }
+
     quintptr MarketOrderTreeModel::getGroupingId(const MarketOrder &order) const
     {
         switch (mGrouping) {
@@ -24,6 +24,8 @@
 namespace Evernus
 {
     class EveDataProvider;
+    class ExternalOrder;
+    class ItemCost;
 
     class MarketOrderTreeModel
         : public MarketOrderModel
@@ -54,6 +56,14 @@ namespace Evernus
         void reset();
 
     protected:
+        // market data captured once per reset, so views don't query the provider on every data() call
+        struct MarketSnapshot
+        {
+            std::shared_ptr<ExternalOrder> mPrice;
+            std::shared_ptr<ExternalOrder> mReferencePrice;
+            std::shared_ptr<ItemCost> mCost;
+        };
+
         class TreeItem
         {
         public:
@@ -70,6 +80,9 @@ namespace Evernus
             const MarketOrder *getOrder() const noexcept;
             void setOrder(const std::shared_ptr<MarketOrder> &order) noexcept;
 
+            const MarketSnapshot &getMarketSnapshot() const noexcept;
+            void setMarketSnapshot(MarketSnapshot snapshot) noexcept;
+
             QString getGroupName() const;
             void setGroupName(const QString &name);
             void setGroupName(QString &&name);
@@ -82,6 +95,7 @@ namespace Evernus
             std::vector<std::unique_ptr<TreeItem>> mChildItems;
             TreeItem *mParentItem = nullptr;
             std::shared_ptr<MarketOrder> mOrder;
+            MarketSnapshot mMarketSnapshot;
             QString mGroupName;
         };
 
@@ -114,6 +128,8 @@ namespace Evernus
         virtual void handleAllCharacters();
         virtual void handleOrderRemoval(const MarketOrder &order) = 0;
 
+        virtual MarketSnapshot createMarketSnapshot(const MarketOrder &order) const;
+
         quintptr getGroupingId(const MarketOrder &order) const;
         QString getGroupingData(const MarketOrder &order) const;
     };
@@ -0,0 +1,270 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <functional>
+#include <tuple>
+
+#include <boost/scope_exit.hpp>
+
+#include <QtConcurrent>
+
+#include <QLocale>
+#include <QIcon>
+#include <QDate>
+
+#include "TechnicalIndicatorUtils.h"
+#include "PerformanceTracer.h"
+#include "EveDataProvider.h"
+#include "TextUtils.h"
+
+#include "MarketScreenerModel.h"
+
+namespace Evernus
+{
+    MarketScreenerModel::MarketScreenerModel(const EveDataProvider &dataProvider, QObject *parent)
+        : QAbstractTableModel{parent}
+        , ModelWithTypes{}
+        , mDataProvider{dataProvider}
+    {
+    }
+
+    int MarketScreenerModel::columnCount(const QModelIndex &parent) const
+    {
+        Q_UNUSED(parent);
+        return numColumns;
+    }
+
+    QVariant MarketScreenerModel::data(const QModelIndex &index, int role) const
+    {
+        if (Q_UNLIKELY(!index.isValid()))
+            return {};
+
+        const auto column = index.column();
+        const auto &data = mData[index.row()];
+
+        switch (role) {
+        case Qt::DisplayRole:
+            {
+                QLocale locale;
+
+                switch (column) {
+                case nameColumn:
+                    return mDataProvider.getTypeName(data.mId);
+                case regionColumn:
+                    return mDataProvider.getRegionName(data.mRegionId);
+                case priceColumn:
+                    return TextUtils::currencyToString(data.mPrice, locale);
+                case smaColumn:
+                    return TextUtils::currencyToString(data.mSMA, locale);
+                case rsiColumn:
+                    return locale.toString(data.mRSI, 'f', 2);
+                case bollingerLowerColumn:
+                    return TextUtils::currencyToString(data.mBollingerLower, locale);
+                case bollingerUpperColumn:
+                    return TextUtils::currencyToString(data.mBollingerUpper, locale);
+                case macdColumn:
+                    return locale.toString(data.mMACD, 'f', 2);
+                case volumeColumn:
+                    return locale.toString(data.mVolume, 'f', 0);
+                case avgVolumeColumn:
+                    return locale.toString(data.mAvgVolume, 'f', 2);
+                case volumeDeviationColumn:
+                    return locale.toString(data.mVolumeDeviation, 'f', 2);
+                }
+            }
+            break;
+        case Qt::UserRole:
+            switch (column) {
+            case nameColumn:
+                return mDataProvider.getTypeName(data.mId);
+            case regionColumn:
+                return mDataProvider.getRegionName(data.mRegionId);
+            case priceColumn:
+                return data.mPrice;
+            case smaColumn:
+                return data.mSMA;
+            case rsiColumn:
+                return data.mRSI;
+            case bollingerLowerColumn:
+                return data.mBollingerLower;
+            case bollingerUpperColumn:
+                return data.mBollingerUpper;
+            case macdColumn:
+                return data.mMACD;
+            case volumeColumn:
+                return data.mVolume;
+            case avgVolumeColumn:
+                return data.mAvgVolume;
+            case volumeDeviationColumn:
+                return data.mVolumeDeviation;
+            }
+            break;
+        case Qt::ToolTipRole:
+            if (column == nameColumn)
+                return tr("Double-click for detailed market information.");
+            if (column == volumeDeviationColumn)
+                return tr("Last day volume distance from the mean, in standard deviations.");
+            break;
+        case Qt::DecorationRole:
+            if (column == nameColumn)
+                return QIcon{":/images/chart_curve.png"};
+        }
+
+        return {};
+    }
+
+    QVariant MarketScreenerModel::headerData(int section, Qt::Orientation orientation, int role) const
+    {
+        if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+        {
+            switch (section) {
+            case nameColumn:
+                return tr("Name");
+            case regionColumn:
+                return tr("Region");
+            case priceColumn:
+                return tr("Last avg. price");
+            case smaColumn:
+                return tr("SMA");
+            case rsiColumn:
+                return tr("RSI (14 days)");
+            case bollingerLowerColumn:
+                return tr("Bollinger lower band");
+            case bollingerUpperColumn:
+                return tr("Bollinger upper band");
+            case macdColumn:
+                return tr("MACD");
+            case volumeColumn:
+                return tr("Last volume");
+            case avgVolumeColumn:
+                return tr("Avg. volume");
+            case volumeDeviationColumn:
+                return tr("Volume deviation");
+            }
+        }
+
+        return {};
+    }
+
+    int MarketScreenerModel::rowCount(const QModelIndex &parent) const
+    {
+        return (parent.isValid()) ? (0) : (static_cast<int>(mData.size()));
+    }
+
+    EveType::IdType MarketScreenerModel::getTypeId(const QModelIndex &index) const
+    {
+        if (Q_UNLIKELY(!index.isValid()))
+            return EveType::invalidId;
+
+        return mData[index.row()].mId;
+    }
+
+    uint MarketScreenerModel::getRegionId(const QModelIndex &index) const
+    {
+        if (Q_UNLIKELY(!index.isValid()))
+            return 0;
+
+        return mData[index.row()].mRegionId;
+    }
+
+    void MarketScreenerModel::setHistory(const MarketDataProvider::HistoryRegionMap &history, const Conditions &conditions)
+    {
+        const TraceSpan span{"analysis", "MarketScreenerModel::setHistory"};
+
+        beginResetModel();
+
+        BOOST_SCOPE_EXIT(this_) {
+            this_->endResetModel();
+        } BOOST_SCOPE_EXIT_END
+
+        mData.clear();
+
+        using HistoryEntry = std::tuple<uint, EveType::IdType, const MarketHistory *>;
+
+        std::vector<HistoryEntry> entries;
+        for (const auto &region : history)
+        {
+            for (const auto &type : region.second)
+            {
+                if (!type.second.empty())
+                    entries.emplace_back(region.first, type.first, &type.second);
+            }
+        }
+
+        // ESI has no history for the current day, which would show up as a drop to 0
+        const auto end = QDate::currentDate().addDays(-1);
+        const auto start = end.addDays(-conditions.mAnalysisDays + 1);
+
+        // NOTE: using std::function because QtConcurrent::mapped cannot infer the result type properly
+        const std::function<TypeData (const HistoryEntry &)> evaluate = [&](const auto &entry) {
+            const auto values = TechnicalIndicatorUtils::calcIndicators(*std::get<2>(entry),
+                                                                        start,
+                                                                        end,
+                                                                        conditions.mSMADays,
+                                                                        conditions.mMACDFastDays,
+                                                                        conditions.mMACDSlowDays,
+                                                                        conditions.mMACDEmaDays,
+                                                                        conditions.mVolumeType);
+
+            const auto volumeDeviation = (qFuzzyIsNull(values.mVolumeStdDev)) ?
+                                         (0.) :
+                                         ((values.mVolume - values.mVolumeMean) / values.mVolumeStdDev);
+
+            // no trades on the last day means there's no price to compare against
+            if (qFuzzyIsNull(values.mPrice))
+                return TypeData{};
+            if (conditions.mMaxRSI && values.mRSI > *conditions.mMaxRSI)
+                return TypeData{};
+            if (conditions.mMinRSI && values.mRSI < *conditions.mMinRSI)
+                return TypeData{};
+            if (conditions.mBelowLowerBollinger && values.mPrice >= values.mBollingerLower)
+                return TypeData{};
+            if (conditions.mAboveUpperBollinger && values.mPrice <= values.mBollingerUpper)
+                return TypeData{};
+            if (conditions.mMACDAboveSignal && values.mMACD <= values.mMACDSignal)
+                return TypeData{};
+            if (conditions.mMinVolumeDeviation && volumeDeviation < *conditions.mMinVolumeDeviation)
+                return TypeData{};
+
+            TypeData data;
+            data.mId = std::get<1>(entry);
+            data.mRegionId = std::get<0>(entry);
+            data.mPrice = values.mPrice;
+            data.mSMA = values.mSMA;
+            data.mRSI = values.mRSI;
+            data.mBollingerLower = values.mBollingerLower;
+            data.mBollingerUpper = values.mBollingerUpper;
+            data.mMACD = values.mMACD;
+            data.mVolume = values.mVolume;
+            data.mAvgVolume = values.mVolumeMean;
+            data.mVolumeDeviation = volumeDeviation;
+
+            return data;
+        };
+
+        const auto fillData = [](auto &result, const auto &data) {
+            if (data.mId != EveType::invalidId)
+                result.emplace_back(data);
+        };
+
+        mData = QtConcurrent::blockingMappedReduced<decltype(mData)>(entries, evaluate, fillData, QtConcurrent::UnorderedReduce);
+    }
+
+    void MarketScreenerModel::reset()
+    {
+        beginResetModel();
+        mData.clear();
+        endResetModel();
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <QAbstractTableModel>
+
+#include "MarketDataProvider.h"
+#include "ModelWithTypes.h"
+#include "VolumeType.h"
+
+namespace Evernus
+{
+    class EveDataProvider;
+
+    class MarketScreenerModel
+        : public QAbstractTableModel
+        , public ModelWithTypes
+    {
+        Q_OBJECT
+
+    public:
+        enum
+        {
+            nameColumn,
+            regionColumn,
+            priceColumn,
+            smaColumn,
+            rsiColumn,
+            bollingerLowerColumn,
+            bollingerUpperColumn,
+            macdColumn,
+            volumeColumn,
+            avgVolumeColumn,
+            volumeDeviationColumn,
+
+            numColumns
+        };
+
+        struct Conditions
+        {
+            int mAnalysisDays = 90;
+            int mSMADays = 20;
+            int mMACDFastDays = 5;
+            int mMACDSlowDays = 15;
+            int mMACDEmaDays = 5;
+            VolumeType mVolumeType = VolumeType::Volume;
+
+            std::optional<double> mMaxRSI;
+            std::optional<double> mMinRSI;
+            bool mBelowLowerBollinger = false;
+            bool mAboveUpperBollinger = false;
+            bool mMACDAboveSignal = false;
+            std::optional<double> mMinVolumeDeviation;
+        };
+
+        explicit MarketScreenerModel(const EveDataProvider &dataProvider, QObject *parent = nullptr);
+        MarketScreenerModel(const MarketScreenerModel &) = default;
+        MarketScreenerModel(MarketScreenerModel &&) = default;
+        virtual ~MarketScreenerModel() = default;
+
+        virtual int columnCount(const QModelIndex &parent = QModelIndex{}) const override;
+        virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+        virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+        virtual int rowCount(const QModelIndex &parent = QModelIndex{}) const override;
+
+        virtual EveType::IdType getTypeId(const QModelIndex &index) const override;
+        uint getRegionId(const QModelIndex &index) const;
+
+        void setHistory(const MarketDataProvider::HistoryRegionMap &history, const Conditions &conditions);
+
+        void reset();
+
+        MarketScreenerModel &operator =(const MarketScreenerModel &) = default;
+        MarketScreenerModel &operator =(MarketScreenerModel &&) = default;
+
+    private:
+        struct TypeData
+        {
+            EveType::IdType mId = EveType::invalidId;
+            uint mRegionId = 0;
+            double mPrice = 0.;
+            double mSMA = 0.;
+            double mRSI = 0.;
+            double mBollingerLower = 0.;
+            double mBollingerUpper = 0.;
+            double mMACD = 0.;
+            double mVolume = 0.;
+            double mAvgVolume = 0.;
+            double mVolumeDeviation = 0.;
+        };
+
+        const EveDataProvider &mDataProvider;
+
+        std::vector<TypeData> mData;
+    };
+}
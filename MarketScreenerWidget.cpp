@@ -0,0 +1,257 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QStackedWidget>
+#include <QDoubleSpinBox>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QSettings>
+#include <QSpinBox>
+#include <QAction>
+#include <QLabel>
+#include <QtDebug>
+
+#include "LookupActionGroupModelConnector.h"
+#include "TypeAggregatedDetailsWidget.h"
+#include "MarketAnalysisSettings.h"
+#include "CalculatingDataWidget.h"
+#include "AdjustableTableView.h"
+#include "MarketAnalysisUtils.h"
+#include "MarketDataProvider.h"
+#include "EveDataProvider.h"
+#include "FlowLayout.h"
+
+#include "MarketScreenerWidget.h"
+
+namespace Evernus
+{
+    MarketScreenerWidget::MarketScreenerWidget(const EveDataProvider &dataProvider,
+                                               const MarketDataProvider &marketDataProvider,
+                                               QWidget *parent)
+        : StandardModelProxyWidget(mDataModel, mDataProxy, parent)
+        , mDataProvider(dataProvider)
+        , mMarketDataProvider(marketDataProvider)
+        , mDataModel(mDataProvider)
+    {
+        auto mainLayout = new QVBoxLayout{this};
+
+        auto toolBarLayout = new FlowLayout{};
+        mainLayout->addLayout(toolBarLayout);
+
+        QSettings settings;
+
+        toolBarLayout->addWidget(new QLabel{tr("Analysis period:"), this});
+
+        mAnalysisDaysEdit = new QSpinBox{this};
+        toolBarLayout->addWidget(mAnalysisDaysEdit);
+        mAnalysisDaysEdit->setRange(1, 365);
+        mAnalysisDaysEdit->setSuffix(tr(" days"));
+        mAnalysisDaysEdit->setToolTip(tr("The number of days going back from today, to calculate indicators over."));
+        mAnalysisDaysEdit->setValue(
+            settings.value(MarketAnalysisSettings::screenerAnalysisDaysKey, MarketAnalysisSettings::screenerAnalysisDaysDefault).toInt());
+
+        const auto createRSIEdit = [=, &settings](auto &btn, auto &edit, const auto &label, const auto &useKey, const auto &valueKey, auto valueDefault) {
+            btn = new QCheckBox{label, this};
+            toolBarLayout->addWidget(btn);
+            btn->setChecked(settings.value(useKey, false).toBool());
+
+            edit = new QDoubleSpinBox{this};
+            toolBarLayout->addWidget(edit);
+            edit->setRange(0., 100.);
+            edit->setValue(settings.value(valueKey, valueDefault).toDouble());
+        };
+
+        createRSIEdit(mUseMaxRSIBtn,
+                      mMaxRSIEdit,
+                      tr("RSI below:"),
+                      MarketAnalysisSettings::screenerUseMaxRSIKey,
+                      MarketAnalysisSettings::screenerMaxRSIKey,
+                      MarketAnalysisSettings::screenerMaxRSIDefault);
+        createRSIEdit(mUseMinRSIBtn,
+                      mMinRSIEdit,
+                      tr("RSI above:"),
+                      MarketAnalysisSettings::screenerUseMinRSIKey,
+                      MarketAnalysisSettings::screenerMinRSIKey,
+                      MarketAnalysisSettings::screenerMinRSIDefault);
+
+        mBelowLowerBollingerBtn = new QCheckBox{tr("Price below lower Bollinger band"), this};
+        toolBarLayout->addWidget(mBelowLowerBollingerBtn);
+        mBelowLowerBollingerBtn->setChecked(settings.value(MarketAnalysisSettings::screenerBelowLowerBollingerKey, false).toBool());
+
+        mAboveUpperBollingerBtn = new QCheckBox{tr("Price above upper Bollinger band"), this};
+        toolBarLayout->addWidget(mAboveUpperBollingerBtn);
+        mAboveUpperBollingerBtn->setChecked(settings.value(MarketAnalysisSettings::screenerAboveUpperBollingerKey, false).toBool());
+
+        mMACDAboveSignalBtn = new QCheckBox{tr("MACD above signal line"), this};
+        toolBarLayout->addWidget(mMACDAboveSignalBtn);
+        mMACDAboveSignalBtn->setChecked(settings.value(MarketAnalysisSettings::screenerMACDAboveSignalKey, false).toBool());
+
+        mUseVolumeSpikeBtn = new QCheckBox{tr("Volume spike:"), this};
+        toolBarLayout->addWidget(mUseVolumeSpikeBtn);
+        mUseVolumeSpikeBtn->setChecked(settings.value(MarketAnalysisSettings::screenerUseVolumeSpikeKey, false).toBool());
+
+        mMinVolumeDeviationEdit = new QDoubleSpinBox{this};
+        toolBarLayout->addWidget(mMinVolumeDeviationEdit);
+        mMinVolumeDeviationEdit->setRange(0., 100.);
+        mMinVolumeDeviationEdit->setSuffix(QStringLiteral("σ"));
+        mMinVolumeDeviationEdit->setToolTip(tr("How many standard deviations above the mean the last volume must be."));
+        mMinVolumeDeviationEdit->setValue(
+            settings.value(MarketAnalysisSettings::screenerMinVolumeDeviationKey, MarketAnalysisSettings::screenerMinVolumeDeviationDefault).toDouble());
+
+        auto filterBtn = new QPushButton{tr("Apply"), this};
+        toolBarLayout->addWidget(filterBtn);
+        connect(filterBtn, &QPushButton::clicked, this, [=] {
+            mImportedNewData = true;
+            recalculateData();
+        });
+
+        toolBarLayout->addWidget(new QLabel{tr("Press \"Apply\" to screen all imported history. Additional actions are available via the right-click menu."), this});
+
+        mDataStack = new QStackedWidget{this};
+        mainLayout->addWidget(mDataStack);
+
+        mDataStack->addWidget(new CalculatingDataWidget{this});
+
+        mDataProxy.setSortRole(Qt::UserRole);
+        mDataProxy.setSourceModel(&mDataModel);
+
+        mDataView = new AdjustableTableView{QStringLiteral("marketAnalysisScreenerView"), this};
+        mDataStack->addWidget(mDataView);
+        mDataView->setSortingEnabled(true);
+        mDataView->setAlternatingRowColors(true);
+        mDataView->setModel(&mDataProxy);
+        mDataView->setContextMenuPolicy(Qt::ActionsContextMenu);
+        mDataView->restoreHeaderState();
+        connect(mDataView, &QTableView::doubleClicked, this, &MarketScreenerWidget::showDetails);
+        connect(mDataView->selectionModel(), &QItemSelectionModel::selectionChanged,
+                this, &MarketScreenerWidget::selectType);
+
+        mDataStack->setCurrentWidget(mDataView);
+
+        mShowDetailsAct = new QAction{tr("Show details"), this};
+        mShowDetailsAct->setEnabled(false);
+        mDataView->addAction(mShowDetailsAct);
+        connect(mShowDetailsAct, &QAction::triggered, this, &MarketScreenerWidget::showDetailsForCurrent);
+
+        new LookupActionGroupModelConnector{mDataModel, mDataProxy, *mDataView, this};
+
+        installOnView(mDataView);
+    }
+
+    void MarketScreenerWidget::setCharacter(const std::shared_ptr<Character> &character)
+    {
+        StandardModelProxyWidget::setCharacter((character) ? (character->getId()) : (Character::invalidId));
+    }
+
+    void MarketScreenerWidget::recalculateData()
+    {
+        if (!mImportedNewData)
+            return;
+
+        const auto history = mMarketDataProvider.getHistory();
+        if (history == nullptr)
+            return;
+
+        qDebug() << "Screening market history...";
+
+        mDataStack->setCurrentIndex(waitingLabelIndex);
+        mDataStack->repaint();
+
+        QSettings settings;
+
+        MarketScreenerModel::Conditions conditions;
+        conditions.mAnalysisDays = mAnalysisDaysEdit->value();
+        conditions.mSMADays = settings.value(MarketAnalysisSettings::smaDaysKey, MarketAnalysisSettings::smaDaysDefault).toInt();
+        conditions.mMACDFastDays = settings.value(MarketAnalysisSettings::macdFastDaysKey, MarketAnalysisSettings::macdFastDaysDefault).toInt();
+        conditions.mMACDSlowDays = settings.value(MarketAnalysisSettings::macdSlowDaysKey, MarketAnalysisSettings::macdSlowDaysDefault).toInt();
+        conditions.mMACDEmaDays = settings.value(MarketAnalysisSettings::macdEmaDaysKey, MarketAnalysisSettings::macdEmaDaysDefault).toInt();
+        conditions.mVolumeType = static_cast<VolumeType>(
+            settings.value(MarketAnalysisSettings::volumeGraphTypeKey, MarketAnalysisSettings::volumeGraphTypeDefault).toInt());
+        conditions.mBelowLowerBollinger = mBelowLowerBollingerBtn->isChecked();
+        conditions.mAboveUpperBollinger = mAboveUpperBollingerBtn->isChecked();
+        conditions.mMACDAboveSignal = mMACDAboveSignalBtn->isChecked();
+
+        if (mUseMaxRSIBtn->isChecked())
+            conditions.mMaxRSI = mMaxRSIEdit->value();
+        if (mUseMinRSIBtn->isChecked())
+            conditions.mMinRSI = mMinRSIEdit->value();
+        if (mUseVolumeSpikeBtn->isChecked())
+            conditions.mMinVolumeDeviation = mMinVolumeDeviationEdit->value();
+
+        settings.setValue(MarketAnalysisSettings::screenerAnalysisDaysKey, conditions.mAnalysisDays);
+        settings.setValue(MarketAnalysisSettings::screenerUseMaxRSIKey, mUseMaxRSIBtn->isChecked());
+        settings.setValue(MarketAnalysisSettings::screenerMaxRSIKey, mMaxRSIEdit->value());
+        settings.setValue(MarketAnalysisSettings::screenerUseMinRSIKey, mUseMinRSIBtn->isChecked());
+        settings.setValue(MarketAnalysisSettings::screenerMinRSIKey, mMinRSIEdit->value());
+        settings.setValue(MarketAnalysisSettings::screenerBelowLowerBollingerKey, conditions.mBelowLowerBollinger);
+        settings.setValue(MarketAnalysisSettings::screenerAboveUpperBollingerKey, conditions.mAboveUpperBollinger);
+        settings.setValue(MarketAnalysisSettings::screenerMACDAboveSignalKey, conditions.mMACDAboveSignal);
+        settings.setValue(MarketAnalysisSettings::screenerUseVolumeSpikeKey, mUseVolumeSpikeBtn->isChecked());
+        settings.setValue(MarketAnalysisSettings::screenerMinVolumeDeviationKey, mMinVolumeDeviationEdit->value());
+
+        mDataModel.setHistory(*history, conditions);
+
+        mDataView->horizontalHeader()->resizeSections(QHeaderView::ResizeToContents);
+        mImportedNewData = false;
+
+        mDataStack->setCurrentWidget(mDataView);
+    }
+
+    void MarketScreenerWidget::clearData()
+    {
+        mDataModel.reset();
+    }
+
+    void MarketScreenerWidget::completeImport()
+    {
+        mImportedNewData = true;
+    }
+
+    void MarketScreenerWidget::showDetails(const QModelIndex &item)
+    {
+        const auto mappedItem = mDataProxy.mapToSource(item);
+        const auto id = mDataModel.getTypeId(mappedItem);
+        const auto region = mDataModel.getRegionId(mappedItem);
+
+        const auto history = mMarketDataProvider.getHistory(region);
+        if (history == nullptr)
+            return;
+
+        const auto it = history->find(id);
+        if (it != std::end(*history))
+        {
+            auto widget = new TypeAggregatedDetailsWidget{it->second, this, Qt::Window};
+            widget->setWindowTitle(tr("%1 in %2").arg(mDataProvider.getTypeName(id)).arg(mDataProvider.getRegionName(region)));
+            widget->show();
+            connect(this, &MarketScreenerWidget::preferencesChanged, widget, &TypeAggregatedDetailsWidget::handleNewPreferences);
+        }
+        else
+        {
+            MarketAnalysisUtils::showMissingHistoryMessage(this);
+        }
+    }
+
+    void MarketScreenerWidget::showDetailsForCurrent()
+    {
+        showDetails(mDataView->currentIndex());
+    }
+
+    void MarketScreenerWidget::selectType(const QItemSelection &selected)
+    {
+        const auto enabled = !selected.isEmpty();
+        mShowDetailsAct->setEnabled(enabled);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QSortFilterProxyModel>
+
+#include "StandardModelProxyWidget.h"
+#include "MarketScreenerModel.h"
+
+class QItemSelection;
+class QStackedWidget;
+class QDoubleSpinBox;
+class QCheckBox;
+class QSpinBox;
+class QAction;
+
+namespace Evernus
+{
+    class AdjustableTableView;
+    class MarketDataProvider;
+    class EveDataProvider;
+
+    class MarketScreenerWidget
+        : public StandardModelProxyWidget
+    {
+        Q_OBJECT
+
+    public:
+        MarketScreenerWidget(const EveDataProvider &dataProvider,
+                             const MarketDataProvider &marketDataProvider,
+                             QWidget *parent = nullptr);
+        MarketScreenerWidget(const MarketScreenerWidget &) = default;
+        MarketScreenerWidget(MarketScreenerWidget &&) = default;
+        virtual ~MarketScreenerWidget() = default;
+
+        void setCharacter(const std::shared_ptr<Character> &character);
+        void recalculateData();
+        void clearData();
+        void completeImport();
+
+        MarketScreenerWidget &operator =(const MarketScreenerWidget &) = default;
+        MarketScreenerWidget &operator =(MarketScreenerWidget &&) = default;
+
+    signals:
+        void preferencesChanged();
+
+    private slots:
+        void showDetails(const QModelIndex &item);
+        void showDetailsForCurrent();
+
+        void selectType(const QItemSelection &selected);
+
+    private:
+        static const auto waitingLabelIndex = 0;
+
+        const EveDataProvider &mDataProvider;
+        const MarketDataProvider &mMarketDataProvider;
+
+        QSpinBox *mAnalysisDaysEdit = nullptr;
+        QCheckBox *mUseMaxRSIBtn = nullptr;
+        QDoubleSpinBox *mMaxRSIEdit = nullptr;
+        QCheckBox *mUseMinRSIBtn = nullptr;
+        QDoubleSpinBox *mMinRSIEdit = nullptr;
+        QCheckBox *mBelowLowerBollingerBtn = nullptr;
+        QCheckBox *mAboveUpperBollingerBtn = nullptr;
+        QCheckBox *mMACDAboveSignalBtn = nullptr;
+        QCheckBox *mUseVolumeSpikeBtn = nullptr;
+        QDoubleSpinBox *mMinVolumeDeviationEdit = nullptr;
+        QStackedWidget *mDataStack = nullptr;
+        AdjustableTableView *mDataView = nullptr;
+
+        QAction *mShowDetailsAct = nullptr;
+
+        MarketScreenerModel mDataModel;
+        QSortFilterProxyModel mDataProxy;
+
+        bool mImportedNewData = true;
+    };
+}
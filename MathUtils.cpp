@@ -0,0 +1,135 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+#include "MathUtils.h"
+
+namespace Evernus::MathUtils
+{
+    namespace
+    {
+        template<class Compare>
+        double calcPercentile(PriceVolumeList &orders,
+                              Compare compare,
+                              quint64 maxVolume,
+                              double avgPrice,
+                              bool discardBogusOrders,
+                              double bogusOrderThreshold)
+        {
+            if (orders.empty())
+                return (std::isnan(avgPrice)) ? (0.) : (avgPrice);
+
+            if (maxVolume == 0)
+                maxVolume = 1;
+
+            const auto nullAvg = qFuzzyIsNull(avgPrice);
+            const auto isLegit = [=](auto price) {
+                return !discardBogusOrders || nullAvg || std::fabs((price - avgPrice) / avgPrice) < bogusOrderThreshold;
+            };
+
+            // bogus orders still use up the volume we're looking at, they just don't contribute to the price
+            auto remaining = maxVolume;
+            quint64 bogusVolume = 0;
+            auto result = 0.;
+
+            const auto consume = [&](const auto &order) {
+                const auto add = std::min(order.mVolume, remaining);
+                if (isLegit(order.mPrice))
+                    result += order.mPrice * add;
+                else
+                    bogusVolume += add;
+
+                remaining -= add;
+            };
+
+            // weighted quickselect - only the part of the book which fits in maxVolume needs to be visited
+            // and it never needs to be fully sorted
+            const auto sortThreshold = 16;
+
+            auto first = std::begin(orders);
+            auto last = std::end(orders);
+
+            while (remaining > 0 && first != last)
+            {
+                if (std::distance(first, last) <= sortThreshold)
+                {
+                    std::sort(first, last, compare);
+                    for (auto it = first; it != last && remaining > 0; ++it)
+                        consume(*it);
+
+                    break;
+                }
+
+                const auto mid = std::next(first, std::distance(first, last) / 2);
+                std::nth_element(first, mid, last, compare);
+
+                quint64 leftVolume = 0;
+                for (auto it = first; it != mid; ++it)
+                    leftVolume += it->mVolume;
+
+                if (leftVolume >= remaining)
+                {
+                    last = mid;
+                }
+                else
+                {
+                    std::for_each(first, mid, consume);
+                    first = mid;
+                }
+            }
+
+            maxVolume -= bogusVolume;
+            if (maxVolume == 0) // all bogus orders?
+                return std::min_element(std::begin(orders), std::end(orders), compare)->mPrice;
+
+            return result / maxVolume;
+        }
+    }
+
+    double calcPercentile(PriceVolumeList &orders,
+                          PriceType type,
+                          quint64 maxVolume,
+                          double avgPrice,
+                          bool discardBogusOrders,
+                          double bogusOrderThreshold)
+    {
+        if (type == PriceType::Buy)
+        {
+            return calcPercentile(orders, [](const auto &a, const auto &b) {
+                return a.mPrice > b.mPrice;
+            }, maxVolume, avgPrice, discardBogusOrders, bogusOrderThreshold);
+        }
+
+        return calcPercentile(orders, [](const auto &a, const auto &b) {
+            return a.mPrice < b.mPrice;
+        }, maxVolume, avgPrice, discardBogusOrders, bogusOrderThreshold);
+    }
+
+    double getBestPrice(const PriceVolumeList &orders, PriceType type) noexcept
+    {
+        if (orders.empty())
+            return 0.;
+
+        const auto lowToHigh = [](const auto &a, const auto &b) {
+            return a.mPrice < b.mPrice;
+        };
+
+        return (type == PriceType::Buy) ?
+               (std::max_element(std::begin(orders), std::end(orders), lowToHigh)->mPrice) :
+               (std::min_element(std::begin(orders), std::end(orders), lowToHigh)->mPrice);
+    }
+}
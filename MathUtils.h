@@ -14,8 +14,12 @@
  */
 #pragma once
 
+#include <vector>
+
 #include <QtGlobal>
 
+#include "PriceType.h"
+
 namespace Evernus
 {
     class EveDataProvider;
@@ -33,12 +37,22 @@ namespace Evernus::MathUtils
         double mTotalSize = 0.;
     };
 
-    template<class T>
-    double calcPercentile(const T &orders,
+    struct PriceVolume
+    {
+        double mPrice = 0.;
+        quint64 mVolume = 0;
+    };
+
+    using PriceVolumeList = std::vector<PriceVolume>;
+
+    // orders are reordered in place; buy orders are walked from the highest price, sell orders from the lowest
+    double calcPercentile(PriceVolumeList &orders,
+                          PriceType type,
                           quint64 maxVolume,
                           double avgPrice,
                           bool discardBogusOrders,
                           double bogusOrderThreshold);
+    double getBestPrice(const PriceVolumeList &orders, PriceType type) noexcept;
 
     template<class T>
     std::size_t batchSize(T value) noexcept;
@@ -20,50 +20,6 @@
 
 namespace Evernus::MathUtils
 {
-    template<class T>
-    double calcPercentile(const T &orders,
-                          quint64 maxVolume,
-                          double avgPrice,
-                          bool discardBogusOrders,
-                          double bogusOrderThreshold)
-    {
-        if (orders.empty())
-            return (std::isnan(avgPrice)) ? (0.) : (avgPrice);
-
-        if (maxVolume == 0)
-            maxVolume = 1;
-
-        const auto nullAvg = qFuzzyIsNull(avgPrice);
-
-        auto it = std::begin(orders);
-        quint64 volume = 0u;
-        auto result = 0.;
-
-        while (volume < maxVolume && it != std::end(orders))
-        {
-            const auto price = it->get().getPrice();
-            const quint64 orderVolume = it->get().getVolumeRemaining();
-            const auto add = std::min(orderVolume, maxVolume - volume);
-
-            if (!discardBogusOrders || nullAvg || fabs((price - avgPrice) / avgPrice) < bogusOrderThreshold)
-            {
-                volume += add;
-                result += price * add;
-            }
-            else if (!nullAvg)
-            {
-                maxVolume -= add;
-            }
-
-            ++it;
-        }
-
-        if (maxVolume == 0) // all bogus orders?
-            return std::begin(orders)->get().getPrice();
-
-        return result / maxVolume;
-    }
-
     template<class T>
     std::size_t batchSize(T value) noexcept
     {
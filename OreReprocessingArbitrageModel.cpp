@@ -29,6 +29,7 @@
 #include <QtDebug>
 
 #include "MarketAnalysisSettings.h"
+#include "PerformanceTracer.h"
 #include "EveDataProvider.h"
 #include "ArbitrageUtils.h"
 #include "ExternalOrder.h"
@@ -73,6 +74,8 @@ namespace Evernus
                                                      double sellVolumeLimit,
                                                      const std::optional<double> &customStationTax)
     {
+        const TraceSpan span{"analysis", "OreReprocessingArbitrageModel::setOrderData"};
+
         beginResetModel();
 
         BOOST_SCOPE_EXIT(this_) {
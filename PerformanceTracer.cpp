@@ -0,0 +1,275 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QThread>
+#include <QtDebug>
+
+#include "PerformanceTracer.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        struct TraceEvent
+        {
+            const char *mCategory = nullptr;
+            const char *mName = nullptr;
+            qint64 mStart = 0;
+            qint64 mDuration = 0;
+            QString mDetail;
+            quint64 mAsyncId = 0;
+        };
+
+        // each thread appends to its own buffer, so recording never contends with other threads
+        struct ThreadBuffer
+        {
+            uint mThreadId = 0;
+            QString mThreadName;
+            std::mutex mMutex;
+            std::vector<TraceEvent> mEvents;
+        };
+
+        const std::size_t maxEventsPerThread = 1000000;
+
+        std::atomic_bool enabled{false};
+        std::atomic_uint nextThreadId{1};
+        std::atomic<quint64> nextAsyncId{1};
+
+        std::mutex buffersMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+        const auto epoch = std::chrono::steady_clock::now();
+
+        ThreadBuffer &getThreadBuffer()
+        {
+            thread_local const auto buffer = [] {
+                auto buffer = std::make_shared<ThreadBuffer>();
+                buffer->mThreadId = nextThreadId++;
+
+                const auto thread = QThread::currentThread();
+                if (thread != nullptr)
+                    buffer->mThreadName = thread->objectName();
+                if (buffer->mThreadName.isEmpty())
+                    buffer->mThreadName = QStringLiteral("Thread %1").arg(buffer->mThreadId);
+
+                std::lock_guard<std::mutex> lock{buffersMutex};
+                buffers.emplace_back(buffer);
+
+                return buffer;
+            }();
+
+            return *buffer;
+        }
+
+        QByteArray escapeJson(const QString &value)
+        {
+            QByteArray result;
+            result.reserve(value.size() + 2);
+
+            for (const auto c : value.toUtf8())
+            {
+                switch (c) {
+                case '"':
+                    result += "\\\"";
+                    break;
+                case '\\':
+                    result += "\\\\";
+                    break;
+                case '\n':
+                    result += "\\n";
+                    break;
+                case '\t':
+                    result += "\\t";
+                    break;
+                default:
+                    if (static_cast<uchar>(c) < 0x20)
+                        result += QByteArrayLiteral("\\u00") + QByteArray::number(static_cast<uchar>(c), 16).rightJustified(2, '0');
+                    else
+                        result += c;
+                }
+            }
+
+            return result;
+        }
+
+        void appendEvent(TraceEvent event)
+        {
+            auto &buffer = getThreadBuffer();
+
+            std::lock_guard<std::mutex> lock{buffer.mMutex};
+            if (Q_LIKELY(buffer.mEvents.size() < maxEventsPerThread))
+                buffer.mEvents.emplace_back(std::move(event));
+        }
+
+        QByteArray makeEventHeader(const char *phase, const TraceEvent &event, const QByteArray &pid, const QByteArray &tid, qint64 timestamp)
+        {
+            QByteArray line = "{\"ph\":\"";
+            line += phase;
+            line += "\",\"cat\":\"";
+            line += event.mCategory;
+            line += "\",\"name\":\"";
+            line += event.mName;
+            line += "\",\"pid\":" + pid + ",\"tid\":" + tid;
+            line += ",\"ts\":" + QByteArray::number(timestamp);
+
+            return line;
+        }
+
+        QByteArray makeEventArgs(const TraceEvent &event)
+        {
+            return (event.mDetail.isEmpty()) ? (QByteArray{}) : (",\"args\":{\"detail\":\"" + escapeJson(event.mDetail) + "\"}");
+        }
+    }
+
+    bool PerformanceTracer::isEnabled() noexcept
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void PerformanceTracer::setEnabled(bool flag) noexcept
+    {
+        enabled = flag;
+    }
+
+    qint64 PerformanceTracer::now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    void PerformanceTracer::record(const char *category, const char *name, qint64 start, const QString &detail)
+    {
+        if (!isEnabled())
+            return;
+
+        appendEvent(TraceEvent{category, name, start, now() - start, detail});
+    }
+
+    void PerformanceTracer::recordAsync(const char *category, const char *name, qint64 start, const QString &detail)
+    {
+        if (!isEnabled())
+            return;
+
+        appendEvent(TraceEvent{category, name, start, now() - start, detail, nextAsyncId++});
+    }
+
+    void PerformanceTracer::clear()
+    {
+        std::lock_guard<std::mutex> lock{buffersMutex};
+
+        // buffers no longer referenced by their threads are gone for good
+        buffers.erase(std::remove_if(std::begin(buffers), std::end(buffers), [](const auto &buffer) {
+            return buffer.use_count() == 1;
+        }), std::end(buffers));
+
+        for (const auto &buffer : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock{buffer->mMutex};
+            buffer->mEvents.clear();
+        }
+    }
+
+    bool PerformanceTracer::exportChromeTrace(const QString &fileName)
+    {
+        QSaveFile file{fileName};
+        if (!file.open(QIODevice::WriteOnly))
+        {
+            qWarning() << "Cannot open trace file:" << fileName << file.errorString();
+            return false;
+        }
+
+        const auto pid = QByteArray::number(QCoreApplication::applicationPid());
+
+        file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+        auto first = true;
+        const auto writeSeparator = [&] {
+            if (!first)
+                file.write(",\n");
+
+            first = false;
+        };
+
+        std::lock_guard<std::mutex> lock{buffersMutex};
+        for (const auto &buffer : buffers)
+        {
+            std::lock_guard<std::mutex> bufferLock{buffer->mMutex};
+
+            const auto tid = QByteArray::number(buffer->mThreadId);
+
+            writeSeparator();
+            file.write("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid +
+                       ",\"args\":{\"name\":\"" + escapeJson(buffer->mThreadName) + "\"}}");
+
+            for (const auto &event : buffer->mEvents)
+            {
+                writeSeparator();
+
+                if (event.mAsyncId != 0)
+                {
+                    // async begin/end pairs get their own track instead of breaking the thread's span nesting
+                    const auto id = ",\"id\":\"0x" + QByteArray::number(event.mAsyncId, 16) + '"';
+
+                    file.write(makeEventHeader("b", event, pid, tid, event.mStart) + id + makeEventArgs(event) + "},\n");
+                    file.write(makeEventHeader("e", event, pid, tid, event.mStart + event.mDuration) + id + '}');
+                }
+                else
+                {
+                    file.write(makeEventHeader("X", event, pid, tid, event.mStart) +
+                               ",\"dur\":" + QByteArray::number(event.mDuration) +
+                               makeEventArgs(event) + '}');
+                }
+            }
+        }
+
+        file.write("]}\n");
+
+        if (!file.commit())
+        {
+            qWarning() << "Cannot write trace file:" << fileName << file.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    TraceSpan::TraceSpan(const char *category, const char *name) noexcept
+        : mCategory{category}
+        , mName{name}
+    {
+        if (PerformanceTracer::isEnabled())
+            mStart = PerformanceTracer::now();
+    }
+
+    TraceSpan::TraceSpan(const char *category, const char *name, QString detail)
+        : TraceSpan{category, name}
+    {
+        if (mStart >= 0)
+            mDetail = std::move(detail);
+    }
+
+    TraceSpan::~TraceSpan()
+    {
+        if (mStart >= 0)
+            PerformanceTracer::record(mCategory, mName, mStart, mDetail);
+    }
+}
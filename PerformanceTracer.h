@@ -0,0 +1,69 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <type_traits>
+
+#include <QString>
+
+namespace Evernus
+{
+    // lightweight span recorder, exportable to Chrome trace format (chrome://tracing, Perfetto)
+    class PerformanceTracer final
+    {
+    public:
+        PerformanceTracer() = delete;
+
+        static bool isEnabled() noexcept;
+        static void setEnabled(bool flag) noexcept;
+
+        // microseconds since application start
+        static qint64 now() noexcept;
+
+        static void record(const char *category, const char *name, qint64 start, const QString &detail = QString{});
+        // for spans which can overlap others on the same thread, e.g. network requests awaited by the event loop
+        static void recordAsync(const char *category, const char *name, qint64 start, const QString &detail = QString{});
+        static void clear();
+
+        static bool exportChromeTrace(const QString &fileName);
+    };
+
+    class TraceSpan final
+    {
+    public:
+        TraceSpan(const char *category, const char *name) noexcept;
+        TraceSpan(const char *category, const char *name, QString detail);
+        // detail is only built when tracing is enabled
+        template<class DetailFunc, class = std::enable_if_t<std::is_invocable_r_v<QString, DetailFunc>>>
+        TraceSpan(const char *category, const char *name, DetailFunc detailFunc)
+            : TraceSpan{category, name}
+        {
+            if (mStart >= 0)
+                mDetail = detailFunc();
+        }
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan(TraceSpan &&) = delete;
+        ~TraceSpan();
+
+        TraceSpan &operator =(const TraceSpan &) = delete;
+        TraceSpan &operator =(TraceSpan &&) = delete;
+
+    private:
+        const char * const mCategory = nullptr;
+        const char * const mName = nullptr;
+        QString mDetail;
+        qint64 mStart = -1;
+    };
+}
@@ -14,8 +14,10 @@
  */
 #include <QSettings>
 
+#include "MarketImportPlanner.h"
+#include "EveDataProvider.h"
+
 #include "ProxyWebExternalOrderImporter.h"
-#include "SSOUtils.h"
 
 namespace Evernus
 {
@@ -41,10 +43,15 @@ namespace Evernus
     {
         if (mCurrentOrderImportType == ImportSettings::MarketOrderImportType::Auto)
         {
-            if (SSOUtils::useWholeMarketImport(target, mDataProvider))
-                mESIWholeImporter->fetchExternalOrders(id, target);
-            else
+            TypeLocationPairs typeRegionPairs;
+            for (const auto &pair : target)
+                typeRegionPairs.insert(std::make_pair(pair.first, mDataProvider.getStationRegionId(pair.second)));
+
+            const auto plan = MarketImportPlanner::planImport(typeRegionPairs, mCurrentOrderImportType);
+            if (plan.mWholeRegions.empty())
                 mESIIndividualImporter->fetchExternalOrders(id, target);
+            else
+                mESIWholeImporter->fetchExternalOrders(id, target, plan.mWholeRegions);
         }
         else if (mCurrentOrderImportType == ImportSettings::MarketOrderImportType::Individual)
         {
@@ -193,6 +193,16 @@ namespace Evernus
         mTypeViewProxy.setSortRole(Qt::UserRole);
         mTypeViewProxy.setSourceModel(&mTypeDataModel);
 
+        connect(&mTypeDataModel, &TypeAggregatedMarketDataModel::calculationFinished, this, [=] {
+            mRegionDataStack->setCurrentWidget(mRegionTypeDataView);
+
+            if (mCalculatedRegion != 0)
+                emit analysisResultsChanged(mCalculatedRegion, HttpApiResponse::tableFromModel(mTypeDataModel));
+        });
+        connect(&mTypeDataModel, &TypeAggregatedMarketDataModel::calculationCancelled, this, [=] {
+            mRegionDataStack->setCurrentWidget(mRegionTypeDataView);
+        });
+
         mRegionTypeDataView = new AdjustableTableView{QStringLiteral("marketAnalysisRegionView"), this};
         mRegionDataStack->addWidget(mRegionTypeDataView);
         mRegionTypeDataView->setSortingEnabled(true);
@@ -247,41 +257,46 @@ namespace Evernus
             QSettings settings;
             settings.setValue(MarketAnalysisSettings::lastRegionKey, region);
 
-            mRegionDataStack->setCurrentIndex(waitingLabelIndex);
-            mRegionDataStack->repaint();
+            showWaitingForData();
 
             const auto historyAndOrders = getHistoryAndOrders(region);
 
+            mCalculatedRegion = region;
+
             fillSolarSystems(region);
             mTypeDataModel.setOrderData(*historyAndOrders.second,
                                         *historyAndOrders.first,
                                         region,
                                         mSrcPriceType,
                                         mDstPriceType);
-
-            mRegionDataStack->setCurrentWidget(mRegionTypeDataView);
         }
     }
 
+    void RegionAnalysisWidget::showForRegion(uint region)
+    {
+        // only refresh when new data is relevant to what's shown
+        if (region == getCurrentRegion())
+            showForCurrentRegion();
+    }
+
     void RegionAnalysisWidget::showForCurrentRegionAndSolarSystem()
     {
         const auto region = getCurrentRegion();
         if (region != 0)
         {
-            mRegionDataStack->setCurrentIndex(waitingLabelIndex);
-            mRegionDataStack->repaint();
+            showWaitingForData();
 
             const auto historyAndOrders = getHistoryAndOrders(region);
 
             const auto system = mSolarSystemCombo->currentData().toUInt();
+            mCalculatedRegion = (system == 0) ? (region) : (0);
+
             mTypeDataModel.setOrderData(*historyAndOrders.second,
                                         *historyAndOrders.first,
                                         region,
                                         mSrcPriceType,
                                         mDstPriceType,
                                         system);
-
-            mRegionDataStack->setCurrentWidget(mRegionTypeDataView);
         }
     }
 
@@ -381,6 +396,13 @@ namespace Evernus
         mSolarSystemCombo->blockSignals(false);
     }
 
+    void RegionAnalysisWidget::showWaitingForData()
+    {
+        // keep showing current rows while recalculating, since they get updated in place
+        if (mTypeDataModel.rowCount() == 0)
+            mRegionDataStack->setCurrentIndex(waitingLabelIndex);
+    }
+
     uint RegionAnalysisWidget::getCurrentRegion() const
     {
         return mRegionCombo->currentData().toUInt();
@@ -20,6 +20,7 @@
 #include "StandardModelProxyWidget.h"
 #include "ExternalOrderImporter.h"
 #include "MarketDataProvider.h"
+#include "HttpApiResponse.h"
 #include "ExternalOrder.h"
 #include "TaskConstants.h"
 #include "PriceType.h"
@@ -59,8 +60,12 @@ namespace Evernus
     signals:
         void preferencesChanged();
 
+        // whole region results, after each calculation
+        void analysisResultsChanged(uint regionId, const HttpApiTable &table);
+
     public slots:
         void showForCurrentRegion();
+        void showForRegion(uint region);
 
     private slots:
         void showForCurrentRegionAndSolarSystem();
@@ -106,7 +111,11 @@ namespace Evernus
         TypeAggregatedMarketDataModel mTypeDataModel;
         TypeAggregatedMarketDataFilterProxyModel mTypeViewProxy;
 
+        // 0 when the pending calculation is limited to a solar system
+        uint mCalculatedRegion = 0;
+
         void fillSolarSystems(uint regionId);
+        void showWaitingForData();
 
         uint getCurrentRegion() const;
         HistoryOrdersPair getHistoryAndOrders(uint region);
@@ -21,6 +21,8 @@
 #include <QtDebug>
 
 #include "DatabaseConnectionProvider.h"
+#include "LoggingCategories.h"
+#include "PerformanceTracer.h"
 #include "DatabaseUtils.h"
 
 namespace Evernus
@@ -34,7 +36,9 @@ namespace Evernus
     template<class T>
     QSqlQuery Repository<T>::exec(const QString &query) const
     {
-        qDebug() << "SQL:" << query;
+        const TraceSpan span{"sql", "Repository::exec", [&query] { return query; }};
+
+        qCDebug(lcSql) << "SQL:" << query;
 
         const auto db = getDatabase();
 
@@ -70,6 +74,8 @@ namespace Evernus
     template<class T>
     void Repository<T>::store(T &entity) const
     {
+        const TraceSpan span{"sql", "Repository::store", [this] { return getTableName(); }};
+
         preStore(entity);
 
         if (entity.isNew())
@@ -90,6 +96,8 @@ namespace Evernus
         if (entities.empty())
             return;
 
+        const TraceSpan span{"sql", "Repository::batchStore", [this] { return getTableName(); }};
+
         const auto maxRowsPerInsert = getMaxRowsPerInsert();
         const auto totalRows = entities.size();
         const auto batches = totalRows / maxRowsPerInsert;
@@ -168,6 +176,8 @@ namespace Evernus
     template<class Id>
     void Repository<T>::remove(Id &&id) const
     {
+        const TraceSpan span{"sql", "Repository::remove", [this] { return getTableName(); }};
+
         auto query = prepare(QStringLiteral("DELETE FROM %1 WHERE %2 = :id").arg(getTableName()).arg(getIdColumn()));
         query.bindValue(QStringLiteral(":id"), id);
         DatabaseUtils::execQuery(query);
@@ -176,6 +186,8 @@ namespace Evernus
     template<class T>
     typename Repository<T>::EntityList Repository<T>::fetchAll() const
     {
+        const TraceSpan span{"sql", "Repository::fetchAll", [this] { return getTableName(); }};
+
         EntityList out;
 
         auto result = exec(QStringLiteral("SELECT * FROM %1").arg(getTableName()));
@@ -193,6 +205,8 @@ namespace Evernus
     template<class Id>
     typename Repository<T>::EntityPtr Repository<T>::find(Id &&id) const
     {
+        const TraceSpan span{"sql", "Repository::find", [this] { return getTableName(); }};
+
         auto query = prepare(QStringLiteral("SELECT * FROM %1 WHERE %2 = :id").arg(getTableName()).arg(getIdColumn()));
         query.bindValue(QStringLiteral(":id"), id);
         DatabaseUtils::execQuery(query);
@@ -0,0 +1,56 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <unordered_set>
+#include <utility>
+#include <queue>
+
+#include "RouteUtils.h"
+
+namespace Evernus
+{
+    namespace RouteUtils
+    {
+        uint getJumpDistance(const JumpMap &jumpMap, uint startSystem, uint endSystem)
+        {
+            std::unordered_set<uint> visited;
+            std::queue<std::pair<uint, uint>> candidates;
+
+            visited.emplace(startSystem);
+            candidates.emplace(std::make_pair(startSystem, 0u));
+
+            while (!candidates.empty())
+            {
+                const auto current = candidates.front();
+                candidates.pop();
+
+                const auto depth = current.second;
+                if (current.first == endSystem)
+                    return depth;
+
+                const auto children = jumpMap.equal_range(current.first);
+                for (auto it = children.first; it != children.second; ++it)
+                {
+                    if (visited.find(it->second) == std::end(visited))
+                    {
+                        visited.emplace(it->second);
+                        candidates.emplace(std::make_pair(it->second, depth + 1));
+                    }
+                }
+            }
+
+            return unreachableDistance;
+        }
+    }
+}
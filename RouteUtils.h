@@ -0,0 +1,33 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <unordered_map>
+#include <limits>
+
+#include <QtGlobal>
+
+namespace Evernus
+{
+    namespace RouteUtils
+    {
+        using JumpMap = std::unordered_multimap<uint, uint>;
+
+        const auto unreachableDistance = std::numeric_limits<uint>::max();
+
+        // number of jumps between systems in a single jump map, or unreachableDistance
+        uint getJumpDistance(const JumpMap &jumpMap, uint startSystem, uint endSystem);
+    }
+}
@@ -17,7 +17,6 @@
 #include <QSettings>
 #include <QUrlQuery>
 
-#include "EveDataProvider.h"
 #include "SSOSettings.h"
 
 #include "SSOUtils.h"
@@ -26,27 +25,6 @@ namespace Evernus
 {
     namespace SSOUtils
     {
-        bool useWholeMarketImport(const TypeLocationPairs &target,
-                                  const EveDataProvider &dataProvider)
-        {
-            std::unordered_set<uint> regions;
-            TypeLocationPairs typeRegions;
-
-            for (const auto &pair : target)
-            {
-                const auto regionId = dataProvider.getStationRegionId(pair.second);
-
-                regions.insert(regionId);
-                typeRegions.insert(std::make_pair(pair.first, regionId));
-            }
-
-            const auto requestsPerRegion = 30; // assuming 30 requests typical worst case, as with The Forge
-            const auto wholeImportScore = regions.size() * requestsPerRegion;
-
-            qDebug() << "Auto importer values:" << wholeImportScore << "vs" << typeRegions.size();
-            return wholeImportScore < typeRegions.size();
-        }
-
         void clearRefreshTokens()
         {
             QSettings settings;
@@ -16,16 +16,10 @@
 
 #include <QVariant>
 
-#include "ExternalOrderImporter.h"
-
 namespace Evernus
 {
-    class EveDataProvider;
-
     namespace SSOUtils
     {
-        bool useWholeMarketImport(const TypeLocationPairs &target,
-                                  const EveDataProvider &dataProvider);
         void clearRefreshTokens();
 
         QVariantMap parseAuthorizationCode(const QByteArray &rawQuery);
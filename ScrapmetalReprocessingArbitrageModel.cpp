@@ -30,6 +30,7 @@
 #include <QtDebug>
 
 #include "MarketAnalysisSettings.h"
+#include "PerformanceTracer.h"
 #include "EveDataProvider.h"
 #include "ArbitrageUtils.h"
 #include "ExternalOrder.h"
@@ -74,6 +75,8 @@ namespace Evernus
                                                             double sellVolumeLimit,
                                                             const std::optional<double> &customStationTax)
     {
+        const TraceSpan span{"analysis", "ScrapmetalReprocessingArbitrageModel::setOrderData"};
+
         beginResetModel();
 
         BOOST_SCOPE_EXIT(this_) {
@@ -12,6 +12,8 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
+
 #include <QJSEngine>
 
 #include "ItemCostProvider.h"
@@ -73,6 +75,17 @@ namespace Evernus
         QJSEngine engine;
         CommonScriptAPI::insertAPI(engine, mDataProvider);
 
+        std::vector<ItemCostProvider::CharacterTypePair> costKeys;
+        costKeys.reserve(orders.size());
+
+        for (const auto &order : orders)
+            costKeys.emplace_back(order->getCharacterId(), order->getTypeId());
+
+        const auto costs = mItemCostProvider.fetchForCharacterAndTypes(costKeys);
+        const auto getCost = [&](const auto &order) {
+            return costs.at(std::make_pair(order.getCharacterId(), order.getTypeId()));
+        };
+
         if (mode == Mode::ForEach)
         {
             auto processFunction = engine.evaluate("(function process(order) {\n" + script + "\n})");
@@ -86,7 +99,7 @@ namespace Evernus
             for (const auto &order : orders)
             {
                 const auto value
-                    = processFunction.call(QJSValueList{} << ScriptUtils::wrapMarketOrder(engine, *order, mItemCostProvider.fetchForCharacterAndType(order->getCharacterId(), order->getTypeId())));
+                    = processFunction.call(QJSValueList{} << ScriptUtils::wrapMarketOrder(engine, *order, getCost(*order)));
                 if (value.isError())
                 {
                     endResetModel();
@@ -114,7 +127,7 @@ namespace Evernus
 
             auto arguments = engine.newArray(static_cast<uint>(orders.size()));
             for (auto i = 0u; i < orders.size(); ++i)
-                arguments.setProperty(i, ScriptUtils::wrapMarketOrder(engine, *orders[i], mItemCostProvider.fetchForCharacterAndType(orders[i]->getCharacterId(), orders[i]->getTypeId())));
+                arguments.setProperty(i, ScriptUtils::wrapMarketOrder(engine, *orders[i], getCost(*orders[i])));
 
             const auto value = processFunction.call(QJSValueList{} << arguments);
             if (value.isError())
@@ -0,0 +1,63 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+
+#include <QSettings>
+
+#include "SettingsSnapshot.h"
+
+namespace Evernus
+{
+    namespace SettingsSnapshotUtils
+    {
+        namespace
+        {
+            SnapshotPtr currentSnapshot;
+        }
+
+        SnapshotPtr getSnapshot()
+        {
+            auto snapshot = std::atomic_load(&currentSnapshot);
+            if (Q_LIKELY(snapshot))
+                return snapshot;
+
+            refreshSnapshot();
+            return std::atomic_load(&currentSnapshot);
+        }
+
+        void refreshSnapshot()
+        {
+            QSettings settings;
+
+            auto snapshot = std::make_shared<SettingsSnapshot>();
+            snapshot->mPriceMaxAge
+                = settings.value(PriceSettings::priceMaxAgeKey, PriceSettings::priceMaxAgeDefault).toInt();
+            snapshot->mPreferredMargin
+                = settings.value(PriceSettings::preferredMarginKey, PriceSettings::preferredMarginDefault).toDouble();
+            snapshot->mShareCosts
+                = settings.value(PriceSettings::shareCostsKey, PriceSettings::shareCostsDefault).toBool();
+            snapshot->mUpdateOnlyFullAssetValue
+                = settings.value(ImportSettings::updateOnlyFullAssetValueKey, ImportSettings::updateOnlyFullAssetValueDefault).toBool();
+            snapshot->mMarketOrderMaxAge
+                = settings.value(OrderSettings::marketOrderMaxAgeKey, OrderSettings::marketOrderMaxAgeDefault).toInt();
+            snapshot->mLimitSellToStation
+                = settings.value(OrderSettings::limitSellToStationKey, OrderSettings::limitSellToStationDefault).toBool();
+            snapshot->mUseSkillsForDifference
+                = settings.value(MarketAnalysisSettings::useSkillsForDifferenceKey, MarketAnalysisSettings::useSkillsForDifferenceDefault).toBool();
+
+            std::atomic_store(&currentSnapshot, SnapshotPtr{std::move(snapshot)});
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+
+#include "MarketAnalysisSettings.h"
+#include "ImportSettings.h"
+#include "OrderSettings.h"
+#include "PriceSettings.h"
+
+namespace Evernus
+{
+    // immutable copy of settings read in valuation, painting and analysis code
+    struct SettingsSnapshot
+    {
+        int mPriceMaxAge = PriceSettings::priceMaxAgeDefault;
+        double mPreferredMargin = PriceSettings::preferredMarginDefault;
+        bool mShareCosts = PriceSettings::shareCostsDefault;
+        bool mUpdateOnlyFullAssetValue = ImportSettings::updateOnlyFullAssetValueDefault;
+        int mMarketOrderMaxAge = OrderSettings::marketOrderMaxAgeDefault;
+        bool mLimitSellToStation = OrderSettings::limitSellToStationDefault;
+        bool mUseSkillsForDifference = MarketAnalysisSettings::useSkillsForDifferenceDefault;
+    };
+
+    namespace SettingsSnapshotUtils
+    {
+        using SnapshotPtr = std::shared_ptr<const SettingsSnapshot>;
+
+        SnapshotPtr getSnapshot();
+        void refreshSnapshot();
+    }
+}
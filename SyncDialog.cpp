@@ -25,19 +25,19 @@
 #include <QPushButton>
 #include <QGroupBox>
 #include <QSettings>
-#include <QSaveFile>
 #include <QFileInfo>
 #include <QLineEdit>
 #include <QUrlQuery>
 #include <QLabel>
 #include <QMovie>
 #include <QtDebug>
-#include <QFile>
 #include <QUuid>
 #include <QFont>
 #include <QUrl>
 
+#include "DropboxSyncStorage.h"
 #include "DatabaseUtils.h"
+#include "DatabaseSync.h"
 #include "SyncSettings.h"
 #include "ReplyTimeout.h"
 
@@ -105,7 +105,7 @@ namespace Evernus
         QString mAuthState;
     };
 
-    const QString SyncDialog::mainDbPath = "/sandbox/main.db";
+    const QString SyncDialog::remoteRoot = "/sandbox";
     const QString SyncDialog::redirectLink = "https://evernus.com/sso-authentication/";
     const QString SyncDialog::localRedirectLink = QStringLiteral("http://localhost:%1").arg(localPort);
 
@@ -389,56 +389,86 @@ namespace Evernus
     {
         qDebug() << "Requesting metadata...";
 
-        QDropbox2File file{mainDbPath, &mDb};
-        connect(&file, &QDropbox2File::signal_errorOccurred, this, &SyncDialog::showError);
+        QDropbox2File manifest{remoteRoot + "/" + DatabaseSync::manifestName, &mDb};
+        connect(&manifest, &QDropbox2File::signal_errorOccurred, this, &SyncDialog::showError);
 
-        const auto metadata = file.metadata();
-        if (file.error() == QDropbox2::Error::NoError || file.error() == QDropbox2::Error::FileNotFound)
-            processMetadata(metadata);
+        const auto metadata = manifest.metadata();
+        if (manifest.error() == QDropbox2::Error::NoError)
+        {
+            // an older version might have uploaded the legacy file since - in that case it holds the newest data
+            QDropbox2File file{remoteRoot + "/" + DatabaseSync::legacyName, &mDb};
+
+            const auto legacyMetadata = file.metadata();
+            mLegacyFilesPresent = file.error() == QDropbox2::Error::NoError;
+
+            if (mLegacyFilesPresent && legacyMetadata.clientModified() > metadata.clientModified())
+            {
+                mLegacyFormat = true;
+                processMetadata(legacyMetadata);
+            }
+            else
+            {
+                processMetadata(metadata);
+            }
+        }
+        else if (manifest.error() == QDropbox2::Error::FileNotFound)
+        {
+            // data uploaded by older versions is a single compressed file
+            QDropbox2File file{remoteRoot + "/" + DatabaseSync::legacyName, &mDb};
+            connect(&file, &QDropbox2File::signal_errorOccurred, this, &SyncDialog::showError);
+
+            const auto legacyMetadata = file.metadata();
+            if (file.error() == QDropbox2::Error::NoError)
+            {
+                mLegacyFormat = true;
+                mLegacyFilesPresent = true;
+                processMetadata(legacyMetadata);
+            }
+            else if (file.error() == QDropbox2::Error::FileNotFound)
+            {
+                processMetadata(metadata);
+            }
+        }
     }
 
     void SyncDialog::downloadFiles()
     {
-        qDebug() << "Downloading files...";
+        qDebug() << "Downloading files, legacy format:" << mLegacyFormat;
 
         mStarted = true;
 
-        QDropbox2File mainDb{mainDbPath, &mDb};
-        connect(&mainDb, &QDropbox2File::signal_downloadProgress, this, &SyncDialog::updateProgress);
-        connect(&mainDb, &QDropbox2File::signal_errorOccurred, this, &SyncDialog::showError);
-        connect(mCancelBtn, &QPushButton::clicked, &mainDb, &QDropbox2File::slot_abort, Qt::QueuedConnection);
+        DropboxSyncStorage storage{mDb, remoteRoot};
+        DatabaseSync sync{storage, [](const auto &func) {
+            asyncExec(func);
+        }};
+        sync.setProgressCallback([=](auto current, auto total) {
+            updateProgress(current, total);
+        });
 
-        if (mainDb.open(QIODevice::ReadOnly))
-        {
-            qDebug() << "Saving main db...";
+        const auto cancelConnection = connect(mCancelBtn, &QPushButton::clicked, this, [&] {
+            sync.cancel();
+        });
 
-            mCancelBtn->setEnabled(false);
-            DatabaseUtils::backupDatabase(getMainDbPath());
+        DatabaseUtils::backupDatabase(getMainDbPath());
 
-            QSaveFile file{getMainDbPath()};
-            if (!file.open(QIODevice::WriteOnly))
-            {
-                QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't open file for writing! Synchronization failed."));
-                QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
-                return;
-            }
-
-            asyncExec([&] {
-                file.write(qUncompress(mainDb.readAll()));
-            });
-            mCancelBtn->setEnabled(true);
+        try
+        {
+            const auto downloaded = (mLegacyFormat) ? (sync.downloadLegacy(getMainDbPath())) : (sync.download(getMainDbPath()));
+            if (downloaded)
+                mLastSyncTime = getRemoteModificationTime();
+        }
+        catch (const std::exception &e)
+        {
+            disconnect(cancelConnection);
 
-            if (file.commit())
-            {
-                mLastSyncTime = mainDb.metadata().clientModified();
-            }
-            else
-            {
-                QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't write destination file! Synchronization failed."));
-                QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
-            }
+            qWarning() << "Sync download error:" << e.what();
+            QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't download data: %1 Synchronization failed.").arg(e.what()));
+            QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
+            return;
         }
 
+        disconnect(cancelConnection);
+
         QMetaObject::invokeMethod(this, "accept", Qt::QueuedConnection);
     }
 
@@ -447,44 +477,63 @@ namespace Evernus
         qDebug() << "Uploading files...";
 
         mStarted = true;
-        mCancelBtn->setEnabled(false);
 
-        QDropbox2File mainDb{mainDbPath, &mDb};
-        mainDb.setOverwrite(true);
-        connect(&mainDb, &QDropbox2File::signal_uploadProgress, this, &SyncDialog::updateProgress);
-        connect(mCancelBtn, &QPushButton::clicked, &mainDb, &QDropbox2File::slot_abort);
+        DropboxSyncStorage storage{mDb, remoteRoot};
+        DatabaseSync sync{storage, [](const auto &func) {
+            asyncExec(func);
+        }};
+        sync.setProgressCallback([=](auto current, auto total) {
+            updateProgress(current, total);
+        });
+
+        const auto cancelConnection = connect(mCancelBtn, &QPushButton::clicked, this, [&] {
+            sync.cancel();
+        });
 
-        if (!mainDb.open(QIODevice::WriteOnly))
+        try
         {
-            QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't open remote file! Synchronization failed."));
-            QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
-            return;
+            sync.upload(getMainDbPath());
         }
-
-        QFile localMainDb{getMainDbPath()};
-        if (!localMainDb.open(QIODevice::ReadOnly))
+        catch (const std::exception &e)
         {
-            QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't open local file! Synchronization failed."));
+            disconnect(cancelConnection);
+
+            qWarning() << "Sync upload error:" << e.what();
+            QMessageBox::warning(this, tr("Synchronization"), tr("Couldn't upload data: %1 Synchronization failed.").arg(e.what()));
             QMetaObject::invokeMethod(this, "reject", Qt::QueuedConnection);
             return;
         }
 
-        asyncExec([&] {
-            const auto data = qCompress(localMainDb.readAll(), 9);
-            mainDb.write(data);
-        });
-        mCancelBtn->setEnabled(true);
+        disconnect(cancelConnection);
 
-        mainDb.close();
+        if (mLegacyFilesPresent)
+        {
+            // the manifest is newer now, so the legacy file would only hand stale data to older versions
+            try
+            {
+                sync.removeLegacy();
+                mLegacyFilesPresent = false;
+            }
+            catch (const std::exception &e)
+            {
+                qWarning() << "Couldn't remove legacy sync file:" << e.what();
+            }
+        }
 
         QSettings settings;
         settings.setValue(SyncSettings::firstSyncKey, false);
 
-        mLastSyncTime = mainDb.metadata().clientModified();
+        mLastSyncTime = getRemoteModificationTime();
 
         QMetaObject::invokeMethod(this, "accept", Qt::QueuedConnection);
     }
 
+    QDateTime SyncDialog::getRemoteModificationTime()
+    {
+        QDropbox2File file{remoteRoot + "/" + ((mLegacyFormat) ? (DatabaseSync::legacyName) : (DatabaseSync::manifestName)), &mDb};
+        return file.metadata().clientModified();
+    }
+
     QString SyncDialog::getMainDbPath()
     {
         return DatabaseUtils::getDbPath() + "main.db";
@@ -496,6 +545,8 @@ namespace Evernus
         auto future = std::async(std::launch::async, std::forward<T>(func));
         while (future.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
             qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+
+        future.get();
     }
 }
 
@@ -61,7 +61,7 @@ namespace Evernus
 
         static const quint16 localPort = 62345;
 
-        static const QString mainDbPath;
+        static const QString remoteRoot;
         static const QString redirectLink;
         static const QString localRedirectLink;
 
@@ -69,6 +69,8 @@ namespace Evernus
 
         Mode mMode = Mode::Download;
         bool mStarted = false;
+        bool mLegacyFormat = false;
+        bool mLegacyFilesPresent = false;
 
         SimpleCrypt mCrypt;
         QDropbox2 mDb;
@@ -96,6 +98,8 @@ namespace Evernus
         void downloadFiles();
         void uploadFiles();
 
+        QDateTime getRemoteModificationTime();
+
         static QString getMainDbPath();
 
         template<class T>
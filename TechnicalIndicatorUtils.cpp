@@ -0,0 +1,147 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include <QDate>
+
+#ifdef Q_CC_MSVC
+#   pragma warning(push)
+#   pragma warning(disable : 4244)
+#endif
+
+#include <boost/accumulators/statistics/rolling_variance.hpp>
+#include <boost/accumulators/statistics/rolling_mean.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/accumulators.hpp>
+
+#ifdef Q_CC_MSVC
+#   pragma warning(pop)
+#endif
+
+#include "TechnicalIndicatorUtils.h"
+
+namespace ba = boost::accumulators;
+
+namespace Evernus
+{
+    namespace TechnicalIndicatorUtils
+    {
+        IndicatorValues calcIndicators(const MarketHistory &history,
+                                       const QDate &start,
+                                       const QDate &end,
+                                       int smaDays,
+                                       int macdFastDays,
+                                       int macdSlowDays,
+                                       int macdEmaDays,
+                                       VolumeType volumeType,
+                                       const DayCallback &dayCallback)
+        {
+            IndicatorValues result;
+
+            if (start > end || history.empty())
+                return result;
+
+            auto prevAvg = 0.;
+
+            const auto it = history.lower_bound(start);
+            if (it != std::end(history))
+            {
+                if (it == std::begin(history))
+                    prevAvg = it->second.mAvgPrice;
+                else
+                    prevAvg = std::prev(it)->second.mAvgPrice;
+            }
+
+            const auto rsiDays = 14;
+            const auto rsiEmaAlpha = 1. / rsiDays;
+            const auto macdFastEmaAlpha = 1. / macdFastDays;
+            const auto macdSlowEmaAlpha = 1. / macdSlowDays;
+            const auto macdEmaAlpha = 1. / macdEmaDays;
+
+            auto prevUEma = 0., prevDEma = 0.;
+            auto prevMacdFastEma = prevAvg, prevMacdSlowEma = prevAvg, prevMacdEma = 0.;
+
+            ba::accumulator_set<double, ba::stats<ba::tag::variance>> volAcc;
+            ba::accumulator_set<double, ba::stats<ba::tag::rolling_mean, ba::tag::rolling_variance>>
+            prcAcc(ba::tag::rolling_window::window_size = std::max(smaDays, 1));
+
+            for (auto date = start; date <= end; date = date.addDays(1))
+            {
+                auto u = 0., d = 0.;
+
+                result.mPreviousPrice = prevAvg;
+
+                const auto it = history.find(date);
+                if (it == std::end(history))
+                {
+                    volAcc(0.);
+                    prcAcc(0.);
+
+                    result.mVolume = 0.;
+                    result.mPrice = 0.;
+
+                    prevAvg = 0.;
+                }
+                else
+                {
+                    u = std::max(0., it->second.mAvgPrice - prevAvg);
+                    d = std::max(0., prevAvg - it->second.mAvgPrice);
+
+                    const double volumeValue = (volumeType == VolumeType::OrderCount) ?
+                                               (it->second.mOrders) :
+                                               (it->second.mVolume);
+
+                    volAcc(volumeValue);
+                    prcAcc(it->second.mAvgPrice);
+
+                    result.mVolume = volumeValue;
+                    result.mPrice = it->second.mAvgPrice;
+
+                    prevAvg = it->second.mAvgPrice;
+                }
+
+                result.mSMA = ba::rolling_mean(prcAcc);
+
+                prevUEma = rsiEmaAlpha * u + (1. - rsiEmaAlpha) * prevUEma;
+                prevDEma = rsiEmaAlpha * d + (1. - rsiEmaAlpha) * prevDEma;
+
+                result.mRSI = (qFuzzyIsNull(prevDEma)) ? (100.) : (100. - 100. / (1. + prevUEma / prevDEma));
+
+                prevMacdFastEma = macdFastEmaAlpha * prevAvg + (1. - macdFastEmaAlpha) * prevMacdFastEma;
+                prevMacdSlowEma = macdSlowEmaAlpha * prevAvg + (1. - macdSlowEmaAlpha) * prevMacdSlowEma;
+
+                result.mMACD = prevMacdFastEma - prevMacdSlowEma;
+
+                prevMacdEma = macdEmaAlpha * result.mMACD + (1. - macdEmaAlpha) * prevMacdEma;
+                result.mMACDSignal = prevMacdEma;
+
+                const auto stdDev2 = 2. * std::sqrt(ba::rolling_variance(prcAcc));
+
+                result.mBollingerUpper = result.mSMA + stdDev2;
+                result.mBollingerLower = result.mSMA - stdDev2;
+
+                if (dayCallback)
+                    dayCallback(date, (it == std::end(history)) ? (nullptr) : (&it->second), result);
+            }
+
+            result.mVolumeMean = ba::mean(volAcc);
+            result.mVolumeStdDev = std::sqrt(ba::variance(volAcc));
+
+            return result;
+        }
+    }
+}
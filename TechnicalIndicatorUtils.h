@@ -0,0 +1,57 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <functional>
+
+#include "MarketHistory.h"
+#include "VolumeType.h"
+
+class QDate;
+
+namespace Evernus
+{
+    namespace TechnicalIndicatorUtils
+    {
+        struct IndicatorValues
+        {
+            double mPrice = 0.;
+            double mPreviousPrice = 0.;
+            double mSMA = 0.;
+            double mRSI = 0.;
+            double mMACD = 0.;
+            double mMACDSignal = 0.;
+            double mBollingerUpper = 0.;
+            double mBollingerLower = 0.;
+            double mVolume = 0.;
+            double mVolumeMean = 0.;
+            double mVolumeStdDev = 0.;
+        };
+
+        // called for every day in range; entry is null on days without history and volume statistics are not filled in
+        using DayCallback = std::function<void (const QDate &date, const MarketHistoryEntry *entry, const IndicatorValues &values)>;
+
+        // returns values for the last day, along with volume statistics for the whole range
+        IndicatorValues calcIndicators(const MarketHistory &history,
+                                       const QDate &start,
+                                       const QDate &end,
+                                       int smaDays,
+                                       int macdFastDays,
+                                       int macdSlowDays,
+                                       int macdEmaDays,
+                                       VolumeType volumeType,
+                                       const DayCallback &dayCallback = DayCallback{});
+    }
+}
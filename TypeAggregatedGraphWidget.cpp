@@ -13,28 +13,14 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <memory>
-#include <cmath>
+#include <algorithm>
 
 #include <QVBoxLayout>
 #include <QScrollArea>
 #include <QSettings>
 #include <QDate>
 
-#ifdef Q_CC_MSVC
-#   pragma warning(push)
-#   pragma warning(disable : 4244)
-#endif
-
-#include <boost/accumulators/statistics/rolling_variance.hpp>
-#include <boost/accumulators/statistics/rolling_mean.hpp>
-#include <boost/accumulators/statistics/variance.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/accumulators.hpp>
-
-#ifdef Q_CC_MSVC
-#   pragma warning(pop)
-#endif
-
+#include "TechnicalIndicatorUtils.h"
 #include "MarketAnalysisSettings.h"
 #include "UISettings.h"
 
@@ -42,8 +28,6 @@
 
 #include "TypeAggregatedGraphWidget.h"
 
-namespace ba = boost::accumulators;
-
 namespace Evernus
 {
     TypeAggregatedGraphWidget::TypeAggregatedGraphWidget(History history, QWidget *parent, Qt::WindowFlags flags)
@@ -229,26 +213,6 @@ namespace Evernus
 
         const auto size = start.daysTo(end) + 1;
 
-        auto prevAvg = 0.;
-
-        const auto it = mHistory.lower_bound(start);
-        if (it != std::end(mHistory))
-        {
-            if (it == std::begin(mHistory))
-                prevAvg = it->second.mAvgPrice;
-            else
-                prevAvg = std::prev(it)->second.mAvgPrice;
-        }
-
-        const auto rsiDays = 14;
-        const auto rsiEmaAlpha = 1. / rsiDays;
-        const auto macdFastEmaAlpha = 1. / macdFastDays;
-        const auto macdSlowEmaAlpha = 1. / macdSlowDays;
-        const auto macdEmaAlpha = 1. / macdEmaDays;
-
-        auto prevUEma = 0., prevDEma = 0.;
-        auto prevMacdFastEma = prevAvg, prevMacdSlowEma = prevAvg, prevMacdEma = 0.;
-
         QVector<double> dates, volumes, open, high, low, close, sma, rsi, macd, macdAvg, macdDivergence, bollingerUp, bollingerLow;
         dates.reserve(size);
         volumes.reserve(size);
@@ -264,87 +228,45 @@ namespace Evernus
         bollingerUp.reserve(size);
         bollingerLow.reserve(size);
 
-        ba::accumulator_set<quint64, ba::stats<ba::tag::variance>> volAcc;
-        ba::accumulator_set<double, ba::stats<ba::tag::rolling_mean, ba::tag::rolling_variance>>
-        prcAcc(ba::tag::rolling_window::window_size = smaDays);
-
-        for (auto date = start; date <= end; date = date.addDays(1))
-        {
+        const auto indicators = TechnicalIndicatorUtils::calcIndicators(mHistory,
+                                                                        start,
+                                                                        end,
+                                                                        smaDays,
+                                                                        macdFastDays,
+                                                                        macdSlowDays,
+                                                                        macdEmaDays,
+                                                                        volumeType,
+                                                                        [&](const auto &date, const auto entry, const auto &values) {
             dates << QDateTime{date}.toMSecsSinceEpoch() / 1000.;
 
-            auto u = 0., d = 0.;
-
-            const auto it = mHistory.find(date);
-            if (it == std::end(mHistory))
+            if (entry == nullptr)
             {
-                volAcc(0);
-                prcAcc(0.);
-
                 volumes << 0.;
                 open << 0.;
                 high << 0.;
                 low << 0.;
                 close << 0.;
-
-                prevAvg = 0.;
             }
             else
             {
-                u = std::max(0., it->second.mAvgPrice - prevAvg);
-                d = std::max(0., prevAvg - it->second.mAvgPrice);
-
-                const auto volumeValue = (volumeType == VolumeType::OrderCount) ?
-                                         (it->second.mOrders) :
-                                         (it->second.mVolume);
-
-                volAcc(volumeValue);
-                prcAcc(it->second.mAvgPrice);
-
-                volumes << volumeValue;
-                open << std::max(std::min(prevAvg, it->second.mHighPrice), it->second.mLowPrice);
-                high << it->second.mHighPrice;
-                low << it->second.mLowPrice;
-                close << it->second.mAvgPrice;
-
-                prevAvg = it->second.mAvgPrice;
-            }
-
-            const auto avg = ba::rolling_mean(prcAcc);
-
-            sma << avg;
-
-            prevUEma = rsiEmaAlpha * u + (1. - rsiEmaAlpha) * prevUEma;
-            prevDEma = rsiEmaAlpha * d + (1. - rsiEmaAlpha) * prevDEma;
-
-            if (qFuzzyIsNull(prevDEma))
-            {
-                rsi << 100.;
+                volumes << values.mVolume;
+                open << std::max(std::min(values.mPreviousPrice, entry->mHighPrice), entry->mLowPrice);
+                high << entry->mHighPrice;
+                low << entry->mLowPrice;
+                close << values.mPrice;
             }
-            else
-            {
-                const auto rs = prevUEma / prevDEma;
-                rsi << (100. - 100. / (1. + rs));
-            }
-
-            prevMacdFastEma = macdFastEmaAlpha * prevAvg + (1. - macdFastEmaAlpha) * prevMacdFastEma;
-            prevMacdSlowEma = macdSlowEmaAlpha * prevAvg + (1. - macdSlowEmaAlpha) * prevMacdSlowEma;
-
-            const auto curMacd = prevMacdFastEma - prevMacdSlowEma;
-            macd << curMacd;
-
-            prevMacdEma = macdEmaAlpha * curMacd + (1. - macdEmaAlpha) * prevMacdEma;
-            macdAvg << prevMacdEma;
-
-            macdDivergence << (curMacd - prevMacdEma);
-
-            const auto stdDev2 = 2. * std::sqrt(ba::rolling_variance(prcAcc));
-
-            bollingerUp << (avg + stdDev2);
-            bollingerLow << (avg - stdDev2);
-        }
 
-        const quint64 volStdDev2 = 2 * std::sqrt(ba::variance(volAcc));
-        const auto volMean = ba::mean(volAcc);
+            sma << values.mSMA;
+            rsi << values.mRSI;
+            macd << values.mMACD;
+            macdAvg << values.mMACDSignal;
+            macdDivergence << (values.mMACD - values.mMACDSignal);
+            bollingerUp << values.mBollingerUpper;
+            bollingerLow << values.mBollingerLower;
+        });
+
+        const auto volStdDev2 = 2. * indicators.mVolumeStdDev;
+        const auto volMean = indicators.mVolumeMean;
 
         QVector<double> volumeFlagDates, volumeFlags;
         for (auto date = start; date <= end; date = date.addDays(1))
@@ -12,19 +12,19 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <unordered_set>
 #include <functional>
-#include <set>
 
-#include <QSettings>
+#include <QFutureWatcher>
 #include <QLocale>
 #include <QColor>
 #include <QIcon>
 
 #include <boost/range/adaptor/reversed.hpp>
-#include <boost/scope_exit.hpp>
 
-#include "MarketAnalysisSettings.h"
+#include <QtConcurrent>
+
+#include "PerformanceTracer.h"
+#include "SettingsSnapshot.h"
 #include "EveDataProvider.h"
 #include "ExternalOrder.h"
 #include "PriceUtils.h"
@@ -42,6 +42,11 @@ namespace Evernus
     {
     }
 
+    TypeAggregatedMarketDataModel::~TypeAggregatedMarketDataModel()
+    {
+        cancelCalculation();
+    }
+
     int TypeAggregatedMarketDataModel::columnCount(const QModelIndex &parent) const
     {
         return numColumns;
@@ -161,76 +166,48 @@ namespace Evernus
                                                      PriceType dstType,
                                                      uint solarSystem)
     {
-        beginResetModel();
-
-        BOOST_SCOPE_EXIT(this_) {
-            this_->endResetModel();
-        } BOOST_SCOPE_EXIT_END
-
-        mData.clear();
-
-        mSrcPriceType = srcType;
-        mDstPriceType = dstType;
-
-        struct LowToHigh
-        {
-            bool operator ()(const ExternalOrder &a, const ExternalOrder &b) const noexcept
-            {
-                return a.getPrice() < b.getPrice();
-            }
-        };
-
-        struct HighToLow
-        {
-            bool operator ()(const ExternalOrder &a, const ExternalOrder &b) const noexcept
-            {
-                return a.getPrice() > b.getPrice();
-            }
-        };
+        const TraceSpan span{"analysis", "TypeAggregatedMarketDataModel::setOrderData"};
 
-        TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, LowToHigh>> sellOrders;
-        TypeMap<std::multiset<std::reference_wrapper<const ExternalOrder>, HighToLow>> buyOrders;
+        cancelCalculation();
 
-        TypeMap<uint> sellVolumes, buyVolumes;
+        mPendingSrcPriceType = srcType;
+        mPendingDstPriceType = dstType;
 
-        std::unordered_set<EveType::IdType> usedTypes;
+        // the source data can be replaced by a new import while we're calculating, so gather what's needed here
+        // and leave the expensive part (percentiles) to worker threads
+        TypeMap<TypeInput> typeMap;
 
         for (const auto &order : orders)
         {
             if (order.getRegionId() != region || (solarSystem != 0 && order.getSolarSystemId() != solarSystem))
                 continue;
 
-            const auto typeId = order.getTypeId();
+            auto &input = typeMap[order.getTypeId()];
+            const auto volume = order.getVolumeRemaining();
+
             if (order.getType() == ExternalOrder::Type::Buy)
             {
-                buyOrders[typeId].insert(std::cref(order));
-                buyVolumes[typeId] += order.getVolumeRemaining();
+                input.mBuyOrders.emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                input.mBuyVolume += volume;
             }
             else
             {
-                sellOrders[typeId].insert(std::cref(order));
-                sellVolumes[typeId] += order.getVolumeRemaining();
+                input.mSellOrders.emplace_back(MathUtils::PriceVolume{order.getPrice(), volume});
+                input.mSellVolume += volume;
             }
-
-            usedTypes.insert(typeId);
         }
 
         const auto historyLimit = QDate::currentDate().addDays(-static_cast<int>(mAvgPeriod) + 1);
-        PriceUtils::Taxes taxes;
 
-        QSettings settings;
-        const auto useSkillsForDifference = mCharacter && settings.value(
-            MarketAnalysisSettings::useSkillsForDifferenceKey, MarketAnalysisSettings::useSkillsForDifferenceDefault).toBool();
-
-        if (useSkillsForDifference)
-            taxes = PriceUtils::calculateTaxes(*mCharacter);
+        auto inputs = std::make_shared<std::vector<TypeInput>>();
+        inputs->reserve(typeMap.size());
 
-        for (const auto type : usedTypes)
+        for (auto &type : typeMap)
         {
-            TypeData data;
-            auto avgPrice = 0.;
+            auto &input = type.second;
+            input.mId = type.first;
 
-            const auto typeHistory = history.find(type);
+            const auto typeHistory = history.find(type.first);
             if (typeHistory != std::end(history))
             {
                 for (const auto &timePoint : boost::adaptors::reverse(typeHistory->second))
@@ -238,61 +215,116 @@ namespace Evernus
                     if (Q_UNLIKELY(timePoint.first < historyLimit))
                         break;
 
-                    data.mVolume += timePoint.second.mVolume;
-                    avgPrice += timePoint.second.mAvgPrice;
+                    input.mVolume += timePoint.second.mVolume;
+                    input.mAvgPrice += timePoint.second.mAvgPrice;
                 }
 
-                data.mVolume /= mAvgPeriod;
-                avgPrice /= mAvgPeriod;
+                input.mVolume /= mAvgPeriod;
+                input.mAvgPrice /= mAvgPeriod;
             }
 
-            const auto &typeBuyOrders = buyOrders[type];
-            const auto &typeSellOrders = sellOrders[type];
+            inputs->emplace_back(std::move(input));
+        }
+
+        PriceUtils::Taxes taxes;
 
-            data.mId = type;
-            data.mBuyOrderCount = typeBuyOrders.size();
-            data.mSellOrderCount = typeSellOrders.size();
+        const auto useSkillsForDifference = mCharacter && SettingsSnapshotUtils::getSnapshot()->mUseSkillsForDifference;
 
-            if (mIgnorePercentiles)
+        if (useSkillsForDifference)
+            taxes = PriceUtils::calculateTaxes(*mCharacter);
+
+        const auto ignorePercentiles = mIgnorePercentiles;
+        const auto discardBogusOrders = mDiscardBogusOrders;
+        const auto bogusOrderThreshold = mBogusOrderThreshold;
+
+        // NOTE: using std::function because QtConcurrent::mapped cannot infer the result type properly
+        // the functor also keeps the input alive, since mappedReduced() over iterators doesn't own the sequence
+        const std::function<TypeData (const TypeInput &)> calculate = [=](const auto &input) {
+            Q_UNUSED(inputs);
+
+            TypeData data;
+            data.mId = input.mId;
+            data.mVolume = input.mVolume;
+            data.mBuyOrderCount = input.mBuyOrders.size();
+            data.mSellOrderCount = input.mSellOrders.size();
+
+            if (ignorePercentiles)
             {
-                data.mBuyPrice = (typeBuyOrders.empty()) ? (0.) : (std::cbegin(typeBuyOrders)->get().getPrice());
-                data.mSellPrice = (typeSellOrders.empty()) ? (0.) : (std::cbegin(typeSellOrders)->get().getPrice());
+                data.mBuyPrice = MathUtils::getBestPrice(input.mBuyOrders, PriceType::Buy);
+                data.mSellPrice = MathUtils::getBestPrice(input.mSellOrders, PriceType::Sell);
             }
             else
             {
+                // percentile calculation reorders the list, so work on a copy
+                auto typeBuyOrders = input.mBuyOrders;
+                auto typeSellOrders = input.mSellOrders;
+
                 data.mBuyPrice = MathUtils::calcPercentile(typeBuyOrders,
-                                                           buyVolumes[type] * 0.05,
-                                                           avgPrice,
-                                                           mDiscardBogusOrders,
-                                                           mBogusOrderThreshold);
+                                                           PriceType::Buy,
+                                                           input.mBuyVolume * 0.05,
+                                                           input.mAvgPrice,
+                                                           discardBogusOrders,
+                                                           bogusOrderThreshold);
                 data.mSellPrice = MathUtils::calcPercentile(typeSellOrders,
-                                                            sellVolumes[type] * 0.05,
-                                                            avgPrice,
-                                                            mDiscardBogusOrders,
-                                                            mBogusOrderThreshold);
+                                                            PriceType::Sell,
+                                                            input.mSellVolume * 0.05,
+                                                            input.mAvgPrice,
+                                                            discardBogusOrders,
+                                                            bogusOrderThreshold);
             }
 
             double realSellPrice, realBuyPrice;
             if (useSkillsForDifference)
             {
-                realSellPrice = (mDstPriceType == PriceType::Sell) ? (PriceUtils::getSellPrice(data.mSellPrice, taxes)) : (PriceUtils::getSellPrice(data.mBuyPrice, taxes, false));
-                realBuyPrice = (mSrcPriceType == PriceType::Buy) ? (PriceUtils::getBuyPrice(data.mBuyPrice, taxes)) : (PriceUtils::getBuyPrice(data.mSellPrice, taxes, false));
+                realSellPrice = (dstType == PriceType::Sell) ? (PriceUtils::getSellPrice(data.mSellPrice, taxes)) : (PriceUtils::getSellPrice(data.mBuyPrice, taxes, false));
+                realBuyPrice = (srcType == PriceType::Buy) ? (PriceUtils::getBuyPrice(data.mBuyPrice, taxes)) : (PriceUtils::getBuyPrice(data.mSellPrice, taxes, false));
             }
             else
             {
-                realSellPrice = (mDstPriceType == PriceType::Sell) ? (data.mSellPrice) : (data.mBuyPrice);
-                realBuyPrice = (mSrcPriceType == PriceType::Buy) ? (data.mBuyPrice) : (data.mSellPrice);
+                realSellPrice = (dstType == PriceType::Sell) ? (data.mSellPrice) : (data.mBuyPrice);
+                realBuyPrice = (srcType == PriceType::Buy) ? (data.mBuyPrice) : (data.mSellPrice);
             }
 
             data.mDifference = realSellPrice - realBuyPrice;
             data.mMargin = (qFuzzyIsNull(realSellPrice)) ? (0.) : (100. * data.mDifference / realSellPrice);
 
-            mData.emplace_back(std::move(data));
-        }
+            return data;
+        };
+
+        const auto fillData = [](auto &result, const auto &data) {
+            result.emplace_back(data);
+        };
+
+        const auto generation = ++mCalculationGeneration;
+
+        // workers only use what the functors own, so a watcher can outlive its generation
+        const auto watcher = new QFutureWatcher<TypeDataList>{this};
+        connect(watcher, &QFutureWatcher<TypeDataList>::finished, this, [=] {
+            watcher->deleteLater();
+
+            if (generation != mCalculationGeneration || watcher->isCanceled())
+                return;
+
+            mCalculating = false;
+            applyData(watcher->result());
+        });
+
+        mCalculationStart = PerformanceTracer::now();
+        mCalculation = QtConcurrent::mappedReduced<TypeDataList>(inputs->cbegin(),
+                                                                 inputs->cend(),
+                                                                 calculate,
+                                                                 fillData,
+                                                                 QtConcurrent::UnorderedReduce);
+        mCalculating = true;
+
+        watcher->setFuture(mCalculation);
     }
 
     void TypeAggregatedMarketDataModel::setCharacter(const std::shared_ptr<Character> &character)
     {
+        if (cancelCalculation())
+            emit calculationCancelled();
+
         beginResetModel();
         mCharacter = character;
         mData.clear();
@@ -366,4 +398,72 @@ namespace Evernus
     {
         return dstPriceColumn;
     }
+
+    void TypeAggregatedMarketDataModel::applyData(TypeDataList result)
+    {
+        PerformanceTracer::recordAsync("analysis", "TypeAggregatedMarketDataModel calculation", mCalculationStart);
+        const TraceSpan span{"analysis", "TypeAggregatedMarketDataModel::applyData"};
+
+        mSrcPriceType = mPendingSrcPriceType;
+        mDstPriceType = mPendingDstPriceType;
+
+        TypeMap<TypeData> newData;
+        for (auto &data : result)
+            newData.emplace(data.mId, std::move(data));
+
+        // update rows in place, so views can keep their sorting and selection
+        auto row = static_cast<int>(mData.size()) - 1;
+        while (row >= 0)
+        {
+            const auto it = newData.find(mData[row].mId);
+            if (it == std::end(newData))
+            {
+                auto first = row;
+                while (first > 0 && newData.find(mData[first - 1].mId) == std::end(newData))
+                    --first;
+
+                beginRemoveRows(QModelIndex{}, first, row);
+                mData.erase(std::next(std::begin(mData), first), std::next(std::begin(mData), row + 1));
+                endRemoveRows();
+
+                row = first - 1;
+            }
+            else
+            {
+                mData[row] = std::move(it->second);
+                newData.erase(it);
+
+                --row;
+            }
+        }
+
+        if (!mData.empty())
+            emit dataChanged(index(0, 0), index(static_cast<int>(mData.size()) - 1, numColumns - 1));
+
+        if (!newData.empty())
+        {
+            beginInsertRows(QModelIndex{}, static_cast<int>(mData.size()), static_cast<int>(mData.size() + newData.size()) - 1);
+
+            mData.reserve(mData.size() + newData.size());
+            for (auto &data : newData)
+                mData.emplace_back(std::move(data.second));
+
+            endInsertRows();
+        }
+
+        emit headerDataChanged(Qt::Horizontal, 0, numColumns - 1);
+        emit calculationFinished();
+    }
+
+    bool TypeAggregatedMarketDataModel::cancelCalculation()
+    {
+        if (!mCalculating)
+            return false;
+
+        ++mCalculationGeneration;
+        mCalculation.cancel();
+        mCalculating = false;
+
+        return true;
+    }
 }
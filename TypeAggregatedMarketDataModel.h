@@ -20,9 +20,11 @@
 #include <map>
 
 #include <QAbstractTableModel>
+#include <QFuture>
 
 #include "ModelWithTypes.h"
 #include "MarketHistory.h"
+#include "MathUtils.h"
 #include "Character.h"
 #include "PriceType.h"
 #include "EveType.h"
@@ -46,7 +48,7 @@ namespace Evernus
         using HistoryMap = TypeMap<MarketHistory>;
 
         explicit TypeAggregatedMarketDataModel(const EveDataProvider &dataProvider, QObject *parent = nullptr);
-        virtual ~TypeAggregatedMarketDataModel() = default;
+        virtual ~TypeAggregatedMarketDataModel();
 
         virtual int columnCount(const QModelIndex &parent = QModelIndex{}) const override;
         virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -78,6 +80,11 @@ namespace Evernus
         static int getBuyPriceColumn() noexcept;
         static int getSellPriceColumn() noexcept;
 
+    signals:
+        void calculationFinished();
+        // a running calculation was dropped without a replacement
+        void calculationCancelled();
+
     private:
         enum
         {
@@ -106,9 +113,30 @@ namespace Evernus
             quint64 mSellOrderCount = 0;
         };
 
+        struct TypeInput
+        {
+            EveType::IdType mId = EveType::invalidId;
+            MathUtils::PriceVolumeList mBuyOrders;
+            MathUtils::PriceVolumeList mSellOrders;
+            quint64 mBuyVolume = 0;
+            quint64 mSellVolume = 0;
+            double mVolume = 0.;
+            double mAvgPrice = 0.;
+        };
+
+        using TypeDataList = std::vector<TypeData>;
+
         const EveDataProvider &mDataProvider;
 
-        std::vector<TypeData> mData;
+        TypeDataList mData;
+
+        // results from older generations are stale and get ignored, so nothing needs to wait for them
+        QFuture<TypeDataList> mCalculation;
+        quint64 mCalculationGeneration = 0;
+        bool mCalculating = false;
+        PriceType mPendingSrcPriceType = PriceType::Buy;
+        PriceType mPendingDstPriceType = PriceType::Sell;
+        qint64 mCalculationStart = 0;
 
         std::shared_ptr<Character> mCharacter;
 
@@ -120,5 +148,8 @@ namespace Evernus
 
         bool mIgnorePercentiles = false;
         uint mAvgPeriod = 30;
+
+        void applyData(TypeDataList result);
+        bool cancelCalculation();
     };
 }
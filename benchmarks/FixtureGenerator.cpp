@@ -0,0 +1,258 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <QJsonObject>
+#include <QDateTime>
+#include <QDate>
+
+#include "FixtureGenerator.h"
+
+namespace Evernus
+{
+    FixtureGenerator::FixtureGenerator(unsigned seed)
+        : mEngine{seed}
+    {
+    }
+
+    MathUtils::PriceVolumeList FixtureGenerator::createPriceVolumes(std::size_t count, double basePrice)
+    {
+        MathUtils::PriceVolumeList result;
+        result.reserve(count);
+
+        for (auto i = 0u; i < count; ++i)
+            result.emplace_back(MathUtils::PriceVolume{randomPrice(basePrice), randomVolume()});
+
+        return result;
+    }
+
+    std::vector<ExternalOrder> FixtureGenerator::createOrderBook(std::size_t count, ExternalOrder::Type type, double basePrice)
+    {
+        std::vector<ExternalOrder> result(count);
+
+        auto id = ExternalOrder::IdType{1};
+        for (auto &order : result)
+        {
+            const auto volume = randomVolume();
+
+            order.setId(id++);
+            order.setType(type);
+            order.setTypeId(34);
+            order.setStationId(60003760);
+            order.setRegionId(10000002);
+            order.setPrice(randomPrice(basePrice));
+            order.setVolumeEntered(volume);
+            order.setVolumeRemaining(volume);
+            order.setMinVolume(1);
+        }
+
+        if (type == ExternalOrder::Type::Buy)
+            std::sort(std::begin(result), std::end(result), ExternalOrder::HighToLow{});
+        else
+            std::sort(std::begin(result), std::end(result), ExternalOrder::LowToHigh{});
+
+        return result;
+    }
+
+    AssetList::ItemList FixtureGenerator::createAssetItems(std::size_t count, std::size_t locations)
+    {
+        std::uniform_int_distribution<std::size_t> locationDist{0, std::max<std::size_t>(locations, 1) - 1};
+        std::uniform_int_distribution<int> kindDist{0, 9};
+        std::uniform_int_distribution<ItemData::TypeIdType> typeDist{18, 40000};
+
+        AssetList::ItemList result;
+        result.reserve(count);
+
+        std::vector<Item::IdType> containers;
+
+        auto id = Item::IdType{1000000000000};
+        for (auto i = 0u; i < count; ++i)
+        {
+            Item item{id++};
+            item.setTypeId(typeDist(mEngine));
+            item.setQuantity(randomVolume());
+            item.setRawQuantity(static_cast<int>(item.getQuantity()));
+
+            // roughly a tenth of items are containers, most of the rest sit inside one
+            const auto kind = kindDist(mEngine);
+            if (kind == 0 || containers.empty())
+            {
+                item.setLocationId(60000000 + locationDist(mEngine));
+                containers.emplace_back(item.getId());
+            }
+            else if (kind < 8)
+            {
+                std::uniform_int_distribution<std::size_t> containerDist{0, containers.size() - 1};
+                item.setParentId(containers[containerDist(mEngine)]);
+            }
+            else
+            {
+                item.setLocationId(60000000 + locationDist(mEngine));
+            }
+
+            result.emplace_back(std::move(item));
+        }
+
+        // ESI returns items in no particular order
+        std::shuffle(std::begin(result), std::end(result), mEngine);
+
+        return result;
+    }
+
+    MarketHistory FixtureGenerator::createHistory(std::size_t days, double basePrice)
+    {
+        std::normal_distribution<double> changeDist{0., 0.02};
+        std::uniform_int_distribution<int> gapDist{0, 19};
+
+        MarketHistory result;
+
+        const auto today = QDate::currentDate();
+        auto price = basePrice;
+
+        for (auto day = static_cast<qint64>(days) - 1; day >= 0; --day)
+        {
+            price = std::max(price * (1. + changeDist(mEngine)), 0.01);
+
+            // thin markets have days without any trades
+            if (gapDist(mEngine) == 0)
+                continue;
+
+            MarketHistoryEntry entry;
+            entry.mOrders = randomVolume();
+            entry.mVolume = entry.mOrders * randomVolume();
+            entry.mAvgPrice = price;
+            entry.mLowPrice = price * 0.95;
+            entry.mHighPrice = price * 1.05;
+
+            result.emplace(today.addDays(-day), entry);
+        }
+
+        return result;
+    }
+
+    QJsonArray FixtureGenerator::createOrderJson(std::size_t count, double basePrice)
+    {
+        std::bernoulli_distribution buyDist{0.5};
+        std::uniform_int_distribution<int> rangeDist{0, 3};
+
+        const QString ranges[] = {
+            QStringLiteral("station"),
+            QStringLiteral("region"),
+            QStringLiteral("system"),
+            QStringLiteral("5"),
+        };
+
+        const auto issued = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+
+        QJsonArray result;
+
+        auto id = 5000000000.;
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto volume = randomVolume();
+
+            QJsonObject order;
+            order[QStringLiteral("order_id")] = id++;
+            order[QStringLiteral("is_buy_order")] = buyDist(mEngine);
+            order[QStringLiteral("type_id")] = 34;
+            order[QStringLiteral("location_id")] = 60003760;
+            order[QStringLiteral("system_id")] = 30000142;
+            order[QStringLiteral("range")] = ranges[rangeDist(mEngine)];
+            order[QStringLiteral("price")] = randomPrice(basePrice);
+            order[QStringLiteral("volume_total")] = static_cast<int>(volume);
+            order[QStringLiteral("volume_remain")] = static_cast<int>(volume);
+            order[QStringLiteral("min_volume")] = 1;
+            order[QStringLiteral("issued")] = issued;
+            order[QStringLiteral("duration")] = 90;
+
+            result.append(order);
+        }
+
+        return result;
+    }
+
+    QJsonArray FixtureGenerator::createWalletJournalJson(std::size_t count)
+    {
+        std::uniform_int_distribution<int> refTypeDist{0, 2};
+        std::normal_distribution<double> amountDist{0., 1000000.};
+
+        const QString refTypes[] = {
+            QStringLiteral("market_transaction"),
+            QStringLiteral("brokers_fee"),
+            QStringLiteral("transaction_tax"),
+        };
+
+        const auto now = QDateTime::currentDateTimeUtc();
+
+        QJsonArray result;
+
+        auto balance = 1000000000.;
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto amount = amountDist(mEngine);
+            balance += amount;
+
+            QJsonObject entry;
+            entry[QStringLiteral("id")] = 10000000000. + i;
+            entry[QStringLiteral("date")] = now.addSecs(-static_cast<qint64>(i) * 60).toString(Qt::ISODate);
+            entry[QStringLiteral("ref_type")] = refTypes[refTypeDist(mEngine)];
+            entry[QStringLiteral("first_party_id")] = 90000001;
+            entry[QStringLiteral("second_party_id")] = 1000132;
+            entry[QStringLiteral("amount")] = amount;
+            entry[QStringLiteral("balance")] = balance;
+            entry[QStringLiteral("context_id")] = 5000000000. + i;
+            entry[QStringLiteral("context_id_type")] = QStringLiteral("market_transaction_id");
+            entry[QStringLiteral("reason")] = QString{};
+
+            result.append(entry);
+        }
+
+        return result;
+    }
+
+    RouteUtils::JumpMap FixtureGenerator::createJumpMap(uint systems)
+    {
+        std::uniform_int_distribution<uint> systemDist{0, std::max(systems, 1u) - 1};
+
+        RouteUtils::JumpMap result;
+
+        const auto addGate = [&](auto from, auto to) {
+            result.emplace(from, to);
+            result.emplace(to, from);
+        };
+
+        for (auto system = 1u; system < systems; ++system)
+            addGate(system - 1, system);
+
+        // regions have a few shortcuts, but stay mostly sparse
+        for (auto i = 0u; i < systems / 4; ++i)
+            addGate(systemDist(mEngine), systemDist(mEngine));
+
+        return result;
+    }
+
+    double FixtureGenerator::randomPrice(double basePrice)
+    {
+        // most orders cluster around the price, with a long tail of bogus ones
+        std::lognormal_distribution<double> dist{0., 0.25};
+        return basePrice * dist(mEngine);
+    }
+
+    uint FixtureGenerator::randomVolume()
+    {
+        std::geometric_distribution<uint> dist{0.01};
+        return dist(mEngine) + 1;
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include <QJsonArray>
+
+#include "MarketHistory.h"
+#include "ExternalOrder.h"
+#include "RouteUtils.h"
+#include "AssetList.h"
+#include "MathUtils.h"
+
+namespace Evernus
+{
+    // synthesizes data shaped like real market and asset imports, reproducibly for a given seed
+    class FixtureGenerator final
+    {
+    public:
+        explicit FixtureGenerator(unsigned seed = 0);
+        ~FixtureGenerator() = default;
+
+        MathUtils::PriceVolumeList createPriceVolumes(std::size_t count, double basePrice);
+        std::vector<ExternalOrder> createOrderBook(std::size_t count, ExternalOrder::Type type, double basePrice);
+
+        // a few root containers per location, with nested ships and cargo below them
+        AssetList::ItemList createAssetItems(std::size_t count, std::size_t locations);
+
+        // daily entries ending today, with a random walk price and occasional missing days
+        MarketHistory createHistory(std::size_t days, double basePrice);
+
+        // shaped like ESI market order and wallet journal pages
+        QJsonArray createOrderJson(std::size_t count, double basePrice);
+        QJsonArray createWalletJournalJson(std::size_t count);
+
+        // a chain of systems with random extra gates, so every system is reachable
+        RouteUtils::JumpMap createJumpMap(uint systems);
+
+    private:
+        std::mt19937_64 mEngine;
+
+        double randomPrice(double basePrice);
+        uint randomVolume();
+    };
+}
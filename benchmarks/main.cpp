@@ -0,0 +1,208 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <set>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QJsonObject>
+#include <QSqlQuery>
+#include <QDate>
+
+#include "MemoryDatabaseConnectionProvider.h"
+#include "TechnicalIndicatorUtils.h"
+#include "AssetListRepository.h"
+#include "ReferenceMathUtils.h"
+#include "FixtureGenerator.h"
+#include "ArbitrageUtils.h"
+#include "ItemRepository.h"
+#include "ESIJsonUtils.h"
+#include "RouteUtils.h"
+#include "MathUtils.h"
+
+namespace
+{
+    // setup runs before every iteration and is not measured
+    void runBenchmark(QTextStream &out,
+                      const QString &name,
+                      uint iterations,
+                      const std::function<void ()> &setup,
+                      const std::function<void ()> &run)
+    {
+        using Clock = std::chrono::steady_clock;
+        using Duration = std::chrono::duration<double, std::milli>;
+
+        std::vector<double> times;
+        times.reserve(iterations);
+
+        for (auto i = 0u; i < iterations; ++i)
+        {
+            setup();
+
+            const auto start = Clock::now();
+            run();
+            times.emplace_back(Duration{Clock::now() - start}.count());
+        }
+
+        std::sort(std::begin(times), std::end(times));
+
+        out << QStringLiteral("%1: median %2 ms, min %3 ms, max %4 ms\n")
+            .arg(name, -32)
+            .arg(times[times.size() / 2], 0, 'f', 3)
+            .arg(times.front(), 0, 'f', 3)
+            .arg(times.back(), 0, 'f', 3);
+        out.flush();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app{argc, argv};
+    QCoreApplication::setApplicationName(QStringLiteral("evernus-benchmarks"));
+
+    const auto iterationsArg = QStringLiteral("iterations");
+    const auto sizeArg = QStringLiteral("size");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QCoreApplication::translate("main", "Evernus hot path benchmarks"));
+    parser.addHelpOption();
+    parser.addOptions({
+        { iterationsArg, QCoreApplication::translate("main", "Iterations per benchmark"), QStringLiteral("n"), QStringLiteral("20") },
+        { sizeArg, QCoreApplication::translate("main", "Number of orders/items in fixtures"), QStringLiteral("n"), QStringLiteral("100000") },
+    });
+    parser.process(app);
+
+    const auto iterations = std::max(parser.value(iterationsArg).toUInt(), 1u);
+    const auto size = std::max(parser.value(sizeArg).toULongLong(), 1ull);
+
+    QTextStream out{stdout};
+    Evernus::FixtureGenerator generator;
+
+    {
+        const auto fixture = generator.createPriceVolumes(size, 5.);
+        Evernus::MathUtils::PriceVolumeList orders;
+
+        runBenchmark(out, QStringLiteral("MathUtils::calcPercentile"), iterations, [&] {
+            orders = fixture;
+        }, [&] {
+            Evernus::MathUtils::calcPercentile(orders, Evernus::PriceType::Sell, size / 20, 5., true, 10.);
+        });
+
+        // baseline for the above
+        runBenchmark(out, QStringLiteral("calcPercentile (sorted walk)"), iterations, [] {}, [&] {
+            Evernus::ReferenceMathUtils::calcPercentile(fixture, Evernus::PriceType::Sell, size / 20, 5., true, 10.);
+        });
+    }
+
+    {
+        const auto fixture = generator.createOrderBook(size, Evernus::ExternalOrder::Type::Sell, 5.);
+
+        using OrderSet = std::multiset<Evernus::ExternalOrder, Evernus::ExternalOrder::LowToHigh>;
+        OrderSet orders;
+
+        runBenchmark(out, QStringLiteral("ArbitrageUtils::fillOrders"), iterations, [&] {
+            orders = OrderSet(std::begin(fixture), std::end(fixture));
+        }, [&] {
+            Evernus::ArbitrageUtils::fillOrders(orders, static_cast<uint>(size * 50), false);
+        });
+    }
+
+    {
+        const auto fixture = generator.createAssetItems(size, 50);
+        Evernus::AssetList::ItemList items;
+
+        runBenchmark(out, QStringLiteral("AssetList linking"), iterations, [&] {
+            items = fixture;
+        }, [&] {
+            Evernus::AssetList list{std::move(items)};
+        });
+    }
+
+    {
+        const auto fixture = generator.createOrderJson(size, 5.);
+        const auto updateTime = QDateTime::currentDateTimeUtc();
+
+        runBenchmark(out, QStringLiteral("ESI market order conversion"), iterations, [] {}, [&] {
+            std::vector<Evernus::ExternalOrder> orders;
+            orders.reserve(fixture.size());
+
+            for (const auto &order : fixture)
+                orders.emplace_back(Evernus::ESIJsonUtils::getExternalOrderFromJson(order.toObject(), 10000002, updateTime));
+        });
+    }
+
+    {
+        const auto fixture = generator.createWalletJournalJson(size);
+
+        runBenchmark(out, QStringLiteral("ESI wallet journal conversion"), iterations, [] {}, [&] {
+            std::vector<Evernus::WalletJournalEntry> entries;
+            entries.reserve(fixture.size());
+
+            for (const auto &entry : fixture)
+                entries.emplace_back(Evernus::ESIJsonUtils::getWalletJournalEntryFromJson(entry.toObject(), 1, 0));
+        });
+    }
+
+    {
+        // the biggest regions have a few hundred systems
+        const auto systems = 400u;
+        const auto jumpMap = generator.createJumpMap(systems);
+
+        runBenchmark(out, QStringLiteral("RouteUtils::getJumpDistance"), iterations, [] {}, [&] {
+            for (auto system = 0u; system < systems; ++system)
+                Evernus::RouteUtils::getJumpDistance(jumpMap, 0, system);
+        });
+    }
+
+    {
+        const auto history = generator.createHistory(365, 5.);
+        const auto end = QDate::currentDate();
+        const auto start = end.addDays(-90);
+
+        runBenchmark(out, QStringLiteral("Technical indicators (1k types)"), iterations, [] {}, [&] {
+            for (auto i = 0; i < 1000; ++i)
+                Evernus::TechnicalIndicatorUtils::calcIndicators(history, start, end, 20, 12, 26, 9, Evernus::VolumeType::Volume);
+        });
+    }
+
+    {
+        Evernus::MemoryDatabaseConnectionProvider connectionProvider{QStringLiteral("benchmark")};
+        Evernus::ItemRepository itemRepo{false, connectionProvider};
+        Evernus::AssetListRepository assetRepo{false, connectionProvider, itemRepo};
+
+        // asset lists normally reference characters, which are irrelevant here
+        assetRepo.exec(QStringLiteral("CREATE TABLE %1 (id INTEGER PRIMARY KEY ASC, character_id BIGINT NOT NULL)").arg(assetRepo.getTableName()));
+        itemRepo.create(assetRepo);
+
+        const auto fixture = generator.createAssetItems(size, 50);
+        Evernus::AssetList list;
+
+        runBenchmark(out, QStringLiteral("Repository batch store (assets)"), iterations, [&] {
+            assetRepo.exec(QStringLiteral("DELETE FROM %1").arg(assetRepo.getTableName()));
+
+            auto items = fixture;
+            list = Evernus::AssetList{std::move(items)};
+            list.setCharacterId(1);
+        }, [&] {
+            assetRepo.store(list);
+        });
+    }
+
+    return 0;
+}
@@ -12,10 +12,13 @@
  *  You should have received a copy of the GNU General Public License
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
+
 #include <boost/exception/diagnostic_information.hpp>
 
 #include <QCommandLineParser>
 #include <QDesktopServices>
+#include <QLoggingCategory>
 #include <QStandardPaths>
 #include <QApplication>
 #include <QLocalSocket>
@@ -24,6 +27,7 @@
 #include <QQmlEngine>
 #include <QSettings>
 #include <QSysInfo>
+#include <QThread>
 #include <QtDebug>
 #include <QFile>
 #include <QDir>
@@ -48,11 +52,16 @@
 #include "EvernusApplication.h"
 #include "CommandLineOptions.h"
 #include "EveDatabaseUpdater.h"
+#include "PerformanceTracer.h"
+#include "ESIReplyArchive.h"
+#include "ESIReplayServer.h"
 #include "UpdaterSettings.h"
+#include "HeadlessRunner.h"
 #include "ImportSettings.h"
 #include "BezierCurve.h"
 #include "MainWindow.h"
 #include "VolumeType.h"
+#include "ESIUrls.h"
 #include "Version.h"
 #include "Defines.h"
 #include "Citadel.h"
@@ -122,6 +131,8 @@ namespace
 
 int main(int argc, char *argv[])
 {
+    auto headless = false;
+
     try
     {
         QCoreApplication::setApplicationName(QStringLiteral("Evernus"));
@@ -184,7 +195,22 @@ int main(int argc, char *argv[])
             { Evernus::CommandLineOptions::clientSecretArg, QCoreApplication::translate("main", "SSO client secret"), QStringLiteral("secret"), EVERNUS_CLIENT_SECRET_TEXT },
             { Evernus::CommandLineOptions::maxLogFileSizeArg, QCoreApplication::translate("main", "Max. log file size"), QStringLiteral("size"), QStringLiteral("%1").arg(10 * 1014 * 1024) },
             { Evernus::CommandLineOptions::maxLogFilesArg, QCoreApplication::translate("main", "Max. log files"), QStringLiteral("n"), QStringLiteral("3") },
+            { Evernus::CommandLineOptions::traceArg, QCoreApplication::translate("main", "Record performance trace and save it in Chrome trace format on exit"), QStringLiteral("file") },
+            { Evernus::CommandLineOptions::logRulesArg, QCoreApplication::translate("main", "Semicolon-separated logging rules, eg. evernus.sql.debug=true;evernus.esi.debug=false"), QStringLiteral("rules"), QStringLiteral("evernus.sql.debug=false") },
+            { Evernus::CommandLineOptions::esiUrlArg, QCoreApplication::translate("main", "Base ESI url"), QStringLiteral("url"), Evernus::ESIUrls::esiUrl },
+            { Evernus::CommandLineOptions::esiRecordArg, QCoreApplication::translate("main", "Record ESI responses to given directory"), QStringLiteral("dir") },
+            { Evernus::CommandLineOptions::esiReplayArg, QCoreApplication::translate("main", "Serve ESI responses recorded in given directory from a local server and use it instead of ESI"), QStringLiteral("dir") },
+            { Evernus::CommandLineOptions::esiReplayPortArg, QCoreApplication::translate("main", "ESI replay server port"), QStringLiteral("port"), QStringLiteral("8129") },
+            { Evernus::CommandLineOptions::esiReplayLatencyArg, QCoreApplication::translate("main", "ESI replay response latency"), QStringLiteral("ms"), QStringLiteral("0") },
+            { Evernus::CommandLineOptions::esiReplayErrorRateArg, QCoreApplication::translate("main", "Fraction of ESI replay responses replaced with 420/429 errors"), QStringLiteral("rate"), QStringLiteral("0") },
+            { Evernus::CommandLineOptions::esiReplayPageSizeArg, QCoreApplication::translate("main", "Repaginate recorded ESI responses using given page size (0 - as recorded)"), QStringLiteral("n"), QStringLiteral("0") },
             { Evernus::CommandLineOptions::forceSDEUpdateArg, QCoreApplication::translate("main", "Force Eve database update") },
+            { Evernus::CommandLineOptions::headlessArg, QCoreApplication::translate("main", "Run given tasks without GUI and exit") },
+            { Evernus::CommandLineOptions::headlessTasksArg, QCoreApplication::translate("main", "Comma-separated headless tasks: characters, prices, analysis"), QStringLiteral("tasks"), QStringLiteral("characters,prices") },
+            { Evernus::CommandLineOptions::headlessCharacterArg, QCoreApplication::translate("main", "Character to use in headless mode (default: all enabled)"), QStringLiteral("id") },
+            { Evernus::CommandLineOptions::headlessRegionsArg, QCoreApplication::translate("main", "Comma-separated region ids for headless analysis"), QStringLiteral("ids") },
+            { Evernus::CommandLineOptions::headlessOutputDirArg, QCoreApplication::translate("main", "Headless output directory"), QStringLiteral("dir"), QStringLiteral(".") },
+            { Evernus::CommandLineOptions::headlessOutputFormatArg, QCoreApplication::translate("main", "Headless output format: csv or json"), QStringLiteral("format"), QStringLiteral("csv") },
         });
 
         // NOTE: don't use process here or it will exit on additional args in OSX
@@ -195,9 +221,32 @@ int main(int argc, char *argv[])
         if (parser.isSet(QStringLiteral("help")))
             parser.showHelp();
 
+        headless = parser.isSet(Evernus::CommandLineOptions::headlessArg);
+
+        // no windows are ever shown in headless mode, so don't require a display
+        if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+
         Evernus::ChainableFileLogger::initialize(parser.value(Evernus::CommandLineOptions::maxLogFileSizeArg).toULongLong(),
                                                  parser.value(Evernus::CommandLineOptions::maxLogFilesArg).toUInt());
 
+        // disabled categories skip message formatting entirely
+        QLoggingCategory::setFilterRules(parser.value(Evernus::CommandLineOptions::logRulesArg).replace(';', '\n'));
+
+        const auto traceFile = parser.value(Evernus::CommandLineOptions::traceArg);
+        if (!traceFile.isEmpty())
+            Evernus::PerformanceTracer::setEnabled(true);
+
+        const auto esiReplayArchive = parser.value(Evernus::CommandLineOptions::esiReplayArg);
+        const auto esiReplayPort = parser.value(Evernus::CommandLineOptions::esiReplayPortArg).toUShort();
+
+        if (!esiReplayArchive.isEmpty())
+            Evernus::ESIUrls::setEsiUrl(QStringLiteral("http://127.0.0.1:%1").arg(esiReplayPort));
+        else
+            Evernus::ESIUrls::setEsiUrl(parser.value(Evernus::CommandLineOptions::esiUrlArg));
+
+        Evernus::ESIReplyArchive::setRecordingPath(parser.value(Evernus::CommandLineOptions::esiRecordArg));
+
         qSetMessagePattern(QStringLiteral("[%{type}] %{time} %{threadid} %{message}"));
 
 #ifdef Q_OS_WIN
@@ -215,6 +264,12 @@ int main(int argc, char *argv[])
         {
             qDebug() << "Connected to" << socket.fullServerName();
 
+            if (headless)
+            {
+                qCritical() << "Evernus is already running.";
+                return 1;
+            }
+
             QApplication tempApp{argc, argv};
             QMessageBox::information(nullptr, QCoreApplication::translate("main", "Already running"), QCoreApplication::translate("main",
                 "Evernus seems to be already running. If this is not the case, please remove '%1'.").arg(socket.fullServerName()));
@@ -228,7 +283,19 @@ int main(int argc, char *argv[])
         {
             qDebug() << "Local server listen failed:" << server.errorString();
 #ifndef Q_OS_WIN
-            if (server.serverError() == QAbstractSocket::AddressInUseError)
+            if (server.serverError() == QAbstractSocket::AddressInUseError && headless)
+            {
+                // nobody answered above, so the socket is stale
+                qDebug() << "Cleanup attempt.";
+                if (!QFile::remove(serverName))
+                {
+                    qCritical() << "Couldn't remove" << serverName;
+                    return 1;
+                }
+
+                server.listen(serverName);
+            }
+            else if (server.serverError() == QAbstractSocket::AddressInUseError)
             {
                 QApplication tempApp{argc, argv};
                 const auto ret = QMessageBox::question(nullptr, QCoreApplication::translate("main", "Already running"), QCoreApplication::translate("main",
@@ -279,7 +346,9 @@ int main(int argc, char *argv[])
         qRegisterMetaType<Evernus::Citadel::IdType>("Citadel::IdType");
 
         // Eve database must be fetched before the main application starts
-        if (Evernus::EveDatabaseUpdater::performUpdate(argc, argv, parser.isSet(Evernus::CommandLineOptions::forceSDEUpdateArg)) == Evernus::EveDatabaseUpdater::Status::Error)
+        if (headless)
+            qInfo() << "Skipping Eve database update check in headless mode.";
+        else if (Evernus::EveDatabaseUpdater::performUpdate(argc, argv, parser.isSet(Evernus::CommandLineOptions::forceSDEUpdateArg)) == Evernus::EveDatabaseUpdater::Status::Error)
             return 1;
 
         Evernus::EvernusApplication app{argc,
@@ -287,7 +356,50 @@ int main(int argc, char *argv[])
                                         parser.value(Evernus::CommandLineOptions::clientIdArg),
                                         parser.value(Evernus::CommandLineOptions::clientSecretArg),
                                         parser.value(Evernus::CommandLineOptions::forceVersionArg),
-                                        parser.isSet(Evernus::CommandLineOptions::noUpdateArg)};
+                                        parser.isSet(Evernus::CommandLineOptions::noUpdateArg),
+                                        headless};
+
+        if (!traceFile.isEmpty())
+        {
+            QObject::connect(&app, &QCoreApplication::aboutToQuit, [=] {
+                if (Evernus::PerformanceTracer::exportChromeTrace(traceFile))
+                    qInfo() << "Performance trace saved to" << traceFile;
+            });
+        }
+
+        // replay server gets its own thread, so serving doesn't skew measurements on the main one
+        QThread esiReplayThread;
+        if (!esiReplayArchive.isEmpty())
+        {
+            const auto replayServer = new Evernus::ESIReplayServer{
+                esiReplayArchive,
+                std::chrono::milliseconds{parser.value(Evernus::CommandLineOptions::esiReplayLatencyArg).toLongLong()},
+                parser.value(Evernus::CommandLineOptions::esiReplayErrorRateArg).toDouble(),
+                parser.value(Evernus::CommandLineOptions::esiReplayPageSizeArg).toUInt()
+            };
+            replayServer->moveToThread(&esiReplayThread);
+            QObject::connect(&esiReplayThread, &QThread::finished, replayServer, &QObject::deleteLater);
+
+            esiReplayThread.start();
+
+            auto started = false;
+            QMetaObject::invokeMethod(replayServer, "start", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, started), Q_ARG(quint16, esiReplayPort));
+
+            if (!started)
+            {
+                qCritical() << "Cannot start ESI replay server on port" << esiReplayPort;
+
+                esiReplayThread.quit();
+                esiReplayThread.wait();
+
+                return 1;
+            }
+
+            QObject::connect(&app, &QCoreApplication::aboutToQuit, [&] {
+                esiReplayThread.quit();
+                esiReplayThread.wait();
+            });
+        }
 
 #if EVERNUS_CREATE_DUMPS
         // hopefully we'll reach this point
@@ -318,6 +430,19 @@ int main(int argc, char *argv[])
             QStringLiteral("Type reserved.")
         );
 
+        if (headless)
+        {
+            Evernus::HeadlessRunner runner{app,
+                                           Evernus::HeadlessRunner::parseTasks(parser.value(Evernus::CommandLineOptions::headlessTasksArg)),
+                                           parser.value(Evernus::CommandLineOptions::headlessCharacterArg).toULongLong(),
+                                           Evernus::HeadlessRunner::parseRegions(parser.value(Evernus::CommandLineOptions::headlessRegionsArg)),
+                                           parser.value(Evernus::CommandLineOptions::headlessOutputDirArg),
+                                           Evernus::HeadlessRunner::parseOutputFormat(parser.value(Evernus::CommandLineOptions::headlessOutputFormatArg))};
+
+            QMetaObject::invokeMethod(&runner, "run", Qt::QueuedConnection);
+            return app.exec();
+        }
+
         try
         {
             Evernus::MainWindow mainWnd{app,
@@ -334,8 +459,8 @@ int main(int argc, char *argv[])
                                         app.getESIInterfaceManager(),
                                         app};
 
-            QObject::connect(&mainWnd, &Evernus::MainWindow::refreshCharacters,
-                             &app, &Evernus::EvernusApplication::refreshCharacters);
+            QObject::connect(&mainWnd, &Evernus::MainWindow::refreshAllCharacters,
+                             &app, &Evernus::EvernusApplication::refreshAllCharacters);
             QObject::connect(&mainWnd, &Evernus::MainWindow::refreshCitadels,
                              &app, &Evernus::EvernusApplication::refreshCitadels);
             QObject::connect(&mainWnd, &Evernus::MainWindow::importCharacter,
@@ -382,6 +507,8 @@ int main(int argc, char *argv[])
                              &app, &Evernus::EvernusApplication::setDestinationInEve);
             QObject::connect(&mainWnd, &Evernus::MainWindow::updateExternalOrders,
                              &app, &Evernus::EvernusApplication::updateExternalOrdersAndAssetValue);
+            QObject::connect(&mainWnd, &Evernus::MainWindow::marketAnalysisResultsChanged,
+                             &app, &Evernus::EvernusApplication::marketAnalysisResultsChanged);
             QObject::connect(&mainWnd, &Evernus::MainWindow::clearCorpWalletData,
                              &app, &Evernus::EvernusApplication::clearCorpWalletData);
             QObject::connect(&mainWnd, &Evernus::MainWindow::clearRefreshTokens,
@@ -410,6 +537,8 @@ int main(int argc, char *argv[])
                              &mainWnd, &Evernus::MainWindow::updateCharacters);
             QObject::connect(&app, &Evernus::EvernusApplication::characterAssetsChanged,
                              &mainWnd, &Evernus::MainWindow::characterAssetsChanged);
+            QObject::connect(&app, &Evernus::EvernusApplication::characterAssetsUpdated,
+                             &mainWnd, &Evernus::MainWindow::characterAssetsUpdated);
             QObject::connect(&app, &Evernus::EvernusApplication::externalOrdersChanged,
                              &mainWnd, &Evernus::MainWindow::externalOrdersChanged);
             QObject::connect(&app, &Evernus::EvernusApplication::externalOrdersChangedWithMarketOrders,
@@ -426,6 +555,8 @@ int main(int argc, char *argv[])
                              &mainWnd, &Evernus::MainWindow::characterMiningLedgerChanged);
             QObject::connect(&app, &Evernus::EvernusApplication::corpAssetsChanged,
                              &mainWnd, &Evernus::MainWindow::corpAssetsChanged);
+            QObject::connect(&app, &Evernus::EvernusApplication::corpAssetsUpdated,
+                             &mainWnd, &Evernus::MainWindow::corpAssetsUpdated);
             QObject::connect(&app, &Evernus::EvernusApplication::corpWalletJournalChanged,
                              &mainWnd, &Evernus::MainWindow::corpWalletJournalChanged);
             QObject::connect(&app, &Evernus::EvernusApplication::corpWalletTransactionsChanged,
@@ -521,6 +652,9 @@ int main(int argc, char *argv[])
 
         qCritical() << info.c_str();
 
+        if (headless)
+            return 1;
+
         QApplication tempApp{argc, argv};
         QMessageBox::critical(nullptr, QCoreApplication::translate("main", "Initialization error"), QString::fromStdString(info));
         return 1;
@@ -0,0 +1,156 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <unordered_map>
+#include <algorithm>
+
+#include <QtTest>
+
+#include "MemoryDatabaseConnectionProvider.h"
+#include "AssetListRepository.h"
+#include "FixtureGenerator.h"
+#include "ItemRepository.h"
+
+#include "AssetListRepositoryTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        const Character::IdType characterId = 1;
+
+        Item makeItem(Item::IdType id, Item::ParentIdType parentId, uint quantity)
+        {
+            Item item{id};
+            item.setParentId(parentId);
+            item.setTypeId(34);
+            item.setQuantity(quantity);
+            item.setRawQuantity(static_cast<int>(quantity));
+
+            if (!parentId)
+                item.setLocationId(60003760);
+
+            return item;
+        }
+
+        AssetList makeList(AssetList::ItemList &&items)
+        {
+            AssetList list{std::move(items)};
+            list.setCharacterId(characterId);
+
+            return list;
+        }
+
+        std::vector<Item::IdType> sorted(std::vector<Item::IdType> ids)
+        {
+            std::sort(std::begin(ids), std::end(ids));
+            return ids;
+        }
+    }
+
+    AssetListRepositoryTest::AssetListRepositoryTest() = default;
+    AssetListRepositoryTest::~AssetListRepositoryTest() = default;
+
+    void AssetListRepositoryTest::init()
+    {
+        mConnectionProvider = std::make_unique<MemoryDatabaseConnectionProvider>(QStringLiteral("asset-list-repository-test"));
+        mItemRepository = std::make_unique<ItemRepository>(false, *mConnectionProvider);
+        mAssetRepository = std::make_unique<AssetListRepository>(false, *mConnectionProvider, *mItemRepository);
+
+        // asset lists normally reference characters, which are irrelevant here
+        mAssetRepository->exec(QStringLiteral("CREATE TABLE %1 (id INTEGER PRIMARY KEY ASC, character_id BIGINT NOT NULL)")
+            .arg(mAssetRepository->getTableName()));
+        mItemRepository->create(*mAssetRepository);
+    }
+
+    void AssetListRepositoryTest::cleanup()
+    {
+        mAssetRepository.reset();
+        mItemRepository.reset();
+        mConnectionProvider.reset();
+    }
+
+    void AssetListRepositoryTest::storesAndFetchesItems()
+    {
+        FixtureGenerator generator;
+
+        auto list = makeList(generator.createAssetItems(1000, 10));
+        mAssetRepository->store(list);
+
+        const auto fetched = mAssetRepository->fetchForCharacter(characterId);
+        QCOMPARE(fetched->getAllItems().size(), list.getAllItems().size());
+        QCOMPARE(fetched->size(), list.size());
+
+        std::unordered_map<Item::IdType, const Item *> items;
+        for (const auto &item : list.getAllItems())
+            items.emplace(item.getId(), &item);
+
+        for (const auto &item : fetched->getAllItems())
+        {
+            const auto original = items.find(item.getId());
+            QVERIFY(original != std::end(items));
+            QCOMPARE(item.getParentId(), original->second->getParentId());
+            QCOMPARE(item.getLocationId(), original->second->getLocationId());
+            QCOMPARE(item.getTypeId(), original->second->getTypeId());
+            QCOMPARE(item.getQuantity(), original->second->getQuantity());
+            QCOMPARE(item.getChildCount(), original->second->getChildCount());
+        }
+    }
+
+    void AssetListRepositoryTest::syncReportsChanges()
+    {
+        AssetList::ItemList items;
+        items.emplace_back(makeItem(1, {}, 1));
+        items.emplace_back(makeItem(2, {}, 1));
+        items.emplace_back(makeItem(3, 1, 10));
+        items.emplace_back(makeItem(4, 1, 10));
+        items.emplace_back(makeItem(5, 2, 10));
+
+        auto initial = makeList(std::move(items));
+
+        const auto added = mAssetRepository->syncForCharacter(initial);
+        QCOMPARE(sorted(added.mAdded), (std::vector<Item::IdType>{1, 2, 3, 4, 5}));
+
+        items.clear();
+        items.emplace_back(makeItem(1, {}, 1));
+        items.emplace_back(makeItem(2, {}, 1));
+        items.emplace_back(makeItem(3, 2, 10));  // moved
+        items.emplace_back(makeItem(4, 1, 20));  // changed
+        items.emplace_back(makeItem(6, 1, 10));  // added
+                                                // 5 removed
+
+        auto updated = makeList(std::move(items));
+
+        const auto changes = mAssetRepository->syncForCharacter(updated);
+        QCOMPARE(changes.mAdded, (std::vector<Item::IdType>{6}));
+        QCOMPARE(changes.mMoved, (std::vector<Item::IdType>{3}));
+        QCOMPARE(changes.mChanged, (std::vector<Item::IdType>{4}));
+        QCOMPARE(changes.mRemoved, (std::vector<Item::IdType>{5}));
+
+        const auto fetched = mAssetRepository->fetchForCharacter(characterId);
+
+        std::vector<Item::IdType> ids;
+        for (const auto &item : fetched->getAllItems())
+        {
+            ids.emplace_back(item.getId());
+
+            if (item.getId() == 3)
+                QCOMPARE(item.getParentId(), Item::ParentIdType{2});
+            else if (item.getId() == 4)
+                QCOMPARE(item.getQuantity(), 20u);
+        }
+
+        QCOMPARE(sorted(ids), (std::vector<Item::IdType>{1, 2, 3, 4, 6}));
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+
+namespace Evernus
+{
+    class MemoryDatabaseConnectionProvider;
+    class AssetListRepository;
+    class ItemRepository;
+
+    class AssetListRepositoryTest
+        : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        AssetListRepositoryTest();
+        virtual ~AssetListRepositoryTest();
+
+    private slots:
+        void init();
+        void cleanup();
+
+        void storesAndFetchesItems();
+        void syncReportsChanges();
+
+    private:
+        std::unique_ptr<MemoryDatabaseConnectionProvider> mConnectionProvider;
+        std::unique_ptr<ItemRepository> mItemRepository;
+        std::unique_ptr<AssetListRepository> mAssetRepository;
+    };
+}
@@ -0,0 +1,88 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <unordered_set>
+
+#include <QtTest>
+
+#include "FixtureGenerator.h"
+#include "AssetList.h"
+
+#include "AssetListTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        void visit(const Item &item, std::unordered_set<Item::IdType> &seen)
+        {
+            QVERIFY(seen.emplace(item.getId()).second);
+
+            std::size_t children = 0;
+            for (const auto child : item)
+            {
+                QCOMPARE(child->getParentId(), Item::ParentIdType{item.getId()});
+                visit(*child, seen);
+                ++children;
+            }
+
+            QCOMPARE(item.getChildCount(), children);
+        }
+    }
+
+    void AssetListTest::nestsChildrenBeforeParents()
+    {
+        AssetList::ItemList items;
+
+        Item cargo{3};
+        cargo.setParentId(2);
+        items.emplace_back(std::move(cargo));
+
+        Item ship{2};
+        ship.setLocationId(60003760);
+        items.emplace_back(std::move(ship));
+
+        Item module{4};
+        module.setParentId(2);
+        items.emplace_back(std::move(module));
+
+        const AssetList list{std::move(items)};
+        QCOMPARE(list.size(), std::size_t{1});
+
+        const auto root = *list.begin();
+        QCOMPARE(root->getId(), Item::IdType{2});
+        QCOMPARE(root->getChildCount(), std::size_t{2});
+
+        std::unordered_set<Item::IdType> seen;
+        visit(*root, seen);
+        QCOMPARE(seen.size(), std::size_t{3});
+    }
+
+    void AssetListTest::linksEveryItemOnce()
+    {
+        FixtureGenerator generator;
+        auto items = generator.createAssetItems(10000, 20);
+
+        const AssetList list{std::move(items)};
+
+        std::unordered_set<Item::IdType> seen;
+        for (const auto root : list)
+        {
+            QVERIFY(!root->getParentId());
+            visit(*root, seen);
+        }
+
+        QCOMPARE(seen.size(), list.getAllItems().size());
+    }
+}
@@ -0,0 +1,284 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+#include <random>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QtTest>
+#include <QFile>
+#include <QDir>
+#include <QSet>
+
+#include "LocalSyncStorage.h"
+#include "DatabaseSync.h"
+
+#include "DatabaseSyncTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        // enough rows to span several chunks
+        const auto rowCount = 2000;
+        const auto blobSize = 4096;
+
+        class RecordingSyncStorage
+            : public LocalSyncStorage
+        {
+        public:
+            using LocalSyncStorage::LocalSyncStorage;
+            virtual ~RecordingSyncStorage() = default;
+
+            QSet<QString> mWritten, mRemoved;
+
+            virtual void write(const QString &path, const QByteArray &data) override
+            {
+                mWritten.insert(path);
+                LocalSyncStorage::write(path, data);
+            }
+
+            virtual void remove(const QString &path) override
+            {
+                mRemoved.insert(path);
+                LocalSyncStorage::remove(path);
+            }
+
+            void clearRecords()
+            {
+                mWritten.clear();
+                mRemoved.clear();
+            }
+        };
+
+        void synchronousExecutor(const std::function<void ()> &func)
+        {
+            func();
+        }
+
+        template<class Func>
+        void withDatabase(const QString &path, Func func)
+        {
+            const auto connectionName = QStringLiteral("sync-test");
+
+            {
+                auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+                db.setDatabaseName(path);
+                QVERIFY(db.open());
+
+                func(db);
+
+                db.close();
+            }
+
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+
+        QByteArray makeBlob(std::mt19937 &generator)
+        {
+            QByteArray blob{blobSize, Qt::Uninitialized};
+            for (auto &byte : blob)
+                byte = static_cast<char>(generator());
+
+            return blob;
+        }
+
+        void createDatabase(const QString &path)
+        {
+            withDatabase(path, [](auto &db) {
+                QSqlQuery query{db};
+                QVERIFY(query.exec(QStringLiteral("CREATE TABLE data (id INTEGER PRIMARY KEY, value BLOB NOT NULL)")));
+
+                std::mt19937 generator{42};
+
+                db.transaction();
+
+                QVERIFY(query.prepare(QStringLiteral("INSERT INTO data (id, value) VALUES (?, ?)")));
+                for (auto id = 0; id < rowCount; ++id)
+                {
+                    query.bindValue(0, id);
+                    query.bindValue(1, makeBlob(generator));
+                    QVERIFY(query.exec());
+                }
+
+                db.commit();
+            });
+        }
+
+        void changeRow(const QString &path, int id)
+        {
+            withDatabase(path, [=](auto &db) {
+                std::mt19937 generator{7};
+
+                QSqlQuery query{db};
+                QVERIFY(query.prepare(QStringLiteral("UPDATE data SET value = ? WHERE id = ?")));
+                query.bindValue(0, makeBlob(generator));
+                query.bindValue(1, id);
+                QVERIFY(query.exec());
+            });
+        }
+
+        QByteArray readFile(const QString &path)
+        {
+            QFile file{path};
+            if (!file.open(QIODevice::ReadOnly))
+                return QByteArray{};
+
+            return file.readAll();
+        }
+
+        QSet<QString> getChunkPaths(const DatabaseSync::ChunkList &chunks)
+        {
+            QSet<QString> paths;
+            for (const auto &chunk : chunks)
+                paths.insert(QStringLiteral("chunks/") + QString::fromLatin1(chunk.mHash));
+
+            return paths;
+        }
+    }
+
+    void DatabaseSyncTest::init()
+    {
+        mDir = std::make_unique<QTemporaryDir>();
+        QVERIFY(mDir->isValid());
+        QVERIFY(QDir{mDir->path()}.mkdir(QStringLiteral("remote")));
+
+        createDatabase(getPath(QStringLiteral("main.db")));
+    }
+
+    void DatabaseSyncTest::cleanup()
+    {
+        mDir.reset();
+    }
+
+    void DatabaseSyncTest::roundTripRebuildsDatabase()
+    {
+        LocalSyncStorage storage{getPath(QStringLiteral("remote"))};
+        DatabaseSync sync{storage, synchronousExecutor};
+
+        const auto dbPath = getPath(QStringLiteral("main.db"));
+        sync.upload(dbPath);
+
+        // uploads are made from a snapshot, which is what should come back
+        const auto snapshotPath = getPath(QStringLiteral("snapshot.db"));
+        DatabaseSync::snapshotDatabase(dbPath, snapshotPath);
+
+        const auto chunks = DatabaseSync::chunkFile(snapshotPath);
+        QVERIFY(chunks.size() > 1);
+
+        const auto targetPath = getPath(QStringLiteral("downloaded.db"));
+        QVERIFY(sync.download(targetPath));
+
+        const auto expected = readFile(snapshotPath);
+        QVERIFY(!expected.isEmpty());
+        QVERIFY(readFile(targetPath) == expected);
+
+        withDatabase(targetPath, [](auto &db) {
+            QSqlQuery query{QStringLiteral("SELECT COUNT(*) FROM data"), db};
+            QVERIFY(query.next());
+            QCOMPARE(query.value(0).toInt(), rowCount);
+        });
+    }
+
+    void DatabaseSyncTest::uploadsOnlyChangedChunks()
+    {
+        RecordingSyncStorage storage{getPath(QStringLiteral("remote"))};
+        DatabaseSync sync{storage, synchronousExecutor};
+
+        const auto dbPath = getPath(QStringLiteral("main.db"));
+        const auto snapshotPath = getPath(QStringLiteral("snapshot.db"));
+
+        sync.upload(dbPath);
+
+        DatabaseSync::snapshotDatabase(dbPath, snapshotPath);
+        const auto oldChunks = getChunkPaths(DatabaseSync::chunkFile(snapshotPath));
+
+        changeRow(dbPath, rowCount / 2);
+        storage.clearRecords();
+
+        sync.upload(dbPath);
+
+        QFile::remove(snapshotPath);
+        DatabaseSync::snapshotDatabase(dbPath, snapshotPath);
+        const auto newChunks = getChunkPaths(DatabaseSync::chunkFile(snapshotPath));
+
+        auto expectedWrites = newChunks - oldChunks;
+        QVERIFY(!expectedWrites.isEmpty());
+        QVERIFY(expectedWrites.size() < newChunks.size());
+
+        expectedWrites.insert(DatabaseSync::manifestName);
+        QCOMPARE(storage.mWritten, expectedWrites);
+
+        QCOMPARE(storage.mRemoved, oldChunks - newChunks);
+
+        QSet<QString> remoteChunks;
+        const auto files = QDir{getPath(QStringLiteral("remote/chunks"))}.entryList(QDir::Files);
+        for (const auto &file : files)
+            remoteChunks.insert(QStringLiteral("chunks/") + file);
+
+        QCOMPARE(remoteChunks, newChunks);
+    }
+
+    void DatabaseSyncTest::rejectsCorruptedChunks()
+    {
+        LocalSyncStorage storage{getPath(QStringLiteral("remote"))};
+        DatabaseSync sync{storage, synchronousExecutor};
+
+        sync.upload(getPath(QStringLiteral("main.db")));
+
+        const auto chunks = QDir{getPath(QStringLiteral("remote/chunks"))}.entryList(QDir::Files);
+        QVERIFY(!chunks.isEmpty());
+
+        const auto chunkPath = QStringLiteral("chunks/") + chunks.first();
+
+        auto data = qUncompress(*storage.read(chunkPath));
+        const auto middle = data.size() / 2;
+        data[middle] = static_cast<char>(~data.at(middle));
+        storage.write(chunkPath, qCompress(data));
+
+        const auto targetPath = getPath(QStringLiteral("downloaded.db"));
+        QVERIFY_EXCEPTION_THROWN(sync.download(targetPath), std::runtime_error);
+        QVERIFY(!QFile::exists(targetPath));
+    }
+
+    void DatabaseSyncTest::downloadsLegacyFormat()
+    {
+        LocalSyncStorage storage{getPath(QStringLiteral("remote"))};
+        DatabaseSync sync{storage, synchronousExecutor};
+
+        const auto targetPath = getPath(QStringLiteral("downloaded.db"));
+        QVERIFY(!sync.downloadLegacy(targetPath));
+
+        const auto original = readFile(getPath(QStringLiteral("main.db")));
+        storage.write(DatabaseSync::legacyName, qCompress(original));
+
+        // no manifest - only the legacy file is there
+        QVERIFY(!sync.download(targetPath));
+        QVERIFY(sync.downloadLegacy(targetPath));
+        QVERIFY(readFile(targetPath) == original);
+
+        // the first upload in the new format replaces it
+        sync.upload(getPath(QStringLiteral("main.db")));
+        sync.removeLegacy();
+
+        QVERIFY(!storage.read(DatabaseSync::legacyName));
+        QVERIFY(storage.read(DatabaseSync::manifestName));
+    }
+
+    QString DatabaseSyncTest::getPath(const QString &name) const
+    {
+        return mDir->filePath(name);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtTest>
+
+#include "ESIJsonUtils.h"
+#include "MarketOrder.h"
+
+#include "ESIJsonUtilsTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        QJsonObject parse(const char *json)
+        {
+            return QJsonDocument::fromJson(json).object();
+        }
+    }
+
+    void ESIJsonUtilsTest::convertsMarketOrder()
+    {
+        const auto updateTime = QDateTime::currentDateTimeUtc();
+        const auto order = ESIJsonUtils::getExternalOrderFromJson(parse(R"({
+            "duration": 90,
+            "is_buy_order": true,
+            "issued": "2018-05-01T12:34:56Z",
+            "location_id": 60003760,
+            "min_volume": 1,
+            "order_id": 4000000001,
+            "price": 5.5,
+            "range": "region",
+            "system_id": 30000142,
+            "type_id": 34,
+            "volume_remain": 10,
+            "volume_total": 20
+        })"), 10000002, updateTime);
+
+        QCOMPARE(order.getId(), ExternalOrder::IdType{4000000001});
+        QCOMPARE(order.getType(), ExternalOrder::Type::Buy);
+        QCOMPARE(order.getTypeId(), ExternalOrder::TypeIdType{34});
+        QCOMPARE(order.getStationId(), quint64{60003760});
+        QCOMPARE(order.getSolarSystemId(), 30000142u);
+        QCOMPARE(order.getRegionId(), 10000002u);
+        QCOMPARE(order.getRange(), short{ExternalOrder::rangeRegion});
+        QCOMPARE(order.getUpdateTime(), updateTime);
+        QCOMPARE(order.getPrice(), 5.5);
+        QCOMPARE(order.getVolumeEntered(), 20u);
+        QCOMPARE(order.getVolumeRemaining(), 10u);
+        QCOMPARE(order.getMinVolume(), 1u);
+        QCOMPARE(order.getIssued(), QDateTime(QDate{2018, 5, 1}, QTime{12, 34, 56}, Qt::UTC));
+        QCOMPARE(order.getDuration(), short{90});
+    }
+
+    void ESIJsonUtilsTest::leavesMissingSystemUnset()
+    {
+        const auto order = ESIJsonUtils::getExternalOrderFromJson(parse(R"({
+            "is_buy_order": false,
+            "location_id": 1022734985679,
+            "order_id": 1,
+            "range": "station",
+            "type_id": 34
+        })"), 10000002, QDateTime::currentDateTimeUtc());
+
+        QCOMPARE(order.getSolarSystemId(), 0u);
+        QCOMPARE(order.getStationId(), quint64{1022734985679});
+        QCOMPARE(order.getType(), ExternalOrder::Type::Sell);
+        QCOMPARE(order.getRange(), short{ExternalOrder::rangeStation});
+    }
+
+    void ESIJsonUtilsTest::convertsMarketOrderRanges()
+    {
+        QCOMPARE(ESIJsonUtils::getMarketOrderRangeFromString(QStringLiteral("station")), short{MarketOrder::rangeStation});
+        QCOMPARE(ESIJsonUtils::getMarketOrderRangeFromString(QStringLiteral("solarsystem")), short{MarketOrder::rangeSystem});
+        QCOMPARE(ESIJsonUtils::getMarketOrderRangeFromString(QStringLiteral("region")), short{MarketOrder::rangeRegion});
+        QCOMPARE(ESIJsonUtils::getMarketOrderRangeFromString(QStringLiteral("5")), short{5});
+    }
+
+    void ESIJsonUtilsTest::convertsWalletJournalEntry()
+    {
+        const auto entry = ESIJsonUtils::getWalletJournalEntryFromJson(parse(R"({
+            "amount": -1000.5,
+            "balance": 50000,
+            "date": "2018-05-01T12:34:56Z",
+            "description": "Market escrow",
+            "first_party_id": 90000001,
+            "id": 17000000001,
+            "ref_type": "market_escrow",
+            "second_party_id": 1000132
+        })"), 90000001, 0);
+
+        QCOMPARE(entry.getId(), WalletJournalEntry::IdType{17000000001});
+        QCOMPARE(entry.getCharacterId(), Character::IdType{90000001});
+        QCOMPARE(entry.getTimestamp(), QDateTime(QDate{2018, 5, 1}, QTime{12, 34, 56}, Qt::UTC));
+        QCOMPARE(entry.getRefType(), QStringLiteral("market_escrow"));
+        QCOMPARE(entry.getFirstPartyId(), WalletJournalEntry::PartyIdType{90000001});
+        QCOMPARE(entry.getSecondPartyId(), WalletJournalEntry::PartyIdType{1000132});
+        QCOMPARE(entry.getAmount(), WalletJournalEntry::ISKType{-1000.5});
+        QCOMPARE(entry.getBalance(), WalletJournalEntry::ISKType{50000.});
+        QVERIFY(!entry.getTaxAmount());
+    }
+}
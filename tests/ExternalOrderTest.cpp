@@ -0,0 +1,87 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include <QStringList>
+#include <QByteArray>
+#include <QtTest>
+
+#include "ExternalOrder.h"
+
+#include "ExternalOrderTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        const auto logLine = "5.5,10.0,34,32767,4000000001,20,1,True,2018-05-01 12:34:56.000,90,60003760,10000002,30000142,0";
+
+        void verifyOrder(const ExternalOrder &order)
+        {
+            QCOMPARE(order.getId(), ExternalOrder::IdType{4000000001});
+            QCOMPARE(order.getPrice(), 5.5);
+            QCOMPARE(order.getVolumeRemaining(), 10u);
+            QCOMPARE(order.getTypeId(), ExternalOrder::TypeIdType{34});
+            QCOMPARE(order.getRange(), short{ExternalOrder::rangeRegion});
+            QCOMPARE(order.getVolumeEntered(), 20u);
+            QCOMPARE(order.getMinVolume(), 1u);
+            QCOMPARE(order.getType(), ExternalOrder::Type::Buy);
+            QCOMPARE(order.getIssued(), QDateTime(QDate{2018, 5, 1}, QTime{12, 34, 56}, Qt::UTC));
+            QCOMPARE(order.getDuration(), short{90});
+            QCOMPARE(order.getStationId(), quint64{60003760});
+            QCOMPARE(order.getRegionId(), 10000002u);
+            QCOMPARE(order.getSolarSystemId(), 30000142u);
+        }
+    }
+
+    void ExternalOrderTest::parsesLogLine()
+    {
+        verifyOrder(ExternalOrder::parseLogLine(QString::fromLatin1(logLine).split(',')));
+    }
+
+    void ExternalOrderTest::parsesRawLogTokens()
+    {
+        const QByteArray line{logLine};
+
+        ExternalOrder::LogLineTokens tokens;
+
+        auto column = 0;
+        auto token = line.constData();
+        const auto end = token + line.size();
+
+        while (column < ExternalOrder::logColumns)
+        {
+            const auto tokenEnd = std::find(token, end, ',');
+            tokens[column++] = std::string_view{token, static_cast<std::size_t>(tokenEnd - token)};
+
+            if (tokenEnd == end)
+                break;
+
+            token = tokenEnd + 1;
+        }
+
+        QCOMPARE(column, int{ExternalOrder::logColumns});
+        verifyOrder(ExternalOrder::parseLogLine(tokens));
+    }
+
+    void ExternalOrderTest::fallsBackToShortIssuedDate()
+    {
+        auto values = QString::fromLatin1(logLine).split(',');
+        values[8] = QStringLiteral("2018-05-01");
+
+        const auto order = ExternalOrder::parseLogLine(values);
+        QCOMPARE(order.getIssued(), QDateTime(QDate{2018, 5, 1}, QTime{0, 0}, Qt::UTC));
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QStandardPaths>
+#include <QSettings>
+#include <QtTest>
+
+#include "MarketImportPlanner.h"
+
+#include "MarketImportPlannerTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        const uint smallRegion = 10000001;
+        const uint largeRegion = 10000002;
+        const uint unknownRegion = 10000003;
+
+        TypeLocationPairs makePairs(uint regionId, uint typeCount)
+        {
+            TypeLocationPairs pairs;
+            for (auto type = 1u; type <= typeCount; ++type)
+                pairs.emplace(type, regionId);
+
+            return pairs;
+        }
+
+        void removeLearnedCounts()
+        {
+            QSettings settings;
+            settings.remove(ImportSettings::marketRegionPageCountGroup);
+        }
+    }
+
+    void MarketImportPlannerTest::initTestCase()
+    {
+        // learned counts are persisted - keep them away from real settings
+        QStandardPaths::setTestModeEnabled(true);
+        removeLearnedCounts();
+    }
+
+    void MarketImportPlannerTest::cleanupTestCase()
+    {
+        removeLearnedCounts();
+    }
+
+    void MarketImportPlannerTest::plansIndividualImport()
+    {
+        const auto pairs = makePairs(largeRegion, 50);
+        const auto plan = MarketImportPlanner::planImport(pairs, ImportSettings::MarketOrderImportType::Individual);
+
+        QVERIFY(plan.mWholeRegions.empty());
+        QVERIFY(plan.mWholeRegionPairs.empty());
+        QCOMPARE(plan.mIndividualPairs, pairs);
+    }
+
+    void MarketImportPlannerTest::plansWholeImport()
+    {
+        auto pairs = makePairs(smallRegion, 1);
+        pairs.emplace(2, largeRegion);
+
+        const auto plan = MarketImportPlanner::planImport(pairs, ImportSettings::MarketOrderImportType::Whole);
+
+        QCOMPARE(plan.mWholeRegions, (std::unordered_set<uint>{smallRegion, largeRegion}));
+        QCOMPARE(plan.mWholeRegionPairs, pairs);
+        QVERIFY(plan.mIndividualPairs.empty());
+    }
+
+    void MarketImportPlannerTest::plansAutoImportFromLearnedCounts()
+    {
+        MarketImportPlanner::setPageCount(smallRegion, 2);
+        MarketImportPlanner::setPageCount(largeRegion, 300);
+
+        QCOMPARE(MarketImportPlanner::getPageCount(smallRegion), std::make_optional(2u));
+        QCOMPARE(MarketImportPlanner::getPageCount(largeRegion), std::make_optional(300u));
+
+        auto pairs = makePairs(smallRegion, 5);
+        const auto largePairs = makePairs(largeRegion, 5);
+        pairs.insert(std::begin(largePairs), std::end(largePairs));
+
+        const auto plan = MarketImportPlanner::planImport(pairs, ImportSettings::MarketOrderImportType::Auto);
+
+        // 2 pages beat 5 requests, but 300 pages don't
+        QCOMPARE(plan.mWholeRegions, std::unordered_set<uint>{smallRegion});
+        QCOMPARE(plan.mWholeRegionPairs, makePairs(smallRegion, 5));
+        QCOMPARE(plan.mIndividualPairs, largePairs);
+
+        // two pages are still more than a single request
+        const auto singlePlan = MarketImportPlanner::planImport(makePairs(smallRegion, 1), ImportSettings::MarketOrderImportType::Auto);
+        QVERIFY(singlePlan.mWholeRegions.empty());
+        QCOMPARE(singlePlan.mIndividualPairs, makePairs(smallRegion, 1));
+    }
+
+    void MarketImportPlannerTest::plansAutoImportForUnknownRegions()
+    {
+        QVERIFY(!MarketImportPlanner::getPageCount(unknownRegion));
+
+        // fetching a whole unknown region is the only way to learn its size
+        const auto plan = MarketImportPlanner::planImport(makePairs(unknownRegion, 2), ImportSettings::MarketOrderImportType::Auto);
+        QCOMPARE(plan.mWholeRegions, std::unordered_set<uint>{unknownRegion});
+        QCOMPARE(plan.mWholeRegionPairs, makePairs(unknownRegion, 2));
+        QVERIFY(plan.mIndividualPairs.empty());
+
+        // but not for a single type, which takes one request either way
+        const auto singlePlan = MarketImportPlanner::planImport(makePairs(unknownRegion, 1), ImportSettings::MarketOrderImportType::Auto);
+        QVERIFY(singlePlan.mWholeRegions.empty());
+        QCOMPARE(singlePlan.mIndividualPairs, makePairs(unknownRegion, 1));
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QtTest>
+
+#include "MarketScreenerModel.h"
+#include "StubEveDataProvider.h"
+
+#include "MarketScreenerModelTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        const uint regionId = 10000002;
+
+        MarketHistory makeHistory(const QDate &last, int days)
+        {
+            MarketHistory history;
+            for (auto day = 0; day < days; ++day)
+            {
+                MarketHistoryEntry entry;
+                entry.mOrders = 10;
+                entry.mVolume = 100 + day % 7;
+                entry.mAvgPrice = 100. + day % 5;
+                entry.mLowPrice = entry.mAvgPrice - 1.;
+                entry.mHighPrice = entry.mAvgPrice + 1.;
+
+                history.emplace(last.addDays(-day), entry);
+            }
+
+            return history;
+        }
+    }
+
+    void MarketScreenerModelTest::includesHistoryEndingYesterday()
+    {
+        // ESI never returns history for the current day
+        MarketDataProvider::HistoryRegionMap history;
+        history[regionId][34] = makeHistory(QDate::currentDate().addDays(-1), 120);
+
+        StubEveDataProvider dataProvider;
+        MarketScreenerModel model{dataProvider};
+        model.setHistory(history, MarketScreenerModel::Conditions{});
+
+        QCOMPARE(model.rowCount(), 1);
+
+        const auto index = model.index(0, MarketScreenerModel::nameColumn);
+        QCOMPARE(model.getTypeId(index), EveType::IdType{34});
+        QCOMPARE(model.getRegionId(index), regionId);
+    }
+
+    void MarketScreenerModelTest::skipsHistoryWithoutRecentTrades()
+    {
+        MarketDataProvider::HistoryRegionMap history;
+        history[regionId][34] = makeHistory(QDate::currentDate().addDays(-1), 120);
+        history[regionId][35] = makeHistory(QDate::currentDate().addDays(-5), 120);
+
+        StubEveDataProvider dataProvider;
+        MarketScreenerModel model{dataProvider};
+        model.setHistory(history, MarketScreenerModel::Conditions{});
+
+        QCOMPARE(model.rowCount(), 1);
+        QCOMPARE(model.getTypeId(model.index(0, MarketScreenerModel::nameColumn)), EveType::IdType{34});
+    }
+}
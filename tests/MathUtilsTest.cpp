@@ -0,0 +1,120 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+#include <QtTest>
+
+#include "ReferenceMathUtils.h"
+#include "MathUtils.h"
+
+#include "MathUtilsTest.h"
+
+namespace Evernus
+{
+    void MathUtilsTest::emptyOrdersFallBackToAverage()
+    {
+        MathUtils::PriceVolumeList orders;
+
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Sell, 100, 5., false, 10.), 5.);
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Sell, 100, std::nan(""), false, 10.), 0.);
+    }
+
+    void MathUtilsTest::percentileWalksBestPricesFirst()
+    {
+        MathUtils::PriceVolumeList orders{
+            { 3., 10 },
+            { 1., 10 },
+            { 2., 10 },
+        };
+
+        // cheapest 15 units: 10 @ 1 and 5 @ 2
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Sell, 15, 2., false, 10.), 20. / 15.);
+        // most expensive 15 units: 10 @ 3 and 5 @ 2
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Buy, 15, 2., false, 10.), 40. / 15.);
+    }
+
+    void MathUtilsTest::bogusOrdersAreDiscarded()
+    {
+        MathUtils::PriceVolumeList orders{
+            { 0.01, 100 },
+            { 10., 10 },
+            { 11., 10 },
+        };
+
+        // the bogus order eats its volume from the percentile, but not its price
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Sell, 110, 10., true, 0.5), 10.);
+        QCOMPARE(MathUtils::calcPercentile(orders, PriceType::Sell, 120, 10., true, 0.5), 10.5);
+    }
+
+    void MathUtilsTest::bestPriceDependsOnSide()
+    {
+        const MathUtils::PriceVolumeList orders{
+            { 3., 1 },
+            { 1., 1 },
+            { 2., 1 },
+        };
+
+        QCOMPARE(MathUtils::getBestPrice(orders, PriceType::Sell), 1.);
+        QCOMPARE(MathUtils::getBestPrice(orders, PriceType::Buy), 3.);
+    }
+
+    void MathUtilsTest::percentileMatchesSortedWalk()
+    {
+        std::mt19937_64 engine{0};
+
+        std::uniform_int_distribution<std::size_t> sizeDist{0, 2000};
+        std::uniform_int_distribution<quint64> volumeDist{1, 1000};
+        std::uniform_int_distribution<int> tickDist{1, 200};
+        std::uniform_int_distribution<int> kindDist{0, 19};
+        std::uniform_real_distribution<double> fractionDist{0., 1.2};
+        std::bernoulli_distribution flagDist;
+
+        for (auto round = 0; round < 500; ++round)
+        {
+            const auto basePrice = 100.;
+
+            MathUtils::PriceVolumeList orders(sizeDist(engine));
+            quint64 totalVolume = 0;
+
+            for (auto &order : orders)
+            {
+                // prices on a coarse tick grid, so equal prices are common, with some far off bogus ones
+                const auto kind = kindDist(engine);
+                order.mPrice = basePrice * tickDist(engine) / 100.;
+                if (kind == 0)
+                    order.mPrice *= 1000.;
+                else if (kind == 1)
+                    order.mPrice /= 1000.;
+
+                order.mVolume = volumeDist(engine);
+                totalVolume += order.mVolume;
+            }
+
+            const auto type = (flagDist(engine)) ? (PriceType::Buy) : (PriceType::Sell);
+            const auto maxVolume = static_cast<quint64>(totalVolume * fractionDist(engine));
+            const auto avgPrice = (round % 10 == 0) ? (0.) : (basePrice);
+            const auto discardBogusOrders = flagDist(engine);
+
+            const auto expected = ReferenceMathUtils::calcPercentile(orders, type, maxVolume, avgPrice, discardBogusOrders, 0.9);
+            const auto actual = MathUtils::calcPercentile(orders, type, maxVolume, avgPrice, discardBogusOrders, 0.9);
+
+            // summation order differs, so allow for rounding
+            QVERIFY2(std::fabs(actual - expected) <= 1e-9 * std::max(1., std::fabs(expected)),
+                     qPrintable(QStringLiteral("round %1: expected %2, got %3").arg(round).arg(expected, 0, 'g', 17).arg(actual, 0, 'g', 17)));
+        }
+    }
+}
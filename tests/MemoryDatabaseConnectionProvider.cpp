@@ -0,0 +1,41 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QSqlDatabase>
+
+#include "MemoryDatabaseConnectionProvider.h"
+
+namespace Evernus
+{
+    MemoryDatabaseConnectionProvider::MemoryDatabaseConnectionProvider(const QString &connectionName)
+        : DatabaseConnectionProvider{}
+        , mConnectionName{connectionName}
+    {
+        auto db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), mConnectionName);
+        db.setDatabaseName(QStringLiteral(":memory:"));
+        db.open();
+        db.exec(QStringLiteral("PRAGMA foreign_keys = ON"));
+    }
+
+    MemoryDatabaseConnectionProvider::~MemoryDatabaseConnectionProvider()
+    {
+        QSqlDatabase::database(mConnectionName, false).close();
+        QSqlDatabase::removeDatabase(mConnectionName);
+    }
+
+    QSqlDatabase MemoryDatabaseConnectionProvider::getConnection() const
+    {
+        return QSqlDatabase::database(mConnectionName);
+    }
+}
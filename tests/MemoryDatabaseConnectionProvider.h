@@ -0,0 +1,41 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QString>
+
+#include "DatabaseConnectionProvider.h"
+
+namespace Evernus
+{
+    // a private in-memory SQLite database, which lives as long as the provider
+    class MemoryDatabaseConnectionProvider final
+        : public DatabaseConnectionProvider
+    {
+    public:
+        explicit MemoryDatabaseConnectionProvider(const QString &connectionName);
+        MemoryDatabaseConnectionProvider(const MemoryDatabaseConnectionProvider &) = delete;
+        MemoryDatabaseConnectionProvider(MemoryDatabaseConnectionProvider &&) = delete;
+        virtual ~MemoryDatabaseConnectionProvider();
+
+        virtual QSqlDatabase getConnection() const override;
+
+        MemoryDatabaseConnectionProvider &operator =(const MemoryDatabaseConnectionProvider &) = delete;
+        MemoryDatabaseConnectionProvider &operator =(MemoryDatabaseConnectionProvider &&) = delete;
+
+    private:
+        const QString mConnectionName;
+    };
+}
@@ -0,0 +1,74 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include "MathUtils.h"
+
+namespace Evernus::ReferenceMathUtils
+{
+    // the original percentile, which walks a fully sorted book - kept as an oracle for the quickselect version
+    inline double calcPercentile(const MathUtils::PriceVolumeList &orders,
+                                 PriceType type,
+                                 quint64 maxVolume,
+                                 double avgPrice,
+                                 bool discardBogusOrders,
+                                 double bogusOrderThreshold)
+    {
+        const auto compare = [=](const auto &a, const auto &b) {
+            return (type == PriceType::Buy) ? (a.mPrice > b.mPrice) : (a.mPrice < b.mPrice);
+        };
+
+        const std::multiset<MathUtils::PriceVolume, decltype(compare)> sorted(std::begin(orders), std::end(orders), compare);
+
+        if (sorted.empty())
+            return (std::isnan(avgPrice)) ? (0.) : (avgPrice);
+
+        if (maxVolume == 0)
+            maxVolume = 1;
+
+        const auto nullAvg = qFuzzyIsNull(avgPrice);
+
+        auto it = std::begin(sorted);
+        quint64 volume = 0u;
+        auto result = 0.;
+
+        while (volume < maxVolume && it != std::end(sorted))
+        {
+            const auto price = it->mPrice;
+            const auto add = std::min(it->mVolume, maxVolume - volume);
+
+            if (!discardBogusOrders || nullAvg || std::fabs((price - avgPrice) / avgPrice) < bogusOrderThreshold)
+            {
+                volume += add;
+                result += price * add;
+            }
+            else if (!nullAvg)
+            {
+                maxVolume -= add;
+            }
+
+            ++it;
+        }
+
+        if (maxVolume == 0) // all bogus orders?
+            return std::begin(sorted)->mPrice;
+
+        return result / maxVolume;
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QtTest>
+
+#include "RouteUtils.h"
+
+#include "RouteUtilsTest.h"
+
+namespace Evernus
+{
+    namespace
+    {
+        void addGate(RouteUtils::JumpMap &jumpMap, uint from, uint to)
+        {
+            jumpMap.emplace(from, to);
+            jumpMap.emplace(to, from);
+        }
+    }
+
+    void RouteUtilsTest::findsShortestRoute()
+    {
+        RouteUtils::JumpMap jumpMap;
+
+        // 1 - 2 - 3 - 4 - 5 with a shortcut 2 - 5
+        addGate(jumpMap, 1, 2);
+        addGate(jumpMap, 2, 3);
+        addGate(jumpMap, 3, 4);
+        addGate(jumpMap, 4, 5);
+        addGate(jumpMap, 2, 5);
+
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 1), 0u);
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 3), 2u);
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 5), 2u);
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 5, 1), 2u);
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 4), 3u);
+    }
+
+    void RouteUtilsTest::reportsUnreachableSystems()
+    {
+        RouteUtils::JumpMap jumpMap;
+        addGate(jumpMap, 1, 2);
+        addGate(jumpMap, 3, 4);
+
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 4), RouteUtils::unreachableDistance);
+        QCOMPARE(RouteUtils::getJumpDistance(jumpMap, 1, 100), RouteUtils::unreachableDistance);
+    }
+}
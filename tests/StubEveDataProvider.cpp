@@ -0,0 +1,230 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "StubEveDataProvider.h"
+
+namespace Evernus
+{
+    QString StubEveDataProvider::getTypeName(EveType::IdType) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getTypeMarketGroupParentName(EveType::IdType) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getTypeMarketGroupName(EveType::IdType) const
+    {
+        return {};
+    }
+
+    MarketGroup::IdType StubEveDataProvider::getTypeMarketGroupParentId(EveType::IdType) const
+    {
+        return {};
+    }
+
+    const std::unordered_map<EveType::IdType, QString> &StubEveDataProvider::getAllTradeableTypeNames() const
+    {
+        return mTypeNames;
+    }
+
+    const StubEveDataProvider::TypeList &StubEveDataProvider::getAllTradeableTypeIds() const
+    {
+        return mTypeIds;
+    }
+
+    const StubEveDataProvider::TypeList &StubEveDataProvider::getCitadelTypeIds() const
+    {
+        return mTypeIds;
+    }
+
+    QString StubEveDataProvider::getTypeMetaGroupName(EveType::IdType) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getGenericName(quint64) const
+    {
+        return {};
+    }
+
+    bool StubEveDataProvider::hasGenericName(quint64) const
+    {
+        return {};
+    }
+
+    double StubEveDataProvider::getTypeVolume(EveType::IdType) const
+    {
+        return {};
+    }
+
+    std::shared_ptr<ExternalOrder> StubEveDataProvider::getTypeStationSellPrice(EveType::IdType, quint64) const
+    {
+        return {};
+    }
+
+    std::shared_ptr<ExternalOrder> StubEveDataProvider::getTypeRegionSellPrice(EveType::IdType, uint) const
+    {
+        return {};
+    }
+
+    std::shared_ptr<ExternalOrder> StubEveDataProvider::getTypeBuyPrice(EveType::IdType, quint64, int) const
+    {
+        return {};
+    }
+
+    void StubEveDataProvider::updateExternalOrders(const std::vector<ExternalOrder> &)
+    {
+    }
+
+    void StubEveDataProvider::clearExternalOrders()
+    {
+    }
+
+    void StubEveDataProvider::clearExternalOrdersForType(EveType::IdType)
+    {
+    }
+
+    QString StubEveDataProvider::getLocationName(quint64) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getRegionName(uint) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getSolarSystemName(uint) const
+    {
+        return {};
+    }
+
+    const std::vector<StubEveDataProvider::MapLocation> &StubEveDataProvider::getRegions() const
+    {
+        return mLocations;
+    }
+
+    const std::vector<StubEveDataProvider::MapLocation> &StubEveDataProvider::getConstellations(uint) const
+    {
+        return mLocations;
+    }
+
+    const std::vector<StubEveDataProvider::MapTreeLocation> &StubEveDataProvider::getConstellations() const
+    {
+        return mTreeLocations;
+    }
+
+    const std::vector<StubEveDataProvider::MapLocation> &StubEveDataProvider::getSolarSystemsForConstellation(uint) const
+    {
+        return mLocations;
+    }
+
+    const std::vector<StubEveDataProvider::MapLocation> &StubEveDataProvider::getSolarSystemsForRegion(uint) const
+    {
+        return mLocations;
+    }
+
+    const std::vector<StubEveDataProvider::MapTreeLocation> &StubEveDataProvider::getSolarSystems() const
+    {
+        return mTreeLocations;
+    }
+
+    const std::vector<StubEveDataProvider::Station> &StubEveDataProvider::getStations(uint) const
+    {
+        return mStations;
+    }
+
+    double StubEveDataProvider::getSolarSystemSecurityStatus(uint) const
+    {
+        return {};
+    }
+
+    uint StubEveDataProvider::getSolarSystemConstellationId(uint) const
+    {
+        return {};
+    }
+
+    uint StubEveDataProvider::getSolarSystemRegionId(uint) const
+    {
+        return {};
+    }
+
+    uint StubEveDataProvider::getStationRegionId(quint64) const
+    {
+        return {};
+    }
+
+    uint StubEveDataProvider::getStationSolarSystemId(quint64) const
+    {
+        return {};
+    }
+
+    const CitadelRepository::EntityList StubEveDataProvider::getCitadelsForRegion(uint) const
+    {
+        return {};
+    }
+
+    const CitadelRepository::EntityList &StubEveDataProvider::getCitadels() const
+    {
+        return mCitadels;
+    }
+
+    const StubEveDataProvider::ReprocessingMap &StubEveDataProvider::getOreReprocessingInfo() const
+    {
+        return mReprocessingInfo;
+    }
+
+    const StubEveDataProvider::ReprocessingMap &StubEveDataProvider::getTypeReprocessingInfo(const TypeList &) const
+    {
+        return mReprocessingInfo;
+    }
+
+    uint StubEveDataProvider::getGroupId(const QString &) const
+    {
+        return {};
+    }
+
+    uint StubEveDataProvider::getDistance(uint, uint) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getRaceName(uint) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getBloodlineName(uint) const
+    {
+        return {};
+    }
+
+    QString StubEveDataProvider::getAncestryName(uint) const
+    {
+        return {};
+    }
+
+    const StubEveDataProvider::ManufacturingInfo &StubEveDataProvider::getTypeManufacturingInfo(EveType::IdType) const
+    {
+        return mManufacturingInfo;
+    }
+
+    EveType::IdType StubEveDataProvider::getBlueprintOutputType(EveType::IdType) const
+    {
+        return {};
+    }
+}
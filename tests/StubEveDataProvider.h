@@ -0,0 +1,83 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "EveDataProvider.h"
+
+namespace Evernus
+{
+    // data provider knowing nothing, for testing code which only needs one to exist
+    class StubEveDataProvider
+        : public EveDataProvider
+    {
+    public:
+        using EveDataProvider::EveDataProvider;
+        virtual ~StubEveDataProvider() = default;
+
+        virtual QString getTypeName(EveType::IdType) const override;
+        virtual QString getTypeMarketGroupParentName(EveType::IdType) const override;
+        virtual QString getTypeMarketGroupName(EveType::IdType) const override;
+        virtual MarketGroup::IdType getTypeMarketGroupParentId(EveType::IdType) const override;
+        virtual const std::unordered_map<EveType::IdType, QString> &getAllTradeableTypeNames() const override;
+        virtual const TypeList &getAllTradeableTypeIds() const override;
+        virtual const TypeList &getCitadelTypeIds() const override;
+        virtual QString getTypeMetaGroupName(EveType::IdType) const override;
+        virtual QString getGenericName(quint64) const override;
+        virtual bool hasGenericName(quint64) const override;
+        virtual double getTypeVolume(EveType::IdType) const override;
+        virtual std::shared_ptr<ExternalOrder> getTypeStationSellPrice(EveType::IdType, quint64) const override;
+        virtual std::shared_ptr<ExternalOrder> getTypeRegionSellPrice(EveType::IdType, uint) const override;
+        virtual std::shared_ptr<ExternalOrder> getTypeBuyPrice(EveType::IdType, quint64, int) const override;
+        virtual void updateExternalOrders(const std::vector<ExternalOrder> &) override;
+        virtual void clearExternalOrders() override;
+        virtual void clearExternalOrdersForType(EveType::IdType) override;
+        virtual QString getLocationName(quint64) const override;
+        virtual QString getRegionName(uint) const override;
+        virtual QString getSolarSystemName(uint) const override;
+        virtual const std::vector<MapLocation> &getRegions() const override;
+        virtual const std::vector<MapLocation> &getConstellations(uint) const override;
+        virtual const std::vector<MapTreeLocation> &getConstellations() const override;
+        virtual const std::vector<MapLocation> &getSolarSystemsForConstellation(uint) const override;
+        virtual const std::vector<MapLocation> &getSolarSystemsForRegion(uint) const override;
+        virtual const std::vector<MapTreeLocation> &getSolarSystems() const override;
+        virtual const std::vector<Station> &getStations(uint) const override;
+        virtual double getSolarSystemSecurityStatus(uint) const override;
+        virtual uint getSolarSystemConstellationId(uint) const override;
+        virtual uint getSolarSystemRegionId(uint) const override;
+        virtual uint getStationRegionId(quint64) const override;
+        virtual uint getStationSolarSystemId(quint64) const override;
+        virtual const CitadelRepository::EntityList getCitadelsForRegion(uint) const override;
+        virtual const CitadelRepository::EntityList &getCitadels() const override;
+        virtual const ReprocessingMap &getOreReprocessingInfo() const override;
+        virtual const ReprocessingMap &getTypeReprocessingInfo(const TypeList &) const override;
+        virtual uint getGroupId(const QString &) const override;
+        virtual uint getDistance(uint, uint) const override;
+        virtual QString getRaceName(uint) const override;
+        virtual QString getBloodlineName(uint) const override;
+        virtual QString getAncestryName(uint) const override;
+        virtual const ManufacturingInfo &getTypeManufacturingInfo(EveType::IdType) const override;
+        virtual EveType::IdType getBlueprintOutputType(EveType::IdType) const override;
+
+    private:
+        std::unordered_map<EveType::IdType, QString> mTypeNames;
+        TypeList mTypeIds;
+        std::vector<MapLocation> mLocations;
+        std::vector<MapTreeLocation> mTreeLocations;
+        std::vector<Station> mStations;
+        CitadelRepository::EntityList mCitadels;
+        ReprocessingMap mReprocessingInfo;
+        ManufacturingInfo mManufacturingInfo{};
+    };
+}
@@ -0,0 +1,60 @@
+/**
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <QCoreApplication>
+#include <QtTest>
+
+#include "AssetListRepositoryTest.h"
+#include "MarketImportPlannerTest.h"
+#include "MarketScreenerModelTest.h"
+#include "ExternalOrderTest.h"
+#include "DatabaseSyncTest.h"
+#include "ESIJsonUtilsTest.h"
+#include "RouteUtilsTest.h"
+#include "AssetListTest.h"
+#include "MathUtilsTest.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app{argc, argv};
+    QCoreApplication::setApplicationName(QStringLiteral("evernus-tests"));
+
+    Evernus::AssetListRepositoryTest assetListRepositoryTest;
+    Evernus::MarketImportPlannerTest marketImportPlannerTest;
+    Evernus::MarketScreenerModelTest marketScreenerModelTest;
+    Evernus::ExternalOrderTest externalOrderTest;
+    Evernus::DatabaseSyncTest databaseSyncTest;
+    Evernus::ESIJsonUtilsTest esiJsonUtilsTest;
+    Evernus::RouteUtilsTest routeUtilsTest;
+    Evernus::AssetListTest assetListTest;
+    Evernus::MathUtilsTest mathUtilsTest;
+
+    const std::initializer_list<QObject *> tests{
+        &mathUtilsTest,
+        &externalOrderTest,
+        &assetListTest,
+        &assetListRepositoryTest,
+        &esiJsonUtilsTest,
+        &routeUtilsTest,
+        &marketScreenerModelTest,
+        &marketImportPlannerTest,
+        &databaseSyncTest,
+    };
+
+    auto result = 0;
+    for (const auto test : tests)
+        result |= QTest::qExec(test, argc, argv);
+
+    return result;
+}